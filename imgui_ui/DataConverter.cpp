@@ -9,7 +9,11 @@
 #include <iomanip>
 #include <cctype>
 #include <algorithm>
+#ifdef _WIN32
 #include <windows.h>  // Windows编码转换API
+#else
+#include <iconv.h>    // POSIX编码转换API
+#endif
 
 std::string DataConverter::BytesToHexString(const unsigned char* data, int length, bool addSpaces) {
     if (!data || length <= 0) {
@@ -138,6 +142,35 @@ bool DataConverter::HexCharToValue(char ch, unsigned char& value) {
 // 编码转换函数实现
 // ========================================
 
+#ifndef _WIN32
+/**
+ * @brief 使用iconv进行编码转换
+ * @return 成功返回true
+ */
+static bool IconvConvert(const char* from, const char* to, const char* input, size_t length, std::string& output) {
+    iconv_t cd = iconv_open(to, from);
+    if (cd == reinterpret_cast<iconv_t>(-1)) {
+        return false;
+    }
+
+    // GBK→UTF-8最多膨胀1.5倍，UTF-8→GBK不会膨胀，按2倍分配足够
+    output.assign(length * 2 + 4, '\0');
+    char* in_ptr = const_cast<char*>(input);
+    size_t in_left = length;
+    char* out_ptr = &output[0];
+    size_t out_left = output.size();
+
+    size_t result = iconv(cd, &in_ptr, &in_left, &out_ptr, &out_left);
+    iconv_close(cd);
+    if (result == static_cast<size_t>(-1)) {
+        return false;
+    }
+
+    output.resize(output.size() - out_left);
+    return true;
+}
+#endif
+
 std::string DataConverter::ConvertToUTF8(const unsigned char* data, int length, EncodingType encoding) {
     if (!data || length <= 0) {
         return "";
@@ -148,6 +181,7 @@ std::string DataConverter::ConvertToUTF8(const unsigned char* data, int length,
         return std::string(reinterpret_cast<const char*>(data), length);
     }
 
+#ifdef _WIN32
     // 确定源编码的代码页
     UINT sourceCodePage = 0;
     switch (encoding) {
@@ -186,6 +220,17 @@ std::string DataConverter::ConvertToUTF8(const unsigned char* data, int length,
                         &utf8str[0], utf8len, NULL, NULL);
 
     return utf8str;
+#else
+    if (encoding != EncodingType::GBK) {
+        return std::string(reinterpret_cast<const char*>(data), length);
+    }
+    std::string utf8str;
+    if (!IconvConvert("GBK", "UTF-8", reinterpret_cast<const char*>(data), length, utf8str)) {
+        // 转换失败，返回原始数据
+        return std::string(reinterpret_cast<const char*>(data), length);
+    }
+    return utf8str;
+#endif
 }
 
 bool DataConverter::ConvertFromUTF8(const std::string& utf8Str, EncodingType encoding, std::vector<unsigned char>& outData) {
@@ -201,6 +246,7 @@ bool DataConverter::ConvertFromUTF8(const std::string& utf8Str, EncodingType enc
         return true;
     }
 
+#ifdef _WIN32
     // 确定目标编码的代码页
     UINT targetCodePage = 0;
     switch (encoding) {
@@ -240,4 +286,16 @@ bool DataConverter::ConvertFromUTF8(const std::string& utf8Str, EncodingType enc
 
     outData.assign(tempStr.begin(), tempStr.end());
     return true;
+#else
+    if (encoding != EncodingType::GBK) {
+        outData.assign(utf8Str.begin(), utf8Str.end());
+        return true;
+    }
+    std::string tempStr;
+    if (!IconvConvert("UTF-8", "GBK", utf8Str.data(), utf8Str.length(), tempStr)) {
+        return false;
+    }
+    outData.assign(tempStr.begin(), tempStr.end());
+    return true;
+#endif
 }
@@ -0,0 +1,30 @@
+/**
+ * @file SerialPort.cpp
+ * @brief 串口传输接口 - 平台实现分发
+ */
+
+#include "SerialPort.h"
+
+#ifdef _WIN32
+#include "SerialPort_Win.h"
+using PlatformSerialPort = SerialPort_Win;
+#else
+#include "SerialPort_Posix.h"
+using PlatformSerialPort = SerialPort_Posix;
+#endif
+
+std::unique_ptr<SerialPort> SerialPort::Create() {
+    return std::make_unique<PlatformSerialPort>();
+}
+
+std::vector<std::string> SerialPort::EnumeratePorts() {
+    return PlatformSerialPort::EnumeratePorts();
+}
+
+std::vector<SerialPortInfo> SerialPort::EnumeratePortsDetailed() {
+    return PlatformSerialPort::EnumeratePortsDetailed();
+}
+
+std::future<std::vector<SerialPortInfo>> SerialPort::EnumeratePortsAsync() {
+    return PlatformSerialPort::EnumeratePortsAsync();
+}
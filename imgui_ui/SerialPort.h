@@ -0,0 +1,259 @@
+/**
+ * @file SerialPort.h
+ * @brief 串口传输抽象接口
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 定义与平台无关的串口接口，具体实现：
+ * - SerialPort_Win：Windows API（CreateFileA + OVERLAPPED）
+ * - SerialPort_Posix：termios + epoll（Linux/macOS，支持pty对压测）
+ *
+ * 上层代码（AppState、main_imgui.cpp）只依赖本接口，
+ * 通过SerialPort::Create()获取当前平台的实现。
+ */
+
+#ifndef SERIALPORT_H
+#define SERIALPORT_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <future>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief 串口配置参数
+ */
+struct SerialConfig {
+    std::string portName = "COM1";       // 串口名称（POSIX下为设备路径，如"/dev/ttyUSB0"）
+    int baudRate = 115200;                // 波特率（POSIX下支持任意自定义波特率）
+    int dataBits = 8;                     // 数据位 (5, 6, 7, 8)
+    int stopBits = 1;                     // 停止位 (1=ONESTOPBIT, 2=TWOSTOPBITS)
+    int parity = 0;                       // 校验位 (0=NOPARITY, 1=ODDPARITY, 2=EVENPARITY)
+    int rxQueueSize = 65536;              // 驱动接收队列大小（字节，Windows SetupComm）
+    int txQueueSize = 4096;               // 驱动发送队列大小（字节，Windows SetupComm）
+    int readChunkSize = 16384;            // 单次读取块大小（字节，即回调的最大长度）
+};
+
+/**
+ * @brief 接收线程统计信息
+ */
+struct ReceiveStats {
+    uint64_t totalBytes = 0;              // 累计接收字节数
+    uint64_t totalWakeups = 0;            // 累计唤醒次数（每次唤醒可能包含多次读取）
+    double bytesPerWakeup = 0.0;          // 最近统计窗口内平均每次唤醒读取的字节数
+    double wakeupsPerSecond = 0.0;        // 最近统计窗口内每秒唤醒次数
+    double bytesPerSecond = 0.0;          // 最近统计窗口内每秒接收字节数
+};
+
+/**
+ * @brief 接收统计计数器（接收线程写，UI线程读）
+ *
+ * 每次唤醒调用一次Record()；每满1秒滚动一次统计窗口，
+ * 窗口结果通过原子变量发布，读取端无需加锁。
+ */
+class ReceiveStatsCounter {
+public:
+    ReceiveStatsCounter() {
+        Reset();
+    }
+
+    /**
+     * @brief 重置计数器（打开串口时调用）
+     */
+    void Reset() {
+        totalBytes_ = 0;
+        totalWakeups_ = 0;
+        windowBytes_ = 0;
+        windowWakeups_ = 0;
+        windowStart_ = std::chrono::steady_clock::now();
+        lastWindowEndNs_ = 0;
+        bytesPerWakeup_ = 0.0;
+        wakeupsPerSecond_ = 0.0;
+        bytesPerSecond_ = 0.0;
+    }
+
+    /**
+     * @brief 记录一次唤醒（仅接收线程调用）
+     * @param bytes 本次唤醒读取的总字节数
+     */
+    void Record(size_t bytes) {
+        totalBytes_.fetch_add(bytes, std::memory_order_relaxed);
+        totalWakeups_.fetch_add(1, std::memory_order_relaxed);
+        windowBytes_ += bytes;
+        windowWakeups_++;
+
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - windowStart_).count();
+        if (elapsed >= 1.0) {
+            bytesPerWakeup_ = static_cast<double>(windowBytes_) / windowWakeups_;
+            wakeupsPerSecond_ = windowWakeups_ / elapsed;
+            bytesPerSecond_ = windowBytes_ / elapsed;
+            lastWindowEndNs_ = now.time_since_epoch().count();
+            windowBytes_ = 0;
+            windowWakeups_ = 0;
+            windowStart_ = now;
+        }
+    }
+
+    /**
+     * @brief 获取统计快照（任意线程）
+     *
+     * 超过2秒没有新窗口（链路空闲）时，速率按0处理
+     */
+    ReceiveStats Snapshot() const {
+        ReceiveStats stats;
+        stats.totalBytes = totalBytes_.load(std::memory_order_relaxed);
+        stats.totalWakeups = totalWakeups_.load(std::memory_order_relaxed);
+
+        auto now_ns = std::chrono::steady_clock::now().time_since_epoch().count();
+        auto idle = std::chrono::steady_clock::duration(now_ns - lastWindowEndNs_.load());
+        if (idle < std::chrono::seconds(2)) {
+            stats.bytesPerWakeup = bytesPerWakeup_.load();
+            stats.wakeupsPerSecond = wakeupsPerSecond_.load();
+            stats.bytesPerSecond = bytesPerSecond_.load();
+        }
+        return stats;
+    }
+
+private:
+    std::atomic<uint64_t> totalBytes_;
+    std::atomic<uint64_t> totalWakeups_;
+    std::atomic<int64_t> lastWindowEndNs_;
+    std::atomic<double> bytesPerWakeup_;
+    std::atomic<double> wakeupsPerSecond_;
+    std::atomic<double> bytesPerSecond_;
+
+    // 仅接收线程访问
+    uint64_t windowBytes_;
+    uint64_t windowWakeups_;
+    std::chrono::steady_clock::time_point windowStart_;
+};
+
+/**
+ * @brief 串口设备详细信息
+ */
+struct SerialPortInfo {
+    std::string portName;        // 端口名称 "COM3" / "/dev/ttyUSB0"
+    std::string friendlyName;    // 友好名称 "USB Serial Port (COM3)"
+    std::string description;     // 设备描述 "CH340 USB-SERIAL CHIP"
+    std::string manufacturer;    // 制造商 "wch.cn"
+    std::string hardwareId;      // 硬件ID "USB\VID_1A86&PID_7523"
+
+    /**
+     * @brief 获取显示名称（优先使用友好名称）
+     * @return 用于UI显示的名称
+     */
+    std::string GetDisplayName() const {
+        if (!friendlyName.empty()) {
+            return friendlyName;
+        }
+        return portName;
+    }
+};
+
+/**
+ * @brief 串口传输接口（抽象类）
+ */
+class SerialPort {
+public:
+    using ReceiveCallback = std::function<void(const unsigned char*, int)>;
+
+    virtual ~SerialPort() = default;
+
+    /**
+     * @brief 创建当前平台的串口实现
+     * @return Windows下为SerialPort_Win，其余平台为SerialPort_Posix
+     */
+    static std::unique_ptr<SerialPort> Create();
+
+    /**
+     * @brief 枚举所有可用串口（简单版，向后兼容）
+     * @return 串口名称列表
+     */
+    static std::vector<std::string> EnumeratePorts();
+
+    /**
+     * @brief 枚举所有可用串口（详细版，包含设备信息）
+     * @return 串口详细信息列表
+     */
+    static std::vector<SerialPortInfo> EnumeratePortsDetailed();
+
+    /**
+     * @brief 异步枚举所有可用串口
+     * @return future对象，可异步获取串口详细信息列表
+     */
+    static std::future<std::vector<SerialPortInfo>> EnumeratePortsAsync();
+
+    /**
+     * @brief 打开串口
+     * @param config 串口配置参数
+     * @return 成功返回true，失败返回false
+     */
+    virtual bool Open(const SerialConfig& config) = 0;
+
+    /**
+     * @brief 关闭串口
+     */
+    virtual void Close() = 0;
+
+    /**
+     * @brief 判断串口是否已打开
+     */
+    virtual bool IsOpen() const = 0;
+
+    /**
+     * @brief 发送数据
+     * @param data 要发送的数据
+     * @param length 数据长度
+     * @return 实际发送的字节数，失败返回-1
+     */
+    virtual int Write(const unsigned char* data, int length) = 0;
+
+    /**
+     * @brief 发送字符串
+     * @param str 要发送的字符串
+     * @return 实际发送的字节数，失败返回-1
+     */
+    int Write(const std::string& str) {
+        return Write(reinterpret_cast<const unsigned char*>(str.c_str()), static_cast<int>(str.length()));
+    }
+
+    /**
+     * @brief 设置数据接收回调函数（在接收线程中调用）
+     * @param callback 回调函数，参数为接收到的数据和长度
+     *
+     * 须在Open()之前设置：接收线程启动时复制一份回调，串口打开期间调用无效。
+     */
+    virtual void SetReceiveCallback(ReceiveCallback callback) = 0;
+
+    /**
+     * @brief 获取最后一次错误信息
+     */
+    virtual std::string GetLastError() const = 0;
+
+    /**
+     * @brief 清空接收缓冲区
+     */
+    virtual void ClearReceiveBuffer() = 0;
+
+    /**
+     * @brief 清空发送缓冲区
+     */
+    virtual void ClearTransmitBuffer() = 0;
+
+    /**
+     * @brief 获取接收统计（每次唤醒字节数、每秒唤醒次数）
+     */
+    ReceiveStats GetReceiveStats() const {
+        return rxStats_.Snapshot();
+    }
+
+protected:
+    ReceiveStatsCounter rxStats_;                               // 接收统计（由接收线程更新）
+};
+
+#endif // SERIALPORT_H
@@ -0,0 +1,507 @@
+#include "SerialPort_Posix.h"
+
+#ifndef _WIN32
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <poll.h>
+#include <dirent.h>
+#include <sys/ioctl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <climits>
+#include <fstream>
+#include <algorithm>
+#include <linux/serial.h>
+
+// Linux自定义波特率：termios2 + BOTHER
+// 注意：不能包含<asm/termbits.h>（与<termios.h>冲突），这里按内核ABI自行声明
+#ifndef BOTHER
+#define BOTHER 0010000
+#endif
+
+struct termios2 {
+    tcflag_t c_iflag;
+    tcflag_t c_oflag;
+    tcflag_t c_cflag;
+    tcflag_t c_lflag;
+    cc_t c_line;
+    cc_t c_cc[19];
+    speed_t c_ispeed;
+    speed_t c_ospeed;
+};
+
+/**
+ * @brief 读取sysfs属性文件的第一行
+ * @param path 文件路径
+ * @return 文件内容（去除行尾），失败返回空串
+ */
+static std::string ReadSysfsAttr(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    if (file.is_open()) {
+        std::getline(file, line);
+    }
+    while (!line.empty() && (line.back() == '\n' || line.back() == '\r' || line.back() == ' ')) {
+        line.pop_back();
+    }
+    return line;
+}
+
+/**
+ * @brief 将常用波特率映射到termios的speed_t常量
+ * @return 标准波特率返回对应常量，否则返回0（需要走termios2）
+ */
+static speed_t BaudRateToSpeed(int baudRate) {
+    switch (baudRate) {
+        case 1200:    return B1200;
+        case 2400:    return B2400;
+        case 4800:    return B4800;
+        case 9600:    return B9600;
+        case 19200:   return B19200;
+        case 38400:   return B38400;
+        case 57600:   return B57600;
+        case 115200:  return B115200;
+        case 230400:  return B230400;
+#ifdef B460800
+        case 460800:  return B460800;
+#endif
+#ifdef B921600
+        case 921600:  return B921600;
+#endif
+#ifdef B1000000
+        case 1000000: return B1000000;
+#endif
+#ifdef B1500000
+        case 1500000: return B1500000;
+#endif
+#ifdef B2000000
+        case 2000000: return B2000000;
+#endif
+#ifdef B3000000
+        case 3000000: return B3000000;
+#endif
+        default:      return 0;
+    }
+}
+
+SerialPort_Posix::SerialPort_Posix()
+    : fd_(-1)
+    , epollFd_(-1)
+    , wakeFd_(-1)
+    , isOpen_(false)
+    , isReceiving_(false)
+    , receiveCallback_(nullptr)
+{
+}
+
+SerialPort_Posix::~SerialPort_Posix() {
+    Close();
+}
+
+std::vector<std::string> SerialPort_Posix::EnumeratePorts() {
+    auto detailed = EnumeratePortsDetailed();
+    std::vector<std::string> ports;
+    for (const auto& info : detailed) {
+        ports.push_back(info.portName);
+    }
+
+    // 如果没找到任何端口，返回默认列表
+    if (ports.empty()) {
+        ports = {"/dev/ttyUSB0", "/dev/ttyACM0", "/dev/ttyS0"};
+    }
+
+    return ports;
+}
+
+/**
+ * @brief 通过/sys/class/tty枚举串口设备（详细版）
+ *
+ * 额外端口（如socat创建的pty对）可通过环境变量SERIAL_EXTRA_PORTS
+ * 以冒号分隔追加，例如：SERIAL_EXTRA_PORTS=/tmp/ttyV0:/tmp/ttyV1
+ */
+std::vector<SerialPortInfo> SerialPort_Posix::EnumeratePortsDetailed() {
+    std::vector<SerialPortInfo> ports;
+
+    DIR* dir = opendir("/sys/class/tty");
+    if (dir) {
+        while (struct dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name == "." || name == "..") continue;
+
+            // 没有device链接的是虚拟终端（tty0、console等），跳过
+            std::string sysPath = "/sys/class/tty/" + name;
+            char devicePath[PATH_MAX];
+            if (!realpath((sysPath + "/device").c_str(), devicePath)) {
+                continue;
+            }
+
+            SerialPortInfo portInfo;
+            portInfo.portName = "/dev/" + name;
+
+            // 驱动名称
+            char driverPath[PATH_MAX];
+            std::string driver;
+            if (realpath((sysPath + "/device/driver").c_str(), driverPath)) {
+                const char* slash = strrchr(driverPath, '/');
+                driver = slash ? slash + 1 : driverPath;
+            }
+
+            // serial8250会为不存在的ttyS*也注册设备，通过TIOCGSERIAL过滤
+            if (driver == "serial8250") {
+                int fd = open(portInfo.portName.c_str(), O_RDWR | O_NONBLOCK | O_NOCTTY);
+                if (fd < 0) continue;
+                struct serial_struct serinfo;
+                bool present = ioctl(fd, TIOCGSERIAL, &serinfo) == 0 && serinfo.type != PORT_UNKNOWN;
+                close(fd);
+                if (!present) continue;
+            }
+
+            // 向上查找USB设备节点，读取产品信息
+            std::string usbPath = devicePath;
+            for (int level = 0; level < 4 && !usbPath.empty(); level++) {
+                std::string vid = ReadSysfsAttr(usbPath + "/idVendor");
+                if (!vid.empty()) {
+                    std::string pid = ReadSysfsAttr(usbPath + "/idProduct");
+                    portInfo.description = ReadSysfsAttr(usbPath + "/product");
+                    portInfo.manufacturer = ReadSysfsAttr(usbPath + "/manufacturer");
+                    portInfo.hardwareId = "USB\\VID_" + vid + "&PID_" + pid;
+                    break;
+                }
+                usbPath = usbPath.substr(0, usbPath.find_last_of('/'));
+            }
+
+            if (portInfo.description.empty()) {
+                portInfo.description = driver;
+            }
+            portInfo.friendlyName = portInfo.description.empty()
+                ? portInfo.portName
+                : portInfo.description + " (" + portInfo.portName + ")";
+
+            ports.push_back(portInfo);
+        }
+        closedir(dir);
+    }
+
+    std::sort(ports.begin(), ports.end(),
+        [](const SerialPortInfo& a, const SerialPortInfo& b) {
+            return a.portName < b.portName;
+        }
+    );
+
+    // 追加环境变量中指定的额外端口（pty压测等）
+    if (const char* extra = std::getenv("SERIAL_EXTRA_PORTS")) {
+        std::string list = extra;
+        size_t start = 0;
+        while (start <= list.size()) {
+            size_t end = list.find(':', start);
+            if (end == std::string::npos) end = list.size();
+            if (end > start) {
+                SerialPortInfo portInfo;
+                portInfo.portName = list.substr(start, end - start);
+                portInfo.description = "Extra port";
+                ports.push_back(portInfo);
+            }
+            start = end + 1;
+        }
+    }
+
+    return ports;
+}
+
+std::future<std::vector<SerialPortInfo>> SerialPort_Posix::EnumeratePortsAsync() {
+    return std::async(std::launch::async, []() {
+        return EnumeratePortsDetailed();
+    });
+}
+
+bool SerialPort_Posix::Open(const SerialConfig& config) {
+    if (!IsOpen()) {
+        // 释放设备断开后遗留的接收线程和文件描述符
+        Close();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (isOpen_) {
+        lastError_ = "Port already open";
+        return false;
+    }
+
+    // 允许传入"ttyUSB0"这种短名称
+    std::string path = config.portName;
+    if (!path.empty() && path[0] != '/') {
+        path = "/dev/" + path;
+    }
+
+    fd_ = open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd_ < 0) {
+        int error = errno;
+        if (error == ENOENT) {
+            lastError_ = "Port not found: " + config.portName;
+        } else if (error == EACCES) {
+            lastError_ = "Port access denied: " + config.portName;
+        } else if (error == EBUSY) {
+            lastError_ = "Port busy: " + config.portName;
+        } else {
+            lastError_ = "Failed to open port, error: " + std::string(strerror(error));
+        }
+        return false;
+    }
+
+    if (!ConfigurePort(config)) {
+        close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    tcflush(fd_, TCIOFLUSH);
+
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd_ < 0 || wakeFd_ < 0) {
+        lastError_ = "Create epoll failed: " + std::string(strerror(errno));
+        if (epollFd_ >= 0) close(epollFd_);
+        if (wakeFd_ >= 0) close(wakeFd_);
+        close(fd_);
+        fd_ = epollFd_ = wakeFd_ = -1;
+        return false;
+    }
+
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd_;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd_, &ev);
+    ev.data.fd = wakeFd_;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &ev);
+
+    rxStats_.Reset();
+    currentConfig_ = config;
+    isOpen_ = true;
+    isReceiving_ = true;
+    // 回调在加锁时复制给接收线程，之后接收线程不再读取receiveCallback_
+    receiveThread_ = std::thread(&SerialPort_Posix::ReceiveThread, this, receiveCallback_);
+    return true;
+}
+
+void SerialPort_Posix::Close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // 设备断开后isOpen_已为false，但接收线程和文件描述符仍需释放
+        if (!isOpen_ && !receiveThread_.joinable() && fd_ < 0) {
+            return;
+        }
+        isOpen_ = false;
+        isReceiving_ = false;
+
+        // 唤醒epoll_wait，立即退出接收线程
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd_, &one, sizeof(one));
+        (void)ignored;
+    }
+    if (receiveThread_.joinable()) {
+        receiveThread_.join();
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+    if (epollFd_ >= 0) {
+        close(epollFd_);
+        epollFd_ = -1;
+    }
+    if (wakeFd_ >= 0) {
+        close(wakeFd_);
+        wakeFd_ = -1;
+    }
+}
+
+bool SerialPort_Posix::IsOpen() const {
+    return isOpen_;
+}
+
+int SerialPort_Posix::Write(const unsigned char* data, int length) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!isOpen_ || fd_ < 0) {
+        lastError_ = "Port not open";
+        return -1;
+    }
+
+    // 非阻塞fd：写满时等待POLLOUT，总超时1秒（与Windows实现一致）
+    int written = 0;
+    while (written < length) {
+        ssize_t n = write(fd_, data + written, length - written);
+        if (n > 0) {
+            written += static_cast<int>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            lastError_ = "Write failed: " + std::string(strerror(errno));
+            return -1;
+        }
+        struct pollfd pfd = {fd_, POLLOUT, 0};
+        if (poll(&pfd, 1, 1000) <= 0) {
+            lastError_ = "Write timeout";
+            return written > 0 ? written : -1;
+        }
+    }
+    return written;
+}
+
+void SerialPort_Posix::SetReceiveCallback(ReceiveCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (isOpen_) {
+        lastError_ = "Receive callback must be set before Open()";
+        return;
+    }
+    receiveCallback_ = callback;
+}
+
+std::string SerialPort_Posix::GetLastError() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lastError_;
+}
+
+void SerialPort_Posix::ClearReceiveBuffer() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (isOpen_ && fd_ >= 0) {
+        tcflush(fd_, TCIFLUSH);
+    }
+}
+
+void SerialPort_Posix::ClearTransmitBuffer() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (isOpen_ && fd_ >= 0) {
+        tcflush(fd_, TCOFLUSH);
+    }
+}
+
+bool SerialPort_Posix::ConfigurePort(const SerialConfig& config) {
+    struct termios tty;
+    if (tcgetattr(fd_, &tty) != 0) {
+        lastError_ = "Get termios failed: " + std::string(strerror(errno));
+        return false;
+    }
+
+    // 原始模式：关闭回显、规范模式、信号字符和所有输入输出转换
+    cfmakeraw(&tty);
+
+    tty.c_cflag &= ~CSIZE;
+    switch (config.dataBits) {
+        case 5: tty.c_cflag |= CS5; break;
+        case 6: tty.c_cflag |= CS6; break;
+        case 7: tty.c_cflag |= CS7; break;
+        default: tty.c_cflag |= CS8; break;
+    }
+    switch (config.stopBits) {
+        case 2: tty.c_cflag |= CSTOPB; break;
+        default: tty.c_cflag &= ~CSTOPB; break;
+    }
+    switch (config.parity) {
+        case 1: tty.c_cflag |= (PARENB | PARODD); break;
+        case 2: tty.c_cflag |= PARENB; tty.c_cflag &= ~PARODD; break;
+        default: tty.c_cflag &= ~(PARENB | PARODD); break;
+    }
+    tty.c_cflag |= (CLOCAL | CREAD);
+    tty.c_cflag &= ~CRTSCTS;
+    tty.c_iflag &= ~(IXON | IXOFF | IXANY);
+
+    // 非阻塞读取由O_NONBLOCK + epoll负责
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 0;
+
+    speed_t speed = BaudRateToSpeed(config.baudRate);
+    if (speed != 0) {
+        cfsetispeed(&tty, speed);
+        cfsetospeed(&tty, speed);
+    }
+
+    if (tcsetattr(fd_, TCSANOW, &tty) != 0) {
+        lastError_ = "Set termios failed: " + std::string(strerror(errno));
+        return false;
+    }
+
+    if (speed == 0 && !ConfigureBaudRate(config.baudRate)) {
+        return false;
+    }
+    return true;
+}
+
+bool SerialPort_Posix::ConfigureBaudRate(int baudRate) {
+#if defined(__linux__) && defined(TCGETS2)
+    struct termios2 tio;
+    if (ioctl(fd_, TCGETS2, &tio) != 0) {
+        lastError_ = "Get termios2 failed: " + std::string(strerror(errno));
+        return false;
+    }
+    tio.c_cflag &= ~CBAUD;
+    tio.c_cflag |= BOTHER;
+    tio.c_ispeed = static_cast<speed_t>(baudRate);
+    tio.c_ospeed = static_cast<speed_t>(baudRate);
+    if (ioctl(fd_, TCSETS2, &tio) != 0) {
+        lastError_ = "Unsupported baud rate: " + std::to_string(baudRate);
+        return false;
+    }
+    return true;
+#else
+    lastError_ = "Unsupported baud rate: " + std::to_string(baudRate);
+    return false;
+#endif
+}
+
+void SerialPort_Posix::ReceiveThread(ReceiveCallback callback) {
+    const size_t chunkSize = currentConfig_.readChunkSize > 0 ? currentConfig_.readChunkSize : 4096;
+    std::vector<unsigned char> buffer(chunkSize);
+    struct epoll_event events[2];
+
+    while (isReceiving_) {
+        int n = epoll_wait(epollFd_, events, 2, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        for (int e = 0; e < n; e++) {
+            if (events[e].data.fd == wakeFd_) {
+                return;
+            }
+
+            // 一次唤醒读空内核缓冲区，直到EAGAIN
+            bool hangup = (events[e].events & (EPOLLHUP | EPOLLERR)) != 0;
+            size_t wakeupBytes = 0;
+            while (true) {
+                ssize_t bytesRead = read(fd_, buffer.data(), chunkSize);
+                if (bytesRead > 0) {
+                    wakeupBytes += bytesRead;
+                    if (callback) {
+                        callback(buffer.data(), static_cast<int>(bytesRead));
+                    }
+                    continue;
+                }
+                if (bytesRead < 0 && errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            if (wakeupBytes > 0) {
+                rxStats_.Record(wakeupBytes);
+            }
+
+            // 设备拔出或pty主端关闭：标记串口已关闭并停止接收（避免EPOLLHUP忙等），
+            // 之后IsOpen()返回false、Write()不再写入失效的fd，UI据此断开连接
+            if (hangup) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                lastError_ = "Device disconnected";
+                isOpen_ = false;
+                isReceiving_ = false;
+                return;
+            }
+        }
+    }
+}
+
+#endif // _WIN32
@@ -0,0 +1,100 @@
+/**
+ * @file SerialPort_Posix.h
+ * @brief POSIX串口通信管理器
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 使用termios + epoll实现串口通信功能：
+ * - 非阻塞读取（O_NONBLOCK），epoll等待可读事件
+ * - eventfd唤醒接收线程，Close()无需等待超时
+ * - Linux下通过termios2/BOTHER支持任意自定义波特率
+ * - 可直接打开pty从设备（/dev/pts/N），用于无硬件压测
+ */
+
+#ifndef SERIALPORT_POSIX_H
+#define SERIALPORT_POSIX_H
+
+#ifndef _WIN32
+
+#include "SerialPort.h"
+#include <string>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <future>
+
+/**
+ * @brief POSIX串口管理器
+ */
+class SerialPort_Posix : public SerialPort {
+public:
+    SerialPort_Posix();
+    ~SerialPort_Posix() override;
+
+    using SerialPort::Write;
+
+    /**
+     * @brief 枚举所有可用串口（简单版，向后兼容）
+     * @return 设备路径列表
+     */
+    static std::vector<std::string> EnumeratePorts();
+
+    /**
+     * @brief 枚举所有可用串口（详细版，读取sysfs设备信息）
+     * @return 串口详细信息列表
+     */
+    static std::vector<SerialPortInfo> EnumeratePortsDetailed();
+
+    /**
+     * @brief 异步枚举所有可用串口
+     */
+    static std::future<std::vector<SerialPortInfo>> EnumeratePortsAsync();
+
+    bool Open(const SerialConfig& config) override;
+    void Close() override;
+    bool IsOpen() const override;
+    int Write(const unsigned char* data, int length) override;
+    void SetReceiveCallback(ReceiveCallback callback) override;
+    std::string GetLastError() const override;
+    void ClearReceiveBuffer() override;
+    void ClearTransmitBuffer() override;
+
+private:
+    /**
+     * @brief 配置串口参数（termios）
+     * @param config 串口配置参数
+     * @return 成功返回true，失败返回false
+     */
+    bool ConfigurePort(const SerialConfig& config);
+
+    /**
+     * @brief 设置波特率（标准波特率走cfsetspeed，其余走termios2）
+     */
+    bool ConfigureBaudRate(int baudRate);
+
+    /**
+     * @brief 接收线程函数
+     * @param callback Open()时复制的接收回调
+     *
+     * 设备拔出（EPOLLHUP/EPOLLERR）时将串口标记为关闭并退出，
+     * 资源由之后的Close()或Open()释放。
+     */
+    void ReceiveThread(ReceiveCallback callback);
+
+    int fd_;                                                    // 串口文件描述符
+    int epollFd_;                                               // epoll实例
+    int wakeFd_;                                                // eventfd，用于唤醒接收线程
+    std::atomic<bool> isOpen_;                                  // 串口是否打开
+    std::atomic<bool> isReceiving_;                             // 是否正在接收数据
+    std::thread receiveThread_;                                 // 接收线程
+    ReceiveCallback receiveCallback_;                           // 接收回调函数
+    mutable std::mutex mutex_;                                  // 互斥锁
+    std::string lastError_;                                     // 最后一次错误信息
+    SerialConfig currentConfig_;                                // 当前配置
+};
+
+#endif // _WIN32
+
+#endif // SERIALPORT_POSIX_H
@@ -1,4 +1,7 @@
 #include "SerialPort_Win.h"
+
+#ifdef _WIN32
+
 #include <setupapi.h>
 #include <devguid.h>
 #include <regstr.h>
@@ -33,6 +36,7 @@ static std::string WideToUtf8(const wchar_t* wstr) {
 
 SerialPort_Win::SerialPort_Win()
     : hComm_(INVALID_HANDLE_VALUE)
+    , hStopEvent_(NULL)
     , isOpen_(false)
     , isReceiving_(false)
     , receiveCallback_(nullptr)
@@ -165,6 +169,10 @@ std::future<std::vector<SerialPortInfo>> SerialPort_Win::EnumeratePortsAsync() {
 }
 
 bool SerialPort_Win::Open(const SerialConfig& config) {
+    if (!IsOpen()) {
+        // 释放设备断开后遗留的接收线程和句柄
+        Close();
+    }
     std::lock_guard<std::mutex> lock(mutex_);
     if (isOpen_) {
         lastError_ = "Port already open";
@@ -196,23 +204,37 @@ bool SerialPort_Win::Open(const SerialConfig& config) {
         hComm_ = INVALID_HANDLE_VALUE;
         return false;
     }
-    SetupComm(hComm_, 4096, 4096);
+    // 驱动队列大小可配置（高波特率下4096字节很快溢出）
+    SetupComm(hComm_, config.rxQueueSize, config.txQueueSize);
     PurgeComm(hComm_, PURGE_RXCLEAR | PURGE_TXCLEAR);
+    hStopEvent_ = CreateEvent(NULL, TRUE, FALSE, NULL);
+    if (hStopEvent_ == NULL) {
+        lastError_ = "Create event failed";
+        CloseHandle(hComm_);
+        hComm_ = INVALID_HANDLE_VALUE;
+        return false;
+    }
+    rxStats_.Reset();
     currentConfig_ = config;
     isOpen_ = true;
     isReceiving_ = true;
-    receiveThread_ = std::thread(&SerialPort_Win::ReceiveThread, this);
+    // 回调在加锁时复制给接收线程，之后接收线程不再读取receiveCallback_
+    receiveThread_ = std::thread(&SerialPort_Win::ReceiveThread, this, receiveCallback_);
     return true;
 }
 
 void SerialPort_Win::Close() {
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        if (!isOpen_) {
+        // 设备断开后isOpen_已为false，但接收线程和句柄仍需释放
+        if (!isOpen_ && !receiveThread_.joinable() && hComm_ == INVALID_HANDLE_VALUE) {
             return;
         }
         isOpen_ = false;
         isReceiving_ = false;
+        if (hStopEvent_ != NULL) {
+            SetEvent(hStopEvent_);
+        }
     }
     if (receiveThread_.joinable()) {
         receiveThread_.join();
@@ -221,6 +243,10 @@ void SerialPort_Win::Close() {
         CloseHandle(hComm_);
         hComm_ = INVALID_HANDLE_VALUE;
     }
+    if (hStopEvent_ != NULL) {
+        CloseHandle(hStopEvent_);
+        hStopEvent_ = NULL;
+    }
 }
 
 bool SerialPort_Win::IsOpen() const {
@@ -260,12 +286,12 @@ int SerialPort_Win::Write(const unsigned char* data, int length) {
     return static_cast<int>(bytesWritten);
 }
 
-int SerialPort_Win::Write(const std::string& str) {
-    return Write(reinterpret_cast<const unsigned char*>(str.c_str()), str.length());
-}
-
-void SerialPort_Win::SetReceiveCallback(std::function<void(const unsigned char*, int)> callback) {
+void SerialPort_Win::SetReceiveCallback(ReceiveCallback callback) {
     std::lock_guard<std::mutex> lock(mutex_);
+    if (isOpen_) {
+        lastError_ = "Receive callback must be set before Open()";
+        return;
+    }
     receiveCallback_ = callback;
 }
 
@@ -325,50 +351,105 @@ bool SerialPort_Win::ConfigurePort(const SerialConfig& config) {
         lastError_ = "Set comm state failed";
         return false;
     }
+    // 读超时：MAXDWORD + 0 + 0 表示ReadFile立即返回已到达的数据（由WaitCommEvent负责等待）
     COMMTIMEOUTS timeouts = {0};
-    timeouts.ReadIntervalTimeout = 50;
-    timeouts.ReadTotalTimeoutMultiplier = 10;
-    timeouts.ReadTotalTimeoutConstant = 50;
+    timeouts.ReadIntervalTimeout = MAXDWORD;
+    timeouts.ReadTotalTimeoutMultiplier = 0;
+    timeouts.ReadTotalTimeoutConstant = 0;
     timeouts.WriteTotalTimeoutMultiplier = 10;
     timeouts.WriteTotalTimeoutConstant = 50;
     if (!SetCommTimeouts(hComm_, &timeouts)) {
         lastError_ = "Set timeouts failed";
         return false;
     }
+    if (!SetCommMask(hComm_, EV_RXCHAR)) {
+        lastError_ = "Set comm mask failed";
+        return false;
+    }
     return true;
 }
 
-void SerialPort_Win::ReceiveThread() {
-    const int BUFFER_SIZE = 4096;
-    unsigned char buffer[BUFFER_SIZE];
+void SerialPort_Win::ReceiveThread(ReceiveCallback callback) {
+    const DWORD chunkSize = static_cast<DWORD>(currentConfig_.readChunkSize > 0 ? currentConfig_.readChunkSize : 4096);
+    std::vector<unsigned char> buffer(chunkSize);
+
+    OVERLAPPED osEvent = {0};
     OVERLAPPED osReader = {0};
+    osEvent.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
     osReader.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
-    if (osReader.hEvent == NULL) {
+    if (osEvent.hEvent == NULL || osReader.hEvent == NULL) {
+        if (osEvent.hEvent) CloseHandle(osEvent.hEvent);
+        if (osReader.hEvent) CloseHandle(osReader.hEvent);
         return;
     }
+
+    HANDLE waitHandles[2] = {osEvent.hEvent, hStopEvent_};
+
     while (isReceiving_) {
-        DWORD bytesRead = 0;
-        BOOL readResult = ReadFile(hComm_, buffer, BUFFER_SIZE, &bytesRead, &osReader);
-        if (readResult) {
-            if (bytesRead > 0 && receiveCallback_) {
-                receiveCallback_(buffer, bytesRead);
+        // 1. 等待EV_RXCHAR事件（或停止事件）
+        DWORD eventMask = 0;
+        ResetEvent(osEvent.hEvent);
+        if (!WaitCommEvent(hComm_, &eventMask, &osEvent)) {
+            if (::GetLastError() != ERROR_IO_PENDING) {
+                break;
             }
-        } else {
-            DWORD error = ::GetLastError();
-            if (error == ERROR_IO_PENDING) {
-                DWORD waitResult = WaitForSingleObject(osReader.hEvent, 100);
-                if (waitResult == WAIT_OBJECT_0) {
-                    if (GetOverlappedResult(hComm_, &osReader, &bytesRead, FALSE)) {
-                        if (bytesRead > 0 && receiveCallback_) {
-                            receiveCallback_(buffer, bytesRead);
-                        }
-                    }
+            DWORD waitResult = WaitForMultipleObjects(2, waitHandles, FALSE, INFINITE);
+            if (waitResult != WAIT_OBJECT_0) {
+                // 停止事件或等待失败：取消挂起的WaitCommEvent，等待其完成后退出
+                DWORD unused = 0;
+                CancelIo(hComm_);
+                GetOverlappedResult(hComm_, &osEvent, &unused, TRUE);
+                break;
+            }
+            DWORD unused = 0;
+            if (!GetOverlappedResult(hComm_, &osEvent, &unused, FALSE)) {
+                break;
+            }
+        }
+
+        // 2. 读空驱动接收队列（唤醒一次，读取多次）
+        size_t wakeupBytes = 0;
+        while (isReceiving_) {
+            DWORD errors = 0;
+            COMSTAT comStat = {0};
+            if (!ClearCommError(hComm_, &errors, &comStat) || comStat.cbInQue == 0) {
+                break;
+            }
+
+            DWORD toRead = comStat.cbInQue < chunkSize ? comStat.cbInQue : chunkSize;
+            DWORD bytesRead = 0;
+            ResetEvent(osReader.hEvent);
+            if (!ReadFile(hComm_, buffer.data(), toRead, &bytesRead, &osReader)) {
+                if (::GetLastError() != ERROR_IO_PENDING ||
+                    !GetOverlappedResult(hComm_, &osReader, &bytesRead, TRUE)) {
+                    break;
                 }
-            } else {
+            }
+            if (bytesRead == 0) {
                 break;
             }
+
+            wakeupBytes += bytesRead;
+            if (callback) {
+                callback(buffer.data(), static_cast<int>(bytesRead));
+            }
+        }
+
+        if (wakeupBytes > 0) {
+            rxStats_.Record(wakeupBytes);
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
+
+    CloseHandle(osEvent.hEvent);
     CloseHandle(osReader.hEvent);
+
+    // 不是Close()要求退出（设备拔出等I/O错误）：标记串口已关闭，UI据此断开连接
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (isReceiving_) {
+        lastError_ = "Device disconnected";
+        isOpen_ = false;
+        isReceiving_ = false;
+    }
 }
+
+#endif // _WIN32
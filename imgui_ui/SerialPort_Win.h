@@ -10,6 +10,9 @@
 #ifndef SERIALPORT_WIN_H
 #define SERIALPORT_WIN_H
 
+#ifdef _WIN32
+
+#include "SerialPort.h"
 #include <string>
 #include <vector>
 #include <functional>
@@ -19,46 +22,15 @@
 #include <future>
 #include <windows.h>
 
-/**
- * @brief 串口配置参数
- */
-struct SerialConfig {
-    std::string portName = "COM1";       // 串口名称
-    int baudRate = 115200;                // 波特率
-    int dataBits = 8;                     // 数据位 (5, 6, 7, 8)
-    int stopBits = 1;                     // 停止位 (1=ONESTOPBIT, 2=TWOSTOPBITS)
-    int parity = 0;                       // 校验位 (0=NOPARITY, 1=ODDPARITY, 2=EVENPARITY)
-};
-
-/**
- * @brief 串口设备详细信息
- */
-struct SerialPortInfo {
-    std::string portName;        // 端口名称 "COM3"
-    std::string friendlyName;    // 友好名称 "USB Serial Port (COM3)"
-    std::string description;     // 设备描述 "CH340 USB-SERIAL CHIP"
-    std::string manufacturer;    // 制造商 "wch.cn"
-    std::string hardwareId;      // 硬件ID "USB\VID_1A86&PID_7523"
-
-    /**
-     * @brief 获取显示名称（优先使用友好名称）
-     * @return 用于UI显示的名称
-     */
-    std::string GetDisplayName() const {
-        if (!friendlyName.empty()) {
-            return friendlyName;
-        }
-        return portName;
-    }
-};
-
 /**
  * @brief Windows串口管理器
  */
-class SerialPort_Win {
+class SerialPort_Win : public SerialPort {
 public:
     SerialPort_Win();
-    ~SerialPort_Win();
+    ~SerialPort_Win() override;
+
+    using SerialPort::Write;
 
     /**
      * @brief 枚举所有可用串口（简单版，向后兼容）
@@ -83,18 +55,18 @@ public:
      * @param config 串口配置参数
      * @return 成功返回true，失败返回false
      */
-    bool Open(const SerialConfig& config);
+    bool Open(const SerialConfig& config) override;
 
     /**
      * @brief 关闭串口
      */
-    void Close();
+    void Close() override;
 
     /**
      * @brief 判断串口是否已打开
      * @return 已打开返回true，否则返回false
      */
-    bool IsOpen() const;
+    bool IsOpen() const override;
 
     /**
      * @brief 发送数据
@@ -102,36 +74,29 @@ public:
      * @param length 数据长度
      * @return 实际发送的字节数，失败返回-1
      */
-    int Write(const unsigned char* data, int length);
-
-    /**
-     * @brief 发送字符串
-     * @param str 要发送的字符串
-     * @return 实际发送的字节数，失败返回-1
-     */
-    int Write(const std::string& str);
+    int Write(const unsigned char* data, int length) override;
 
     /**
      * @brief 设置数据接收回调函数
      * @param callback 回调函数，参数为接收到的数据和长度
      */
-    void SetReceiveCallback(std::function<void(const unsigned char*, int)> callback);
+    void SetReceiveCallback(ReceiveCallback callback) override;
 
     /**
      * @brief 获取最后一次错误信息
      * @return 错误信息字符串
      */
-    std::string GetLastError() const;
+    std::string GetLastError() const override;
 
     /**
      * @brief 清空接收缓冲区
      */
-    void ClearReceiveBuffer();
+    void ClearReceiveBuffer() override;
 
     /**
      * @brief 清空发送缓冲区
      */
-    void ClearTransmitBuffer();
+    void ClearTransmitBuffer() override;
 
 private:
     /**
@@ -142,18 +107,25 @@ private:
     bool ConfigurePort(const SerialConfig& config);
 
     /**
-     * @brief 接收线程函数
+     * @brief 接收线程函数（事件驱动）
+     *
+     * WaitCommEvent(EV_RXCHAR)等待数据到达，唤醒后按cbInQue
+     * 循环读空驱动队列再进入下一次等待，全程不sleep。
+     * @param callback Open()时复制的接收回调
      */
-    void ReceiveThread();
+    void ReceiveThread(ReceiveCallback callback);
 
     HANDLE hComm_;                                              // 串口句柄
+    HANDLE hStopEvent_;                                         // 停止事件（Close时唤醒接收线程）
     std::atomic<bool> isOpen_;                                  // 串口是否打开
     std::atomic<bool> isReceiving_;                             // 是否正在接收数据
     std::thread receiveThread_;                                 // 接收线程
-    std::function<void(const unsigned char*, int)> receiveCallback_;  // 接收回调函数
+    ReceiveCallback receiveCallback_;                           // 接收回调函数
     mutable std::mutex mutex_;                                  // 互斥锁
     std::string lastError_;                                     // 最后一次错误信息
     SerialConfig currentConfig_;                                // 当前配置
 };
 
+#endif // _WIN32
+
 #endif // SERIALPORT_WIN_H
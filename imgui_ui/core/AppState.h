@@ -15,10 +15,15 @@
 #include <queue>
 #include <chrono>
 #include <future>
+#include <atomic>
 #include <imgui.h>
 #include "ThreadPool.h"
+#include "IngestThread.h"
+#include "ReceiveGate.h"
+#include "OrderedCommitter.h"
+#include "ChunkSlots.h"
 #include "../ui/VisualizationUI.h"
-#include "../SerialPort_Win.h"
+#include "../SerialPort.h"
 
 // 视图类型枚举
 enum class ViewType {
@@ -33,6 +38,12 @@ enum class EncodingType {
     ASCII,     // 纯ASCII
 };
 
+// 接收数据块的显示格式（随数据块分发到格式化线程）
+struct RxFormat {
+    bool hex = false;                                  // 十六进制显示
+    EncodingType encoding = EncodingType::UTF8;        // 文本编码
+};
+
 // 行尾符类型枚举
 enum class LineEnding {
     NONE,      // 无后缀
@@ -82,10 +93,13 @@ struct AppState {
     int selected_databits_index = 3;  // 默认8位
     int selected_stopbits_index = 0;  // 默认1位
     int selected_parity_index = 0;    // 默认无校验
+    int rx_queue_size = 65536;        // 驱动接收队列大小（字节）
+    int read_chunk_size = 16384;      // 单次读取块大小（字节）
     bool is_connected = false;
+    std::string connection_error;     // 最近一次打开失败或设备断开的原因
 
-    // 串口管理器
-    SerialPort_Win serial_port;
+    // 串口管理器（平台实现由SerialPort::Create()决定）
+    std::unique_ptr<SerialPort> serial_port = SerialPort::Create();
     std::mutex receive_mutex;  // 接收数据互斥锁
 
     // 数据显示
@@ -120,7 +134,7 @@ struct AppState {
     int send_history_index = -1;                       // 当前选择的历史索引
 
     // 统计信息
-    int bytes_received = 0;
+    std::atomic<int> bytes_received{0};  // 有序阶段无锁累加
     int bytes_sent = 0;
 
     // 日志功能
@@ -141,15 +155,25 @@ struct AppState {
         bool enable_multithreading = true;  // 默认启用多线程
     };
     ThreadConfig thread_config;
-    std::unique_ptr<ThreadPool> thread_pool;
 
-    // 数据处理队列
-    struct DataPacket {
-        std::vector<unsigned char> data;
-        std::chrono::steady_clock::time_point timestamp;
-    };
-    std::queue<DataPacket> data_queue;
-    std::mutex queue_mutex;
+    // 接收流水线：
+    //   接收回调（分配数据块在接收字节流中的位置）
+    //     -> 消费线程（有序：协议解析、分配数据块序号）
+    //     -> rx_chunk_slots（预分配槽位，数据块拷贝循环复用）
+    //     -> 线程池（并行：显示格式化/编码转换）
+    //     -> rx_log_committer（按序号提交：数据日志、日志文件）
+    std::atomic<uint64_t> rx_stream_offset{0};             // 接收字节流的当前位置（不随连接重置）
+    std::atomic<uint64_t> rx_chunk_sequence{0};            // 下一个数据块序号
+    ChunkSlots<RxFormat> rx_chunk_slots;                   // 分发给格式化线程的数据块槽位
+    OrderedCommitter<std::string> rx_log_committer;        // 格式化结果按序提交
+    std::unique_ptr<ThreadPool> thread_pool;               // 格式化工作线程
+
+    // 接收数据消费线程（串口接收线程 -> 无锁环形缓冲区 -> 消费线程）
+    IngestThread ingest_thread{1 << 20};
+
+    // 接收回调闸门：停止消费线程、切换单/多线程模式前关闭，
+    // 保证切换期间没有回调在执行（enable_multithreading只在闸门关闭时修改）
+    ReceiveGate rx_gate;
 
     // UI状态
     bool show_settings_dialog = false;  // 显示设置对话框
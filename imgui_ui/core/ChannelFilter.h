@@ -0,0 +1,531 @@
+/**
+ * @file ChannelFilter.h
+ * @brief 通道滤波 - 双二阶节级联（IIR）与FIR滤波器，按块处理
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 滤波器类型：
+ * - 低通/高通：巴特沃斯，阶数2~8，拆为阶数/2个双二阶节级联（各节Q值由极点角度确定）
+ * - 陷波：单个双二阶节，中心频率和Q值可调（去除工频等窄带干扰）
+ * - 滑动平均：N个抽头的等权FIR
+ * - FIR低通：加Blackman窗的sinc，直流增益为1，线性相位
+ *
+ * 块处理（每次最多BLOCK_SIZE个样本，数据为连续的一列float）：
+ * - IIR按节处理：每一节对整块做一遍转置直接II型递推，系数和状态留在寄存器中，
+ *   递推本身无法跨样本并行，但没有逐样本的分派和跨节的数据依赖
+ * - FIR把历史样本和本块拼接在一个连续缓冲区中，外层循环按抽头、内层循环按样本：
+ *   out[i] += h[k] · x[i - k] 是无归约的乘加，编译器可直接向量化
+ *
+ * 缺失值（NaN）：输入中的NaN在滤波器内部保持上一个有效值，对应的输出仍为NaN，
+ * 不会污染滤波器状态。第一个有效样本到达时把状态预置为该值的稳态，避免启动瞬态。
+ *
+ * 截止频率以Hz表示，需要采样率才能设计（滑动平均除外）；
+ * 采样率未知时滤波器原样输出输入。不加锁，由调用者保护。
+ */
+
+#ifndef CHANNEL_FILTER_H
+#define CHANNEL_FILTER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * @brief 滤波器类型
+ */
+enum class FilterType {
+    LOWPASS,            // 巴特沃斯低通
+    HIGHPASS,           // 巴特沃斯高通
+    NOTCH,              // 陷波
+    MOVING_AVERAGE,     // 滑动平均
+    FIR_LOWPASS         // FIR低通（加窗sinc）
+};
+
+/**
+ * @brief 获取滤波器类型名称
+ */
+inline const char* GetFilterTypeName(FilterType type) {
+    switch (type) {
+        case FilterType::LOWPASS:        return "低通";
+        case FilterType::HIGHPASS:       return "高通";
+        case FilterType::NOTCH:          return "陷波";
+        case FilterType::MOVING_AVERAGE: return "滑动平均";
+        case FilterType::FIR_LOWPASS:    return "FIR低通";
+        default: return "Unknown";
+    }
+}
+
+/**
+ * @brief 滤波器配置
+ */
+struct FilterConfig {
+    size_t source_channel = 0;                  // 输入通道索引
+    FilterType type = FilterType::LOWPASS;      // 类型
+    double frequency = 10.0;                    // 截止/中心频率（Hz）
+    int order = 2;                              // 巴特沃斯阶数（2/4/6/8）
+    double q = 10.0;                            // 陷波Q值（中心频率/带宽）
+    int taps = 16;                              // FIR抽头数
+
+    static constexpr int MAX_ORDER = 8;
+    static constexpr int MAX_TAPS = 512;
+
+    /**
+     * @brief 是否需要采样率才能设计
+     */
+    bool NeedsSampleRate() const {
+        return type != FilterType::MOVING_AVERAGE;
+    }
+
+    /**
+     * @brief 参数限制在有效范围内
+     */
+    void Clamp() {
+        if (static_cast<int>(type) < 0 || static_cast<int>(type) > static_cast<int>(FilterType::FIR_LOWPASS)) {
+            type = FilterType::LOWPASS;
+        }
+        order = std::min(std::max(order / 2 * 2, 2), MAX_ORDER);
+        taps = std::min(std::max(taps, 1), MAX_TAPS);
+        frequency = std::max(frequency, 1e-6);
+        q = std::max(q, 0.1);
+    }
+
+    bool operator==(const FilterConfig& other) const {
+        return source_channel == other.source_channel && type == other.type &&
+               frequency == other.frequency && order == other.order &&
+               q == other.q && taps == other.taps;
+    }
+    bool operator!=(const FilterConfig& other) const {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @brief 单通道滤波器（双二阶节级联或FIR）
+ */
+class ChannelFilter {
+public:
+    static constexpr size_t BLOCK_SIZE = 1024;      // 每次处理的最大样本数
+    static constexpr double PI = 3.14159265358979323846;
+
+    explicit ChannelFilter(const FilterConfig& config = FilterConfig())
+        : config_(config)
+    {
+        config_.Clamp();
+    }
+
+    const FilterConfig& GetConfig() const {
+        return config_;
+    }
+
+    /**
+     * @brief 按采样率设计系数（保留滤波状态，参数变化时只有短暂过渡）
+     * @param sample_rate 采样率（Hz），不大于0时需要采样率的滤波器变为直通
+     */
+    void Design(double sample_rate) {
+        std::vector<Section> previous;
+        previous.swap(sections_);
+        taps_.clear();
+        designed_ = false;
+
+        if (config_.type == FilterType::MOVING_AVERAGE) {
+            taps_.assign(config_.taps, 1.0f / static_cast<float>(config_.taps));
+        } else if (sample_rate > 0.0) {
+            // 频率限制在奈奎斯特频率以内
+            double frequency = std::min(config_.frequency, 0.45 * sample_rate);
+            double w0 = 2.0 * PI * frequency / sample_rate;
+            switch (config_.type) {
+                case FilterType::LOWPASS:
+                case FilterType::HIGHPASS: {
+                    // N阶巴特沃斯：第k节的Q = 1 / (2·cos(π(2k+1)/(2N)))
+                    int count = config_.order / 2;
+                    for (int k = 0; k < count; k++) {
+                        double angle = PI * (2 * k + 1) / (2.0 * config_.order);
+                        sections_.push_back(MakeSection(config_.type, w0, 1.0 / (2.0 * std::cos(angle))));
+                    }
+                    break;
+                }
+                case FilterType::NOTCH:
+                    sections_.push_back(MakeSection(config_.type, w0, config_.q));
+                    break;
+                case FilterType::FIR_LOWPASS:
+                    DesignFirLowpass(frequency / sample_rate);
+                    break;
+                default:
+                    break;
+            }
+        }
+        designed_ = !sections_.empty() || !taps_.empty();
+
+        if (sections_.size() == previous.size()) {
+            // 只是采样率变化：保留各节状态，系数小幅变化只带来很小的过渡；
+            // 按保持值重新预置会丢掉滤波器的相位延迟，输出出现跳变
+            for (size_t i = 0; i < sections_.size(); i++) {
+                sections_[i].z1 = previous[i].z1;
+                sections_[i].z2 = previous[i].z2;
+            }
+        } else if (primed_) {
+            // 结构变化（如首次得到采样率）：没有可用的状态，按保持值预置稳态
+            Prime(held_);
+        }
+        if (!taps_.empty() && history_.size() != taps_.size() - 1) {
+            history_.assign(taps_.size() - 1, held_);
+        }
+    }
+
+    /**
+     * @brief 是否已设计（否则为直通）
+     */
+    bool IsDesigned() const {
+        return designed_;
+    }
+
+    /**
+     * @brief 清除滤波状态
+     */
+    void Reset() {
+        primed_ = false;
+        held_ = 0.0f;
+        for (Section& section : sections_) {
+            section.z1 = section.z2 = 0.0;
+        }
+        std::fill(history_.begin(), history_.end(), 0.0f);
+    }
+
+    /**
+     * @brief 滤波一块数据
+     * @param input 输入（可含NaN）
+     * @param output 输出（可与input相同）
+     * @param length 样本数（任意长度，内部按BLOCK_SIZE分块）
+     */
+    void Process(const float* input, float* output, size_t length) {
+        while (length > 0) {
+            size_t n = std::min(length, BLOCK_SIZE);
+            ProcessBlock(input, output, n);
+            input += n;
+            output += n;
+            length -= n;
+        }
+    }
+
+private:
+    /**
+     * @brief 双二阶节（系数已按a0归一化，状态用double）
+     */
+    struct Section {
+        double b0, b1, b2, a1, a2;
+        double z1 = 0.0, z2 = 0.0;
+    };
+
+    /**
+     * @brief 按RBJ公式（双线性变换、频率预畸变）生成一节
+     */
+    static Section MakeSection(FilterType type, double w0, double q) {
+        double cosw = std::cos(w0);
+        double alpha = std::sin(w0) / (2.0 * q);
+        double b0, b1, b2;
+        switch (type) {
+            case FilterType::HIGHPASS:
+                b0 = (1.0 + cosw) * 0.5;
+                b1 = -(1.0 + cosw);
+                b2 = b0;
+                break;
+            case FilterType::NOTCH:
+                b0 = 1.0;
+                b1 = -2.0 * cosw;
+                b2 = 1.0;
+                break;
+            default:    // LOWPASS
+                b0 = (1.0 - cosw) * 0.5;
+                b1 = 1.0 - cosw;
+                b2 = b0;
+                break;
+        }
+        double a0 = 1.0 + alpha;
+        Section section;
+        section.b0 = b0 / a0;
+        section.b1 = b1 / a0;
+        section.b2 = b2 / a0;
+        section.a1 = -2.0 * cosw / a0;
+        section.a2 = (1.0 - alpha) / a0;
+        return section;
+    }
+
+    /**
+     * @brief FIR低通：sinc乘Blackman窗，归一化为直流增益1
+     * @param cutoff 归一化截止频率（截止频率/采样率）
+     */
+    void DesignFirLowpass(double cutoff) {
+        const int count = config_.taps;
+        taps_.resize(count);
+        double center = (count - 1) * 0.5;
+        double sum = 0.0;
+        std::vector<double> h(count);
+        for (int k = 0; k < count; k++) {
+            double x = k - center;
+            double sinc = (x == 0.0) ? 2.0 * cutoff : std::sin(2.0 * PI * cutoff * x) / (PI * x);
+            double window = (count > 1)
+                ? 0.42 - 0.5 * std::cos(2.0 * PI * k / (count - 1)) + 0.08 * std::cos(4.0 * PI * k / (count - 1))
+                : 1.0;
+            h[k] = sinc * window;
+            sum += h[k];
+        }
+        for (int k = 0; k < count; k++) {
+            taps_[k] = static_cast<float>(h[k] / sum);
+        }
+    }
+
+    /**
+     * @brief 把状态预置为恒定输入value的稳态
+     */
+    void Prime(float value) {
+        double u = value;
+        for (Section& section : sections_) {
+            // 转置直接II型的稳态：y = G·u，z1 = y - b0·u，z2 = b2·u - a2·y
+            double gain = (section.b0 + section.b1 + section.b2) / (1.0 + section.a1 + section.a2);
+            double y = gain * u;
+            section.z1 = y - section.b0 * u;
+            section.z2 = section.b2 * u - section.a2 * y;
+            u = y;
+        }
+        std::fill(history_.begin(), history_.end(), value);
+        held_ = value;
+        primed_ = true;
+    }
+
+    /**
+     * @brief 处理一块（length <= BLOCK_SIZE）
+     */
+    void ProcessBlock(const float* input, float* output, size_t length) {
+        // 缺失值保持上一个有效值，记录位置以便输出NaN
+        work_.resize(BLOCK_SIZE);
+        for (size_t i = 0; i < length; i++) {
+            float value = input[i];
+            if (std::isfinite(value)) {
+                if (!primed_) Prime(value);
+                held_ = value;
+            }
+            work_[i] = held_;
+        }
+
+        if (!designed_ || !primed_) {
+            std::copy(input, input + length, output);
+            return;
+        }
+
+        if (!taps_.empty()) {
+            ProcessFir(length);
+        }
+        for (Section& section : sections_) {
+            ProcessSection(section, work_.data(), length);
+        }
+
+        for (size_t i = 0; i < length; i++) {
+            output[i] = std::isfinite(input[i]) ? work_[i] : input[i];
+        }
+    }
+
+    /**
+     * @brief 一节对整块做转置直接II型递推（原地）
+     */
+    static void ProcessSection(Section& section, float* data, size_t length) {
+        const double b0 = section.b0, b1 = section.b1, b2 = section.b2;
+        const double a1 = section.a1, a2 = section.a2;
+        double z1 = section.z1, z2 = section.z2;
+        for (size_t i = 0; i < length; i++) {
+            double x = data[i];
+            double y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            data[i] = static_cast<float>(y);
+        }
+        section.z1 = z1;
+        section.z2 = z2;
+    }
+
+    /**
+     * @brief FIR：历史与本块拼接后按抽头做乘加（结果写回work_）
+     */
+    void ProcessFir(size_t length) {
+        const size_t count = taps_.size();
+        const size_t delay = count - 1;
+
+        // buffer = [最近delay个输入 | 本块]，本块第i个样本位于buffer[delay + i]
+        buffer_.resize(delay + BLOCK_SIZE);
+        std::copy(history_.begin(), history_.end(), buffer_.begin());
+        std::copy(work_.begin(), work_.begin() + length, buffer_.begin() + delay);
+
+        // y[i] = Σ h[k]·x[i-k]，x[i-k]位于buffer[delay + i - k]
+        accumulator_.assign(length, 0.0f);
+        float* out = accumulator_.data();
+        for (size_t k = 0; k < count; k++) {
+            const float h = taps_[k];
+            const float* source = buffer_.data() + delay - k;
+            for (size_t i = 0; i < length; i++) {
+                out[i] += h * source[i];
+            }
+        }
+
+        std::copy(buffer_.begin() + length, buffer_.begin() + length + delay, history_.begin());
+        std::copy(accumulator_.begin(), accumulator_.end(), work_.begin());
+    }
+
+    FilterConfig config_;               // 配置
+    bool designed_ = false;             // 已设计（否则直通）
+    bool primed_ = false;               // 已收到第一个有效样本
+    float held_ = 0.0f;                 // 最近的有效输入
+    std::vector<Section> sections_;     // 双二阶节（IIR）
+    std::vector<float> taps_;           // FIR系数
+    std::vector<float> history_;        // FIR最近taps-1个输入
+    std::vector<float> buffer_;         // FIR拼接缓冲区
+    std::vector<float> accumulator_;    // FIR输出累加
+    std::vector<float> work_;           // 本块工作区（缺失值已填充）
+};
+
+/**
+ * @brief 滤波流水线阶段（解析输出 -> 滤波 -> DataChannelManager）
+ *
+ * 第i个滤波器的输出作为新通道 base + i 追加在原始通道之后，原始数据保持不变。
+ * 配置修改和Apply()由调用者加同一把锁；开销计数为原子量，UI可直接读取。
+ */
+class FilterStage {
+public:
+    static constexpr size_t MAX_FILTERS = 32;
+
+    /**
+     * @brief 设置滤波器列表（配置未变的滤波器保留状态）
+     */
+    void SetFilters(const std::vector<FilterConfig>& configs) {
+        std::vector<ChannelFilter> filters;
+        size_t count = std::min(configs.size(), MAX_FILTERS);
+        filters.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            FilterConfig config = configs[i];
+            config.Clamp();
+            if (i < filters_.size() && filters_[i].GetConfig() == config) {
+                filters.push_back(std::move(filters_[i]));
+            } else {
+                filters.emplace_back(config);
+                filters.back().Design(GetSampleRate());
+            }
+        }
+        filters_ = std::move(filters);
+        ResetCost();
+    }
+
+    size_t GetFilterCount() const {
+        return filters_.size();
+    }
+
+    /**
+     * @brief 清除所有滤波器的状态（通道布局变化或清空数据时调用）
+     */
+    void Reset() {
+        for (ChannelFilter& filter : filters_) {
+            filter.Reset();
+        }
+    }
+
+    /**
+     * @brief 设置设计采样率（值变化时重新设计需要采样率的滤波器，保留状态）
+     * @param sample_rate 采样率（Hz），0表示未设置（需要采样率的滤波器为直通）
+     *
+     * 采样率只由调用者显式设置（用户配置），不随测得的接收帧率变化：
+     * 测得值随读取分块抖动，据此重新设计会让截止/陷波频率跟着漂移。
+     */
+    void SetSampleRate(double sample_rate) {
+        sample_rate = std::max(sample_rate, 0.0);
+        if (sample_rate == sample_rate_) return;
+        sample_rate_ = sample_rate;
+        for (ChannelFilter& filter : filters_) {
+            if (filter.GetConfig().NeedsSampleRate()) {
+                filter.Design(sample_rate_);
+            }
+        }
+    }
+
+    /**
+     * @brief 设计滤波器使用的采样率（0表示未设置）
+     */
+    double GetSampleRate() const {
+        return sample_rate_;
+    }
+
+    /**
+     * @brief 滤波并把结果追加到原始通道之后
+     * @param frames 解析输出（frame_count × channels）
+     * @param frame_count 帧数
+     * @param channels 每帧通道数
+     * @param base 原始通道数（输出前base列为原始数据，不足补NaN、多余截断）
+     * @param output 输出（frame_count × (base + 滤波器数)）
+     * @return 输出的每帧通道数
+     */
+    size_t Apply(const float* frames, size_t frame_count, size_t channels, size_t base, float* output) {
+        const size_t width = base + filters_.size();
+        const size_t copy = std::min(channels, base);
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        for (size_t f = 0; f < frame_count; f++) {
+            const float* row = frames + f * channels;
+            float* out = output + f * width;
+            std::copy(row, row + copy, out);
+            std::fill(out + copy, out + base, nan);
+        }
+
+        // 逐个滤波器：取出一列 -> 块滤波 -> 写回新列（计时只包含这部分）
+        auto start_time = std::chrono::steady_clock::now();
+        column_.resize(frame_count);
+        for (size_t i = 0; i < filters_.size(); i++) {
+            size_t source = filters_[i].GetConfig().source_channel;
+            if (source < channels) {
+                for (size_t f = 0; f < frame_count; f++) {
+                    column_[f] = frames[f * channels + source];
+                }
+            } else {
+                std::fill(column_.begin(), column_.end(), nan);
+            }
+            filters_[i].Process(column_.data(), column_.data(), frame_count);
+            for (size_t f = 0; f < frame_count; f++) {
+                output[f * width + base + i] = column_[f];
+            }
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_time).count();
+
+        filter_ns_.fetch_add(static_cast<uint64_t>(elapsed), std::memory_order_relaxed);
+        filtered_samples_.fetch_add(frame_count * filters_.size(), std::memory_order_relaxed);
+        return width;
+    }
+
+    /**
+     * @brief 平均每个滤波输出样本的耗时（纳秒，含取列和写回）
+     */
+    double GetCostPerSample() const {
+        uint64_t samples = filtered_samples_.load(std::memory_order_relaxed);
+        if (samples == 0) return 0.0;
+        return static_cast<double>(filter_ns_.load(std::memory_order_relaxed)) / static_cast<double>(samples);
+    }
+
+    /**
+     * @brief 已滤波的样本数（所有滤波器合计）
+     */
+    uint64_t GetFilteredSamples() const {
+        return filtered_samples_.load(std::memory_order_relaxed);
+    }
+
+private:
+    void ResetCost() {
+        filter_ns_.store(0, std::memory_order_relaxed);
+        filtered_samples_.store(0, std::memory_order_relaxed);
+    }
+
+    std::vector<ChannelFilter> filters_;            // 滤波器（第i个输出到通道base + i）
+    std::vector<float> column_;                     // 取出的一列
+    double sample_rate_ = 0.0;                      // 设计采样率（0表示未设置）
+    std::atomic<uint64_t> filter_ns_{0};            // 累计滤波耗时（纳秒）
+    std::atomic<uint64_t> filtered_samples_{0};     // 累计滤波样本数
+};
+
+#endif // CHANNEL_FILTER_H
@@ -0,0 +1,146 @@
+/**
+ * @file ChunkSlots.h
+ * @brief 数据块槽位 - 有序阶段把数据块分发给线程池，槽位预分配并循环使用
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 有序阶段（单生产者）按顺序把数据块拷进SLOTS个槽位之一，工作线程从槽位取块处理：
+ * - 槽位的字节缓冲区循环复用，容量增长到最大块长后不再分配
+ * - 不为每个数据块投递任务：工作线程以“排空任务”循环认领已发布的块，
+ *   只有排空任务数少于线程数时才投递新的排空任务，持续接收时几乎不调用Post()
+ * - 处理完成的槽位立即释放；生产者领先最慢的未完成块SLOTS个块时等待（背压）
+ *
+ * 块的处理顺序不确定，需要按序落地的结果由调用方按序号重排（OrderedCommitter）。
+ * 约束：同一时刻只有一个生产者；线程池停止或销毁前先停止生产者，
+ * 本对象必须比线程池中的排空任务存活更久。
+ */
+
+#ifndef CHUNK_SLOTS_H
+#define CHUNK_SLOTS_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "ThreadPool.h"
+
+/**
+ * @brief 数据块槽位
+ * @tparam Meta 随数据块传递的处理参数（如显示格式）
+ */
+template<typename Meta>
+class ChunkSlots {
+public:
+    static constexpr size_t SLOTS = 64;     // 槽位数（最多同时在处理中的数据块）
+
+    using Handler = std::function<void(uint64_t seq, const unsigned char* data, size_t length, const Meta& meta)>;
+
+    ChunkSlots() = default;
+
+    ChunkSlots(const ChunkSlots&) = delete;
+    ChunkSlots& operator=(const ChunkSlots&) = delete;
+
+    /**
+     * @brief 设置处理函数（启动流水线前调用，在工作线程中执行）
+     */
+    void SetHandler(Handler handler) {
+        handler_ = std::move(handler);
+    }
+
+    /**
+     * @brief 分发一个数据块（有序阶段调用，数据在返回前拷入槽位）
+     * @param pool 执行排空任务的线程池
+     * @param seq 数据块序号（原样传给处理函数）
+     * @param data 数据
+     * @param length 字节数
+     * @param meta 处理参数
+     */
+    void Dispatch(ThreadPool& pool, uint64_t seq, const unsigned char* data, size_t length, const Meta& meta) {
+        uint64_t index = published_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[index % SLOTS];
+        while (slot.busy.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        slot.bytes.assign(data, data + length);
+        slot.seq = seq;
+        slot.meta = meta;
+        slot.busy.store(true, std::memory_order_relaxed);
+        published_.store(index + 1, std::memory_order_seq_cst);
+
+        // 排空任务已满时由它们在退出前发现新块（见Drain()）
+        size_t limit = std::max<size_t>(pool.GetThreadCount(), 1);
+        if (drainers_.fetch_add(1, std::memory_order_seq_cst) < limit) {
+            pool.Post([this]() { Drain(); });
+        } else {
+            drainers_.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+
+    /**
+     * @brief 已分发的块是否都已处理完
+     */
+    bool IsIdle() const {
+        uint64_t published = published_.load(std::memory_order_acquire);
+        for (const Slot& slot : slots_) {
+            if (slot.busy.load(std::memory_order_acquire)) return false;
+        }
+        return claimed_.load(std::memory_order_acquire) >= published;
+    }
+
+    /**
+     * @brief 累计分发的数据块数
+     */
+    uint64_t GetDispatchedCount() const {
+        return published_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot {
+        std::vector<unsigned char> bytes;   // 数据块拷贝（容量循环复用）
+        uint64_t seq = 0;                   // 数据块序号
+        Meta meta{};                        // 处理参数
+        std::atomic<bool> busy{false};      // 已发布、尚未处理完
+    };
+
+    /**
+     * @brief 排空任务：认领并处理已发布的块，直到没有新块
+     */
+    void Drain() {
+        while (true) {
+            uint64_t index = claimed_.load(std::memory_order_seq_cst);
+            while (index < published_.load(std::memory_order_seq_cst)) {
+                if (claimed_.compare_exchange_weak(index, index + 1, std::memory_order_seq_cst)) {
+                    Slot& slot = slots_[index % SLOTS];
+                    if (handler_) {
+                        handler_(slot.seq, slot.bytes.data(), slot.bytes.size(), slot.meta);
+                    }
+                    slot.busy.store(false, std::memory_order_release);
+                    index = claimed_.load(std::memory_order_seq_cst);
+                }
+            }
+
+            // 先退出计数再检查：生产者看到排空任务已满而没有投递时，
+            // 它发布的块一定能在这里被看到
+            drainers_.fetch_sub(1, std::memory_order_seq_cst);
+            if (claimed_.load(std::memory_order_seq_cst) >= published_.load(std::memory_order_seq_cst)) {
+                return;
+            }
+            if (drainers_.fetch_add(1, std::memory_order_seq_cst) >= 1) {
+                // 已有其他排空任务在运行（或刚投递），由它处理
+                drainers_.fetch_sub(1, std::memory_order_seq_cst);
+                return;
+            }
+        }
+    }
+
+    Handler handler_;                                   // 处理函数
+    std::array<Slot, SLOTS> slots_;                     // 槽位（按发布序号取模）
+    std::atomic<uint64_t> published_{0};                // 已发布的块数（生产者写）
+    std::atomic<uint64_t> claimed_{0};                  // 已被认领的块数
+    std::atomic<size_t> drainers_{0};                   // 运行中或已投递的排空任务数
+};
+
+#endif // CHUNK_SLOTS_H
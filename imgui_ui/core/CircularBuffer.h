@@ -5,7 +5,10 @@
  * @date 2025
  *
  * 循环缓冲区特性：
- * - 固定大小，避免动态内存分配
+ * - 容量在运行时指定（向上取整为2的幂），写入过程中不再分配内存
+ * - 下标用位掩码回绕，不做取模运算
+ * - 批量写入最多两次memcpy（跨越边界时分两段）
+ * - 存储使用大页友好的分配器（HugePageAllocator），支持千万级容量
  * - O(1)时间复杂度的读写操作
  * - 自动覆盖最旧数据
  * - 线程安全（通过外部互斥锁）
@@ -16,18 +19,49 @@
 
 #include <vector>
 #include <algorithm>
+#include <cstring>
+#include <type_traits>
 #include "DataTypes.h"
+#include "HugePageAllocator.h"
 
 /**
  * @brief 循环缓冲区模板类
  * @tparam T 数据类型
- * @tparam Capacity 缓冲区容量（默认2000个点）
  */
-template<typename T, size_t Capacity = 2000>
+template<typename T>
 class CircularBuffer {
 public:
-    CircularBuffer() : head_(0), count_(0) {
-        data_.resize(Capacity);
+    /**
+     * @brief 构造函数
+     * @param capacity 缓冲区容量（默认2048个点，向上取整为2的幂，0表示暂不分配）
+     */
+    explicit CircularBuffer(size_t capacity = 2048)
+        : capacity_(RoundCapacity(capacity)), mask_(capacity_ - 1), head_(0), count_(0) {
+        data_.resize(capacity_);
+    }
+
+    /**
+     * @brief 实际分配的容量：不小于capacity的最小2的幂（0保持为0）
+     */
+    static size_t RoundCapacity(size_t capacity) {
+        size_t rounded = 1;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        return capacity == 0 ? 0 : rounded;
+    }
+
+    /**
+     * @brief 重新分配容量（向上取整为2的幂，清空已有数据，不能与读写并发）
+     */
+    void SetCapacity(size_t capacity) {
+        capacity = RoundCapacity(capacity);
+        std::vector<T, HugePageAllocator<T>> data(capacity);
+        data_.swap(data);
+        capacity_ = capacity;
+        mask_ = capacity - 1;
+        head_ = 0;
+        count_ = 0;
     }
 
     /**
@@ -36,20 +70,58 @@ public:
      */
     void Push(const T& value) {
         data_[head_] = value;
-        head_ = (head_ + 1) % Capacity;
-        if (count_ < Capacity) {
+        head_ = (head_ + 1) & mask_;
+        if (count_ < capacity_) {
             count_++;
         }
     }
 
     /**
-     * @brief 批量添加数据点
+     * @brief 批量添加数据点（最多两次memcpy）
      * @param values 数据数组
-     * @param length 数据长度
+     * @param length 数据长度（超过容量时只保留最后capacity个）
      */
     void PushBatch(const T* values, size_t length) {
-        for (size_t i = 0; i < length; i++) {
-            Push(values[i]);
+        static_assert(std::is_trivially_copyable<T>::value, "PushBatch requires trivially copyable T");
+        if (length == 0 || capacity_ == 0) return;
+        if (length > capacity_) {
+            head_ = (head_ + length - capacity_) & mask_;
+            values += length - capacity_;
+            length = capacity_;
+        }
+        size_t first_part = std::min(length, capacity_ - head_);
+        std::memcpy(data_.data() + head_, values, first_part * sizeof(T));
+        if (length > first_part) {
+            std::memcpy(data_.data(), values + first_part, (length - first_part) * sizeof(T));
+        }
+        head_ = (head_ + length) & mask_;
+        count_ = std::min(count_ + length, capacity_);
+    }
+
+    /**
+     * @brief 批量添加同一个值（最多两次填充）
+     * @param value 数据值
+     * @param length 数量
+     */
+    void PushFill(const T& value, size_t length) {
+        if (length == 0 || capacity_ == 0) return;
+        if (length > capacity_) {
+            head_ = (head_ + length - capacity_) & mask_;
+            length = capacity_;
+        }
+        size_t first_part = std::min(length, capacity_ - head_);
+        std::fill(data_.begin() + head_, data_.begin() + head_ + first_part, value);
+        std::fill(data_.begin(), data_.begin() + (length - first_part), value);
+        head_ = (head_ + length) & mask_;
+        count_ = std::min(count_ + length, capacity_);
+    }
+
+    /**
+     * @brief 丢弃最旧的数据点
+     */
+    void PopFront() {
+        if (count_ > 0) {
+            count_--;
         }
     }
 
@@ -79,7 +151,7 @@ public:
      * @brief 判断缓冲区是否已满
      */
     bool Full() const {
-        return count_ == Capacity;
+        return count_ == capacity_;
     }
 
     /**
@@ -90,7 +162,7 @@ public:
             static T dummy;
             return dummy;
         }
-        size_t latest_index = (head_ + Capacity - 1) % Capacity;
+        size_t latest_index = (head_ - 1) & mask_;
         return data_[latest_index];
     }
 
@@ -104,8 +176,7 @@ public:
             return dummy;
         }
         // 计算实际位置
-        size_t oldest_index = (head_ + Capacity - count_) % Capacity;
-        size_t actual_index = (oldest_index + index) % Capacity;
+        size_t actual_index = (head_ - count_ + index) & mask_;
         return data_[actual_index];
     }
 
@@ -132,15 +203,15 @@ public:
 
         if (num_points == count_) {
             // 不需要降采样，直接拷贝
-            size_t oldest_index = (head_ + Capacity - count_) % Capacity;
-            if (oldest_index + count_ <= Capacity) {
+            size_t oldest_index = (head_ - count_) & mask_;
+            if (oldest_index + count_ <= capacity_) {
                 // 数据连续，一次拷贝
                 std::copy(data_.begin() + oldest_index,
                          data_.begin() + oldest_index + count_,
                          output.begin());
             } else {
                 // 数据跨越边界，两次拷贝
-                size_t first_part = Capacity - oldest_index;
+                size_t first_part = capacity_ - oldest_index;
                 std::copy(data_.begin() + oldest_index, data_.end(), output.begin());
                 std::copy(data_.begin(), data_.begin() + count_ - first_part,
                          output.begin() + first_part);
@@ -200,15 +271,15 @@ public:
         timestamps.resize(num_points);
         y_values.resize(num_points);
 
-        // 计算起始索引（最老的数据点）
-        size_t oldest_index = (count_ < Capacity) ? 0 : head_;
+        // 计算起始索引（最老的数据点，与Get()一致；Clear()或PopFront()后未满时也不一定从0开始）
+        size_t oldest_index = (head_ - count_) & mask_;
 
         // 计算采样步长（如果需要降采样）
         size_t step = (max_points > 0 && count_ > max_points) ? (count_ / max_points) : 1;
 
         // 直接从data_数组读取，一次完成
         for (size_t i = 0; i < num_points; i++) {
-            size_t idx = (oldest_index + i * step) % Capacity;
+            size_t idx = (oldest_index + i * step) & mask_;
 
             if constexpr (std::is_same_v<T, DataPoint>) {
                 timestamps[i] = data_[idx].timestamp;
@@ -222,15 +293,90 @@ public:
         return num_points;
     }
 
+    /**
+     * @brief 拷贝一段连续的数据（0是最旧），跨越边界时分两段拷贝
+     * @param start 起始索引
+     * @param count 数量（start + count不超过Size()）
+     * @param output 输出数组
+     */
+    void CopyTo(size_t start, size_t count, T* output) const {
+        static_assert(std::is_trivially_copyable<T>::value, "CopyTo requires trivially copyable T");
+        if (count == 0) return;
+        size_t first = (head_ - count_ + start) & mask_;
+        size_t first_part = std::min(count, capacity_ - first);
+        std::memcpy(output, data_.data() + first, first_part * sizeof(T));
+        if (count > first_part) {
+            std::memcpy(output + first_part, data_.data(), (count - first_part) * sizeof(T));
+        }
+    }
+
+    /**
+     * @brief 二分查找第一个不小于value的元素（要求数据从旧到新单调不减，如时间戳）
+     * @return 索引（0是最旧），所有元素都小于value时返回Size()
+     */
+    size_t LowerBound(const T& value) const {
+        return PartitionPoint([&value](const T& element) { return element < value; });
+    }
+
+    /**
+     * @brief 二分查找第一个大于value的元素（要求数据从旧到新单调不减）
+     * @return 索引（0是最旧），所有元素都不大于value时返回Size()
+     */
+    size_t UpperBound(const T& value) const {
+        return PartitionPoint([&value](const T& element) { return !(value < element); });
+    }
+
+    /**
+     * @brief 查找落在[low, high]内的连续区间（要求数据从旧到新单调不减）
+     * @param low 下界（含）
+     * @param high 上界（含）
+     * @param start 输出区间起始索引（0是最旧）
+     * @return 区间内元素个数，O(log n)
+     */
+    size_t FindRange(const T& low, const T& high, size_t& start) const {
+        start = LowerBound(low);
+        size_t end = UpperBound(high);
+        return (end > start) ? end - start : 0;
+    }
+
     /**
      * @brief 获取缓冲区容量
      */
-    constexpr size_t GetCapacity() const {
-        return Capacity;
+    size_t GetCapacity() const {
+        return capacity_;
+    }
+
+    /**
+     * @brief 存储占用的字节数
+     */
+    size_t GetMemoryUsage() const {
+        return capacity_ * sizeof(T);
     }
 
 private:
-    std::vector<T> data_;   // 数据存储
+    /**
+     * @brief 第一个不满足pred的元素索引（pred对前一部分元素成立、对其余不成立）
+     *
+     * 数据跨越边界时先用第一段的最后一个元素判断边界落在哪一段，
+     * 再在该段的连续内存上二分，循环内没有取模运算
+     */
+    template<typename Pred>
+    size_t PartitionPoint(Pred pred) const {
+        if (count_ == 0) return 0;
+        size_t oldest_index = (head_ - count_) & mask_;
+        size_t first_part = std::min(count_, capacity_ - oldest_index);
+        const T* first = data_.data() + oldest_index;
+        if (first_part < count_ && pred(first[first_part - 1])) {
+            const T* second = data_.data();
+            return first_part + static_cast<size_t>(
+                std::partition_point(second, second + (count_ - first_part), pred) - second);
+        }
+        return static_cast<size_t>(std::partition_point(first, first + first_part, pred) - first);
+    }
+
+    std::vector<T, HugePageAllocator<T>> data_;     // 数据存储
+    size_t capacity_;       // 缓冲区容量（2的幂）
+    size_t mask_;           // capacity_ - 1，下标回绕用
     size_t head_;           // 写入位置（指向下一个写入位置）
     size_t count_;          // 当前数据点数量
 };
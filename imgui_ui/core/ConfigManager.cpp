@@ -11,6 +11,8 @@
 #include "../core/DataChannelManager.h"
 #include <fstream>
 #include <iostream>
+#include <cstdio>
+#include <algorithm>
 
 /**
  * @brief 获取配置文件路径（与可执行文件同目录）
@@ -121,6 +123,8 @@ json ConfigManager::SerializeSerial(const AppState& state) {
     j["selected_databits_index"] = state.selected_databits_index;
     j["selected_stopbits_index"] = state.selected_stopbits_index;
     j["selected_parity_index"] = state.selected_parity_index;
+    j["rx_queue_size"] = state.rx_queue_size;
+    j["read_chunk_size"] = state.read_chunk_size;
 
     return j;
 }
@@ -131,6 +135,12 @@ void ConfigManager::DeserializeSerial(AppState& state, const json& j) {
     state.selected_databits_index = SafeGet<int>(j, "selected_databits_index", 3);
     state.selected_stopbits_index = SafeGet<int>(j, "selected_stopbits_index", 0);
     state.selected_parity_index = SafeGet<int>(j, "selected_parity_index", 0);
+    state.rx_queue_size = SafeGet<int>(j, "rx_queue_size", 65536);
+    state.read_chunk_size = SafeGet<int>(j, "read_chunk_size", 16384);
+
+    // 限制队列/块大小范围（4KB - 1MB）
+    state.rx_queue_size = std::clamp(state.rx_queue_size, 4096, 1048576);
+    state.read_chunk_size = std::clamp(state.read_chunk_size, 4096, 1048576);
 }
 
 // ========================================
@@ -200,7 +210,7 @@ void ConfigManager::DeserializeUI(AppState& state, const json& j) {
     // 发送缓冲区
     std::string send_buffer_str = SafeGet<std::string>(j, "send_buffer", "");
     if (!send_buffer_str.empty() && send_buffer_str.length() < sizeof(state.send_buffer)) {
-        strcpy_s(state.send_buffer, sizeof(state.send_buffer), send_buffer_str.c_str());
+        snprintf(state.send_buffer, sizeof(state.send_buffer), "%s", send_buffer_str.c_str());
     }
 
     // 发送后缀配置
@@ -211,12 +221,12 @@ void ConfigManager::DeserializeUI(AppState& state, const json& j) {
 
     std::string custom_prefix_str = SafeGet<std::string>(j, "custom_prefix", "");
     if (custom_prefix_str.length() < sizeof(state.custom_prefix)) {
-        strcpy_s(state.custom_prefix, sizeof(state.custom_prefix), custom_prefix_str.c_str());
+        snprintf(state.custom_prefix, sizeof(state.custom_prefix), "%s", custom_prefix_str.c_str());
     }
 
     std::string custom_suffix_str = SafeGet<std::string>(j, "custom_suffix", "");
     if (custom_suffix_str.length() < sizeof(state.custom_suffix)) {
-        strcpy_s(state.custom_suffix, sizeof(state.custom_suffix), custom_suffix_str.c_str());
+        snprintf(state.custom_suffix, sizeof(state.custom_suffix), "%s", custom_suffix_str.c_str());
     }
 
     // 发送历史
@@ -242,12 +252,31 @@ json ConfigManager::SerializeVisualization(const AppState& state) {
 
     // 协议类型
     j["protocol_type"] = static_cast<int>(state.visualization_ui.GetProtocolParser()->GetType());
+    j["auto_detect_protocol"] = state.visualization_ui.GetAutoDetect();
+    j["history_capacity"] = const_cast<VisualizationUI&>(state.visualization_ui).GetChannelManager().GetCapacity();
+    j["stats_window"] = const_cast<VisualizationUI&>(state.visualization_ui).GetChannelManager().GetStatsWindow();
+
+    // 通道滤波器
+    json filters = json::array();
+    for (const FilterConfig& config : state.visualization_ui.GetFilters()) {
+        json filter;
+        filter["source_channel"] = config.source_channel;
+        filter["type"] = static_cast<int>(config.type);
+        filter["frequency"] = config.frequency;
+        filter["order"] = config.order;
+        filter["q"] = config.q;
+        filter["taps"] = config.taps;
+        filters.push_back(filter);
+    }
+    j["filters"] = filters;
+    j["filter_sample_rate"] = state.visualization_ui.GetFilterSampleRate();
 
     // 通道配置
     json channels = json::array();
     DataChannelManager& channel_mgr = const_cast<VisualizationUI&>(state.visualization_ui).GetChannelManager();
 
-    for (size_t i = 0; i < DataChannelManager::MAX_CHANNELS; i++) {
+    const size_t channel_count = channel_mgr.GetChannelCount();
+    for (size_t i = 0; i < channel_count; i++) {
         ChannelConfig config = channel_mgr.GetChannelConfig(i);
 
         json channel;
@@ -267,6 +296,35 @@ void ConfigManager::DeserializeVisualization(AppState& state, const json& j) {
     // 协议类型
     int protocol_type = SafeGet<int>(j, "protocol_type", 0);
     state.visualization_ui.SetProtocolType(static_cast<ProtocolType>(protocol_type));
+    state.visualization_ui.SetAutoDetect(SafeGet<bool>(j, "auto_detect_protocol", true));
+
+    // 历史深度（与当前不同时在后台调整）
+    size_t history_capacity = SafeGet<size_t>(j, "history_capacity", DataChannelManager::DEFAULT_CAPACITY);
+    history_capacity = DataChannelManager::RoundCapacity(history_capacity);
+    if (history_capacity != state.visualization_ui.GetChannelManager().GetCapacity()) {
+        state.visualization_ui.GetChannelManager().RequestCapacity(history_capacity);
+    }
+
+    // 统计窗口长度
+    state.visualization_ui.GetChannelManager().SetStatsWindow(
+        SafeGet<size_t>(j, "stats_window", WindowedStats::DEFAULT_WINDOW));
+
+    // 通道滤波器（在通道配置之前恢复，滤波输出通道的名称和颜色随后被覆盖为保存值）
+    state.visualization_ui.SetFilterSampleRate(SafeGet<double>(j, "filter_sample_rate", 0.0));
+    std::vector<FilterConfig> filters;
+    if (j.contains("filters") && j["filters"].is_array()) {
+        for (const json& filter : j["filters"]) {
+            FilterConfig config;
+            config.source_channel = SafeGet<size_t>(filter, "source_channel", 0);
+            config.type = static_cast<FilterType>(SafeGet<int>(filter, "type", 0));
+            config.frequency = SafeGet<double>(filter, "frequency", config.frequency);
+            config.order = SafeGet<int>(filter, "order", config.order);
+            config.q = SafeGet<double>(filter, "q", config.q);
+            config.taps = SafeGet<int>(filter, "taps", config.taps);
+            filters.push_back(config);
+        }
+    }
+    state.visualization_ui.SetFilters(filters);
 
     // 通道配置
     if (j.contains("channels") && j["channels"].is_array()) {
@@ -1,81 +1,372 @@
 /**
  * @file DataChannelManager.h
- * @brief 16通道数据管理器
+ * @brief 多通道数据管理器
  * @author AI Assistant
  * @date 2025
  *
- * 管理16个独立数据通道，每个通道包含：
- * - 循环缓冲区（存储历史数据）
+ * 管理最多MAX_CHANNELS个数据通道，每个通道包含：
+ * - 数值列（存储历史数据）
  * - 通道配置（名称、颜色、启用状态等）
- * - 统计信息（最大值、最小值、平均值）
+ * - 统计信息（全程最大值、最小值、平均值、标准差，以及最近一段窗口内的
+ *   最值、均值、标准差、RMS、峰峰值，见WindowedStats，写入时均摊O(1)更新；
+ *   P50/P95/P99/P99.9分位数由每通道的t-digest草图估计，见QuantileSketch）
+ *
+ * 存储布局（结构数组SoA）：
+ * - 每帧一个共享时间戳，存于timestamps_列
+ * - 每个通道一列连续的float，列的第i个元素与timestamps_的第i个元素属于同一帧
+ * - 每个采样约占 4 + 8/N 字节（N为通道数），原先每通道独立的{double, float}
+ *   记录为16字节；列数据连续，绘图/统计内核可直接向量化读取
+ * - 各列与时间戳列尾部对齐：列在通道首次出现时创建，之后每帧都写入；
+ *   帧宽度小于已存储列数时，缺少的通道填NaN占位
+ *
+ * 通道按需创建：通道数随帧宽度、SetChannelCount()和配置修改增长，
+ * 从未出现过的通道不占任何存储；已创建但从未收到数据的通道只有配置和统计。
+ * 快照只拷贝启用通道的数值，UI每帧的开销与启用的通道数成正比。
+ *
+ * 历史深度（每列容量）运行时可调，取2的幂（环形下标用位掩码回绕），最多MAX_CAPACITY帧：
+ * - 列在首次出现对应通道时才分配，大块内存按大页对齐（HugePageAllocator）
+ * - RequestCapacity()在后台线程中调整：锁外分配新缓冲区，
+ *   再分块把保留的历史拷过去（每次持锁最多拷贝RESIZE_BYTES字节，按所有列合计），
+ *   追上写入后在锁内交换，解析阶段不会因调整而长时间等待
+ * - 调整进行中再次请求时只记录最新的目标，当前调整完成后继续按它调整
+ * - 快照只包含最近的时间戳；数值只为请求过的通道拷贝请求的长度
+ *   （RequestSnapshotValues，最多SNAPSHOT_FRAMES帧），UI每帧拷贝量与历史深度无关
+ *
+ * 时间戳由写入时刻推算（一批帧均匀分布在上一次写入与当前时刻之间），相邻间隔
+ * 反映的是串口读取的分块而不是设备的发送频率；接收帧率另由FrameRateMeter按
+ * 最近几秒实际写入的帧数测量，随快照发布（ChannelSnapshot::frame_rate）。
+ *
+ * 批量写入（PushFrames）按列进行：每块最多PUSH_CHUNK帧，时间戳列和每个数值列
+ * 各一次PushBatch（最多两次memcpy），金字塔按桶分段累积，不再逐帧逐通道调用Push。
+ *
+ * 波形绘图：每列并列维护一个最小/最大值金字塔（MinMaxPyramid），对任意时间窗口
+ * 按像素列降采样（见Downsampler），计算量与输出点数成正比，与窗口内的原始帧数无关。
+ * 绘图组件用AddWaveform()登记、每帧RequestWaveform()提交窗口和分段数，
+ * 降采样结果由快照发布者计算，随快照发布（ChannelSnapshot::FindWaveform）。
+ *
+ * 读写分离：
+ * - 写入（解析阶段）和配置修改在mutex_内进行
+ * - UI每帧调用一次AcquireSnapshot()获取所有通道的一致快照，
+ *   之后本帧的读取都访问快照；UI线程的绘制路径不获取mutex_
+ *   （数值、波形请求经原子变量和三缓冲传给发布者）
+ * - 快照由写者在UI请求后的下一次写入时生成（写入之后、锁外进行），
+ *   经三缓冲（TripleBuffer）发布，写者不会等待UI；没有写入时波形请求的变化
+ *   由空闲发布线程发布
+ * - 发布分两步：持mutex_时只拷贝时间戳、请求的数值、O(1)的统计值、
+ *   分位数草图的状态（样本数变化时）和降采样所需的分段；分位数查询和
+ *   波形输出的组装在锁外进行，不延长写入的临界区
  */
 
 #ifndef DATA_CHANNEL_MANAGER_H
 #define DATA_CHANNEL_MANAGER_H
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <mutex>
 #include <chrono>
+#include <condition_variable>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
 #include <string>
+#include <thread>
 #include "DataTypes.h"
 #include "CircularBuffer.h"
+#include "MinMaxPyramid.h"
+#include "Downsampler.h"
+#include "TripleBuffer.h"
+#include "WindowedStats.h"
+#include "QuantileSketch.h"
+#include "FrameRateMeter.h"
+
+/**
+ * @brief 帧顺序统计（用于验证接收到写入的整条流水线保持了顺序）
+ *
+ * 每个数据块在进入流水线时（接收回调）分配接收字节流中的位置，经消费线程、
+ * 协议解析带到这里；每批帧的流位置应严格递增。
+ */
+struct FrameOrderStats {
+    uint64_t frames_pushed = 0;         // 已写入的帧数
+    uint64_t last_stream_position = 0;  // 最近一批帧在接收字节流中的结束位置
+    uint64_t order_violations = 0;      // 流位置未递增的次数（正常应为0）
+};
+
+/**
+ * @brief 单个通道在快照中的内容
+ */
+struct ChannelView {
+    ChannelConfig config;
+    ChannelStats stats;
+    std::vector<float> values;        // 数值列（与ChannelSnapshot::timestamps对齐，未请求或无数据时为空）
+    size_t first_index = 0;           // 第一个有效值的下标（之前为对齐填充的NaN）
+};
 
 /**
- * @brief 通道统计信息
+ * @brief 波形请求（绘图组件每帧提交，快照发布时按它降采样）
  */
-struct ChannelStats {
-    float min_value;
-    float max_value;
-    float avg_value;
-    float last_value;     // 最后一个值
-    size_t sample_count;
-
-    ChannelStats()
-        : min_value(0.0f)
-        , max_value(0.0f)
-        , avg_value(0.0f)
-        , last_value(0.0f)
-        , sample_count(0)
-    {}
-
-    void Reset() {
-        min_value = max_value = avg_value = last_value = 0.0f;
-        sample_count = 0;
+struct WaveformRequest {
+    std::vector<size_t> channels;                   // 绘制的通道
+    DownsampleMode mode = DownsampleMode::MINMAX;   // 降采样方式
+    size_t max_buckets = 0;                         // 最大分段数（通常为绘图区像素宽度）
+    bool follow = true;                             // 跟随最新数据：窗口为[最新时间 - span, 最新时间]
+    double span = 10.0;                             // 跟随时的窗口长度（秒）
+    double t_begin = 0.0;                           // 不跟随时的窗口起始时间（秒）
+    double t_end = 0.0;                             // 不跟随时的窗口结束时间（秒）
+
+    bool operator==(const WaveformRequest& other) const {
+        return channels == other.channels && mode == other.mode && max_buckets == other.max_buckets &&
+               follow == other.follow && span == other.span &&
+               t_begin == other.t_begin && t_end == other.t_end;
     }
 };
 
 /**
- * @brief 16通道数据管理器
+ * @brief 波形中一个通道的降采样结果
+ */
+struct WaveformSeries {
+    size_t channel = 0;                 // 通道索引
+    std::vector<double> timestamps;     // 时间戳（窗口两侧各多一帧）
+    std::vector<float> values;          // Y值（与timestamps等长，通道禁用或窗口内无数据时为空）
+};
+
+/**
+ * @brief 一个绘图组件的波形（快照中）
+ */
+struct WaveformData {
+    uint64_t id = 0;                    // 波形编号（WaveformState::id）
+    std::vector<WaveformSeries> series; // 按请求的通道顺序
+};
+
+/**
+ * @brief 所有通道的一致快照（同一时刻的配置、统计和数据）
+ */
+struct ChannelSnapshot {
+    uint64_t version = 0;               // 快照版本（每次发布递增）
+    uint64_t frames_pushed = 0;         // 生成快照时已写入的帧数
+    size_t capacity = 0;                // 每列容量（帧）
+    size_t stored_frames = 0;           // 缓冲区中的帧数（快照只包含最近的一部分）
+    size_t memory_bytes = 0;            // 历史缓冲区占用的内存
+    double frame_rate = 0.0;            // 测得的接收帧率（帧/秒，见FrameRateMeter），尚未测得时为0
+    FrameOrderStats order_stats;        // 帧顺序统计
+    std::vector<double> timestamps;     // 共享时间戳列（从旧到新）
+    std::vector<ChannelView> channels;  // 各通道内容
+    std::vector<WaveformData> waveforms; // 有效波形请求的降采样结果
+
+    /**
+     * @brief 查找波形中某通道的降采样结果
+     * @return 没有对应结果时返回nullptr（请求尚未发布或已失效）
+     */
+    const WaveformSeries* FindWaveform(uint64_t id, size_t channel_index) const {
+        for (const WaveformData& waveform : waveforms) {
+            if (waveform.id != id) continue;
+            for (const WaveformSeries& series : waveform.series) {
+                if (series.channel == channel_index) return &series;
+            }
+            return nullptr;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief 获取快照中时间范围[t0, t1]内的数值（只含请求过的最近帧，不加锁）
+     * @param channel_index 通道索引
+     * @param t0 起始时间（秒，含）
+     * @param t1 结束时间（秒，含）
+     * @param timestamps 输出时间戳数组
+     * @param y_values 输出Y值数组
+     * @return 实际点数
+     */
+    size_t GetChannelRange(size_t channel_index, double t0, double t1,
+                           std::vector<double>& timestamps, std::vector<float>& y_values) const {
+        timestamps.clear();
+        y_values.clear();
+        if (channel_index >= channels.size()) return 0;
+        const ChannelView& view = channels[channel_index];
+        if (view.values.size() <= view.first_index) return 0;
+
+        auto first = this->timestamps.begin() + static_cast<std::ptrdiff_t>(view.first_index);
+        auto begin = std::lower_bound(first, this->timestamps.end(), t0);
+        auto end = std::upper_bound(begin, this->timestamps.end(), t1);
+        size_t start = static_cast<size_t>(begin - this->timestamps.begin());
+        size_t length = static_cast<size_t>(end - begin);
+        timestamps.assign(begin, end);
+        y_values.assign(view.values.begin() + static_cast<std::ptrdiff_t>(start),
+                        view.values.begin() + static_cast<std::ptrdiff_t>(start + length));
+        return length;
+    }
+
+    /**
+     * @brief 拷贝通道数据用于绘图（与DataChannelManager::GetChannelData语义相同，不加锁）
+     * @param channel_index 通道索引
+     * @param timestamps 输出时间戳数组
+     * @param y_values 输出Y值数组
+     * @param max_points 最大点数（0表示全部，超出时等间隔抽取）
+     * @return 实际点数
+     */
+    size_t GetChannelData(size_t channel_index,
+                          std::vector<double>& timestamps,
+                          std::vector<float>& y_values,
+                          size_t max_points = 0) const {
+        if (channel_index >= channels.size()) {
+            timestamps.clear();
+            y_values.clear();
+            return 0;
+        }
+
+        const ChannelView& view = channels[channel_index];
+        size_t first = view.first_index;
+        size_t count = (view.values.size() > first) ? view.values.size() - first : 0;
+        size_t num_points = (max_points > 0 && max_points < count) ? max_points : count;
+        size_t step = (num_points < count) ? (count / num_points) : 1;
+
+        timestamps.resize(num_points);
+        y_values.resize(num_points);
+        for (size_t i = 0; i < num_points; i++) {
+            timestamps[i] = this->timestamps[first + i * step];
+            y_values[i] = view.values[first + i * step];
+        }
+        return num_points;
+    }
+};
+
+/**
+ * @brief 绘图组件的波形请求状态（AddWaveform()创建，组件持有，组件销毁后自动注销）
+ *
+ * 请求由UI线程经三缓冲交给快照发布者；降采样器（缓存已完成的分段）只由发布者使用。
+ * 组件只通过DataChannelManager::RequestWaveform()访问。
+ */
+struct WaveformState {
+    /**
+     * @brief 带提交时刻的请求
+     */
+    struct Pending {
+        WaveformRequest request;
+        uint64_t acquire = 0;                   // 提交时的AcquireSnapshot()次数
+    };
+
+    uint64_t id = 0;                            // 波形编号（快照中据此查找结果）
+    TripleBuffer<Pending> requests;             // 请求（UI写，发布者读）
+    WaveformRequest submitted;                  // 最近提交的请求（仅UI线程，检测变化）
+    std::vector<Downsampler> downsamplers;      // 各通道的降采样器（按通道索引，仅发布者）
+};
+
+/**
+ * @brief 多通道数据管理器
  */
 class DataChannelManager {
 public:
-    static constexpr size_t MAX_CHANNELS = 16;
-    static constexpr size_t BUFFER_SIZE = 2000;  // 每个通道2000个点
+    static constexpr size_t MAX_CHANNELS = 256;            // 通道数上限（按需创建）
+    static constexpr size_t DEFAULT_CAPACITY = 2048;       // 默认每个通道2048帧
+    static constexpr size_t MIN_CAPACITY = 1024;           // 最小历史深度
+    static constexpr size_t MAX_CAPACITY = size_t(1) << 25; // 最大历史深度（约3355万帧）
+    static constexpr size_t PUSH_CHUNK = 1024;             // 批量写入每块的帧数
+    static constexpr size_t SNAPSHOT_FRAMES = 20000;       // 快照可请求的最近帧数上限
+    static constexpr size_t SNAPSHOT_TIMESTAMPS = 2048;    // 快照至少包含的时间戳数
+    static constexpr size_t RESIZE_BYTES = 256 * 1024;     // 调整历史深度时每次持锁拷贝的字节数（所有列合计）
+    static constexpr double MAX_BATCH_SPAN = 0.05;  // 批量写入时间戳最大分布区间（秒）
+    static constexpr int IDLE_PUBLISH_MS = 20;             // 空闲发布线程检查波形请求变化的间隔（毫秒）
 
-    DataChannelManager() {
-        InitializeChannels();
+    DataChannelManager()
+        : timestamps_(DEFAULT_CAPACITY)
+    {
         start_time_ = std::chrono::steady_clock::now();
+        PublishSnapshot();
+        idle_thread_ = std::thread(&DataChannelManager::IdlePublisher, this);
+    }
+
+    ~DataChannelManager() {
+        {
+            std::lock_guard<std::mutex> lock(idle_mutex_);
+            idle_stop_ = true;
+        }
+        idle_cv_.notify_one();
+        idle_thread_.join();
+        if (resize_thread_.joinable()) {
+            resize_thread_.join();
+        }
+    }
+
+    DataChannelManager(const DataChannelManager&) = delete;
+    DataChannelManager& operator=(const DataChannelManager&) = delete;
+
+    /**
+     * @brief 调整历史深度（后台进行，保留最近的历史）
+     * @param capacity 每个通道的帧数（限制在MIN_CAPACITY~MAX_CAPACITY，向上取整为2的幂）
+     *
+     * 上一次调整尚未完成时只记录目标，调整线程完成当前调整后按最新的目标继续。
+     */
+    void RequestCapacity(size_t capacity) {
+        capacity = RoundCapacity(capacity);
+        std::lock_guard<std::mutex> lock(resize_mutex_);
+        target_capacity_.store(capacity);
+        if (resizing_.load() || capacity == applied_capacity_) {
+            return;
+        }
+        // 上一个调整线程已退出循环（resizing_为false），join不会等待
+        if (resize_thread_.joinable()) {
+            resize_thread_.join();
+        }
+        resizing_.store(true);
+        resize_thread_ = std::thread(&DataChannelManager::ResizeWorker, this);
+    }
+
+    /**
+     * @brief 是否正在调整历史深度
+     */
+    bool IsResizing() const {
+        return resizing_.load();
+    }
+
+    /**
+     * @brief 最近一次请求的历史深度（调整中时为调整完成后的深度）
+     */
+    size_t GetCapacity() const {
+        return target_capacity_.load();
+    }
+
+    /**
+     * @brief 实际使用的历史深度（限制范围后向上取整为2的幂）
+     */
+    static size_t RoundCapacity(size_t capacity) {
+        return CircularBuffer<double>::RoundCapacity(std::min(std::max(capacity, MIN_CAPACITY), MAX_CAPACITY));
+    }
+
+    /**
+     * @brief 估算指定历史深度的内存占用（字节）
+     */
+    static size_t EstimateMemory(size_t capacity, size_t channels) {
+        capacity = RoundCapacity(capacity);
+        return capacity * (sizeof(double) + channels * sizeof(float)) +
+               channels * MinMaxPyramid::EstimateMemory(capacity);
     }
 
     /**
      * @brief 添加数据到指定通道
-     * @param channel_index 通道索引（0-15）
+     * @param channel_index 通道索引（0 ~ MAX_CHANNELS-1）
      * @param value 数据值
      */
     void PushData(size_t channel_index, float value) {
         if (channel_index >= MAX_CHANNELS) return;
 
-        std::lock_guard<std::mutex> lock(mutex_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
 
-        // 计算时间戳
-        auto now = std::chrono::steady_clock::now();
-        double timestamp = std::chrono::duration<double>(now - start_time_).count();
+            // 计算时间戳
+            auto now = std::chrono::steady_clock::now();
+            double timestamp = std::chrono::duration<double>(now - start_time_).count();
 
-        // 添加到缓冲区
-        buffers_[channel_index].Push(DataPoint(timestamp, value));
-
-        // 更新统计信息
-        UpdateStats(channel_index, value);
+            // 作为一帧写入，其余通道填NaN
+            float row[MAX_CHANNELS];
+            for (size_t i = 0; i < channel_index; i++) {
+                row[i] = std::numeric_limits<float>::quiet_NaN();
+            }
+            row[channel_index] = value;
+            PushFrame(timestamp, row, channel_index + 1);
+            rate_meter_.Record(timestamp, total_frames_);
+        }
+        PublishSnapshotIfRequested();
     }
 
     /**
@@ -88,17 +379,157 @@ public:
             num_channels = MAX_CHANNELS;
         }
 
-        std::lock_guard<std::mutex> lock(mutex_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            auto now = std::chrono::steady_clock::now();
+            double timestamp = std::chrono::duration<double>(now - start_time_).count();
 
-        auto now = std::chrono::steady_clock::now();
-        double timestamp = std::chrono::duration<double>(now - start_time_).count();
+            PushFrame(timestamp, values, num_channels);
+            rate_meter_.Record(timestamp, total_frames_);
+        }
+        PublishSnapshotIfRequested();
+    }
+
+    /**
+     * @brief 批量添加多帧数据（整批只加锁一次，校验帧顺序）
+     * @param frames 平铺数据数组（frame_count × channels，第f帧第c通道为frames[f * channels + c]）
+     * @param frame_count 帧数
+     * @param channels 每帧通道数
+     * @param stream_position 这批帧在接收字节流中的结束位置（由入口分配的数据块位置
+     *                        加块内偏移得到，应严格递增，否则计为顺序错误）
+     *
+     * 一批帧通常来自同一次读取，时间戳在上一次写入与当前时刻之间均匀分布
+     * （间隔最多按MAX_BATCH_SPAN计算），避免同一批次的点堆叠在同一时刻。
+     * 时间戳间隔因此随读取分块变化，采样率应使用快照的frame_rate。
+     */
+    void PushFrames(const float* frames, size_t frame_count, size_t channels, uint64_t stream_position) {
+        if (frame_count == 0) return;
+        const size_t push_channels = (channels > MAX_CHANNELS) ? MAX_CHANNELS : channels;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
 
-        for (size_t i = 0; i < num_channels; i++) {
-            buffers_[i].Push(DataPoint(timestamp, values[i]));
-            UpdateStats(i, values[i]);
+            if (order_stats_.frames_pushed > 0 && stream_position <= order_stats_.last_stream_position) {
+                order_stats_.order_violations++;
+            }
+            order_stats_.last_stream_position = stream_position;
+            order_stats_.frames_pushed += frame_count;
+
+            auto now = std::chrono::steady_clock::now();
+            double timestamp = std::chrono::duration<double>(now - start_time_).count();
+            double span = timestamp - last_push_timestamp_;
+            if (span > MAX_BATCH_SPAN || span < 0.0) {
+                span = MAX_BATCH_SPAN;
+            }
+            double step = span / static_cast<double>(frame_count);
+            double frame_time = timestamp - span;
+            last_push_timestamp_ = timestamp;
+
+            for (size_t start = 0; start < frame_count; start += PUSH_CHUNK) {
+                size_t n = std::min(frame_count - start, PUSH_CHUNK);
+                for (size_t f = 0; f < n; f++) {
+                    frame_time += step;
+                    push_times_[f] = frame_time;
+                }
+                PushBlock(push_times_.data(), frames + start * channels, n, channels, push_channels);
+            }
+            rate_meter_.Record(timestamp, total_frames_);
+        }
+        PublishSnapshotIfRequested();
+    }
+
+    /**
+     * @brief 获取最新快照（仅UI线程调用，每帧一次）
+     *
+     * 返回上一次写入时发布的快照，并请求写者在下一次写入时发布新快照。
+     * 返回的引用在下一次AcquireSnapshot()之前有效且不会被修改。
+     */
+    const ChannelSnapshot& AcquireSnapshot() {
+        snapshots_.Update();
+        snapshot_acquires_.fetch_add(1, std::memory_order_relaxed);
+        snapshot_requested_.store(true, std::memory_order_relaxed);
+        return snapshots_.GetReadBuffer();
+    }
+
+    /**
+     * @brief 请求快照包含某通道最近frames帧的数值（仅UI线程调用）
+     * @param channel_index 通道索引
+     * @param frames 帧数（最多SNAPSHOT_FRAMES）
+     *
+     * 快照默认不拷贝数值（波形图通过RequestWaveform绘制）；需要原始样本的
+     * 组件每帧为所用通道请求一次，从下一次发布的快照起生效。同一通道的多个请求
+     * 取最大长度；连续两次AcquireSnapshot()都没有续期的请求失效。
+     * 请求打包在一个原子变量中（见PackRequest），不加锁。
+     */
+    void RequestSnapshotValues(size_t channel_index, size_t frames) {
+        if (channel_index >= MAX_CHANNELS || frames == 0) return;
+        frames = std::min(frames, SNAPSHOT_FRAMES);
+        const uint64_t acquire = snapshot_acquires_.load(std::memory_order_relaxed) & REQUEST_ACQUIRE_MASK;
+
+        // 只有UI线程写入，读-改-写不需要CAS
+        std::atomic<uint64_t>& slot = value_requests_[channel_index];
+        const uint64_t packed = slot.load(std::memory_order_relaxed);
+        const uint64_t request_acquire = packed >> (2 * REQUEST_FRAME_BITS);
+        const size_t request_frames = static_cast<size_t>(packed & REQUEST_FRAME_MASK);
+        if (request_acquire == acquire) {
+            slot.store(PackRequest(acquire, std::max(request_frames, frames),
+                                   static_cast<size_t>((packed >> REQUEST_FRAME_BITS) & REQUEST_FRAME_MASK)),
+                       std::memory_order_relaxed);
+        } else {
+            // 新的一帧：上一帧的请求保留到本帧的请求都续期为止
+            size_t previous = (((request_acquire + 1) & REQUEST_ACQUIRE_MASK) == acquire) ? request_frames : 0;
+            slot.store(PackRequest(acquire, frames, previous), std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief 登记一个波形绘图组件（仅UI线程调用，组件创建时一次）
+     * @return 波形状态，由组件持有；组件销毁（释放最后一个引用）后自动注销
+     */
+    std::shared_ptr<WaveformState> AddWaveform() {
+        auto state = std::make_shared<WaveformState>();
+        state->id = ++waveform_ids_;
+        std::lock_guard<std::mutex> lock(waveform_mutex_);
+        waveforms_.push_back(state);
+        return state;
+    }
+
+    /**
+     * @brief 提交波形请求（仅UI线程调用，每帧一次，不加锁）
+     * @param state AddWaveform()返回的波形状态
+     * @param request 通道、降采样方式、分段数和时间窗口
+     *
+     * 发布者在下一次发布快照时按请求降采样，结果通过ChannelSnapshot::FindWaveform()读取。
+     * 与数值请求一样，连续两次AcquireSnapshot()都没有续期的请求失效（降采样缓存释放）。
+     * 请求变化而没有写入时，由空闲发布线程在IDLE_PUBLISH_MS内发布。
+     */
+    void RequestWaveform(WaveformState& state, const WaveformRequest& request) {
+        WaveformState::Pending& pending = state.requests.GetWriteBuffer();
+        pending.request = request;
+        pending.acquire = snapshot_acquires_.load(std::memory_order_relaxed);
+        state.requests.Publish();
+        if (!(request == state.submitted)) {
+            state.submitted = request;
+            waveforms_changed_.store(true, std::memory_order_release);
         }
     }
 
+    /**
+     * @brief 获取本帧已获取的快照（仅UI线程调用，不更新）
+     */
+    const ChannelSnapshot& GetSnapshot() const {
+        return snapshots_.GetReadBuffer();
+    }
+
+    /**
+     * @brief 获取帧顺序统计（加锁，UI使用快照中的order_stats）
+     */
+    FrameOrderStats GetFrameOrderStats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return order_stats_;
+    }
+
     /**
      * @brief 获取通道数据用于绘图
      * @param channel_index 通道索引
@@ -111,10 +542,21 @@ public:
                          std::vector<double>& timestamps,
                          std::vector<float>& y_values,
                          size_t max_points = 0) {
-        if (channel_index >= MAX_CHANNELS) return 0;
-
         std::lock_guard<std::mutex> lock(mutex_);
-        return buffers_[channel_index].GetXYValues(timestamps, y_values, max_points);
+        if (channel_index >= column_count_) return 0;
+        size_t count = GetValidCount(channel_index);
+        size_t first = timestamps_.Size() - count;
+        size_t offset = GetColumnOffset(channel_index);
+        size_t num_points = (max_points > 0 && max_points < count) ? max_points : count;
+        size_t step = (num_points < count) ? (count / num_points) : 1;
+
+        timestamps.resize(num_points);
+        y_values.resize(num_points);
+        for (size_t i = 0; i < num_points; i++) {
+            timestamps[i] = timestamps_.Get(first + i * step);
+            y_values[i] = columns_[channel_index].Get(first - offset + i * step);
+        }
+        return num_points;
     }
 
     /**
@@ -127,46 +569,121 @@ public:
     size_t GetChannelYValues(size_t channel_index,
                             std::vector<float>& y_values,
                             size_t max_points = 0) {
-        if (channel_index >= MAX_CHANNELS) return 0;
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (channel_index >= column_count_) return 0;
+        size_t count = GetValidCount(channel_index);
+        size_t first = timestamps_.Size() - count;
+        size_t offset = GetColumnOffset(channel_index);
+        size_t num_points = (max_points > 0 && max_points < count) ? max_points : count;
+        size_t step = (num_points < count) ? (count / num_points) : 1;
+
+        y_values.resize(num_points);
+        for (size_t i = 0; i < num_points; i++) {
+            y_values[i] = columns_[channel_index].Get(first - offset + i * step);
+        }
+        return num_points;
+    }
+
+    /**
+     * @brief 获取时间范围[t0, t1]内的全部原始数据
+     * @param channel_index 通道索引
+     * @param t0 起始时间（秒，含）
+     * @param t1 结束时间（秒，含）
+     * @param timestamps 输出时间戳数组
+     * @param y_values 输出Y值数组
+     * @return 实际点数
+     *
+     * 时间戳单调递增，二分查找定位区间后按段拷贝，耗时O(log n + 输出点数)。
+     * 持锁拷贝，供导出等非绘制路径使用；UI绘制使用ChannelSnapshot::GetChannelRange()
+     */
+    size_t GetChannelRange(size_t channel_index, double t0, double t1,
+                           std::vector<double>& timestamps, std::vector<float>& y_values) {
+        timestamps.clear();
+        y_values.clear();
 
         std::lock_guard<std::mutex> lock(mutex_);
-        return buffers_[channel_index].GetYValues(y_values, max_points);
+        if (channel_index >= column_count_) return 0;
+        size_t first = timestamps_.Size() - GetValidCount(channel_index);
+        size_t start;
+        size_t length = timestamps_.FindRange(t0, t1, start);
+        if (start < first) {
+            size_t skip = std::min(first - start, length);
+            start += skip;
+            length -= skip;
+        }
+        if (length == 0) return 0;
+
+        timestamps.resize(length);
+        y_values.resize(length);
+        timestamps_.CopyTo(start, length, timestamps.data());
+        columns_[channel_index].CopyTo(start - GetColumnOffset(channel_index), length, y_values.data());
+        return length;
     }
 
     /**
      * @brief 获取通道最新值
      */
     float GetLatestValue(size_t channel_index) {
-        if (channel_index >= MAX_CHANNELS) return 0.0f;
-
         std::lock_guard<std::mutex> lock(mutex_);
-        if (buffers_[channel_index].Empty()) {
+        if (GetValidCount(channel_index) == 0) {
             return 0.0f;
         }
-        return buffers_[channel_index].GetLatest().value;
+        return columns_[channel_index].GetLatest();
     }
 
     /**
      * @brief 清空指定通道
      */
     void ClearChannel(size_t channel_index) {
-        if (channel_index >= MAX_CHANNELS) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (channel_index >= configs_.size()) return;
+            ClearChannelData(channel_index);
+        }
+        PublishSnapshot();
+    }
 
-        std::lock_guard<std::mutex> lock(mutex_);
-        buffers_[channel_index].Clear();
-        stats_[channel_index].Reset();
+    /**
+     * @brief 恢复通道的默认配置（名称、颜色、缩放，保留启用状态）并清空数据
+     *
+     * 用于不再作为派生通道（如滤波输出）的通道
+     */
+    void ResetChannel(size_t channel_index) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (channel_index >= configs_.size()) return;
+            bool enabled = configs_[channel_index].enabled;
+            configs_[channel_index] = MakeDefaultConfig(channel_index);
+            configs_[channel_index].enabled = enabled;
+            ClearChannelData(channel_index);
+        }
+        PublishSnapshot();
     }
 
     /**
      * @brief 清空所有通道
      */
     void ClearAll() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        for (size_t i = 0; i < MAX_CHANNELS; i++) {
-            buffers_[i].Clear();
-            stats_[i].Reset();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            timestamps_.Clear();
+            clear_count_++;
+            data_epoch_++;
+            for (size_t i = 0; i < configs_.size(); i++) {
+                columns_[i].Clear();
+                stats_[i].Reset();
+                sketches_[i].Reset();
+                first_frame_[i] = 0;
+                last_frame_[i] = 0;
+            }
+            column_count_ = 0;
+            total_frames_ = 0;
+            order_stats_ = FrameOrderStats();
+            last_push_timestamp_ = 0.0;
+            rate_meter_.Reset();
+            start_time_ = std::chrono::steady_clock::now();
         }
-        start_time_ = std::chrono::steady_clock::now();
+        PublishSnapshot();
     }
 
     /**
@@ -175,17 +692,20 @@ public:
     void SetChannelConfig(size_t channel_index, const ChannelConfig& config) {
         if (channel_index >= MAX_CHANNELS) return;
 
-        std::lock_guard<std::mutex> lock(mutex_);
-        configs_[channel_index] = config;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            EnsureChannels(channel_index + 1);
+            configs_[channel_index] = config;
+        }
+        PublishSnapshot();
     }
 
     /**
-     * @brief 获取通道配置
+     * @brief 获取通道配置（通道尚未创建时返回其默认配置）
      */
     ChannelConfig GetChannelConfig(size_t channel_index) {
-        if (channel_index >= MAX_CHANNELS) return ChannelConfig();
-
         std::lock_guard<std::mutex> lock(mutex_);
+        if (channel_index >= configs_.size()) return MakeDefaultConfig(channel_index);
         return configs_[channel_index];
     }
 
@@ -195,38 +715,93 @@ public:
     void SetChannelEnabled(size_t channel_index, bool enabled) {
         if (channel_index >= MAX_CHANNELS) return;
 
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (channel_index >= configs_.size()) {
+                if (!enabled) return;
+                EnsureChannels(channel_index + 1);
+            }
+            if (configs_[channel_index].enabled == enabled) return;
+            configs_[channel_index].enabled = enabled;
+        }
+        PublishSnapshot();
+    }
+
+    /**
+     * @brief 设置通道数：启用前count个通道（按需创建），禁用其余通道
+     * @param count 通道数（不超过MAX_CHANNELS）
+     *
+     * 整体只加锁、发布快照一次，通道数很多时不必逐个调用SetChannelEnabled()
+     */
+    void SetChannelCount(size_t count) {
+        count = std::min(count, MAX_CHANNELS);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            EnsureChannels(count);
+            for (size_t i = 0; i < configs_.size(); i++) {
+                configs_[i].enabled = (i < count);
+            }
+        }
+        PublishSnapshot();
+    }
+
+    /**
+     * @brief 已创建的通道数（含未启用的）
+     */
+    size_t GetChannelCount() {
         std::lock_guard<std::mutex> lock(mutex_);
-        configs_[channel_index].enabled = enabled;
+        return configs_.size();
     }
 
     /**
      * @brief 判断通道是否启用
      */
     bool IsChannelEnabled(size_t channel_index) {
-        if (channel_index >= MAX_CHANNELS) return false;
-
         std::lock_guard<std::mutex> lock(mutex_);
-        return configs_[channel_index].enabled;
+        return channel_index < configs_.size() && configs_[channel_index].enabled;
     }
 
     /**
      * @brief 获取通道统计信息
      */
     ChannelStats GetChannelStats(size_t channel_index) {
-        if (channel_index >= MAX_CHANNELS) return ChannelStats();
-
         std::lock_guard<std::mutex> lock(mutex_);
-        return stats_[channel_index];
+        if (channel_index >= stats_.size()) return ChannelStats();
+        return MakeStats(channel_index);
+    }
+
+    /**
+     * @brief 设置统计窗口长度（所有通道，清空窗口统计，全程统计保留）
+     * @param window 样本数（限制在WindowedStats::MIN_WINDOW~MAX_WINDOW）
+     */
+    void SetStatsWindow(size_t window) {
+        window = WindowedStats::ClampWindow(window);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (window == stats_window_.load(std::memory_order_relaxed)) return;
+            stats_window_.store(window, std::memory_order_relaxed);
+            for (WindowedStats& stats : stats_) {
+                stats.SetWindow(window);
+            }
+        }
+        PublishSnapshot();
+    }
+
+    /**
+     * @brief 统计窗口长度（样本，不加锁）
+     */
+    size_t GetStatsWindow() const {
+        return stats_window_.load(std::memory_order_relaxed);
     }
 
     /**
      * @brief 获取通道数据点数量
      */
     size_t GetChannelSize(size_t channel_index) {
-        if (channel_index >= MAX_CHANNELS) return 0;
-
         std::lock_guard<std::mutex> lock(mutex_);
-        return buffers_[channel_index].Size();
+        return GetValidCount(channel_index);
     }
 
     /**
@@ -236,7 +811,7 @@ public:
         std::lock_guard<std::mutex> lock(mutex_);
 
         std::vector<size_t> enabled;
-        for (size_t i = 0; i < MAX_CHANNELS; i++) {
+        for (size_t i = 0; i < configs_.size(); i++) {
             if (configs_[i].enabled) {
                 enabled.push_back(i);
             }
@@ -245,12 +820,539 @@ public:
     }
 
 private:
+    // 快照数值请求打包为一个uint64：低20位为本帧请求的最大长度，其次20位为上一帧的，
+    // 高24位为请求时的AcquireSnapshot()次数（取模比较）
+    static constexpr unsigned REQUEST_FRAME_BITS = 20;
+    static constexpr uint64_t REQUEST_FRAME_MASK = (uint64_t(1) << REQUEST_FRAME_BITS) - 1;
+    static constexpr uint64_t REQUEST_ACQUIRE_MASK = (uint64_t(1) << (64 - 2 * REQUEST_FRAME_BITS)) - 1;
+    static_assert(SNAPSHOT_FRAMES <= REQUEST_FRAME_MASK, "snapshot request does not fit the packed field");
+
+    /**
+     * @brief 发布者缓存的分位数（草图样本数变化时在锁内拷贝草图，锁外查询）
+     */
+    struct QuantileCache {
+        QuantileSketch sketch;          // 草图副本
+        uint64_t count = 0;             // 副本对应的样本数
+        uint64_t epoch = 0;             // 副本对应的数据代次（清空后样本数可能相同）
+        bool valid = false;             // 已拷贝过
+        bool dirty = false;             // 已拷贝、尚未查询
+        ChannelStats quantiles;         // 查询结果（只使用p50/p95/p99/p999）
+    };
+
+    static uint64_t PackRequest(uint64_t acquire, size_t frames, size_t previous_frames) {
+        return (acquire << (2 * REQUEST_FRAME_BITS)) |
+               (static_cast<uint64_t>(previous_frames) << REQUEST_FRAME_BITS) |
+               static_cast<uint64_t>(frames);
+    }
+
+    /**
+     * @brief 通道当前有效的请求长度（不加锁）
+     */
+    size_t GetRequestedFrames(size_t channel_index, uint64_t acquire) const {
+        const uint64_t packed = value_requests_[channel_index].load(std::memory_order_relaxed);
+        const uint64_t request_acquire = packed >> (2 * REQUEST_FRAME_BITS);
+        const size_t frames = static_cast<size_t>(packed & REQUEST_FRAME_MASK);
+        acquire &= REQUEST_ACQUIRE_MASK;
+        if (request_acquire == acquire) {
+            return std::max(frames, static_cast<size_t>((packed >> REQUEST_FRAME_BITS) & REQUEST_FRAME_MASK));
+        }
+        return (((request_acquire + 1) & REQUEST_ACQUIRE_MASK) == acquire) ? frames : 0;
+    }
+
+    /**
+     * @brief 清空一个通道的数据和统计（调用者持有mutex_）
+     */
+    void ClearChannelData(size_t channel_index) {
+        // 列与时间戳保持对齐：不删除数据，只把有效起点移到当前帧
+        first_frame_[channel_index] = total_frames_;
+        stats_[channel_index].Reset();
+        sketches_[channel_index].Reset();
+        data_epoch_++;
+    }
+
+    /**
+     * @brief UI请求过快照时发布（写入之后、释放mutex_后调用）
+     */
+    void PublishSnapshotIfRequested() {
+        if (snapshot_requested_.load(std::memory_order_relaxed) &&
+            snapshot_requested_.exchange(false, std::memory_order_relaxed)) {
+            PublishSnapshot();
+        }
+    }
+
+    /**
+     * @brief 生成并发布快照（调用者不得持有mutex_）
+     *
+     * 多个线程（写者、配置修改、调整线程、空闲发布线程）可能同时发布，
+     * 由publish_mutex_串行化（加锁顺序：publish_mutex_ → mutex_）。
+     * 持mutex_时只做拷贝（CaptureSnapshot），分位数和波形在锁外完成（FinishSnapshot）。
+     * 槽位中的vector容量跨帧复用，稳定后不再分配内存
+     */
+    void PublishSnapshot() {
+        std::lock_guard<std::mutex> publish_lock(publish_mutex_);
+        const uint64_t acquire = snapshot_acquires_.load(std::memory_order_relaxed);
+        CollectWaveforms(acquire);
+
+        ChannelSnapshot& snapshot = snapshots_.GetWriteBuffer();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            CaptureSnapshot(snapshot, acquire);
+        }
+        FinishSnapshot(snapshot);
+        active_waveforms_.clear();
+        snapshots_.Publish();
+    }
+
+    /**
+     * @brief 取出本次发布要计算的波形请求（调用者持有publish_mutex_）
+     *
+     * 组件已销毁的登记被移除；连续两次AcquireSnapshot()都没有续期的请求跳过，
+     * 其降采样缓存释放。
+     */
+    void CollectWaveforms(uint64_t acquire) {
+        std::lock_guard<std::mutex> lock(waveform_mutex_);
+        size_t kept = 0;
+        for (size_t i = 0; i < waveforms_.size(); i++) {
+            std::shared_ptr<WaveformState> state = waveforms_[i].lock();
+            if (!state) continue;
+            waveforms_[kept++] = waveforms_[i];
+
+            state->requests.Update();
+            const WaveformState::Pending& pending = state->requests.GetReadBuffer();
+            if (pending.acquire + 1 < acquire) {
+                std::vector<Downsampler>().swap(state->downsamplers);
+                continue;
+            }
+            // 降采样器按通道索引（锁外分配）
+            for (size_t channel : pending.request.channels) {
+                if (channel < MAX_CHANNELS && channel >= state->downsamplers.size()) {
+                    state->downsamplers.resize(channel + 1);
+                }
+            }
+            active_waveforms_.push_back(std::move(state));
+        }
+        waveforms_.resize(kept);
+    }
+
+    /**
+     * @brief 拷贝当前状态到写者槽位（调用者持有publish_mutex_和mutex_）
+     */
+    void CaptureSnapshot(ChannelSnapshot& snapshot, uint64_t acquire) {
+        snapshot.version = ++snapshot_version_;
+        snapshot.frames_pushed = order_stats_.frames_pushed;
+        snapshot.capacity = timestamps_.GetCapacity();
+        snapshot.stored_frames = timestamps_.Size();
+        snapshot.memory_bytes = GetMemoryUsage();
+        snapshot.frame_rate = rate_meter_.GetRate();
+        snapshot.order_stats = order_stats_;
+
+        // 时间戳覆盖最长的数值请求（至少SNAPSHOT_TIMESTAMPS帧）
+        size_t window = SNAPSHOT_TIMESTAMPS;
+        for (size_t i = 0; i < configs_.size(); i++) {
+            window = std::max(window, GetRequestedFrames(i, acquire));
+        }
+        window = std::min(timestamps_.Size(), window);
+        size_t start = timestamps_.Size() - window;
+        snapshot.timestamps.resize(window);
+        timestamps_.CopyTo(start, window, snapshot.timestamps.data());
+        snapshot.channels.resize(configs_.size());
+        if (quantiles_.size() < configs_.size()) {
+            quantiles_.resize(configs_.size());
+        }
+        for (size_t i = 0; i < configs_.size(); i++) {
+            ChannelView& view = snapshot.channels[i];
+            view.config = configs_[i];
+            view.stats = stats_[i].GetStats();
+
+            // 分位数：草图有新样本时拷贝状态，查询留到锁外
+            QuantileCache& cache = quantiles_[i];
+            const uint64_t count = sketches_[i].GetCount();
+            if (!cache.valid || cache.count != count || cache.epoch != data_epoch_) {
+                sketches_[i].CopyTo(cache.sketch);
+                cache.count = count;
+                cache.epoch = data_epoch_;
+                cache.valid = true;
+                cache.dirty = true;
+            }
+
+            // 只为已请求的启用通道拷贝请求的长度
+            size_t requested = configs_[i].enabled ? GetRequestedFrames(i, acquire) : 0;
+            size_t valid = std::min(std::min(GetValidCount(i), window), requested);
+            if (valid > 0) {
+                // 只拷贝有效部分，first_index之前的内容无意义
+                view.values.resize(window);
+                columns_[i].CopyTo(columns_[i].Size() - valid, valid, view.values.data() + window - valid);
+                view.first_index = window - valid;
+            } else {
+                view.values.clear();
+                view.first_index = 0;
+            }
+        }
+
+        // 波形：读取新分段和窗口两端的分段（跟随模式的窗口以本快照的最新时间戳为终点）
+        const double latest = timestamps_.Empty() ? 0.0 : timestamps_.GetLatest();
+        for (const std::shared_ptr<WaveformState>& state : active_waveforms_) {
+            const WaveformRequest& request = state->requests.GetReadBuffer().request;
+            double t_begin = request.follow ? latest - request.span : request.t_begin;
+            double t_end = request.follow ? latest : request.t_end;
+            for (size_t channel : request.channels) {
+                if (channel >= configs_.size() || !configs_[channel].enabled) continue;
+                Downsampler& downsampler = state->downsamplers[channel];
+                downsampler.SetMode(request.mode);
+                PrepareDownsampled(channel, t_begin, t_end, request.max_buckets, downsampler);
+            }
+        }
+    }
+
+    /**
+     * @brief 锁外完成快照：分位数查询、波形输出（调用者持有publish_mutex_）
+     */
+    void FinishSnapshot(ChannelSnapshot& snapshot) {
+        for (size_t i = 0; i < snapshot.channels.size(); i++) {
+            QuantileCache& cache = quantiles_[i];
+            if (cache.dirty) {
+                cache.quantiles = ChannelStats();
+                FillQuantiles(cache.sketch, cache.quantiles);
+                cache.dirty = false;
+            }
+            ChannelStats& stats = snapshot.channels[i].stats;
+            stats.p50 = cache.quantiles.p50;
+            stats.p95 = cache.quantiles.p95;
+            stats.p99 = cache.quantiles.p99;
+            stats.p999 = cache.quantiles.p999;
+        }
+
+        snapshot.waveforms.resize(active_waveforms_.size());
+        for (size_t w = 0; w < active_waveforms_.size(); w++) {
+            WaveformState& state = *active_waveforms_[w];
+            const WaveformRequest& request = state.requests.GetReadBuffer().request;
+            WaveformData& waveform = snapshot.waveforms[w];
+            waveform.id = state.id;
+            waveform.series.resize(request.channels.size());
+            for (size_t k = 0; k < request.channels.size(); k++) {
+                const size_t channel = request.channels[k];
+                WaveformSeries& series = waveform.series[k];
+                series.channel = channel;
+                if (channel >= snapshot.channels.size() || !snapshot.channels[channel].config.enabled) {
+                    series.timestamps.clear();
+                    series.values.clear();
+                    continue;
+                }
+                Downsampler& downsampler = state.downsamplers[channel];
+                downsampler.Finish();
+                series.timestamps.assign(downsampler.GetTimestamps().begin(), downsampler.GetTimestamps().end());
+                series.values.assign(downsampler.GetValues().begin(), downsampler.GetValues().end());
+            }
+        }
+    }
+
+    /**
+     * @brief 读取时间窗口内降采样所需的分段（调用者持有mutex_，输出由downsampler.Finish()组装）
+     *
+     * 窗口两侧各多取一帧，折线延伸到绘图区边缘。耗时与新计算的分段数成正比，
+     * 与窗口内的原始帧数无关。
+     */
+    void PrepareDownsampled(size_t channel_index, double t_begin, double t_end, size_t max_buckets,
+                            Downsampler& downsampler) {
+        size_t count = GetValidCount(channel_index);
+        if (count == 0 || !(t_begin < t_end)) {
+            downsampler.ClearOutput();
+            return;
+        }
+
+        // 时间戳单调递增，二分查找窗口对应的下标区间，两侧各多取一帧
+        size_t first = timestamps_.Size() - count;
+        size_t start;
+        size_t length = timestamps_.FindRange(t_begin, t_end, start);
+        size_t begin = std::max(start, first + 1) - 1;
+        size_t end = std::min(start + length + 1, timestamps_.Size());
+
+        const uint64_t oldest_frame = total_frames_ - timestamps_.Size();
+        DownsampleSource source{timestamps_, columns_[channel_index], pyramids_[channel_index],
+                                oldest_frame, oldest_frame + first, total_frames_, data_epoch_};
+        downsampler.Prepare(source, oldest_frame + begin, oldest_frame + end, max_buckets);
+    }
+
+    /**
+     * @brief 空闲发布线程：没有写入时发布波形请求的变化（平移、缩放、切换通道）
+     */
+    void IdlePublisher() {
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+        while (!idle_stop_) {
+            idle_cv_.wait_for(lock, std::chrono::milliseconds(IDLE_PUBLISH_MS));
+            if (idle_stop_) break;
+            if (waveforms_changed_.load(std::memory_order_acquire) &&
+                waveforms_changed_.exchange(false, std::memory_order_acq_rel)) {
+                lock.unlock();
+                PublishSnapshot();
+                lock.lock();
+            }
+        }
+    }
+
+    /**
+     * @brief 写入一帧（调用者持有mutex_）
+     * @param timestamp 帧时间戳
+     * @param row 各通道数值（NaN表示该帧没有此通道）
+     * @param width 帧宽度（通道数）
+     */
+    void PushFrame(double timestamp, const float* row, size_t width) {
+        PushBlock(&timestamp, row, 1, width, width);
+    }
+
+    /**
+     * @brief 按列写入连续的n帧（调用者持有mutex_）
+     * @param timestamps 各帧时间戳
+     * @param rows 平铺数据（第f帧第c通道为rows[f * stride + c]）
+     * @param n 帧数（不超过PUSH_CHUNK）
+     * @param stride 每帧的元素个数
+     * @param width 帧宽度（通道数，不超过stride）
+     *
+     * 每列先把本块的值抽取到连续数组，再一次写入数值列、金字塔和统计，
+     * 然后从两端找到本块第一个和最后一个有效值，整块更新有效范围。
+     * n不超过MIN_CAPACITY，块内第一个有效值之后的帧不会被覆盖，
+     * 因此只需用第一个有效值判断有效范围是否重新开始，结果与逐帧写入相同。
+     */
+    void PushBlock(const double* timestamps, const float* rows, size_t n, size_t stride, size_t width) {
+        // 帧变宽：创建新列（与时间戳列尾部对齐，从本块开始写入）
+        if (width > column_count_) {
+            EnsureChannels(width);
+            for (size_t c = column_count_; c < width; c++) {
+                if (columns_[c].GetCapacity() != timestamps_.GetCapacity()) {
+                    columns_[c].SetCapacity(timestamps_.GetCapacity());
+                    pyramids_[c].SetCapacity(timestamps_.GetCapacity());
+                }
+                columns_[c].Clear();
+                pyramids_[c].Reset(total_frames_);
+                first_frame_[c] = total_frames_;
+            }
+            column_count_ = width;
+        }
+
+        const size_t capacity = timestamps_.GetCapacity();
+        const size_t stored = timestamps_.Size();
+        timestamps_.PushBatch(timestamps, n);
+        for (size_t c = 0; c < width; c++) {
+            float* values = push_values_.data();
+            for (size_t f = 0; f < n; f++) {
+                values[f] = rows[f * stride + c];
+            }
+            columns_[c].PushBatch(values, n);
+            pyramids_[c].PushBatch(values, n);
+            stats_[c].PushBatch(values, n);
+            sketches_[c].PushBatch(values, n);
+
+            size_t first = 0;
+            while (first < n && std::isnan(values[first])) first++;
+            if (first == n) continue;
+            size_t last = n - 1;
+            while (std::isnan(values[last])) last--;
+
+            // 写入块内第一个有效值之前缓冲区中最旧的帧号
+            const uint64_t frame = total_frames_ + first;
+            const uint64_t oldest_frame = frame - std::min(capacity, stored + first);
+            // 缓冲区内没有此通道的有效值（新列或中断后恢复）：有效范围从该帧开始
+            if (last_frame_[c] <= std::max<uint64_t>(first_frame_[c], oldest_frame)) {
+                first_frame_[c] = frame;
+            }
+            last_frame_[c] = total_frames_ + last + 1;
+        }
+        // 帧变窄：多出的列填NaN保持对齐
+        for (size_t c = width; c < column_count_; c++) {
+            columns_[c].PushFill(std::numeric_limits<float>::quiet_NaN(), n);
+            pyramids_[c].PushEmpty(n);
+        }
+        total_frames_ += n;
+    }
+
+    /**
+     * @brief 通道的统计结果（含分位数估计，调用者持有mutex_，供加锁的查询接口使用）
+     */
+    ChannelStats MakeStats(size_t channel_index) {
+        ChannelStats stats = stats_[channel_index].GetStats();
+        FillQuantiles(sketches_[channel_index], stats);
+        return stats;
+    }
+
+    /**
+     * @brief 用草图估计分位数（没有样本时保持默认值）
+     */
+    static void FillQuantiles(QuantileSketch& sketch, ChannelStats& stats) {
+        if (sketch.GetCount() > 0) {
+            stats.p50 = static_cast<float>(sketch.Quantile(0.5));
+            stats.p95 = static_cast<float>(sketch.Quantile(0.95));
+            stats.p99 = static_cast<float>(sketch.Quantile(0.99));
+            stats.p999 = static_cast<float>(sketch.Quantile(0.999));
+        }
+    }
+
+    /**
+     * @brief 时间戳列下标与数值列下标之差（列比时间戳列晚创建时大于0，调用者持有mutex_）
+     */
+    size_t GetColumnOffset(size_t channel_index) const {
+        return timestamps_.Size() - columns_[channel_index].Size();
+    }
+
+    /**
+     * @brief 通道在缓冲区中的有效帧数（调用者持有mutex_）
+     *
+     * 有效范围从第一个有效值到最新帧；缓冲区内已没有任何有效值时返回0
+     */
+    size_t GetValidCount(size_t channel_index) const {
+        if (channel_index >= column_count_) return 0;
+        uint64_t oldest_frame = total_frames_ - timestamps_.Size();
+        uint64_t first = std::max<uint64_t>(first_frame_[channel_index], oldest_frame);
+        if (last_frame_[channel_index] <= first) return 0;
+        return static_cast<size_t>(total_frames_ - first);
+    }
+
+    /**
+     * @brief 历史缓冲区占用的内存（调用者持有mutex_）
+     */
+    size_t GetMemoryUsage() const {
+        size_t bytes = timestamps_.GetMemoryUsage();
+        for (size_t i = 0; i < column_count_; i++) {
+            bytes += columns_[i].GetMemoryUsage() + pyramids_[i].GetMemoryUsage();
+        }
+        return bytes;
+    }
+
+    /**
+     * @brief 调整线程：依次调整到最新请求的深度，直到与请求一致
+     */
+    void ResizeWorker() {
+        while (true) {
+            size_t capacity;
+            {
+                std::lock_guard<std::mutex> lock(resize_mutex_);
+                capacity = target_capacity_.load();
+                if (capacity == applied_capacity_) {
+                    resizing_.store(false);
+                    return;
+                }
+            }
+            ResizeTo(capacity);
+            std::lock_guard<std::mutex> lock(resize_mutex_);
+            applied_capacity_ = capacity;
+        }
+    }
+
     /**
-     * @brief 初始化所有通道
+     * @brief 后台调整历史深度
+     *
+     * 1. 锁外分配新缓冲区（只保留地址空间，页面在写入时才映射）
+     * 2. 每次持锁拷贝的帧数按所有列合计不超过RESIZE_BYTES字节（时间戳 + 各数值列，
+     *    金字塔累积与数值拷贝等量），期间写入照常进行
+     * 3. 拷贝追上最新帧后在同一次持锁内交换缓冲区
+     * 旧缓冲区在锁外释放，交换后发布快照。
      */
-    void InitializeChannels() {
+    void ResizeTo(size_t capacity) {
+        size_t width;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            width = column_count_;
+        }
+
+        CircularBuffer<double> new_timestamps(capacity);
+        std::vector<CircularBuffer<float>> new_columns(width, CircularBuffer<float>(0));
+        std::vector<MinMaxPyramid> new_pyramids(width);
+        for (size_t c = 0; c < width; c++) {
+            new_columns[c].SetCapacity(capacity);
+            new_pyramids[c].SetCapacity(capacity);
+        }
+        // 每帧至少占一个时间戳，单次拷贝不超过MAX_CHUNK帧
+        static constexpr size_t MAX_CHUNK = RESIZE_BYTES / sizeof(double);
+        std::vector<double> time_chunk(MAX_CHUNK);
+        std::vector<float> value_chunk(MAX_CHUNK);
+
+        uint64_t next = 0;              // 下一个要拷贝的帧号
+        uint64_t clear_count = 0;       // 开始拷贝时的ClearAll()次数
+        bool started = false;
+
+        while (true) {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            // 首次进入、期间被清空或尚未拷贝的帧已被覆盖（新缓冲区必须连续）：从头开始
+            uint64_t oldest_frame = total_frames_ - timestamps_.Size();
+            if (!started || clear_count != clear_count_ || next < oldest_frame) {
+                new_timestamps.Clear();
+                for (CircularBuffer<float>& column : new_columns) {
+                    column.Clear();
+                }
+                next = total_frames_ - std::min(timestamps_.Size(), capacity);
+                clear_count = clear_count_;
+                started = true;
+            }
+
+            // 拷贝期间新增的列
+            if (column_count_ > width) {
+                new_columns.resize(column_count_, CircularBuffer<float>(0));
+                new_pyramids.resize(column_count_);
+                for (size_t c = width; c < column_count_; c++) {
+                    new_columns[c].SetCapacity(capacity);
+                    new_pyramids[c].SetCapacity(capacity);
+                }
+                width = column_count_;
+            }
+
+            size_t chunk = RESIZE_BYTES / (sizeof(double) + column_count_ * sizeof(float));
+            size_t n = static_cast<size_t>(std::min<uint64_t>(total_frames_ - next, std::max<size_t>(chunk, 1)));
+            size_t offset = static_cast<size_t>(next - oldest_frame);
+            timestamps_.CopyTo(offset, n, time_chunk.data());
+            new_timestamps.PushBatch(time_chunk.data(), n);
+            for (size_t c = 0; c < column_count_; c++) {
+                // 列晚于时间戳列创建时，只拷贝列存在之后的帧
+                uint64_t column_start = total_frames_ - columns_[c].Size();
+                uint64_t from = std::max<uint64_t>(next, column_start);
+                if (from < next + n) {
+                    size_t length = static_cast<size_t>(next + n - from);
+                    columns_[c].CopyTo(static_cast<size_t>(from - column_start), length, value_chunk.data());
+                    if (new_columns[c].Empty()) {
+                        new_pyramids[c].Reset(from);
+                    }
+                    new_columns[c].PushBatch(value_chunk.data(), length);
+                    new_pyramids[c].PushBatch(value_chunk.data(), length);
+                }
+            }
+            next += n;
+
+            if (next == total_frames_) {
+                // 已追上：交换缓冲区（尚无数据的通道列容量为0，首次出现时按新容量分配）
+                std::swap(timestamps_, new_timestamps);
+                new_columns.resize(columns_.size(), CircularBuffer<float>(0));
+                new_pyramids.resize(pyramids_.size());
+                columns_.swap(new_columns);
+                pyramids_.swap(new_pyramids);
+                data_epoch_++;
+                break;
+            }
+        }
+        PublishSnapshot();
+    }
+
+    /**
+     * @brief 创建通道直到共有count个（调用者持有mutex_）
+     *
+     * 新通道只有默认配置和空统计，数值列容量为0，首次收到数据时才分配
+     */
+    void EnsureChannels(size_t count) {
+        for (size_t i = configs_.size(); i < count; i++) {
+            configs_.push_back(MakeDefaultConfig(i));
+            stats_.emplace_back(stats_window_.load(std::memory_order_relaxed));
+            sketches_.emplace_back();
+            columns_.emplace_back(0);
+            pyramids_.emplace_back();
+            first_frame_.push_back(0);
+            last_frame_.push_back(0);
+        }
+    }
+
+    /**
+     * @brief 通道的默认配置（前16个通道用预定义颜色，之后按黄金角分布色相）
+     */
+    static ChannelConfig MakeDefaultConfig(size_t channel_index) {
         // 预定义颜色（16种不同颜色）
-        const float colors[MAX_CHANNELS][4] = {
+        static const float colors[16][4] = {
             {1.0f, 0.0f, 0.0f, 1.0f},   // 红
             {0.0f, 1.0f, 0.0f, 1.0f},   // 绿
             {0.0f, 0.0f, 1.0f, 1.0f},   // 蓝
@@ -269,46 +1371,86 @@ private:
             {0.5f, 0.5f, 1.0f, 1.0f}    // 淡蓝
         };
 
-        for (size_t i = 0; i < MAX_CHANNELS; i++) {
-            configs_[i].enabled = false;
-            configs_[i].name = "CH" + std::to_string(i + 1);
-            configs_[i].dataType = DataType::FLOAT;
-            configs_[i].scale = 1.0f;
-            configs_[i].offset = 0.0f;
+        ChannelConfig config;
+        config.enabled = false;
+        config.name = "CH" + std::to_string(channel_index + 1);
+        config.dataType = DataType::FLOAT;
+        config.scale = 1.0f;
+        config.offset = 0.0f;
 
+        if (channel_index < 16) {
             for (int j = 0; j < 4; j++) {
-                configs_[i].color[j] = colors[i][j];
+                config.color[j] = colors[channel_index][j];
+            }
+        } else {
+            // 色相按黄金角（约137.5°）递增，相邻通道颜色差异大；饱和度0.65、亮度0.95
+            float hue = std::fmod(static_cast<float>(channel_index) * 0.381966f, 1.0f) * 6.0f;
+            float x = 1.0f - std::fabs(std::fmod(hue, 2.0f) - 1.0f);
+            float rgb[3];
+            switch (static_cast<int>(hue)) {
+                case 0:  rgb[0] = 1.0f; rgb[1] = x;    rgb[2] = 0.0f; break;
+                case 1:  rgb[0] = x;    rgb[1] = 1.0f; rgb[2] = 0.0f; break;
+                case 2:  rgb[0] = 0.0f; rgb[1] = 1.0f; rgb[2] = x;    break;
+                case 3:  rgb[0] = 0.0f; rgb[1] = x;    rgb[2] = 1.0f; break;
+                case 4:  rgb[0] = x;    rgb[1] = 0.0f; rgb[2] = 1.0f; break;
+                default: rgb[0] = 1.0f; rgb[1] = 0.0f; rgb[2] = x;    break;
+            }
+            for (int j = 0; j < 3; j++) {
+                config.color[j] = 0.95f * (1.0f - 0.65f * (1.0f - rgb[j]));
             }
+            config.color[3] = 1.0f;
         }
+        return config;
     }
 
-    /**
-     * @brief 更新通道统计信息
-     */
-    void UpdateStats(size_t channel_index, float value) {
-        ChannelStats& stats = stats_[channel_index];
+    CircularBuffer<double> timestamps_;                                         // 共享时间戳列（每帧一个）
+    std::vector<CircularBuffer<float>> columns_;                                // 各通道数值列（按需创建）
+    std::vector<MinMaxPyramid> pyramids_;                                       // 各列的最小/最大值金字塔
+    std::vector<uint64_t> first_frame_;                                         // 各列第一个有效值的帧号
+    std::vector<uint64_t> last_frame_;                                          // 各列最后一个有效值的帧号+1
+    size_t column_count_ = 0;                                                   // 已存储的列数（最大帧宽度）
+    uint64_t total_frames_ = 0;                                                 // 累计写入帧数（含已覆盖的）
+    uint64_t clear_count_ = 0;                                                  // ClearAll()次数（调整深度时检测清空）
+    uint64_t data_epoch_ = 0;                                                   // 数据代次（清空、调整深度时递增，降采样缓存据此失效）
+    std::vector<ChannelConfig> configs_;                                        // 通道配置（大小即已创建的通道数）
+    std::vector<WindowedStats> stats_;                                          // 统计信息（全程和滑动窗口）
+    std::atomic<size_t> stats_window_{WindowedStats::DEFAULT_WINDOW};           // 统计窗口长度（样本，mutex_内修改）
+    std::vector<QuantileSketch> sketches_;                                      // 各通道的分位数草图
+    FrameOrderStats order_stats_;                                               // 帧顺序统计
+    double last_push_timestamp_ = 0.0;                                          // 上一批数据的时间戳
+    FrameRateMeter rate_meter_;                                                 // 接收帧率测量
+    std::vector<double> push_times_ = std::vector<double>(PUSH_CHUNK);          // 批量写入的时间戳暂存
+    std::vector<float> push_values_ = std::vector<float>(PUSH_CHUNK);           // 批量写入时抽取的单列数值
+    mutable std::mutex mutex_;                                                   // 互斥锁（写入、配置）
+    TripleBuffer<ChannelSnapshot> snapshots_;                                   // UI快照（写者发布，UI读取）
+    std::atomic<bool> snapshot_requested_{false};                               // UI已请求新快照
+    std::atomic<uint64_t> snapshot_acquires_{0};                                // AcquireSnapshot()次数（UI帧数）
+    std::array<std::atomic<uint64_t>, MAX_CHANNELS> value_requests_{};          // 各通道的快照数值请求（PackRequest，UI写）
 
-        if (stats.sample_count == 0) {
-            stats.min_value = stats.max_value = stats.avg_value = value;
-            stats.sample_count = 1;
-        } else {
-            // 更新最小/最大值
-            if (value < stats.min_value) stats.min_value = value;
-            if (value > stats.max_value) stats.max_value = value;
+    // 快照发布（publish_mutex_保护）
+    std::mutex publish_mutex_;                                                  // 串行化发布者（先于mutex_获取）
+    uint64_t snapshot_version_ = 0;                                             // 已发布的快照版本
+    std::vector<QuantileCache> quantiles_;                                      // 各通道的分位数缓存
+    std::vector<std::shared_ptr<WaveformState>> active_waveforms_;              // 本次发布计算的波形
 
-            // 更新平均值（增量式）
-            stats.avg_value = (stats.avg_value * stats.sample_count + value) / (stats.sample_count + 1);
-            stats.sample_count++;
-        }
+    // 波形请求
+    std::mutex waveform_mutex_;                                                 // 保护登记表（只在登记和取请求时短暂持有）
+    std::vector<std::weak_ptr<WaveformState>> waveforms_;                       // 已登记的波形（组件持有状态）
+    std::atomic<uint64_t> waveform_ids_{0};                                     // 已分配的波形编号
+    std::atomic<bool> waveforms_changed_{false};                                // 有波形请求变化尚未发布
 
-        // 更新最后一个值
-        stats.last_value = value;
-    }
+    // 空闲发布线程
+    std::mutex idle_mutex_;                                                     // 保护idle_stop_
+    std::condition_variable idle_cv_;                                           // 析构时唤醒
+    bool idle_stop_ = false;                                                    // 请求退出
+    std::thread idle_thread_;                                                   // 空闲发布线程
 
-    std::array<CircularBuffer<DataPoint, BUFFER_SIZE>, MAX_CHANNELS> buffers_;  // 16个缓冲区
-    std::array<ChannelConfig, MAX_CHANNELS> configs_;                           // 16个通道配置
-    std::array<ChannelStats, MAX_CHANNELS> stats_;                              // 16个统计信息
-    mutable std::mutex mutex_;                                                   // 互斥锁
+    // 历史深度调整
+    std::mutex resize_mutex_;                                                   // 保护调整线程的启动与退出
+    std::thread resize_thread_;                                                 // 调整线程
+    std::atomic<bool> resizing_{false};                                         // 是否正在调整
+    std::atomic<size_t> target_capacity_{DEFAULT_CAPACITY};                     // 最近一次请求的历史深度
+    size_t applied_capacity_ = DEFAULT_CAPACITY;                                // 已完成调整的历史深度（resize_mutex_保护）
     std::chrono::steady_clock::time_point start_time_;                          // 起始时间
 };
 
@@ -0,0 +1,418 @@
+/**
+ * @file Downsampler.h
+ * @brief 波形降采样器 - 等间隔、最小/最大值、M4、LTTB四种模式，增量更新
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 可见窗口按全局帧号对齐划分为等宽分段（段宽为2的幂，缩放一倍以上才变化），
+ * 每段按模式输出若干点：
+ * - 等间隔：每段第一个有效点（原有的抽取方式）
+ * - 最小/最大值：每段的最小值和最大值，按出现顺序
+ * - M4：每段的第一个、最小、最大、最后一个点（每个像素列的绘制结果与原始数据一致）
+ * - LTTB（Largest-Triangle-Three-Buckets）：每段选出与上一段已选点、
+ *   下一段均值点构成的三角形面积最大的点，视觉上最接近原始曲线；
+ *   候选点取自金字塔中各子段的最小/最大值（MinMax预选），
+ *   计算量与输出点数成正比，不随窗口内原始帧数增长
+ *
+ * 增量更新：已完成的分段结果缓存起来，每帧只计算新到达的分段和末尾未完成的分段；
+ * 段宽、模式或数据代次（清空、调整历史深度）变化时缓存失效。
+ * 缓存和输出数组跨帧复用，窗口大小稳定后每帧不再分配内存。
+ *
+ * 更新分两步：Prepare()读取数据（计算新分段和窗口两端未缓存的分段，或拷贝原始数据），
+ * 需要数据锁；Finish()只用缓存组装输出，可在锁外进行。Update()依次调用两者。
+ * 每个降采样器对应一个绘图组件的一个通道，由快照发布者独占使用。
+ */
+
+#ifndef DOWNSAMPLER_H
+#define DOWNSAMPLER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "CircularBuffer.h"
+#include "MinMaxPyramid.h"
+
+/**
+ * @brief 降采样模式
+ */
+enum class DownsampleMode {
+    STRIDE,     // 等间隔抽取
+    MINMAX,     // 最小/最大值
+    M4,         // 第一个/最小/最大/最后一个
+    LTTB        // 最大三角形三桶
+};
+
+/**
+ * @brief 获取降采样模式名称
+ */
+inline const char* GetDownsampleModeName(DownsampleMode mode) {
+    switch (mode) {
+        case DownsampleMode::STRIDE: return "等间隔";
+        case DownsampleMode::MINMAX: return "最小/最大值";
+        case DownsampleMode::M4:     return "M4";
+        case DownsampleMode::LTTB:   return "LTTB";
+        default: return "Unknown";
+    }
+}
+
+/**
+ * @brief 降采样的数据来源（由DataChannelManager在持锁时构造）
+ */
+struct DownsampleSource {
+    const CircularBuffer<double>& timestamps;   // 共享时间戳列
+    const CircularBuffer<float>& column;        // 通道数值列（与时间戳列尾部对齐）
+    const MinMaxPyramid& pyramid;               // 通道的最小/最大值金字塔
+    uint64_t oldest_frame;                      // 时间戳列中最旧的帧
+    uint64_t first_frame;                       // 通道第一个有效帧（不早于oldest_frame）
+    uint64_t end_frame;                         // 最新帧 + 1
+    uint64_t epoch;                             // 数据代次（清空或调整深度时递增）
+
+    double Time(uint64_t frame) const {
+        return timestamps.Get(static_cast<size_t>(frame - oldest_frame));
+    }
+
+    float Value(uint64_t frame) const {
+        return column.Get(static_cast<size_t>(frame - (end_frame - column.Size())));
+    }
+};
+
+/**
+ * @brief 波形降采样器
+ */
+class Downsampler {
+public:
+    static constexpr size_t LTTB_CANDIDATE_SPANS = 8;  // LTTB每段的预选子段数（每个子段取最小/最大值）
+
+    explicit Downsampler(DownsampleMode mode = DownsampleMode::MINMAX)
+        : mode_(mode)
+    {}
+
+    /**
+     * @brief 设置降采样模式（缓存失效）
+     */
+    void SetMode(DownsampleMode mode) {
+        if (mode != mode_) {
+            mode_ = mode;
+            cache_.Clear();
+        }
+    }
+
+    DownsampleMode GetMode() const {
+        return mode_;
+    }
+
+    /**
+     * @brief 更新帧区间[begin, end)的降采样结果（调用者持有数据锁）
+     * @return 输出点数
+     */
+    size_t Update(const DownsampleSource& source, uint64_t begin, uint64_t end, size_t max_buckets) {
+        Prepare(source, begin, end, max_buckets);
+        return Finish();
+    }
+
+    /**
+     * @brief 读取帧区间[begin, end)所需的数据（调用者持有数据锁）
+     * @param source 数据来源
+     * @param begin 起始帧（不早于source.first_frame）
+     * @param end 结束帧（不晚于source.end_frame）
+     * @param max_buckets 最大分段数（通常为绘图区像素宽度）
+     *
+     * 区间内帧数不超过2×max_buckets时直接拷贝原始数据。之后调用Finish()取得输出。
+     */
+    void Prepare(const DownsampleSource& source, uint64_t begin, uint64_t end, size_t max_buckets) {
+        ClearOutput();
+        if (begin >= end || max_buckets == 0) return;
+
+        if (end - begin <= 2 * static_cast<uint64_t>(max_buckets)) {
+            // 跨越环形缓冲区边界时分两段拷贝
+            size_t count = static_cast<size_t>(end - begin);
+            timestamps_.resize(count);
+            values_.resize(count);
+            source.timestamps.CopyTo(static_cast<size_t>(begin - source.oldest_frame), count, timestamps_.data());
+            source.column.CopyTo(static_cast<size_t>(begin - (source.end_frame - source.column.Size())),
+                                 count, values_.data());
+            return;
+        }
+
+        // 段宽取2的幂：窗口平移或轻微缩放时保持不变，缓存可复用
+        uint64_t width = 1;
+        while (width * max_buckets < end - begin) {
+            width <<= 1;
+        }
+        if (width != width_ || source.epoch != epoch_) {
+            cache_.Clear();
+            width_ = width;
+            epoch_ = source.epoch;
+        }
+        // 缓存只保存窗口内的分段，容量随最大分段数增长（稳定后不再分配）
+        if (cache_.GetCapacity() < max_buckets + 2) {
+            cache_.SetCapacity(max_buckets + 2);
+        }
+
+        // 可缓存的分段：完全在有效数据内，且已完成（LTTB还需要下一段完成）
+        const uint64_t first_segment = begin / width;
+        const uint64_t last_segment = (end - 1) / width;
+        const uint64_t first_cacheable = std::max(first_segment, (source.first_frame + width - 1) / width);
+        const uint64_t lookahead = (mode_ == DownsampleMode::LTTB) ? 1 : 0;
+        const uint64_t complete = source.end_frame / width;
+        const uint64_t final_end = std::min(last_segment + 1, complete > lookahead ? complete - lookahead : 0);
+
+        // 丢弃窗口之前的分段；窗口移到缓存之前（向前平移）时整体重建
+        while (!cache_.Empty() && cache_first_ < first_cacheable) {
+            cache_.PopFront();
+            cache_first_++;
+        }
+        if (!cache_.Empty() && cache_first_ > first_cacheable) {
+            cache_.Clear();
+        }
+        if (cache_.Empty()) {
+            cache_first_ = first_cacheable;
+        }
+
+        // 只计算新完成的分段
+        for (uint64_t k = cache_first_ + cache_.Size(); k < final_end; k++) {
+            cache_.Push(ComputeSegment(source, k));
+            computed_segments_++;
+        }
+
+        // 窗口两端未缓存的分段临时计算（按序号顺序，Finish()中依次取用）
+        for (uint64_t k = first_segment; k <= last_segment; k++) {
+            if (k < cache_first_ || k >= cache_first_ + cache_.Size()) {
+                edges_.push_back(ComputeSegment(source, k));
+                computed_segments_++;
+            }
+        }
+        first_segment_ = first_segment;
+        last_segment_ = last_segment;
+        pending_ = true;
+    }
+
+    /**
+     * @brief 组装Prepare()的输出（不访问数据，可在锁外调用）
+     * @return 输出点数
+     */
+    size_t Finish() {
+        if (!pending_) return timestamps_.size();
+        pending_ = false;
+
+        // 缓存中的分段直接使用，其余依次取Prepare()临时计算的分段
+        timestamps_.reserve((last_segment_ - first_segment_ + 1) * 4);
+        values_.reserve((last_segment_ - first_segment_ + 1) * 4);
+        size_t edge = 0;
+        for (uint64_t k = first_segment_; k <= last_segment_; k++) {
+            if (k >= cache_first_ && k < cache_first_ + cache_.Size()) {
+                Emit(cache_.Get(static_cast<size_t>(k - cache_first_)));
+            } else {
+                Emit(edges_[edge++]);
+            }
+        }
+        return timestamps_.size();
+    }
+
+    /**
+     * @brief 清空输出（窗口内没有数据时调用，缓存保留）
+     */
+    void ClearOutput() {
+        timestamps_.clear();
+        values_.clear();
+        edges_.clear();
+        pending_ = false;
+        computed_segments_ = 0;
+    }
+
+    const std::vector<double>& GetTimestamps() const {
+        return timestamps_;
+    }
+
+    const std::vector<float>& GetValues() const {
+        return values_;
+    }
+
+    /**
+     * @brief 上一次Update()中实际计算的分段数（其余来自缓存）
+     */
+    size_t GetComputedSegments() const {
+        return computed_segments_;
+    }
+
+private:
+    /**
+     * @brief 一个分段的输出点（最多4个，按时间排序）
+     */
+    struct Segment {
+        double time[4];
+        float value[4];
+        uint8_t count = 0;
+
+        void Add(double t, float v) {
+            time[count] = t;
+            value[count] = v;
+            count++;
+        }
+    };
+
+    /**
+     * @brief 计算第k段（裁剪到有效数据范围内）
+     */
+    Segment ComputeSegment(const DownsampleSource& source, uint64_t k) const {
+        Segment segment;
+        uint64_t low = std::max(k * width_, source.first_frame);
+        uint64_t high = std::min((k + 1) * width_, source.end_frame);
+        if (low >= high) return segment;
+
+        EnvelopeAggregate aggregate = source.pyramid.Aggregate(source.column, low, high);
+        if (aggregate.Empty()) return segment;
+
+        switch (mode_) {
+            case DownsampleMode::STRIDE: {
+                uint64_t frame = FirstValid(source, low, high);
+                segment.Add(source.Time(frame), source.Value(frame));
+                break;
+            }
+            case DownsampleMode::MINMAX: {
+                uint64_t frames[2] = {aggregate.min_frame, aggregate.max_frame};
+                AddSorted(source, segment, frames, 2);
+                break;
+            }
+            case DownsampleMode::M4: {
+                uint64_t frames[4] = {FirstValid(source, low, high), aggregate.min_frame,
+                                      aggregate.max_frame, LastValid(source, low, high)};
+                AddSorted(source, segment, frames, 4);
+                break;
+            }
+            case DownsampleMode::LTTB:
+                ComputeLttb(source, k, low, high, segment);
+                break;
+        }
+        return segment;
+    }
+
+    /**
+     * @brief LTTB：在预选候选点中选出与前后两段构成最大三角形的点
+     */
+    void ComputeLttb(const DownsampleSource& source, uint64_t k, uint64_t low, uint64_t high,
+                     Segment& segment) const {
+        // 曲线两端的分段保留端点（与标准LTTB保留首末点一致）
+        bool has_previous = (k > cache_first_ && k - 1 < cache_first_ + cache_.Size() &&
+                             cache_.Get(static_cast<size_t>(k - 1 - cache_first_)).count > 0);
+        uint64_t next_low = high;
+        uint64_t next_high = std::min(high + width_, source.end_frame);
+        EnvelopeAggregate next;
+        if (next_low < next_high) {
+            next = source.pyramid.Aggregate(source.column, next_low, next_high);
+        }
+
+        double a_time;
+        float a_value;
+        if (has_previous) {
+            const Segment& previous = cache_.Get(static_cast<size_t>(k - 1 - cache_first_));
+            a_time = previous.time[previous.count - 1];
+            a_value = previous.value[previous.count - 1];
+        } else if (low > source.first_frame) {
+            // 前一段不在缓存中：以其均值点为顶点
+            EnvelopeAggregate prior = source.pyramid.Aggregate(
+                source.column, std::max(low - std::min(low, width_), source.first_frame), low);
+            if (prior.Empty()) {
+                uint64_t frame = FirstValid(source, low, high);
+                segment.Add(source.Time(frame), source.Value(frame));
+                return;
+            }
+            a_time = source.Time((std::max(low - std::min(low, width_), source.first_frame) + low) / 2);
+            a_value = prior.Mean();
+        } else {
+            uint64_t frame = FirstValid(source, low, high);
+            segment.Add(source.Time(frame), source.Value(frame));
+            return;
+        }
+        if (next.Empty()) {
+            uint64_t frame = LastValid(source, low, high);
+            segment.Add(source.Time(frame), source.Value(frame));
+            return;
+        }
+        double c_time = source.Time((next_low + next_high) / 2);
+        double c_value = next.Mean();
+
+        // 候选点：各子段的最小/最大值；段宽不大于子段数的2倍时直接使用原始点
+        double best_area = -1.0;
+        uint64_t best_frame = low;
+        auto consider = [&](uint64_t frame) {
+            float value = source.Value(frame);
+            if (std::isnan(value)) return;
+            double area = std::fabs((a_time - c_time) * (value - a_value) -
+                                    (a_time - source.Time(frame)) * (c_value - a_value));
+            if (area > best_area) {
+                best_area = area;
+                best_frame = frame;
+            }
+        };
+        if (high - low <= 2 * LTTB_CANDIDATE_SPANS) {
+            for (uint64_t frame = low; frame < high; frame++) {
+                consider(frame);
+            }
+        } else {
+            uint64_t span = (high - low + LTTB_CANDIDATE_SPANS - 1) / LTTB_CANDIDATE_SPANS;
+            for (uint64_t start = low; start < high; start += span) {
+                EnvelopeAggregate candidates = source.pyramid.Aggregate(
+                    source.column, start, std::min(start + span, high));
+                if (candidates.Empty()) continue;
+                consider(candidates.min_frame);
+                consider(candidates.max_frame);
+            }
+        }
+        segment.Add(source.Time(best_frame), source.Value(best_frame));
+    }
+
+    /**
+     * @brief 按帧顺序加入若干点（去掉重复帧）
+     */
+    static void AddSorted(const DownsampleSource& source, Segment& segment, uint64_t* frames, size_t count) {
+        std::sort(frames, frames + count);
+        for (size_t i = 0; i < count; i++) {
+            if (i > 0 && frames[i] == frames[i - 1]) continue;
+            segment.Add(source.Time(frames[i]), source.Value(frames[i]));
+        }
+    }
+
+    /**
+     * @brief [low, high)中第一个有效帧（调用者保证至少有一个）
+     */
+    static uint64_t FirstValid(const DownsampleSource& source, uint64_t low, uint64_t high) {
+        for (uint64_t frame = low; frame < high; frame++) {
+            if (!std::isnan(source.Value(frame))) return frame;
+        }
+        return low;
+    }
+
+    /**
+     * @brief [low, high)中最后一个有效帧（调用者保证至少有一个）
+     */
+    static uint64_t LastValid(const DownsampleSource& source, uint64_t low, uint64_t high) {
+        for (uint64_t frame = high; frame > low; frame--) {
+            if (!std::isnan(source.Value(frame - 1))) return frame - 1;
+        }
+        return high - 1;
+    }
+
+    void Emit(const Segment& segment) {
+        for (uint8_t i = 0; i < segment.count; i++) {
+            timestamps_.push_back(segment.time[i]);
+            values_.push_back(segment.value[i]);
+        }
+    }
+
+    DownsampleMode mode_;
+    CircularBuffer<Segment> cache_{0};  // 已完成分段的结果（连续，从cache_first_开始）
+    uint64_t cache_first_ = 0;          // 缓存中最旧分段的序号
+    uint64_t width_ = 0;                // 段宽（帧）
+    uint64_t epoch_ = 0;                // 缓存对应的数据代次
+    size_t computed_segments_ = 0;      // 上一次更新中实际计算的分段数
+    std::vector<Segment> edges_;        // 窗口内未缓存的分段（Prepare()计算，Finish()输出）
+    uint64_t first_segment_ = 0;        // 窗口的第一个分段
+    uint64_t last_segment_ = 0;         // 窗口的最后一个分段
+    bool pending_ = false;              // Prepare()已完成、尚未Finish()
+    std::vector<double> timestamps_;    // 输出时间戳
+    std::vector<float> values_;         // 输出Y值
+};
+
+#endif // DOWNSAMPLER_H
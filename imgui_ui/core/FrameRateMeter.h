@@ -0,0 +1,86 @@
+/**
+ * @file FrameRateMeter.h
+ * @brief 接收帧率测量 - 最近几秒内每秒写入的帧数
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 帧的时间戳由写入时刻推算（一批帧分布在上一次写入与当前时刻之间），
+ * 相邻时间戳的间隔取决于串口读取的分块方式，而不是设备的发送频率；
+ * 用时间戳差估计采样率会随分块大小漂移。这里改为统计较长时间窗口内
+ * 实际写入的帧数：
+ * - 每SLOT_INTERVAL秒记录一次（写入时刻, 累计帧数），最多保留SLOTS个记录（约4秒）
+ * - 帧率 = (最新累计帧数 - 最旧记录的累计帧数) / 两者的时间差
+ * - 分块只影响窗口两端各一批帧，误差约为批间隔 / 窗口长度
+ * - 停顿超过整个窗口（或清空）后重新开始测量
+ *
+ * 不加锁，由调用者（DataChannelManager）保护。
+ */
+
+#ifndef FRAME_RATE_METER_H
+#define FRAME_RATE_METER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 接收帧率测量
+ */
+class FrameRateMeter {
+public:
+    static constexpr size_t SLOTS = 32;                 // 保留的记录数
+    static constexpr double SLOT_INTERVAL = 0.125;      // 记录间隔（秒），窗口约SLOTS * SLOT_INTERVAL
+    static constexpr double MIN_SPAN = 0.5;             // 至少覆盖的时间（秒），不足时不给出结果
+
+    /**
+     * @brief 记录一次写入
+     * @param time 写入时刻（秒，单调递增）
+     * @param frames 写入后的累计帧数
+     */
+    void Record(double time, uint64_t frames) {
+        if (count_ > 0 && (time < latest_.time || frames < latest_.frames ||
+                           time - latest_.time > SLOTS * SLOT_INTERVAL)) {
+            // 时间倒退、计数清零或长时间停顿：旧记录不再代表当前帧率
+            Reset();
+        }
+        latest_ = Sample{time, frames};
+        if (count_ == 0 || time - slots_[newest_].time >= SLOT_INTERVAL) {
+            newest_ = (count_ == 0) ? 0 : (newest_ + 1) % SLOTS;
+            slots_[newest_] = latest_;
+            if (count_ < SLOTS) count_++;
+        }
+    }
+
+    /**
+     * @brief 测得的帧率（帧/秒），记录覆盖的时间不足MIN_SPAN时返回0
+     */
+    double GetRate() const {
+        if (count_ == 0) return 0.0;
+        const Sample& oldest = slots_[(newest_ + SLOTS + 1 - count_) % SLOTS];
+        double span = latest_.time - oldest.time;
+        if (span < MIN_SPAN) return 0.0;
+        return static_cast<double>(latest_.frames - oldest.frames) / span;
+    }
+
+    /**
+     * @brief 清除所有记录
+     */
+    void Reset() {
+        count_ = 0;
+        newest_ = 0;
+        latest_ = Sample();
+    }
+
+private:
+    struct Sample {
+        double time = 0.0;          // 写入时刻（秒）
+        uint64_t frames = 0;        // 写入后的累计帧数
+    };
+
+    std::array<Sample, SLOTS> slots_{};     // 每SLOT_INTERVAL秒一个记录（环形）
+    size_t newest_ = 0;                     // 最新记录的下标
+    size_t count_ = 0;                      // 有效记录数
+    Sample latest_;                         // 最近一次写入（可能晚于最新记录）
+};
+
+#endif // FRAME_RATE_METER_H
@@ -0,0 +1,140 @@
+/**
+ * @file HugePageAllocator.h
+ * @brief 大页友好的内存分配器 - 用于深历史缓冲区
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 千万级采样的缓冲区按普通4KB页映射时TLB缺失严重：
+ * - 不小于HUGE_PAGE_SIZE的分配按2MB对齐、长度向上取整到2MB
+ * - Linux：madvise(MADV_HUGEPAGE)，由透明大页（THP）合并为2MB页
+ * - Windows：VirtualAlloc直接向系统申请（页对齐、不经过堆）；
+ *   大页（MEM_LARGE_PAGES）需要“锁定内存页”权限，失败时回退为普通页
+ * - 小块分配仍走普通operator new
+ * - 元素默认初始化（不清零），页面在首次写入时才映射
+ */
+
+#ifndef HUGE_PAGE_ALLOCATOR_H
+#define HUGE_PAGE_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+#endif
+
+namespace HugePage {
+
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;  // 2MB
+
+/**
+ * @brief 按大页取整后的实际分配字节数
+ */
+inline size_t RoundUp(size_t bytes) {
+    return (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+}
+
+/**
+ * @brief 分配内存（失败抛出std::bad_alloc）
+ */
+inline void* Allocate(size_t bytes) {
+    if (bytes < HUGE_PAGE_SIZE) {
+        return ::operator new(bytes);
+    }
+
+    size_t size = RoundUp(bytes);
+#ifdef _WIN32
+    void* p = nullptr;
+    SIZE_T large_page = GetLargePageMinimum();
+    if (large_page > 0 && size % large_page == 0) {
+        p = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+    }
+    if (!p) {
+        p = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    }
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+#else
+    void* p = nullptr;
+    if (posix_memalign(&p, HUGE_PAGE_SIZE, size) != 0) {
+        throw std::bad_alloc();
+    }
+    #ifdef MADV_HUGEPAGE
+    madvise(p, size, MADV_HUGEPAGE);
+    #endif
+    return p;
+#endif
+}
+
+/**
+ * @brief 释放Allocate()分配的内存
+ */
+inline void Deallocate(void* p, size_t bytes) {
+    if (!p) return;
+    if (bytes < HUGE_PAGE_SIZE) {
+        ::operator delete(p);
+        return;
+    }
+#ifdef _WIN32
+    VirtualFree(p, 0, MEM_RELEASE);
+#else
+    std::free(p);
+#endif
+}
+
+} // namespace HugePage
+
+/**
+ * @brief 大页友好的STL分配器
+ * @tparam T 元素类型
+ */
+template<typename T>
+class HugePageAllocator {
+public:
+    using value_type = T;
+
+    HugePageAllocator() noexcept = default;
+
+    template<typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(HugePage::Allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        HugePage::Deallocate(p, n * sizeof(T));
+    }
+
+    /**
+     * @brief 默认初始化（不清零）：大块内存的页面在首次写入时才映射，
+     *        resize()不会一次性触发全部缺页
+     */
+    template<typename U>
+    void construct(U* p) noexcept(std::is_nothrow_default_constructible<U>::value) {
+        ::new (static_cast<void*>(p)) U;
+    }
+
+    template<typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template<typename U>
+    bool operator==(const HugePageAllocator<U>&) const noexcept { return true; }
+
+    template<typename U>
+    bool operator!=(const HugePageAllocator<U>&) const noexcept { return false; }
+};
+
+#endif // HUGE_PAGE_ALLOCATOR_H
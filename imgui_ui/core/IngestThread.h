@@ -0,0 +1,252 @@
+/**
+ * @file IngestThread.h
+ * @brief 接收数据消费线程 - 从SPSC环形缓冲区取数据并处理
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 数据流：
+ *   串口接收线程 --Push()--> SpscByteRing + 数据块记录 --> 消费线程 --> 处理函数
+ *
+ * - 生产者路径只有memcpy + 原子store，无堆分配、无锁
+ * - 消费线程仅在环为空时休眠（条件变量），生产者只在消费者
+ *   休眠时才加锁通知
+ * - 每个数据块带有入口处分配的字节流位置，随数据一起交给处理函数；
+ *   流位置连续的相邻数据块合并为一次调用（不增加调用次数）
+ */
+
+#ifndef INGEST_THREAD_H
+#define INGEST_THREAD_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "SpscByteRing.h"
+
+/**
+ * @brief 接收数据消费线程
+ */
+class IngestThread {
+public:
+    /**
+     * @brief 数据处理函数
+     * 参数：数据、长度、数据在接收字节流中的起始位置
+     */
+    using Handler = std::function<void(const unsigned char*, size_t, uint64_t)>;
+
+    /**
+     * @brief 构造函数
+     * @param ring_capacity 环形缓冲区容量（字节）
+     */
+    explicit IngestThread(size_t ring_capacity = 1 << 20)
+        : ring_(ring_capacity)
+        , running_(false)
+        , consumer_sleeping_(false)
+    {
+        // 数据块记录：平均每块不小于MIN_CHUNK_BYTES字节时不会先于字节环写满
+        size_t records = 1;
+        while (records < ring_.Capacity() / MIN_CHUNK_BYTES) {
+            records <<= 1;
+        }
+        records_.resize(records);
+        record_mask_ = records - 1;
+    }
+
+    ~IngestThread() {
+        Stop();
+    }
+
+    IngestThread(const IngestThread&) = delete;
+    IngestThread& operator=(const IngestThread&) = delete;
+
+    /**
+     * @brief 启动消费线程
+     * @param handler 数据处理函数（在消费线程中调用，可能被拆成两段连续内存）
+     */
+    void Start(Handler handler) {
+        if (running_) return;
+        handler_ = std::move(handler);
+        running_ = true;
+        thread_ = std::thread(&IngestThread::Run, this);
+    }
+
+    /**
+     * @brief 停止消费线程（剩余数据处理完后退出）
+     *
+     * 调用前应先让生产者静止（见ReceiveGate）；与Stop()并发写入、
+     * 消费线程退出后才到达的数据由调用线程在返回前处理，不会滞留在环中。
+     */
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_) return;
+            running_ = false;
+        }
+        cv_.notify_one();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        DrainRecords();
+    }
+
+    /**
+     * @brief 是否正在运行
+     */
+    bool IsRunning() const {
+        return running_;
+    }
+
+    /**
+     * @brief 推送数据（仅串口接收线程调用）
+     * @param data 数据
+     * @param length 长度
+     * @param stream_offset 数据在接收字节流中的起始位置（入口处分配）
+     * @return 成功返回true；环形缓冲区或数据块记录已满时返回false（数据被丢弃）
+     */
+    bool Push(const unsigned char* data, size_t length, uint64_t stream_offset) {
+        const size_t record_head = record_head_.load(std::memory_order_relaxed);
+        if (record_head - cached_record_tail_ >= records_.size()) {
+            cached_record_tail_ = record_tail_.load(std::memory_order_acquire);
+            if (record_head - cached_record_tail_ >= records_.size()) {
+                record_dropped_bytes_.fetch_add(length, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        bool ok = ring_.Write(data, length);
+        if (ok) {
+            records_[record_head & record_mask_] = ChunkRecord{stream_offset, length};
+            record_head_.store(record_head + 1, std::memory_order_release);
+        }
+
+        // 与消费者的“先置休眠标志、再检查环”配对，避免丢失唤醒
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumer_sleeping_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cv_.notify_one();
+        }
+        return ok;
+    }
+
+    /**
+     * @brief 获取环形缓冲区（用于监控占用/最高占用/丢弃字节）
+     */
+    const SpscByteRing& GetRing() const {
+        return ring_;
+    }
+
+    SpscByteRing& GetRing() {
+        return ring_;
+    }
+
+    /**
+     * @brief 被丢弃的字节数（字节环已满或数据块记录已满）
+     */
+    uint64_t DroppedBytes() const {
+        return ring_.DroppedBytes() + record_dropped_bytes_.load(std::memory_order_relaxed);
+    }
+
+private:
+    /**
+     * @brief 消费线程主循环
+     */
+    void Run() {
+        while (true) {
+            if (DrainRecords()) {
+                continue;
+            }
+
+            if (!running_) {
+                break;
+            }
+
+            // 环为空：置休眠标志后再检查一次，然后等待
+            consumer_sleeping_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (RecordsEmpty() && running_) {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait_for(lock, std::chrono::milliseconds(100), [this] {
+                    return !running_ || !RecordsEmpty();
+                });
+            }
+            consumer_sleeping_.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief 处理当前已写入的全部数据块（消费线程，或消费线程退出后的Stop()）
+     * @return 是否处理了数据
+     */
+    bool DrainRecords() {
+        size_t record_tail = record_tail_.load(std::memory_order_relaxed);
+        const size_t record_head = record_head_.load(std::memory_order_acquire);
+        if (record_tail == record_head) {
+            return false;
+        }
+        while (record_tail != record_head) {
+            // 合并流位置连续的数据块（字节在环中也是连续的）
+            uint64_t run_offset = records_[record_tail & record_mask_].stream_offset;
+            size_t run_length = 0;
+            while (record_tail != record_head) {
+                const ChunkRecord& record = records_[record_tail & record_mask_];
+                if (record.stream_offset != run_offset + run_length) break;
+                run_length += record.length;
+                record_tail++;
+            }
+            ProcessRun(run_offset, run_length);
+            record_tail_.store(record_tail, std::memory_order_release);
+        }
+        return true;
+    }
+
+    /**
+     * @brief 处理环头部的length字节（最多两段连续内存）
+     */
+    void ProcessRun(uint64_t stream_offset, size_t length) {
+        const unsigned char* first = nullptr;
+        const unsigned char* second = nullptr;
+        size_t first_len = 0;
+        size_t second_len = 0;
+        ring_.Peek(first, first_len, second, second_len);
+
+        size_t head_part = (length < first_len) ? length : first_len;
+        handler_(first, head_part, stream_offset);
+        if (head_part < length) {
+            handler_(second, length - head_part, stream_offset + head_part);
+        }
+        ring_.Consume(length);
+    }
+
+    bool RecordsEmpty() const {
+        return record_tail_.load(std::memory_order_relaxed) == record_head_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 数据块记录（与环中的字节一一对应，按写入顺序排列）
+     */
+    struct ChunkRecord {
+        uint64_t stream_offset;     // 数据块在接收字节流中的起始位置
+        size_t length;              // 字节数
+    };
+
+    static constexpr size_t MIN_CHUNK_BYTES = 32;
+
+    SpscByteRing ring_;                         // 接收线程 -> 消费线程
+    std::vector<ChunkRecord> records_;          // 数据块记录（构造时分配）
+    size_t record_mask_ = 0;                    // 记录容量掩码
+    alignas(64) std::atomic<size_t> record_head_{0};    // 记录写索引（生产者独占写）
+    size_t cached_record_tail_ = 0;                     // 生产者缓存的记录读索引
+    alignas(64) std::atomic<size_t> record_tail_{0};    // 记录读索引（消费者独占写）
+    std::atomic<uint64_t> record_dropped_bytes_{0};     // 因记录已满丢弃的字节数
+    Handler handler_;                           // 数据处理函数
+    std::thread thread_;                        // 消费线程
+    std::atomic<bool> running_;                 // 是否运行
+    std::atomic<bool> consumer_sleeping_;       // 消费线程是否休眠
+    std::mutex mutex_;                          // 仅用于条件变量
+    std::condition_variable cv_;                // 唤醒消费线程
+};
+
+#endif // INGEST_THREAD_H
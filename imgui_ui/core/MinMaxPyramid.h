@@ -0,0 +1,396 @@
+/**
+ * @file MinMaxPyramid.h
+ * @brief 最小/最大值金字塔 - 波形绘图的多级降采样索引
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 与每个数值列并列维护，随写入增量更新：
+ * - 第0级每BASE帧一个桶，往上每级把FANOUT个桶合并为一个
+ * - 每个桶记录最小值、最大值（及其所在帧）、和、有效值个数，NaN不计入
+ * - 每级是一个环形数组，容量足以覆盖数值列中的全部帧
+ * - 写入时只更新第0级的当前桶，桶写满时逐级合并，均摊O(1)
+ *
+ * 查询任意帧区间[begin, end)时，按输出桶宽选择合适的级别：
+ * 完整的桶直接合并，区间两端不完整的部分递归到下一级，
+ * 最底层才扫描原始数据（每端不超过BASE帧）。
+ * 查询耗时与输出桶数成正比，与区间内的原始帧数无关。
+ *
+ * 帧号为全局帧序号（与DataChannelManager的帧计数一致），
+ * 数值列的第i个元素对应帧 GetEndFrame() - 列长度 + i。
+ */
+
+#ifndef MIN_MAX_PYRAMID_H
+#define MIN_MAX_PYRAMID_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "CircularBuffer.h"
+#include "HugePageAllocator.h"
+
+/**
+ * @brief 金字塔中存储的桶（无默认初始化，配合HugePageAllocator延迟映射页面）
+ */
+struct EnvelopeBucket {
+    float min_value;
+    float max_value;
+    uint32_t min_offset;    // 最小值相对桶起始帧的偏移
+    uint32_t max_offset;    // 最大值相对桶起始帧的偏移
+    double sum;             // 有效值之和
+    uint32_t count;         // 有效值个数
+
+    static EnvelopeBucket Empty() {
+        EnvelopeBucket bucket;
+        bucket.min_value = std::numeric_limits<float>::infinity();
+        bucket.max_value = -std::numeric_limits<float>::infinity();
+        bucket.min_offset = bucket.max_offset = 0;
+        bucket.sum = 0.0;
+        bucket.count = 0;
+        return bucket;
+    }
+};
+
+/**
+ * @brief 一段帧区间的聚合结果
+ */
+struct EnvelopeAggregate {
+    float min_value = std::numeric_limits<float>::infinity();
+    float max_value = -std::numeric_limits<float>::infinity();
+    uint64_t min_frame = 0;     // 最小值所在帧（相同值取最早的）
+    uint64_t max_frame = 0;     // 最大值所在帧
+    double sum = 0.0;
+    uint64_t count = 0;         // 有效值个数（0表示区间内没有数据）
+
+    bool Empty() const {
+        return count == 0;
+    }
+
+    float Mean() const {
+        return count > 0 ? static_cast<float>(sum / static_cast<double>(count)) : 0.0f;
+    }
+
+    void Add(float value, uint64_t frame) {
+        if (std::isnan(value)) return;
+        if (value < min_value) {
+            min_value = value;
+            min_frame = frame;
+        }
+        if (value > max_value) {
+            max_value = value;
+            max_frame = frame;
+        }
+        sum += value;
+        count++;
+    }
+
+    /**
+     * @brief 合并一个存储的桶（调用顺序须按帧从旧到新）
+     * @param bucket 桶
+     * @param bucket_start 桶的起始帧
+     */
+    void Merge(const EnvelopeBucket& bucket, uint64_t bucket_start) {
+        if (bucket.count == 0) return;
+        if (bucket.min_value < min_value) {
+            min_value = bucket.min_value;
+            min_frame = bucket_start + bucket.min_offset;
+        }
+        if (bucket.max_value > max_value) {
+            max_value = bucket.max_value;
+            max_frame = bucket_start + bucket.max_offset;
+        }
+        sum += bucket.sum;
+        count += bucket.count;
+    }
+};
+
+/**
+ * @brief 最小/最大值金字塔
+ */
+class MinMaxPyramid {
+public:
+    static constexpr uint64_t BASE = 128;       // 第0级每桶帧数
+    static constexpr uint64_t FANOUT = 8;       // 相邻两级的桶宽之比
+    static constexpr size_t MAX_LEVELS = 8;     // 最高级桶宽128×8^7帧，偏移仍可用uint32表示
+    static constexpr uint64_t TOP_BUCKETS = 64; // 最高级覆盖整个缓冲区所需的桶数上限
+
+    MinMaxPyramid() = default;
+
+    /**
+     * @brief 按数值列容量分配各级（清空已有数据，0表示暂不分配）
+     */
+    void SetCapacity(size_t capacity) {
+        level_count_ = 0;
+        if (capacity > 0) {
+            uint64_t span = BASE;
+            while (level_count_ < MAX_LEVELS) {
+                Level& level = levels_[level_count_++];
+                level.span = span;
+                // 覆盖capacity帧的桶最多capacity/span+2个（两端各有一个不完整的桶）
+                std::vector<EnvelopeBucket, HugePageAllocator<EnvelopeBucket>> ring(capacity / span + 2);
+                level.ring.swap(ring);
+                if (span * TOP_BUCKETS >= capacity) break;
+                span *= FANOUT;
+            }
+        }
+        for (size_t l = level_count_; l < MAX_LEVELS; l++) {
+            std::vector<EnvelopeBucket, HugePageAllocator<EnvelopeBucket>>().swap(levels_[l].ring);
+        }
+        Reset(0);
+    }
+
+    /**
+     * @brief 清空，下一次写入的帧号为first_frame
+     */
+    void Reset(uint64_t first_frame) {
+        next_frame_ = first_frame;
+        for (size_t l = 0; l < level_count_; l++) {
+            levels_[l].open = EnvelopeBucket::Empty();
+            levels_[l].open_index = first_frame / levels_[l].span;
+        }
+    }
+
+    /**
+     * @brief 写入下一帧的值（NaN只推进帧号）
+     */
+    void Push(float value) {
+        uint64_t frame = next_frame_++;
+        if (level_count_ == 0) return;
+
+        Level& level = levels_[0];
+        uint64_t index = frame / BASE;
+        if (index != level.open_index) {
+            Close(0);
+        }
+        if (!std::isnan(value)) {
+            EnvelopeBucket& open = level.open;
+            uint32_t offset = static_cast<uint32_t>(frame - index * BASE);
+            if (value < open.min_value) {
+                open.min_value = value;
+                open.min_offset = offset;
+            }
+            if (value > open.max_value) {
+                open.max_value = value;
+                open.max_offset = offset;
+            }
+            open.sum += value;
+            open.count++;
+        }
+    }
+
+    /**
+     * @brief 批量写入连续帧（按第0级桶分段，段内连续累积）
+     */
+    void PushBatch(const float* values, size_t length) {
+        if (level_count_ == 0) {
+            next_frame_ += length;
+            return;
+        }
+        Level& level = levels_[0];
+        while (length > 0) {
+            uint64_t frame = next_frame_;
+            uint64_t index = frame / BASE;
+            if (index != level.open_index) {
+                Close(0);
+            }
+            uint32_t offset = static_cast<uint32_t>(frame - index * BASE);
+            size_t run = static_cast<size_t>(std::min<uint64_t>(length, BASE - offset));
+            EnvelopeBucket& open = level.open;
+            for (size_t i = 0; i < run; i++, offset++) {
+                float value = values[i];
+                if (std::isnan(value)) continue;
+                if (value < open.min_value) {
+                    open.min_value = value;
+                    open.min_offset = offset;
+                }
+                if (value > open.max_value) {
+                    open.max_value = value;
+                    open.max_offset = offset;
+                }
+                open.sum += value;
+                open.count++;
+            }
+            next_frame_ += run;
+            values += run;
+            length -= run;
+        }
+    }
+
+    /**
+     * @brief 写入length个空帧（相当于length个NaN）
+     */
+    void PushEmpty(size_t length) {
+        if (level_count_ == 0) {
+            next_frame_ += length;
+            return;
+        }
+        Level& level = levels_[0];
+        while (length > 0) {
+            uint64_t index = next_frame_ / BASE;
+            if (index != level.open_index) {
+                Close(0);
+            }
+            size_t run = static_cast<size_t>(std::min<uint64_t>(length, (index + 1) * BASE - next_frame_));
+            next_frame_ += run;
+            length -= run;
+        }
+    }
+
+    /**
+     * @brief 下一次写入的帧号
+     */
+    uint64_t GetEndFrame() const {
+        return next_frame_;
+    }
+
+    /**
+     * @brief 聚合帧区间[begin, end)
+     * @param raw 对应的数值列（最新帧为GetEndFrame() - 1）
+     * @param begin 起始帧（不早于数值列中最旧的帧）
+     * @param end 结束帧（不晚于GetEndFrame()）
+     */
+    EnvelopeAggregate Aggregate(const CircularBuffer<float>& raw, uint64_t begin, uint64_t end) const {
+        EnvelopeAggregate result;
+        Accumulate(raw, static_cast<int>(level_count_) - 1, begin, end, result);
+        return result;
+    }
+
+    /**
+     * @brief 把帧区间[begin, end)划分为不超过约max_buckets个等宽的桶并逐个聚合
+     * @param raw 对应的数值列
+     * @param begin 起始帧（不早于数值列中最旧的帧）
+     * @param end 结束帧（不晚于GetEndFrame()）
+     * @param max_buckets 期望的最大桶数（如绘图区像素宽度）
+     * @param output 输出各桶的聚合结果（从旧到新，可能包含空桶）
+     * @return 输出的桶数（不超过max_buckets + 2）
+     *
+     * 桶边界按全局帧号对齐：桶宽不变时区间平移不会改变已有桶的划分，波形不会抖动。
+     */
+    size_t Query(const CircularBuffer<float>& raw, uint64_t begin, uint64_t end,
+                 size_t max_buckets, std::vector<EnvelopeAggregate>& output) const {
+        output.clear();
+        if (begin >= end || max_buckets == 0) return 0;
+
+        // 输出桶宽：不小于区间长度/max_buckets，并取为所选级别桶宽的整数倍
+        uint64_t width = (end - begin + max_buckets - 1) / max_buckets;
+        int level = -1;
+        uint64_t span = 1;
+        while (level + 1 < static_cast<int>(level_count_) && levels_[level + 1].span <= width) {
+            level++;
+            span = levels_[level].span;
+        }
+        width = (width + span - 1) / span * span;
+
+        for (uint64_t start = begin / width * width; start < end; start += width) {
+            EnvelopeAggregate bucket;
+            Accumulate(raw, level, std::max(start, begin), std::min(start + width, end), bucket);
+            output.push_back(bucket);
+        }
+        return output.size();
+    }
+
+    /**
+     * @brief 各级占用的字节数
+     */
+    size_t GetMemoryUsage() const {
+        size_t bytes = 0;
+        for (size_t l = 0; l < level_count_; l++) {
+            bytes += levels_[l].ring.size() * sizeof(EnvelopeBucket);
+        }
+        return bytes;
+    }
+
+    /**
+     * @brief 估算指定容量的金字塔占用的字节数
+     */
+    static size_t EstimateMemory(size_t capacity) {
+        size_t bytes = 0;
+        uint64_t span = BASE;
+        for (size_t l = 0; l < MAX_LEVELS && capacity > 0; l++) {
+            bytes += (capacity / span + 2) * sizeof(EnvelopeBucket);
+            if (span * TOP_BUCKETS >= capacity) break;
+            span *= FANOUT;
+        }
+        return bytes;
+    }
+
+private:
+    struct Level {
+        std::vector<EnvelopeBucket, HugePageAllocator<EnvelopeBucket>> ring;  // 已完成的桶（按桶序号取模存放）
+        EnvelopeBucket open = EnvelopeBucket::Empty();  // 正在累积的桶（只含已完成的下级桶）
+        uint64_t open_index = 0;                        // 正在累积的桶序号
+        uint64_t span = BASE;                           // 桶宽（帧）
+    };
+
+    /**
+     * @brief 完成第l级的当前桶：存入环形数组、合并到上一级，必要时逐级向上完成
+     */
+    void Close(size_t l) {
+        Level& level = levels_[l];
+        level.ring[level.open_index % level.ring.size()] = level.open;
+
+        if (l + 1 < level_count_) {
+            Level& parent = levels_[l + 1];
+            EnvelopeBucket& target = parent.open;
+            const EnvelopeBucket& child = level.open;
+            if (child.count > 0) {
+                uint32_t base = static_cast<uint32_t>(level.open_index * level.span - parent.open_index * parent.span);
+                if (child.min_value < target.min_value) {
+                    target.min_value = child.min_value;
+                    target.min_offset = base + child.min_offset;
+                }
+                if (child.max_value > target.max_value) {
+                    target.max_value = child.max_value;
+                    target.max_offset = base + child.max_offset;
+                }
+                target.sum += child.sum;
+                target.count += child.count;
+            }
+        }
+
+        level.open = EnvelopeBucket::Empty();
+        level.open_index++;
+        if (l + 1 < level_count_ && level.open_index % FANOUT == 0) {
+            Close(l + 1);
+        }
+    }
+
+    /**
+     * @brief 把[begin, end)合并到result：完整且已完成的第level级桶直接合并，其余部分递归到下一级
+     */
+    void Accumulate(const CircularBuffer<float>& raw, int level, uint64_t begin, uint64_t end,
+                    EnvelopeAggregate& result) const {
+        if (begin >= end) return;
+
+        if (level < 0) {
+            // 最底层：扫描原始数据
+            uint64_t raw_first = next_frame_ - raw.Size();
+            for (uint64_t frame = begin; frame < end; frame++) {
+                result.Add(raw.Get(static_cast<size_t>(frame - raw_first)), frame);
+            }
+            return;
+        }
+
+        const Level& current = levels_[level];
+        uint64_t span = current.span;
+        uint64_t first = (begin + span - 1) / span;                 // 第一个完整的桶
+        uint64_t last = std::min(end / span, current.open_index);    // 最后一个完整且已完成的桶之后
+        if (first >= last) {
+            Accumulate(raw, level - 1, begin, end, result);
+            return;
+        }
+
+        Accumulate(raw, level - 1, begin, first * span, result);
+        for (uint64_t index = first; index < last; index++) {
+            result.Merge(current.ring[index % current.ring.size()], index * span);
+        }
+        Accumulate(raw, level - 1, last * span, end, result);
+    }
+
+    Level levels_[MAX_LEVELS];
+    size_t level_count_ = 0;        // 已分配的级数
+    uint64_t next_frame_ = 0;       // 下一次写入的帧号
+};
+
+#endif // MIN_MAX_PYRAMID_H
@@ -0,0 +1,134 @@
+/**
+ * @file OrderedCommitter.h
+ * @brief 按序号提交器 - 并行处理结果按原始顺序落地
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 流水线中的“重排序点”：
+ * - 有序阶段为每个数据块分配递增序号
+ * - 并行阶段（线程池）乱序完成后调用Submit(seq, value)
+ * - 提交器缓存提前到达的结果，只按序号连续地调用提交函数
+ *
+ * 提交函数在提交器内部锁中串行执行，因此日志、文件等
+ * 有序副作用无需额外加锁也不会乱序。
+ */
+
+#ifndef ORDERED_COMMITTER_H
+#define ORDERED_COMMITTER_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+
+/**
+ * @brief 按序号提交器
+ * @tparam T 并行阶段产出的结果类型
+ */
+template<typename T>
+class OrderedCommitter {
+public:
+    using CommitFunction = std::function<void(uint64_t, T&)>;
+
+    OrderedCommitter() = default;
+
+    /**
+     * @brief 设置提交函数（启动流水线前调用）
+     */
+    void SetCommitFunction(CommitFunction fn) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        commit_ = std::move(fn);
+    }
+
+    /**
+     * @brief 提交一个结果（任意线程）
+     * @param seq 序号（由有序阶段分配，从0开始连续递增）
+     * @param value 结果
+     */
+    void Submit(uint64_t seq, T value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (seq < next_seq_) {
+            // 序号重复或倒退：有序阶段出错，丢弃并计数
+            order_errors_++;
+            return;
+        }
+
+        if (seq != next_seq_) {
+            // 提前到达，暂存等待前序结果
+            pending_.emplace(seq, std::move(value));
+            reordered_count_++;
+            if (pending_.size() > max_pending_) {
+                max_pending_ = pending_.size();
+            }
+            return;
+        }
+
+        Commit(seq, value);
+
+        // 依次提交已暂存的后续结果
+        auto it = pending_.begin();
+        while (it != pending_.end() && it->first == next_seq_) {
+            Commit(it->first, it->second);
+            it = pending_.erase(it);
+        }
+    }
+
+    /**
+     * @brief 下一个待提交的序号（即已按序提交的数量）
+     */
+    uint64_t GetNextSequence() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return next_seq_;
+    }
+
+    /**
+     * @brief 当前暂存（等待前序）的结果数量
+     */
+    size_t GetPendingCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pending_.size();
+    }
+
+    /**
+     * @brief 历史最大暂存数量
+     */
+    size_t GetMaxPending() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return max_pending_;
+    }
+
+    /**
+     * @brief 乱序到达（被重排）的结果数量
+     */
+    uint64_t GetReorderedCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return reordered_count_;
+    }
+
+    /**
+     * @brief 序号错误（重复/倒退）的数量，正常应为0
+     */
+    uint64_t GetOrderErrors() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return order_errors_;
+    }
+
+private:
+    void Commit(uint64_t seq, T& value) {
+        if (commit_) {
+            commit_(seq, value);
+        }
+        next_seq_ = seq + 1;
+    }
+
+    CommitFunction commit_;                 // 提交函数
+    std::map<uint64_t, T> pending_;         // 提前到达的结果
+    uint64_t next_seq_ = 0;                 // 下一个待提交序号
+    uint64_t reordered_count_ = 0;          // 乱序到达数量
+    uint64_t order_errors_ = 0;             // 序号错误数量
+    size_t max_pending_ = 0;                // 最大暂存数量
+    mutable std::mutex mutex_;
+};
+
+#endif // ORDERED_COMMITTER_H
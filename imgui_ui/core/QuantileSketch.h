@@ -0,0 +1,296 @@
+/**
+ * @file QuantileSketch.h
+ * @brief 流式分位数草图（合并式t-digest） - 固定内存估计P50/P95/P99/P99.9
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 数据分布用一组按均值排序的质心{均值, 权重}概括：
+ * - 新样本先追加到缓冲区（O(1)），缓冲区满或查询时排序后与质心表归并一次；
+ *   排序用按字节的基数排序（浮点数映射为保序的无符号整数，所有样本该字节相同的趟跳过），
+ *   比较排序在随机数据上分支难以预测，是整个草图的主要开销
+ * - 归并时按k1尺度函数 k(q) = δ/(2π)·asin(2q-1) 限制每个质心的权重：
+ *   相邻质心的k值相差不超过1，分布两端（q接近0或1）的质心很小，
+ *   尾部分位数（P99/P99.9）的精度远高于中位数附近，正适合延迟、抖动类信号
+ * - 质心数不超过约δ个，内存与样本数无关；每个样本的开销为常数（基数排序最多4趟加一次归并）
+ * - 查询时在相邻质心的中点之间线性插值，两端用精确的最小/最大值
+ *
+ * 只统计有限值（NaN、无穷大忽略）。不加锁，由调用者（DataChannelManager）保护。
+ */
+
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+/**
+ * @brief 流式分位数草图（合并式t-digest）
+ */
+class QuantileSketch {
+public:
+    static constexpr double COMPRESSION = 100.0;    // 压缩参数δ（质心数约为δ）
+    static constexpr size_t BUFFER_SIZE = 1024;     // 待归并样本缓冲区大小
+    static constexpr double PI = 3.14159265358979323846;
+
+    QuantileSketch() {
+        Reset();
+    }
+
+    /**
+     * @brief 清空（保留已分配的内存）
+     */
+    void Reset() {
+        means_.clear();
+        weights_.clear();
+        buffered_ = 0;
+        total_weight_ = 0.0;
+        min_value_ = std::numeric_limits<double>::infinity();
+        max_value_ = -std::numeric_limits<double>::infinity();
+    }
+
+    /**
+     * @brief 批量写入样本（非有限值忽略）
+     * @param values 数据数组
+     * @param length 数据长度
+     */
+    void PushBatch(const float* values, size_t length) {
+        if (buffer_.size() < BUFFER_SIZE) {
+            buffer_.resize(BUFFER_SIZE);
+            scratch_.resize(BUFFER_SIZE);
+        }
+        size_t i = 0;
+        while (i < length) {
+            // 一次最多填满缓冲区
+            uint32_t* keys = buffer_.data();
+            size_t buffered = buffered_;
+            size_t end = std::min(length, i + (BUFFER_SIZE - buffered));
+            for (; i < end; i++) {
+                keys[buffered] = ToKey(values[i]);
+                buffered += std::isfinite(values[i]);
+            }
+            buffered_ = buffered;
+            if (buffered_ == BUFFER_SIZE) {
+                Flush();
+            }
+        }
+    }
+
+    /**
+     * @brief 已统计的样本数
+     */
+    uint64_t GetCount() const {
+        return static_cast<uint64_t>(total_weight_) + buffered_;
+    }
+
+    /**
+     * @brief 估计分位数（先归并缓冲区）
+     * @param q 分位点（0~1）
+     * @return 估计值，没有样本时返回NaN
+     */
+    double Quantile(double q) {
+        Flush();
+        if (means_.empty()) return std::numeric_limits<double>::quiet_NaN();
+        if (means_.size() == 1) return means_[0];
+
+        q = std::min(std::max(q, 0.0), 1.0);
+        const double index = q * total_weight_;
+        if (index <= 0.5) return min_value_;
+        if (index >= total_weight_ - 0.5) return max_value_;
+
+        // 第i个质心的“中心”位于累计权重 cumulative + weights_[i] / 2；
+        // 在相邻中心之间线性插值，第一个中心之前与最小值插值，最后一个之后与最大值插值
+        double previous_center = 0.5;
+        double previous_mean = min_value_;
+        double cumulative = 0.0;
+        for (size_t i = 0; i < means_.size(); i++) {
+            double center = cumulative + weights_[i] * 0.5;
+            if (index < center) {
+                double t = (index - previous_center) / std::max(center - previous_center, 1e-12);
+                return previous_mean + t * (means_[i] - previous_mean);
+            }
+            previous_center = center;
+            previous_mean = means_[i];
+            cumulative += weights_[i];
+        }
+        double t = (index - previous_center) / std::max(total_weight_ - 0.5 - previous_center, 1e-12);
+        return previous_mean + t * (max_value_ - previous_mean);
+    }
+
+    /**
+     * @brief 占用的字节数
+     */
+    size_t GetMemoryUsage() const {
+        return (means_.capacity() + weights_.capacity() +
+                merged_means_.capacity() + merged_weights_.capacity()) * sizeof(double) +
+               (buffer_.capacity() + scratch_.capacity()) * sizeof(uint32_t);
+    }
+
+    /**
+     * @brief 把当前状态拷贝到另一个草图（不归并，只拷贝质心和缓冲区中的有效样本）
+     *
+     * 持锁时只做这次拷贝，分位数查询（排序、归并）在锁外对副本进行；
+     * 目标草图的内存跨次复用，稳定后不再分配。
+     */
+    void CopyTo(QuantileSketch& out) const {
+        out.means_.assign(means_.begin(), means_.end());
+        out.weights_.assign(weights_.begin(), weights_.end());
+        if (out.buffer_.size() < BUFFER_SIZE) {
+            out.buffer_.resize(BUFFER_SIZE);
+            out.scratch_.resize(BUFFER_SIZE);
+        }
+        if (buffered_ > 0) {
+            std::memcpy(out.buffer_.data(), buffer_.data(), buffered_ * sizeof(uint32_t));
+        }
+        out.buffered_ = buffered_;
+        out.total_weight_ = total_weight_;
+        out.min_value_ = min_value_;
+        out.max_value_ = max_value_;
+    }
+
+private:
+    /**
+     * @brief 浮点数 -> 保序的无符号整数（负数按位取反，非负数翻转符号位）
+     */
+    static uint32_t ToKey(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    }
+
+    /**
+     * @brief ToKey()的逆变换
+     */
+    static float FromKey(uint32_t key) {
+        uint32_t bits = (key & 0x80000000u) ? (key & 0x7FFFFFFFu) : ~key;
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    /**
+     * @brief 缓冲区中前buffered_个键的基数排序（按字节从低到高，稳定）
+     *
+     * 一遍读取同时统计4个字节的直方图，再逐字节分配
+     */
+    void SortBuffer() {
+        uint32_t counts[4][256] = {};
+        const uint32_t* input = buffer_.data();
+        for (size_t i = 0; i < buffered_; i++) {
+            uint32_t key = input[i];
+            counts[0][key & 0xFF]++;
+            counts[1][(key >> 8) & 0xFF]++;
+            counts[2][(key >> 16) & 0xFF]++;
+            counts[3][key >> 24]++;
+        }
+
+        uint32_t* keys = buffer_.data();
+        uint32_t* temp = scratch_.data();
+        for (int pass = 0; pass < 4; pass++) {
+            const int shift = pass * 8;
+            uint32_t* count = counts[pass];
+            // 所有键的这个字节都相同：这一趟不改变顺序
+            if (count[(keys[0] >> shift) & 0xFF] == buffered_) continue;
+
+            uint32_t offset = 0;
+            for (int d = 0; d < 256; d++) {
+                uint32_t c = count[d];
+                count[d] = offset;
+                offset += c;
+            }
+            for (size_t i = 0; i < buffered_; i++) {
+                temp[count[(keys[i] >> shift) & 0xFF]++] = keys[i];
+            }
+            std::swap(keys, temp);
+        }
+        if (keys != buffer_.data()) {
+            std::memcpy(buffer_.data(), keys, buffered_ * sizeof(uint32_t));
+        }
+    }
+
+    /**
+     * @brief k1尺度函数：分位点 -> k值
+     */
+    static double ScaleK(double q) {
+        return COMPRESSION / (2.0 * PI) * std::asin(2.0 * q - 1.0);
+    }
+
+    /**
+     * @brief k1尺度函数的反函数：k值 -> 分位点
+     */
+    static double ScaleQ(double k) {
+        return (std::sin(k * (2.0 * PI) / COMPRESSION) + 1.0) * 0.5;
+    }
+
+    /**
+     * @brief 把缓冲区排序后与质心表归并（两路归并，一遍完成）
+     *
+     * 当前质心的累计权重不超过k值加1对应的分位点时继续吸收下一个元素，
+     * 否则输出当前质心并开始新质心；尺度函数每输出一个质心计算一次
+     */
+    void Flush() {
+        if (buffered_ == 0) return;
+        SortBuffer();
+        min_value_ = std::min(min_value_, static_cast<double>(FromKey(buffer_[0])));
+        max_value_ = std::max(max_value_, static_cast<double>(FromKey(buffer_[buffered_ - 1])));
+
+        const double total = total_weight_ + buffered_;
+        merged_means_.clear();
+        merged_weights_.clear();
+
+        size_t ci = 0, bi = 0;
+        double sum = 0.0, weight = 0.0;     // 正在累积的质心（加权和、权重，输出时再除）
+        double cumulative = 0.0;            // 之前已输出质心的累计权重
+        double limit = 0.0;                 // 当前质心允许达到的累计权重
+        double buffered_value = FromKey(buffer_[0]);
+        while (ci < means_.size() || bi < buffered_) {
+            double next_mean, next_weight;
+            if (bi == buffered_ || (ci < means_.size() && means_[ci] < buffered_value)) {
+                next_mean = means_[ci];
+                next_weight = weights_[ci];
+                ci++;
+            } else {
+                next_mean = buffered_value;
+                if (++bi < buffered_) buffered_value = FromKey(buffer_[bi]);
+                next_weight = 1.0;
+            }
+
+            if (weight > 0.0 && cumulative + weight + next_weight <= limit) {
+                sum += next_mean * next_weight;
+                weight += next_weight;
+            } else {
+                if (weight > 0.0) {
+                    merged_means_.push_back(sum / weight);
+                    merged_weights_.push_back(weight);
+                    cumulative += weight;
+                }
+                sum = next_mean * next_weight;
+                weight = next_weight;
+                limit = total * ScaleQ(ScaleK(cumulative / total) + 1.0);
+            }
+        }
+        merged_means_.push_back(sum / weight);
+        merged_weights_.push_back(weight);
+
+        means_.swap(merged_means_);
+        weights_.swap(merged_weights_);
+        total_weight_ = total;
+        buffered_ = 0;
+    }
+
+    std::vector<double> means_;             // 质心均值（递增）
+    std::vector<double> weights_;           // 质心权重
+    std::vector<double> merged_means_;      // 归并输出（与means_交替使用，不重复分配）
+    std::vector<double> merged_weights_;    // 归并输出权重
+    std::vector<uint32_t> buffer_;          // 待归并样本（ToKey()编码，前buffered_个有效）
+    std::vector<uint32_t> scratch_;         // 基数排序的临时数组
+    size_t buffered_ = 0;                   // 缓冲区中的样本数
+    double total_weight_;                   // 质心总权重（已归并的样本数）
+    double min_value_;                      // 最小值
+    double max_value_;                      // 最大值
+};
+
+#endif // QUANTILE_SKETCH_H
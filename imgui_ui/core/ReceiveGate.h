@@ -0,0 +1,96 @@
+/**
+ * @file ReceiveGate.h
+ * @brief 接收回调闸门 - 切换接收流水线模式前让接收回调静止
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 串口接收线程每次回调都在Enter()/Leave()之间执行；控制线程（UI）
+ * 在停止消费线程、切换单/多线程模式前调用Close()：
+ * - Close()返回时没有回调正在执行，之后的回调在Enter()处等待
+ * - 闸门关闭期间可以安全地停止/排空消费线程、修改模式
+ * - Open()之后等待中的回调按原顺序继续，数据不丢失也不乱序
+ *
+ * 回调路径只有两次原子store和一次load，无锁；只有闸门关闭时才等待。
+ * 约束：同一时刻只有一个接收线程和一个控制线程。
+ */
+
+#ifndef RECEIVE_GATE_H
+#define RECEIVE_GATE_H
+
+#include <atomic>
+#include <thread>
+
+/**
+ * @brief 接收回调闸门
+ */
+class ReceiveGate {
+public:
+    ReceiveGate() = default;
+
+    ReceiveGate(const ReceiveGate&) = delete;
+    ReceiveGate& operator=(const ReceiveGate&) = delete;
+
+    // ==================== 接收线程接口 ====================
+
+    /**
+     * @brief 进入回调（闸门关闭时等待打开）
+     */
+    void Enter() {
+        while (true) {
+            // 与Close()的“先置关闭、再检查忙碌”配对（均为seq_cst）
+            busy_.store(true, std::memory_order_seq_cst);
+            if (!closed_.load(std::memory_order_seq_cst)) {
+                return;
+            }
+            busy_.store(false, std::memory_order_release);
+            while (closed_.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /**
+     * @brief 离开回调
+     */
+    void Leave() {
+        busy_.store(false, std::memory_order_release);
+    }
+
+    /**
+     * @brief 作用域内持有闸门
+     */
+    class Scope {
+    public:
+        explicit Scope(ReceiveGate& gate) : gate_(gate) { gate_.Enter(); }
+        ~Scope() { gate_.Leave(); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        ReceiveGate& gate_;
+    };
+
+    // ==================== 控制线程接口 ====================
+
+    /**
+     * @brief 关闭闸门并等待正在执行的回调结束
+     */
+    void Close() {
+        closed_.store(true, std::memory_order_seq_cst);
+        while (busy_.load(std::memory_order_seq_cst)) {
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * @brief 打开闸门
+     */
+    void Open() {
+        closed_.store(false, std::memory_order_release);
+    }
+
+private:
+    std::atomic<bool> busy_{false};         // 接收线程正在执行回调
+    std::atomic<bool> closed_{false};       // 闸门已关闭
+};
+
+#endif // RECEIVE_GATE_H
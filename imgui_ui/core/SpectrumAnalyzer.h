@@ -0,0 +1,444 @@
+/**
+ * @file SpectrumAnalyzer.h
+ * @brief 频谱分析 - 加窗FFT、Welch平均，在后台线程中计算
+ * @author AI Assistant
+ * @date 2025
+ *
+ * FFT内核（FftPlan）：
+ * - 实数输入：N点实序列打包为N/2点复序列（偶数点作实部、奇数点作虚部），
+ *   做一次N/2点复FFT后再拆分出N/2+1个频点，计算量约为直接做N点复FFT的一半
+ * - N/2点复FFT为迭代式基2时间抽取，位反转表和各级旋转因子在创建时预先计算；
+ *   每级的旋转因子单独连续存放，实部/虚部分开，蝶形内层循环是对连续数组的乘加
+ *   （编译器可向量化），不调用std::complex的乘法
+ *
+ * Welch平均：取最近 N + (K-1)·N/2 个样本，分为K段（相邻段重叠50%），
+ * 每段去均值（可选）、乘窗（矩形/Hann/Blackman）后做FFT，各段功率谱取平均，
+ * 再按窗的相干增益归一化为单边幅度谱：幅度为A的正弦在其频点上显示为A。
+ *
+ * 线程模型（SpectrumAnalyzer）：
+ * - UI线程填好输入后调用Submit()，与工作线程交换输入缓冲区（不拷贝、稳定后不分配）；
+ *   工作线程正在计算时Submit()返回false，UI下一帧再提交（只保留最新数据）
+ * - 结果在工作线程的缓冲区中算完后加锁交换，UI用TakeResult()取走
+ */
+
+#ifndef SPECTRUM_ANALYZER_H
+#define SPECTRUM_ANALYZER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 窗函数类型
+ */
+enum class SpectrumWindow {
+    RECTANGULAR,    // 矩形窗（不加窗）
+    HANN,           // Hann窗（通用）
+    BLACKMAN        // Blackman窗（旁瓣更低，主瓣更宽）
+};
+
+/**
+ * @brief 获取窗函数名称
+ */
+inline const char* GetSpectrumWindowName(SpectrumWindow window) {
+    switch (window) {
+        case SpectrumWindow::RECTANGULAR: return "矩形窗";
+        case SpectrumWindow::HANN:        return "Hann窗";
+        case SpectrumWindow::BLACKMAN:    return "Blackman窗";
+        default: return "Unknown";
+    }
+}
+
+/**
+ * @brief 实数FFT（点数为2的幂，位反转表和旋转因子预先计算）
+ */
+class FftPlan {
+public:
+    static constexpr double PI = 3.14159265358979323846;
+
+    /**
+     * @brief 构造函数
+     * @param size 点数（2的幂，不小于4）
+     */
+    explicit FftPlan(size_t size = 0) {
+        if (size >= 4) {
+            Init(size);
+        }
+    }
+
+    /**
+     * @brief 重新计算各表（点数不变时直接返回）
+     */
+    void Init(size_t size) {
+        if (size == size_) return;
+        size_ = size;
+        const size_t half = size / 2;
+
+        // N/2点复FFT的位反转表
+        bit_reverse_.resize(half);
+        size_t bits = 0;
+        while ((size_t(1) << bits) < half) bits++;
+        for (size_t i = 0; i < half; i++) {
+            size_t reversed = 0;
+            for (size_t b = 0; b < bits; b++) {
+                reversed |= ((i >> b) & 1) << (bits - 1 - b);
+            }
+            bit_reverse_[i] = static_cast<uint32_t>(reversed);
+        }
+
+        // 复FFT各级的旋转因子 exp(-2πi·j/length)，j < span = length/2，
+        // 按级连续存放：半长为span的一级从下标span-1开始
+        twiddle_re_.resize(std::max<size_t>(half - 1, 1));
+        twiddle_im_.resize(std::max<size_t>(half - 1, 1));
+        for (size_t span = 1; span < half; span <<= 1) {
+            for (size_t j = 0; j < span; j++) {
+                double angle = -PI * static_cast<double>(j) / static_cast<double>(span);
+                twiddle_re_[span - 1 + j] = static_cast<float>(std::cos(angle));
+                twiddle_im_[span - 1 + j] = static_cast<float>(std::sin(angle));
+            }
+        }
+
+        // 拆分实数谱用的旋转因子 exp(-2πi·k/N)，k <= N/2
+        split_re_.resize(half + 1);
+        split_im_.resize(half + 1);
+        for (size_t k = 0; k <= half; k++) {
+            double angle = -2.0 * PI * static_cast<double>(k) / static_cast<double>(size);
+            split_re_[k] = static_cast<float>(std::cos(angle));
+            split_im_[k] = static_cast<float>(std::sin(angle));
+        }
+
+        work_re_.resize(half);
+        work_im_.resize(half);
+    }
+
+    /**
+     * @brief 点数
+     */
+    size_t GetSize() const {
+        return size_;
+    }
+
+    /**
+     * @brief 计算实序列的功率谱并累加：power[k] += |X[k]|²，k = 0 ~ N/2
+     * @param input N个实数
+     * @param power N/2+1个累加值
+     */
+    void AccumulatePower(const float* input, double* power) {
+        const size_t half = size_ / 2;
+        float* re = work_re_.data();
+        float* im = work_im_.data();
+
+        // 打包并按位反转顺序放置
+        for (size_t i = 0; i < half; i++) {
+            size_t j = bit_reverse_[i];
+            re[j] = input[2 * i];
+            im[j] = input[2 * i + 1];
+        }
+
+        // 基2蝶形（每级的旋转因子连续存放）
+        for (size_t span = 1; span < half; span <<= 1) {
+            const float* wr = twiddle_re_.data() + span - 1;
+            const float* wi = twiddle_im_.data() + span - 1;
+            for (size_t start = 0; start < half; start += 2 * span) {
+                float* are = re + start;
+                float* aim = im + start;
+                float* bre = are + span;
+                float* bim = aim + span;
+                for (size_t j = 0; j < span; j++) {
+                    const float tr = bre[j] * wr[j] - bim[j] * wi[j];
+                    const float ti = bre[j] * wi[j] + bim[j] * wr[j];
+                    bre[j] = are[j] - tr;
+                    bim[j] = aim[j] - ti;
+                    are[j] += tr;
+                    aim[j] += ti;
+                }
+            }
+        }
+
+        // 拆分：X[k] = (Z[k] + conj(Z[N/2-k])) / 2 - i·W^k·(Z[k] - conj(Z[N/2-k])) / 2
+        for (size_t k = 0; k <= half; k++) {
+            const size_t k1 = k & (half - 1);           // Z[N/2] = Z[0]
+            const size_t k2 = (half - k) & (half - 1);
+            const float even_re = 0.5f * (re[k1] + re[k2]);
+            const float even_im = 0.5f * (im[k1] - im[k2]);
+            const float odd_re = 0.5f * (im[k1] + im[k2]);
+            const float odd_im = -0.5f * (re[k1] - re[k2]);
+            const float xr = even_re + odd_re * split_re_[k] - odd_im * split_im_[k];
+            const float xi = even_im + odd_re * split_im_[k] + odd_im * split_re_[k];
+            power[k] += static_cast<double>(xr) * xr + static_cast<double>(xi) * xi;
+        }
+    }
+
+private:
+    size_t size_ = 0;                   // 点数N
+    std::vector<uint32_t> bit_reverse_; // N/2点的位反转表
+    std::vector<float> twiddle_re_;     // 复FFT各级旋转因子（实部，按级连续存放）
+    std::vector<float> twiddle_im_;     // 复FFT各级旋转因子（虚部）
+    std::vector<float> split_re_;       // 拆分旋转因子（实部）
+    std::vector<float> split_im_;       // 拆分旋转因子（虚部）
+    std::vector<float> work_re_;        // 工作区（实部）
+    std::vector<float> work_im_;        // 工作区（虚部）
+};
+
+/**
+ * @brief 频谱计算参数
+ */
+struct SpectrumParams {
+    size_t fft_size = 2048;                         // FFT点数（2的幂）
+    size_t segments = 4;                            // Welch平均段数（相邻段重叠50%）
+    SpectrumWindow window = SpectrumWindow::HANN;   // 窗函数
+    bool remove_dc = true;                          // 每段去均值
+
+    /**
+     * @brief 计算所需的样本数
+     */
+    size_t RequiredSamples() const {
+        return fft_size + (segments - 1) * (fft_size / 2);
+    }
+};
+
+/**
+ * @brief 频谱计算输入（UI线程填写）
+ */
+struct SpectrumInput {
+    SpectrumParams params;
+    double sample_rate = 0.0;                       // 采样率（Hz）
+    std::vector<size_t> channels;                   // 通道索引
+    std::vector<std::vector<float>> samples;        // 各通道最近的样本（从旧到新，不含NaN）
+};
+
+/**
+ * @brief 频谱计算结果
+ */
+struct SpectrumResult {
+    uint64_t sequence = 0;                          // 提交序号
+    double sample_rate = 0.0;                       // 采样率（Hz）
+    size_t fft_size = 0;                            // FFT点数
+    size_t segments = 0;                            // 实际平均的段数
+    double compute_ms = 0.0;                        // 计算耗时（毫秒）
+    std::vector<double> frequencies;                // 频点（Hz，fft_size/2+1个）
+    std::vector<size_t> channels;                   // 通道索引
+    std::vector<std::vector<float>> magnitudes;     // 各通道单边幅度谱
+    std::vector<double> peak_frequencies;           // 各通道幅度最大的频率（不含直流，抛物线插值）
+};
+
+/**
+ * @brief 后台频谱分析器（每个频谱组件一个工作线程）
+ */
+class SpectrumAnalyzer {
+public:
+    SpectrumAnalyzer()
+        : worker_(&SpectrumAnalyzer::WorkerLoop, this)
+    {}
+
+    ~SpectrumAnalyzer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        condition_.notify_one();
+        worker_.join();
+    }
+
+    SpectrumAnalyzer(const SpectrumAnalyzer&) = delete;
+    SpectrumAnalyzer& operator=(const SpectrumAnalyzer&) = delete;
+
+    /**
+     * @brief 工作线程是否正在计算
+     */
+    bool IsBusy() const {
+        return busy_.load();
+    }
+
+    /**
+     * @brief 提交计算（与内部缓冲区交换，返回后input中是上一次提交的缓冲区，可直接复用）
+     * @return 正在计算时返回false（input不变）
+     */
+    bool Submit(SpectrumInput& input) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (busy_.load()) return false;
+            std::swap(job_, input);
+            job_sequence_++;
+            busy_.store(true);
+        }
+        condition_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief 取走最新结果（与result交换）
+     * @return 自上次取走后没有新结果时返回false
+     */
+    bool TakeResult(SpectrumResult& result) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!result_ready_) return false;
+        std::swap(result_, result);
+        result_ready_ = false;
+        return true;
+    }
+
+private:
+    /**
+     * @brief 工作线程：等待提交、在锁外计算、加锁交换结果
+     */
+    void WorkerLoop() {
+        SpectrumResult work;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                condition_.wait(lock, [this] { return stop_ || busy_.load(); });
+                if (stop_) return;
+                work.sequence = job_sequence_;
+            }
+
+            // busy_期间UI不会访问job_
+            Compute(job_, work);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::swap(result_, work);
+            result_ready_ = true;
+            busy_.store(false);
+        }
+    }
+
+    /**
+     * @brief 计算各通道的Welch平均幅度谱
+     */
+    void Compute(const SpectrumInput& input, SpectrumResult& result) {
+        auto start_time = std::chrono::steady_clock::now();
+        const SpectrumParams& params = input.params;
+        const size_t n = params.fft_size;
+        const size_t bins = n / 2 + 1;
+        const size_t hop = n / 2;
+
+        plan_.Init(n);
+        UpdateWindow(params.window, n);
+
+        result.sample_rate = input.sample_rate;
+        result.fft_size = n;
+        result.segments = 0;
+        result.frequencies.resize(bins);
+        for (size_t k = 0; k < bins; k++) {
+            result.frequencies[k] = input.sample_rate * static_cast<double>(k) / static_cast<double>(n);
+        }
+        result.channels = input.channels;
+        result.magnitudes.resize(input.channels.size());
+        result.peak_frequencies.assign(input.channels.size(), 0.0);
+
+        segment_.resize(n);
+        power_.resize(bins);
+        for (size_t c = 0; c < input.channels.size(); c++) {
+            const std::vector<float>& samples = input.samples[c];
+            std::vector<float>& magnitude = result.magnitudes[c];
+            if (samples.size() < n) {
+                magnitude.clear();
+                continue;
+            }
+
+            // 段数受样本数限制，使用最新的部分
+            size_t segments = std::min(params.segments, (samples.size() - n) / hop + 1);
+            const float* data = samples.data() + samples.size() - (n + (segments - 1) * hop);
+            std::fill(power_.begin(), power_.end(), 0.0);
+            for (size_t s = 0; s < segments; s++) {
+                const float* source = data + s * hop;
+                float mean = 0.0f;
+                if (params.remove_dc) {
+                    double sum = 0.0;
+                    for (size_t i = 0; i < n; i++) sum += source[i];
+                    mean = static_cast<float>(sum / n);
+                }
+                for (size_t i = 0; i < n; i++) {
+                    segment_[i] = (source[i] - mean) * window_[i];
+                }
+                plan_.AccumulatePower(segment_.data(), power_.data());
+            }
+            result.segments = segments;
+
+            // 单边幅度谱：|X|·2/Σw（直流和奈奎斯特频点不乘2）
+            magnitude.resize(bins);
+            const double inv_segments = 1.0 / static_cast<double>(segments);
+            size_t peak = 1;
+            for (size_t k = 0; k < bins; k++) {
+                double amplitude = std::sqrt(power_[k] * inv_segments) / window_sum_;
+                if (k != 0 && k != bins - 1) amplitude *= 2.0;
+                magnitude[k] = static_cast<float>(amplitude);
+                if (k >= 1 && magnitude[k] > magnitude[peak]) peak = k;
+            }
+            result.peak_frequencies[c] = PeakFrequency(magnitude, peak, result.frequencies[1]);
+        }
+
+        result.compute_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start_time).count();
+    }
+
+    /**
+     * @brief 峰值频率（在峰值和相邻两个频点上做抛物线插值）
+     */
+    static double PeakFrequency(const std::vector<float>& magnitude, size_t peak, double resolution) {
+        double offset = 0.0;
+        if (peak > 0 && peak + 1 < magnitude.size()) {
+            double left = magnitude[peak - 1], center = magnitude[peak], right = magnitude[peak + 1];
+            double denominator = left - 2.0 * center + right;
+            if (denominator < 0.0) {
+                offset = 0.5 * (left - right) / denominator;
+            }
+        }
+        return (static_cast<double>(peak) + offset) * resolution;
+    }
+
+    /**
+     * @brief 重新计算窗函数（类型和点数不变时直接返回）
+     */
+    void UpdateWindow(SpectrumWindow window, size_t n) {
+        if (window == window_type_ && window_.size() == n) return;
+        window_type_ = window;
+        window_.resize(n);
+        window_sum_ = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            // 周期型窗（分母为n），Welch分段时重叠相加更平坦
+            double x = 2.0 * FftPlan::PI * static_cast<double>(i) / static_cast<double>(n);
+            double w = 1.0;
+            switch (window) {
+                case SpectrumWindow::HANN:
+                    w = 0.5 - 0.5 * std::cos(x);
+                    break;
+                case SpectrumWindow::BLACKMAN:
+                    w = 0.42 - 0.5 * std::cos(x) + 0.08 * std::cos(2.0 * x);
+                    break;
+                default:
+                    break;
+            }
+            window_[i] = static_cast<float>(w);
+            window_sum_ += w;
+        }
+    }
+
+    // 工作线程状态（只在工作线程中访问）
+    FftPlan plan_;                                  // FFT表
+    std::vector<float> window_;                     // 窗函数
+    double window_sum_ = 0.0;                       // 窗函数之和（相干增益×N）
+    SpectrumWindow window_type_ = SpectrumWindow::RECTANGULAR;
+    std::vector<float> segment_;                    // 加窗后的一段
+    std::vector<double> power_;                     // 功率谱累加
+
+    // 与UI线程共享
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::atomic<bool> busy_{false};                 // 已提交、尚未算完
+    bool stop_ = false;                             // 退出工作线程
+    SpectrumInput job_;                             // 正在计算的输入
+    uint64_t job_sequence_ = 0;                     // 提交序号
+    SpectrumResult result_;                         // 最新结果
+    bool result_ready_ = false;                     // 有未取走的结果
+
+    std::thread worker_;                            // 工作线程（最后初始化）
+};
+
+#endif // SPECTRUM_ANALYZER_H
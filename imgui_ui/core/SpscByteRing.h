@@ -0,0 +1,172 @@
+/**
+ * @file SpscByteRing.h
+ * @brief 无锁单生产者/单消费者字节环形缓冲区
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 用于串口接收线程（生产者）与解析线程（消费者）之间传递原始字节：
+ * - 容量向上取整为2的幂，构造时一次性分配，之后无堆分配
+ * - 读写索引单调递增，通过掩码取模，原子变量分别独占缓存行
+ * - 写入为“全有或全无”：空间不足时整块丢弃并计入丢弃字节数
+ * - 消费者通过Peek()获得最多两段连续内存，处理后调用Consume()
+ * - 记录当前占用和历史最高占用（high-water），用于监控背压
+ */
+
+#ifndef SPSC_BYTE_RING_H
+#define SPSC_BYTE_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/**
+ * @brief 无锁SPSC字节环形缓冲区
+ */
+class SpscByteRing {
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 期望容量（字节，自动向上取整为2的幂）
+     */
+    explicit SpscByteRing(size_t capacity = 1 << 20) {
+        size_t actual = 1;
+        while (actual < capacity) {
+            actual <<= 1;
+        }
+        buffer_.resize(actual);
+        mask_ = actual - 1;
+    }
+
+    SpscByteRing(const SpscByteRing&) = delete;
+    SpscByteRing& operator=(const SpscByteRing&) = delete;
+
+    // ==================== 生产者接口 ====================
+
+    /**
+     * @brief 写入数据（仅生产者线程调用）
+     * @param data 数据指针
+     * @param length 数据长度
+     * @return 成功返回true；空间不足时整块丢弃并返回false
+     */
+    bool Write(const unsigned char* data, size_t length) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        size_t free_space = buffer_.size() - (head - cached_tail_);
+        if (free_space < length) {
+            // 刷新消费者位置后重试
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            free_space = buffer_.size() - (head - cached_tail_);
+            if (free_space < length) {
+                dropped_bytes_.fetch_add(length, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        // 最多两段memcpy（跨越缓冲区末尾时）
+        const size_t offset = head & mask_;
+        const size_t first = (length < buffer_.size() - offset) ? length : buffer_.size() - offset;
+        std::memcpy(&buffer_[offset], data, first);
+        if (first < length) {
+            std::memcpy(&buffer_[0], data + first, length - first);
+        }
+
+        head_.store(head + length, std::memory_order_release);
+
+        // 更新最高占用（单生产者，无需CAS）
+        const size_t used = head + length - cached_tail_;
+        if (used > high_water_.load(std::memory_order_relaxed)) {
+            high_water_.store(used, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // ==================== 消费者接口 ====================
+
+    /**
+     * @brief 获取可读数据的连续片段（仅消费者线程调用）
+     * @param first 第一段起始地址
+     * @param first_len 第一段长度
+     * @param second 第二段起始地址（未跨越末尾时为nullptr）
+     * @param second_len 第二段长度
+     * @return 可读总字节数
+     */
+    size_t Peek(const unsigned char*& first, size_t& first_len,
+                const unsigned char*& second, size_t& second_len) const {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t available = head - tail;
+
+        const size_t offset = tail & mask_;
+        first = &buffer_[offset];
+        first_len = (available < buffer_.size() - offset) ? available : buffer_.size() - offset;
+        second = (first_len < available) ? &buffer_[0] : nullptr;
+        second_len = available - first_len;
+        return available;
+    }
+
+    /**
+     * @brief 标记已消费字节（仅消费者线程调用）
+     * @param length 已处理的字节数（不超过Peek返回值）
+     */
+    void Consume(size_t length) {
+        tail_.store(tail_.load(std::memory_order_relaxed) + length, std::memory_order_release);
+    }
+
+    // ==================== 监控接口（任意线程） ====================
+
+    /**
+     * @brief 当前占用字节数
+     */
+    size_t Size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 是否为空
+     */
+    bool Empty() const {
+        return Size() == 0;
+    }
+
+    /**
+     * @brief 容量（字节）
+     */
+    size_t Capacity() const {
+        return buffer_.size();
+    }
+
+    /**
+     * @brief 历史最高占用（字节）
+     */
+    size_t HighWater() const {
+        return high_water_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 因空间不足被丢弃的字节数
+     */
+    uint64_t DroppedBytes() const {
+        return dropped_bytes_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 重置监控统计（不影响数据）
+     */
+    void ResetStats() {
+        high_water_.store(Size(), std::memory_order_relaxed);
+        dropped_bytes_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::vector<unsigned char> buffer_;                 // 数据存储（构造时分配）
+    size_t mask_;                                       // 容量掩码
+
+    alignas(64) std::atomic<size_t> head_{0};           // 写索引（生产者独占写）
+    size_t cached_tail_ = 0;                            // 生产者缓存的读索引
+    alignas(64) std::atomic<size_t> tail_{0};           // 读索引（消费者独占写）
+    alignas(64) std::atomic<size_t> high_water_{0};     // 最高占用
+    std::atomic<uint64_t> dropped_bytes_{0};            // 丢弃字节数
+};
+
+#endif // SPSC_BYTE_RING_H
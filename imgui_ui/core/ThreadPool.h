@@ -126,6 +126,21 @@ public:
         return res;
     }
 
+    /**
+     * @brief 提交无返回值任务（不创建future，适合高频小任务）
+     * @param task 任务函数
+     */
+    void Post(std::function<void()> task) {
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            if (stop_) {
+                throw std::runtime_error("Post on stopped ThreadPool");
+            }
+            tasks_.emplace(std::move(task));
+        }
+        condition_.notify_one();
+    }
+
     /**
      * @brief 获取当前线程数量
      */
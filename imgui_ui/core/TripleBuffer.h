@@ -0,0 +1,92 @@
+/**
+ * @file TripleBuffer.h
+ * @brief 无锁三缓冲 - 单写者发布快照，单读者获取最新快照
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 三个槽位分别归写者、读者和“中转”所有：
+ * - 写者在自己的槽位中填好数据后Publish()，与中转槽位原子交换
+ * - 读者Update()时若中转槽位有新数据，与自己的槽位原子交换
+ * - 双方只做一次原子交换，写者永远不会等待读者，读者拿到的槽位
+ *   在下一次Update()之前不会被写者修改
+ *
+ * 约束：同一时刻只能有一个写者（多个写线程需由外部互斥锁串行化）
+ * 和一个读者。
+ */
+
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief 无锁三缓冲
+ * @tparam T 快照类型
+ */
+template<typename T>
+class TripleBuffer {
+public:
+    TripleBuffer()
+        : middle_(1)
+        , write_index_(0)
+        , read_index_(2)
+    {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /**
+     * @brief 写者的槽位（填充数据后调用Publish）
+     */
+    T& GetWriteBuffer() {
+        return slots_[write_index_];
+    }
+
+    /**
+     * @brief 发布写者槽位中的数据（写者调用）
+     */
+    void Publish() {
+        uint8_t previous = middle_.exchange(static_cast<uint8_t>(write_index_ | FRESH_BIT),
+                                            std::memory_order_acq_rel);
+        write_index_ = previous & INDEX_MASK;
+    }
+
+    /**
+     * @brief 获取最新发布的数据（读者调用）
+     * @return 有新数据时返回true
+     */
+    bool Update() {
+        if ((middle_.load(std::memory_order_relaxed) & FRESH_BIT) == 0) {
+            return false;
+        }
+        uint8_t previous = middle_.exchange(read_index_, std::memory_order_acq_rel);
+        read_index_ = previous & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * @brief 读者当前持有的槽位
+     */
+    const T& GetReadBuffer() const {
+        return slots_[read_index_];
+    }
+
+    /**
+     * @brief 访问全部槽位（仅用于初始化，不得与读写并发）
+     */
+    T& GetSlot(int index) {
+        return slots_[index];
+    }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x03;
+    static constexpr uint8_t FRESH_BIT = 0x04;     // 中转槽位有读者未取走的新数据
+
+    T slots_[3];
+    std::atomic<uint8_t> middle_;   // 中转槽位索引 | FRESH_BIT
+    uint8_t write_index_;           // 写者槽位（仅写者访问）
+    uint8_t read_index_;            // 读者槽位（仅读者访问）
+};
+
+#endif // TRIPLE_BUFFER_H
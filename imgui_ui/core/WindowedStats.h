@@ -0,0 +1,455 @@
+/**
+ * @file WindowedStats.h
+ * @brief 通道统计 - 全程统计与滑动窗口统计，每个样本均摊O(1)
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 全程统计（自清空以来）：
+ * - 均值/方差用Welford算法在double中累积，不做“平方和减平方均值”，长时间运行不丢精度
+ * - 批量写入时对整块一遍累积相对块内第一个值的偏差和与偏差平方和（平移后不会相消），
+ *   得到块均值和离差平方和后按Chan公式合并，每块一次除法
+ *
+ * 滑动窗口统计（最近window个有效样本）：
+ * - 样本存于2的幂大小的环形数组（首次写入时分配）
+ * - 最小/最大值用单调队列，队列元素是CHUNK个样本一组的块：
+ *   写入时只无分支地累积当前块的最小/最大值，块写满时入队
+ *   （队尾不优于新块的出队，队头移出窗口的出队），每块最多入队、出队各一次；
+ *   查询时合并队头、当前未满的块和窗口最旧端不完整的块（扫描不超过CHUNK个样本）。
+ *   逐样本维护单调队列时出队循环的分支随数据跳变，难以预测，按块维护把这部分开销摊薄到1/CHUNK
+ * - 均值/方差用滑动Welford：加入新样本的同时移除最旧样本，O(1)更新；
+ *   每写入REFRESH_WINDOWS个窗口的样本按环形数组重新精确计算一次，
+ *   限制浮点误差累积（均摊O(1)）
+ * - RMS由均值和方差得到：RMS² = 均值² + 方差；峰峰值 = 最大值 - 最小值
+ *
+ * NaN（该帧没有此通道）不计入任何统计。不加锁，由调用者（DataChannelManager）保护。
+ */
+
+#ifndef WINDOWED_STATS_H
+#define WINDOWED_STATS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "CircularBuffer.h"
+
+/**
+ * @brief 通道统计信息
+ */
+struct ChannelStats {
+    float min_value;
+    float max_value;
+    float avg_value;
+    float std_dev;        // 总体标准差
+    float last_value;     // 最后一个值
+    size_t sample_count;
+
+    // 滑动窗口统计（最近window_count个有效样本）
+    float window_min;
+    float window_max;
+    float window_mean;
+    float window_std;     // 窗口内总体标准差
+    float window_rms;     // 窗口内均方根
+    size_t window_count;  // 窗口内样本数（不超过窗口长度）
+
+    // 全程分位数（流式估计，见QuantileSketch）
+    float p50;
+    float p95;
+    float p99;
+    float p999;
+
+    ChannelStats() {
+        Reset();
+    }
+
+    void Reset() {
+        min_value = max_value = avg_value = std_dev = last_value = 0.0f;
+        sample_count = 0;
+        window_min = window_max = window_mean = window_std = window_rms = 0.0f;
+        window_count = 0;
+        p50 = p95 = p99 = p999 = 0.0f;
+    }
+
+    /**
+     * @brief 窗口内峰峰值
+     */
+    float PeakToPeak() const {
+        return window_max - window_min;
+    }
+};
+
+/**
+ * @brief 单个通道的全程统计和滑动窗口统计
+ */
+class WindowedStats {
+public:
+    static constexpr size_t DEFAULT_WINDOW = 1000;     // 默认窗口长度（样本）
+    static constexpr size_t MIN_WINDOW = 2;            // 最小窗口长度
+    static constexpr size_t MAX_WINDOW = 65536;        // 最大窗口长度
+    static constexpr size_t REFRESH_WINDOWS = 4;       // 每写入几个窗口的样本精确重算一次
+
+    /**
+     * @brief 构造函数
+     * @param window 窗口长度（样本数，限制在MIN_WINDOW~MAX_WINDOW）
+     */
+    explicit WindowedStats(size_t window = DEFAULT_WINDOW) {
+        window_ = ClampWindow(window);
+        Reset();
+    }
+
+    /**
+     * @brief 限制窗口长度范围
+     */
+    static size_t ClampWindow(size_t window) {
+        return std::min(std::max(window, MIN_WINDOW), MAX_WINDOW);
+    }
+
+    /**
+     * @brief 修改窗口长度（清空窗口统计，全程统计保留）
+     */
+    void SetWindow(size_t window) {
+        window = ClampWindow(window);
+        if (window == window_) return;
+        window_ = window;
+        // 环形数组在下一次写入时按新长度重新分配
+        std::vector<float>().swap(ring_);
+        std::vector<float>().swap(chunk_min_);
+        std::vector<float>().swap(chunk_max_);
+        std::vector<uint64_t>().swap(min_queue_);
+        std::vector<uint64_t>().swap(max_queue_);
+        ResetWindow();
+    }
+
+    /**
+     * @brief 窗口长度（样本）
+     */
+    size_t GetWindow() const {
+        return window_;
+    }
+
+    /**
+     * @brief 清空全部统计（保留窗口长度和已分配的内存）
+     */
+    void Reset() {
+        count_ = 0;
+        mean_ = 0.0;
+        m2_ = 0.0;
+        min_value_ = max_value_ = last_value_ = 0.0f;
+        ResetWindow();
+    }
+
+    /**
+     * @brief 写入一个样本（NaN忽略）
+     */
+    void Push(float value) {
+        PushBatch(&value, 1);
+    }
+
+    /**
+     * @brief 批量写入样本（NaN忽略）
+     * @param values 数据数组
+     * @param length 数据长度
+     */
+    void PushBatch(const float* values, size_t length) {
+        // 全程统计：块内第一个有效值作为平移量，一遍得到块的均值和离差平方和
+        size_t first = 0;
+        while (first < length && std::isnan(values[first])) first++;
+        if (first == length) return;
+        size_t last = length - 1;
+        while (std::isnan(values[last])) last--;
+        last_value_ = values[last];
+
+        // 无分支累积：NaN比较结果为false，不影响最小/最大值，偏差按0计入
+        const float shift = values[first];
+        float block_min = shift, block_max = shift;
+        size_t block_count = 0;
+        double sum = 0.0, sum_sq = 0.0;
+        for (size_t i = first; i <= last; i++) {
+            float value = values[i];
+            bool valid = !std::isnan(value);
+            double d = valid ? static_cast<double>(value - shift) : 0.0;
+            block_min = std::min(block_min, value);
+            block_max = std::max(block_max, value);
+            sum += d;
+            sum_sq += d * d;
+            block_count += valid;
+        }
+        double block_mean = shift + sum / block_count;
+        double block_m2 = std::max(sum_sq - sum * sum / block_count, 0.0);
+
+        if (count_ == 0) {
+            min_value_ = block_min;
+            max_value_ = block_max;
+            mean_ = block_mean;
+            m2_ = block_m2;
+        } else {
+            min_value_ = std::min(min_value_, block_min);
+            max_value_ = std::max(max_value_, block_max);
+            double total = static_cast<double>(count_) + block_count;
+            double delta = block_mean - mean_;
+            mean_ += delta * (block_count / total);
+            m2_ += block_m2 + delta * delta * (static_cast<double>(count_) * block_count / total);
+        }
+        count_ += block_count;
+
+        // 窗口统计：逐样本滑动
+        if (ring_.empty()) {
+            AllocateWindow();
+        }
+        PushWindow(values, length);
+    }
+
+    /**
+     * @brief 当前统计结果
+     */
+    ChannelStats GetStats() const {
+        ChannelStats stats;
+        if (count_ == 0) return stats;
+
+        stats.min_value = min_value_;
+        stats.max_value = max_value_;
+        stats.avg_value = static_cast<float>(mean_);
+        stats.std_dev = static_cast<float>(std::sqrt(m2_ / count_));
+        stats.last_value = last_value_;
+        stats.sample_count = static_cast<size_t>(count_);
+
+        if (window_count_ > 0) {
+            double variance = std::max(window_m2_, 0.0) / window_count_;
+            GetWindowRange(stats.window_min, stats.window_max);
+            stats.window_mean = static_cast<float>(window_mean_);
+            stats.window_std = static_cast<float>(std::sqrt(variance));
+            stats.window_rms = static_cast<float>(std::sqrt(window_mean_ * window_mean_ + variance));
+            stats.window_count = window_count_;
+        }
+        return stats;
+    }
+
+    /**
+     * @brief 窗口状态占用的字节数
+     */
+    size_t GetMemoryUsage() const {
+        return ring_.capacity() * sizeof(float) +
+               (chunk_min_.capacity() + chunk_max_.capacity()) * sizeof(float) +
+               (min_queue_.capacity() + max_queue_.capacity()) * sizeof(uint64_t);
+    }
+
+private:
+    static constexpr size_t CHUNK = 64;                 // 单调队列中每块的样本数（2的幂）
+
+    /**
+     * @brief 清空窗口统计
+     */
+    void ResetWindow() {
+        next_seq_ = 0;
+        window_count_ = 0;
+        window_mean_ = 0.0;
+        window_m2_ = 0.0;
+        since_refresh_ = 0;
+        chunk_min_value_ = std::numeric_limits<float>::infinity();
+        chunk_max_value_ = -std::numeric_limits<float>::infinity();
+        min_head_ = min_tail_ = 0;
+        max_head_ = max_tail_ = 0;
+    }
+
+    /**
+     * @brief 按窗口长度分配环形数组、块最值和单调队列
+     *
+     * 队列中的块都完整落在窗口内，不超过window / CHUNK个，块最值按同样的下标环形存放
+     */
+    void AllocateWindow() {
+        size_t size = CircularBuffer<float>::RoundCapacity(window_);
+        ring_.resize(size);
+        ring_mask_ = size - 1;
+
+        size_t chunks = CircularBuffer<float>::RoundCapacity(window_ / CHUNK + 2);
+        chunk_min_.resize(chunks);
+        chunk_max_.resize(chunks);
+        min_queue_.resize(chunks);
+        max_queue_.resize(chunks);
+        chunk_mask_ = chunks - 1;
+    }
+
+    /**
+     * @brief 窗口批量写入（NaN跳过）
+     *
+     * 逐样本的状态放在局部变量中，循环结束后写回
+     */
+    void PushWindow(const float* values, size_t length) {
+        float* ring = ring_.data();
+        const size_t ring_mask = ring_mask_;
+        const size_t window = window_;
+        const double inv_window = 1.0 / static_cast<double>(window);
+        uint64_t seq = next_seq_;
+        size_t count = window_count_;
+        double mean = window_mean_;
+        double m2 = window_m2_;
+        float chunk_min = chunk_min_value_;
+        float chunk_max = chunk_max_value_;
+        size_t since_refresh = since_refresh_;
+        const size_t refresh_period = window * REFRESH_WINDOWS;
+
+        for (size_t i = 0; i < length; i++) {
+            const float value = values[i];
+            if (std::isnan(value)) continue;
+
+            // 窗口已满：移除最旧样本（环形数组大小可能等于窗口长度，先读出再覆盖）
+            if (count == window) {
+                double old_value = ring[(seq - window) & ring_mask];
+                double old_mean = mean;
+                double delta = value - old_value;
+                mean += delta * inv_window;
+                m2 += delta * (value - mean + old_value - old_mean);
+            } else {
+                count++;
+                double delta = value - mean;
+                mean += delta / static_cast<double>(count);
+                m2 += delta * (value - mean);
+            }
+            ring[seq & ring_mask] = value;
+            chunk_min = std::min(chunk_min, value);
+            chunk_max = std::max(chunk_max, value);
+            seq++;
+
+            // 块写满：入队
+            if ((seq & (CHUNK - 1)) == 0) {
+                PushChunk(seq / CHUNK - 1, chunk_min, chunk_max, seq - count);
+                chunk_min = std::numeric_limits<float>::infinity();
+                chunk_max = -std::numeric_limits<float>::infinity();
+            }
+
+            // 定期精确重算均值和离差平方和
+            if (++since_refresh >= refresh_period) {
+                since_refresh = 0;
+                next_seq_ = seq;
+                window_count_ = count;
+                RefreshWindow();
+                mean = window_mean_;
+                m2 = window_m2_;
+            }
+        }
+
+        next_seq_ = seq;
+        window_count_ = count;
+        window_mean_ = mean;
+        window_m2_ = m2;
+        chunk_min_value_ = chunk_min;
+        chunk_max_value_ = chunk_max;
+        since_refresh_ = since_refresh;
+    }
+
+    /**
+     * @brief 写满的块入队
+     * @param chunk 块序号（覆盖样本序号[chunk * CHUNK, (chunk + 1) * CHUNK)）
+     * @param min_value 块内最小值
+     * @param max_value 块内最大值
+     * @param oldest 窗口内最旧样本的序号
+     */
+    void PushChunk(uint64_t chunk, float min_value, float max_value, uint64_t oldest) {
+        const uint64_t first_full = (oldest + CHUNK - 1) / CHUNK;   // 第一个完整落在窗口内的块
+
+        chunk_min_[chunk & chunk_mask_] = min_value;
+        chunk_max_[chunk & chunk_mask_] = max_value;
+
+        while (min_head_ != min_tail_ && min_queue_[min_head_ & chunk_mask_] < first_full) min_head_++;
+        while (min_head_ != min_tail_ && chunk_min_[min_queue_[(min_tail_ - 1) & chunk_mask_] & chunk_mask_] >= min_value) {
+            min_tail_--;
+        }
+        min_queue_[min_tail_++ & chunk_mask_] = chunk;
+
+        while (max_head_ != max_tail_ && max_queue_[max_head_ & chunk_mask_] < first_full) max_head_++;
+        while (max_head_ != max_tail_ && chunk_max_[max_queue_[(max_tail_ - 1) & chunk_mask_] & chunk_mask_] <= max_value) {
+            max_tail_--;
+        }
+        max_queue_[max_tail_++ & chunk_mask_] = chunk;
+    }
+
+    /**
+     * @brief 窗口内的最小/最大值（window_count_ > 0）
+     *
+     * 窗口[oldest, end)分为三段：最旧端不完整的块（直接扫描环形数组）、
+     * 完整的块（单调队列中第一个未移出窗口的块）、当前未满的块（累积值）
+     */
+    void GetWindowRange(float& min_value, float& max_value) const {
+        const uint64_t end = next_seq_;
+        const uint64_t oldest = end - window_count_;
+        const uint64_t first_full = (oldest + CHUNK - 1) / CHUNK;
+        const uint64_t current = end / CHUNK;
+
+        min_value = std::numeric_limits<float>::infinity();
+        max_value = -std::numeric_limits<float>::infinity();
+
+        for (uint64_t seq = oldest; seq < std::min(first_full * CHUNK, end); seq++) {
+            min_value = std::min(min_value, ring_[seq & ring_mask_]);
+            max_value = std::max(max_value, ring_[seq & ring_mask_]);
+        }
+
+        // 队头的块可能在上次入队后才移出窗口
+        uint64_t head = min_head_;
+        while (head != min_tail_ && min_queue_[head & chunk_mask_] < first_full) head++;
+        if (head != min_tail_) {
+            min_value = std::min(min_value, chunk_min_[min_queue_[head & chunk_mask_] & chunk_mask_]);
+        }
+        head = max_head_;
+        while (head != max_tail_ && max_queue_[head & chunk_mask_] < first_full) head++;
+        if (head != max_tail_) {
+            max_value = std::max(max_value, chunk_max_[max_queue_[head & chunk_mask_] & chunk_mask_]);
+        }
+
+        if (current >= first_full && end > current * CHUNK) {
+            min_value = std::min(min_value, chunk_min_value_);
+            max_value = std::max(max_value, chunk_max_value_);
+        }
+    }
+
+    /**
+     * @brief 按环形数组中的窗口样本重新计算均值和离差平方和（两遍）
+     */
+    void RefreshWindow() {
+        since_refresh_ = 0;
+        const uint64_t first = next_seq_ - window_count_;
+        double sum = 0.0;
+        for (size_t i = 0; i < window_count_; i++) {
+            sum += ring_[(first + i) & ring_mask_];
+        }
+        double mean = sum / window_count_;
+        double m2 = 0.0;
+        for (size_t i = 0; i < window_count_; i++) {
+            double d = ring_[(first + i) & ring_mask_] - mean;
+            m2 += d * d;
+        }
+        window_mean_ = mean;
+        window_m2_ = m2;
+    }
+
+    // 全程统计
+    uint64_t count_;                    // 有效样本数
+    double mean_;                       // 均值
+    double m2_;                         // 离差平方和
+    float min_value_;                   // 最小值
+    float max_value_;                   // 最大值
+    float last_value_;                  // 最后一个值
+
+    // 窗口统计
+    size_t window_;                     // 窗口长度（样本）
+    std::vector<float> ring_;           // 窗口样本（2的幂大小，首次写入时分配）
+    size_t ring_mask_ = 0;              // 环形数组下标掩码
+    uint64_t next_seq_;                 // 下一个样本的序号
+    size_t window_count_;               // 窗口内样本数
+    double window_mean_;                // 窗口均值
+    double window_m2_;                  // 窗口离差平方和
+    size_t since_refresh_;              // 距上次精确重算的样本数
+
+    // 窗口最值（按块的单调队列）
+    std::vector<float> chunk_min_;      // 各块最小值（按块序号环形存放）
+    std::vector<float> chunk_max_;      // 各块最大值
+    std::vector<uint64_t> min_queue_;   // 最小值单调队列（块序号，对应值递增）
+    std::vector<uint64_t> max_queue_;   // 最大值单调队列（块序号，对应值递减）
+    size_t chunk_mask_ = 0;             // 块数组和队列的下标掩码
+    uint64_t min_head_, min_tail_;      // 最小值队列头尾（递增计数）
+    uint64_t max_head_, max_tail_;      // 最大值队列头尾（递增计数）
+    float chunk_min_value_;             // 当前未满块的最小值
+    float chunk_max_value_;             // 当前未满块的最大值
+};
+
+#endif // WINDOWED_STATS_H
@@ -20,6 +20,7 @@
 #include <mutex>
 #include <fstream>
 #include <chrono>
+#include <ctime>
 
 // Windows OpenGL
 #if defined(_WIN32)
@@ -27,7 +28,7 @@
 #endif
 
 // 串口和数据转换
-#include "SerialPort_Win.h"
+#include "SerialPort.h"
 #include "DataConverter.h"
 
 // 可视化系统
@@ -45,6 +46,15 @@
 // 视图类型枚举已移至AppState.h
 // 应用程序状态结构已移至AppState.h
 
+// 跨平台本地时间转换（Windows: localtime_s，POSIX: localtime_r）
+static void LocalTime(const std::time_t& time, struct tm& out) {
+#ifdef _WIN32
+    localtime_s(&out, &time);
+#else
+    localtime_r(&time, &out);
+#endif
+}
+
 // GLFW错误回调
 static void glfw_error_callback(int error, const char* description) {
     fprintf(stderr, "GLFW Error %d: %s\n", error, description);
@@ -195,7 +205,7 @@ void AddDataLog(AppState* state, const std::string& content, DataDirection direc
             now.time_since_epoch()) % 1000;
 
         struct tm timeinfo;
-        localtime_s(&timeinfo, &now_c);
+        LocalTime(now_c, timeinfo);
         char buf[32];
 
         // 根据显示模式决定时间戳精度
@@ -244,39 +254,30 @@ void AddDataLog(AppState* state, const std::string& content, DataDirection direc
     state->scroll_to_bottom = true;
 }
 
-// 数据处理函数（在后台线程中执行）
-void ProcessDataPacket(AppState* state, const std::vector<unsigned char>& data) {
-    size_t length = data.size();
-
-    // 传递原始数据给可视化系统
-    state->visualization_ui.ProcessReceivedData(data.data(), length);
-
-    // 编码转换
-    std::string dataStr;
-    if (state->hex_display) {
-        dataStr = DataConverter::BytesToHexString(data.data(), length, true);
-    } else {
-        // 使用指定编码转换为UTF-8
-        dataStr = DataConverter::ConvertToUTF8(data.data(), length, state->encoding_type);
+// 格式化接收数据用于显示（无共享状态，可在任意工作线程并行执行）
+std::string FormatReceivedData(const unsigned char* data, size_t length, bool hex, EncodingType encoding) {
+    if (hex) {
+        return DataConverter::BytesToHexString(data, static_cast<int>(length), true);
     }
+    // 使用指定编码转换为UTF-8
+    return DataConverter::ConvertToUTF8(data, static_cast<int>(length), encoding);
+}
 
+// 提交格式化结果（由rx_log_committer按序号串行调用）
+// 数据日志和日志文件必须按接收顺序落地，留在提交器中串行执行；
+// 多线程时提交器运行在补齐序号的格式化线程上，不占用解析所在的有序阶段
+void CommitReceivedText(AppState* state, const std::string& dataStr) {
     // 添加到数据日志（分色显示：RX为蓝色）
     AddDataLog(state, dataStr, DataDirection::RX);
 
-    // 更新统计信息
-    {
-        std::lock_guard<std::mutex> lock(state->receive_mutex);
-        state->bytes_received += length;
-    }
-
-    // 文件写入（锁外执行，避免阻塞）
+    // 文件写入
     if (state->enable_logging && !state->log_filename.empty()) {
         std::ofstream logFile(state->log_filename, std::ios::app);
         if (logFile.is_open()) {
             auto now = std::chrono::system_clock::now();
             auto now_c = std::chrono::system_clock::to_time_t(now);
             struct tm timeinfo;
-            localtime_s(&timeinfo, &now_c);
+            LocalTime(now_c, timeinfo);
             char timeStr[64];
             strftime(timeStr, sizeof(timeStr), "[%Y-%m-%d %H:%M:%S] ", &timeinfo);
 
@@ -303,6 +304,40 @@ void ProcessDataPacket(AppState* state, const std::vector<unsigned char>& data)
     }
 }
 
+// 数据处理函数（有序阶段：在消费线程中执行，多线程关闭时在接收线程中执行）
+// stream_offset为接收回调分配的字节流位置，随解析结果带到数据写入处校验顺序
+// fanout非空时，数据块拷入rx_chunk_slots的槽位，由线程池并行格式化，结果按数据块序号提交
+void ProcessDataPacket(AppState* state, const unsigned char* data, size_t length, uint64_t stream_offset,
+                       ThreadPool* fanout) {
+    // 协议解析（解析器有状态，只能在此有序阶段执行）
+    state->visualization_ui.ProcessReceivedData(data, length, stream_offset);
+
+    // 更新统计信息（原子累加，不加锁）
+    state->bytes_received.fetch_add(static_cast<int>(length), std::memory_order_relaxed);
+
+    // 分配数据块序号，显示/日志按此顺序落地
+    uint64_t seq = state->rx_chunk_sequence.fetch_add(1, std::memory_order_relaxed);
+    RxFormat format;
+    format.hex = state->hex_display;
+    format.encoding = state->encoding_type;
+
+    if (fanout) {
+        // 环形缓冲区中的数据在返回后即被覆盖：拷入预分配的槽位（缓冲区循环复用，不逐块分配）
+        state->rx_chunk_slots.Dispatch(*fanout, seq, data, length, format);
+    } else {
+        state->rx_log_committer.Submit(seq, FormatReceivedData(data, length, format.hex, format.encoding));
+    }
+}
+
+// 启动接收数据消费线程
+// 线程池指针在启动时确定；修改线程池前必须先停止消费线程
+void StartIngestThread(AppState& state) {
+    ThreadPool* fanout = state.thread_pool.get();
+    state.ingest_thread.Start([&state, fanout](const unsigned char* data, size_t length, uint64_t stream_offset) {
+        ProcessDataPacket(&state, data, length, stream_offset, fanout);
+    });
+}
+
 // 渲染串口配置面板
 void RenderSerialConfigPanel(AppState& state) {
     // 面板标题
@@ -379,7 +414,7 @@ void RenderSerialConfigPanel(AppState& state) {
     if (ImGui::Button(state.ports_enumerating ? "扫描中..." : "刷新端口", ImVec2(300, 40))) {
         if (!state.ports_enumerating && !state.is_connected) {
             // 启动异步枚举
-            state.port_enum_future = SerialPort_Win::EnumeratePortsAsync();
+            state.port_enum_future = SerialPort::EnumeratePortsAsync();
             state.ports_enumerating = true;
         }
     }
@@ -446,36 +481,54 @@ void RenderSerialConfigPanel(AppState& state) {
                 // 校验位映射
                 config.parity = state.selected_parity_index;
 
+                // 接收队列与读取块大小
+                config.rxQueueSize = state.rx_queue_size;
+                config.readChunkSize = state.read_chunk_size;
+
+                // 新连接重新识别协议（接收线程启动之前）
+                state.visualization_ui.ResetAutoDetection();
+
+                // 设置接收回调（异步处理模式，须在打开串口之前设置）
+                state.serial_port->SetReceiveCallback([&state](const unsigned char* data, int length) {
+                    // 模式切换期间在此等待（见RenderSettingsDialog）
+                    ReceiveGate::Scope gate(state.rx_gate);
+
+                    // 流水线入口：为数据块分配字节流位置
+                    uint64_t stream_offset = state.rx_stream_offset.fetch_add(
+                        static_cast<uint64_t>(length), std::memory_order_relaxed);
+                    if (state.thread_config.enable_multithreading && state.ingest_thread.IsRunning()) {
+                        // 多线程模式：直接写入无锁环形缓冲区，由消费线程处理（无堆分配）
+                        state.ingest_thread.Push(data, static_cast<size_t>(length), stream_offset);
+                    } else {
+                        // 单线程模式：直接同步处理
+                        ProcessDataPacket(&state, data, static_cast<size_t>(length), stream_offset, nullptr);
+                    }
+                });
+
                 // 打开串口
-                if (state.serial_port.Open(config)) {
+                if (state.serial_port->Open(config)) {
                     state.is_connected = true;
+                    state.connection_error.clear();
 
                     // 初始化定时发送计时器
                     state.last_send_time = std::chrono::steady_clock::now();
-
-                    // 设置接收回调（异步处理模式）
-                    state.serial_port.SetReceiveCallback([&state](const unsigned char* data, int length) {
-                        // 复制数据到队列（快速操作，不阻塞）
-                        std::vector<unsigned char> data_copy(data, data + length);
-
-                        if (state.thread_config.enable_multithreading && state.thread_pool) {
-                            // 多线程模式：提交到线程池异步处理
-                            state.thread_pool->Enqueue(ProcessDataPacket, &state, data_copy);
-                        } else {
-                            // 单线程模式：直接同步处理
-                            ProcessDataPacket(&state, data_copy);
-                        }
-                    });
+                } else {
+                    state.connection_error = state.serial_port->GetLastError();
                 }
             }
         } else {
             // 断开串口
-            state.serial_port.Close();
+            state.serial_port->Close();
             state.is_connected = false;
         }
     }
 
     ImGui::PopStyleColor(3);
+
+    // 打开失败或设备断开的原因
+    if (!state.is_connected && !state.connection_error.empty()) {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", state.connection_error.c_str());
+    }
 }
 
 // 渲染数据显示面板
@@ -525,7 +578,7 @@ void RenderDataDisplayPanel(AppState& state) {
         auto now = std::chrono::system_clock::now();
         auto now_c = std::chrono::system_clock::to_time_t(now);
         struct tm timeinfo;
-        localtime_s(&timeinfo, &now_c);
+        LocalTime(now_c, timeinfo);
         char filename[128];
         strftime(filename, sizeof(filename), "serial_log_%Y%m%d_%H%M%S.txt", &timeinfo);
         state.log_filename = filename;
@@ -628,7 +681,17 @@ void RenderDataDisplayPanel(AppState& state) {
     ImGui::PopStyleColor();
 
     // 统计信息
-    ImGui::Text("已接收: %d 字节  已发送: %d 字节", state.bytes_received, state.bytes_sent);
+    ImGui::Text("已接收: %d 字节  已发送: %d 字节", state.bytes_received.load(), state.bytes_sent);
+
+    // 接收线程统计（每次唤醒字节数、每秒唤醒次数）
+    if (state.is_connected) {
+        ReceiveStats rx_stats = state.serial_port->GetReceiveStats();
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f),
+                           "  唤醒: %.0f 次/秒  %.0f 字节/次  %.1f KB/s",
+                           rx_stats.wakeupsPerSecond, rx_stats.bytesPerWakeup,
+                           rx_stats.bytesPerSecond / 1024.0);
+    }
 }
 
 // 添加发送历史（去重）
@@ -701,7 +764,7 @@ void RenderSendPanel(AppState& state) {
                                      (history.substr(0, 47) + "...") : history;
 
                 if (ImGui::Selectable(display.c_str())) {
-                    strcpy_s(state.send_buffer, sizeof(state.send_buffer), history.c_str());
+                    snprintf(state.send_buffer, sizeof(state.send_buffer), "%s", history.c_str());
                 }
             }
             ImGui::EndCombo();
@@ -783,15 +846,15 @@ void RenderSendPanel(AppState& state) {
                 // HEX发送
                 std::vector<unsigned char> hexData;
                 if (DataConverter::HexStringToBytes(final_data, hexData)) {
-                    sent = state.serial_port.Write(hexData.data(), hexData.size());
+                    sent = state.serial_port->Write(hexData.data(), hexData.size());
                 }
             } else {
                 // 编码转换后发送
                 std::vector<unsigned char> encoded_data;
                 if (DataConverter::ConvertFromUTF8(final_data, state.encoding_type, encoded_data)) {
-                    sent = state.serial_port.Write(encoded_data.data(), encoded_data.size());
+                    sent = state.serial_port->Write(encoded_data.data(), encoded_data.size());
                 } else {
-                    sent = state.serial_port.Write(final_data);
+                    sent = state.serial_port->Write(final_data);
                 }
             }
 
@@ -826,7 +889,7 @@ void RenderSendPanel(AppState& state) {
 void RenderSettingsDialog(AppState& state) {
     if (!state.show_settings_dialog) return;
 
-    ImGui::SetNextWindowSize(ImVec2(500, 350), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(500, 480), ImGuiCond_FirstUseEver);
     ImGui::SetNextWindowPos(ImVec2(ImGui::GetIO().DisplaySize.x * 0.5f, ImGui::GetIO().DisplaySize.y * 0.5f),
                             ImGuiCond_Appearing, ImVec2(0.5f, 0.5f));
 
@@ -838,20 +901,24 @@ void RenderSettingsDialog(AppState& state) {
         // 启用多线程
         bool enable_mt = state.thread_config.enable_multithreading;
         if (ImGui::Checkbox("启用多线程处理", &enable_mt)) {
-            state.thread_config.enable_multithreading = enable_mt;
-
+            // 先让接收回调静止，再排空并切换模式，避免同步处理与环中剩余数据交错
+            state.rx_gate.Close();
             if (enable_mt && !state.thread_pool) {
                 // 创建线程池
                 state.thread_pool = std::make_unique<ThreadPool>(state.thread_config.num_worker_threads);
+                StartIngestThread(state);
             } else if (!enable_mt && state.thread_pool) {
-                // 销毁线程池
+                // 停止消费线程（处理完环中剩余数据），销毁线程池
+                state.ingest_thread.Stop();
                 state.thread_pool.reset();
             }
+            state.thread_config.enable_multithreading = enable_mt;
+            state.rx_gate.Open();
         }
 
         if (state.thread_config.enable_multithreading) {
             ImGui::Spacing();
-            ImGui::Text("工作线程数量:");
+            ImGui::Text("格式化工作线程数量:");
             ImGui::PushItemWidth(400);
 
             int thread_count = state.thread_config.num_worker_threads;
@@ -859,8 +926,13 @@ void RenderSettingsDialog(AppState& state) {
                 state.thread_config.num_worker_threads = thread_count;
 
                 // 重启线程池以应用新的线程数
+                // 先停止消费线程，保证重启期间没有任务再提交到线程池
                 if (state.thread_pool) {
+                    state.rx_gate.Close();
+                    state.ingest_thread.Stop();
                     state.thread_pool->Restart(thread_count);
+                    StartIngestThread(state);
+                    state.rx_gate.Open();
                 }
             }
             ImGui::PopItemWidth();
@@ -878,6 +950,29 @@ void RenderSettingsDialog(AppState& state) {
                 ImGui::Text("当前状态:");
                 ImGui::BulletText("活跃线程: %zu", state.thread_pool->GetThreadCount());
                 ImGui::BulletText("待处理任务: %zu", state.thread_pool->GetTaskCount());
+
+                // 接收环形缓冲区监控
+                const SpscByteRing& ring = state.ingest_thread.GetRing();
+                ImGui::BulletText("接收环占用: %zu / %zu KB (最高 %zu KB)",
+                                  ring.Size() / 1024, ring.Capacity() / 1024, ring.HighWater() / 1024);
+                ImGui::BulletText("接收环丢弃: %llu 字节",
+                                  static_cast<unsigned long long>(state.ingest_thread.DroppedBytes()));
+
+                // 流水线顺序校验：写入阶段的字节流位置、显示阶段数据块序号
+                const FrameOrderStats& order = state.visualization_ui.GetChannelManager().GetSnapshot().order_stats;
+                ImGui::BulletText("已解析帧: %llu (乱序: %llu)",
+                                  static_cast<unsigned long long>(order.frames_pushed),
+                                  static_cast<unsigned long long>(order.order_violations));
+                if (state.visualization_ui.GetFilterCount() > 0) {
+                    ImGui::BulletText("通道滤波: %zu 个滤波器, %.1f ns/样本",
+                                      state.visualization_ui.GetFilterCount(),
+                                      state.visualization_ui.GetFilterCostPerSample());
+                }
+                ImGui::BulletText("已提交数据块: %llu (重排 %llu, 等待 %zu, 最多 %zu)",
+                                  static_cast<unsigned long long>(state.rx_log_committer.GetNextSequence()),
+                                  static_cast<unsigned long long>(state.rx_log_committer.GetReorderedCount()),
+                                  state.rx_log_committer.GetPendingCount(),
+                                  state.rx_log_committer.GetMaxPending());
             }
         } else {
             ImGui::Spacing();
@@ -889,6 +984,82 @@ void RenderSettingsDialog(AppState& state) {
         ImGui::Separator();
         ImGui::Spacing();
 
+        // 串口接收配置（下次连接时生效）
+        ImGui::TextColored(ImVec4(0.26f, 0.59f, 0.98f, 1.0f), "串口接收配置");
+        ImGui::Separator();
+        ImGui::Spacing();
+
+        const int queue_sizes[] = { 4096, 16384, 65536, 262144, 1048576 };
+        const char* queue_labels[] = { "4 KB", "16 KB", "64 KB", "256 KB", "1 MB" };
+        ImGui::PushItemWidth(200);
+
+        int queue_index = 2;
+        for (int i = 0; i < IM_ARRAYSIZE(queue_sizes); i++) {
+            if (queue_sizes[i] == state.rx_queue_size) queue_index = i;
+        }
+        if (ImGui::Combo("驱动接收队列", &queue_index, queue_labels, IM_ARRAYSIZE(queue_labels))) {
+            state.rx_queue_size = queue_sizes[queue_index];
+        }
+
+        int chunk_index = 1;
+        for (int i = 0; i < IM_ARRAYSIZE(queue_sizes); i++) {
+            if (queue_sizes[i] == state.read_chunk_size) chunk_index = i;
+        }
+        if (ImGui::Combo("单次读取块", &chunk_index, queue_labels, IM_ARRAYSIZE(queue_labels))) {
+            state.read_chunk_size = queue_sizes[chunk_index];
+        }
+        ImGui::PopItemWidth();
+
+        if (state.is_connected) {
+            ImGui::TextColored(ImVec4(0.8f, 0.6f, 0.3f, 1.0f), "(重新连接后生效)");
+        }
+
+        ImGui::Spacing();
+        ImGui::Separator();
+        ImGui::Spacing();
+
+        // 波形历史深度（后台调整，不影响接收）
+        ImGui::TextColored(ImVec4(0.26f, 0.59f, 0.98f, 1.0f), "波形历史配置");
+        ImGui::Separator();
+        ImGui::Spacing();
+
+        DataChannelManager& channel_mgr = state.visualization_ui.GetChannelManager();
+        const size_t capacities[] = { 2048, 16384, 131072, 1048576, 8388608, 33554432 };
+        const char* capacity_labels[] = { "2048帧", "1.6万帧", "13万帧", "105万帧", "839万帧", "3355万帧" };
+        int capacity_index = 0;
+        for (int i = 0; i < IM_ARRAYSIZE(capacities); i++) {
+            if (capacities[i] == channel_mgr.GetCapacity()) capacity_index = i;
+        }
+        ImGui::PushItemWidth(200);
+        if (ImGui::Combo("每通道历史深度", &capacity_index, capacity_labels, IM_ARRAYSIZE(capacity_labels))) {
+            channel_mgr.RequestCapacity(capacities[capacity_index]);
+        }
+        ImGui::PopItemWidth();
+        const ChannelSnapshot& history = channel_mgr.GetSnapshot();
+        size_t estimate_channels = std::max<size_t>(history.channels.size(), 1);
+        ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "%zu通道满载约 %.1f MB",
+                          estimate_channels,
+                          DataChannelManager::EstimateMemory(capacities[capacity_index],
+                                                             estimate_channels) / (1024.0 * 1024.0));
+
+        ImGui::BulletText("已缓存: %zu / %zu 帧", history.stored_frames, history.capacity);
+        ImGui::BulletText("内存占用: %.1f MB", history.memory_bytes / (1024.0 * 1024.0));
+        if (channel_mgr.IsResizing()) {
+            ImGui::TextColored(ImVec4(0.8f, 0.6f, 0.3f, 1.0f), "正在调整历史深度...");
+        }
+
+        // 统计窗口（数字表盘/仪表盘的窗口统计，修改后窗口统计重新开始）
+        int stats_window = static_cast<int>(channel_mgr.GetStatsWindow());
+        ImGui::PushItemWidth(200);
+        if (ImGui::InputInt("统计窗口(样本)", &stats_window, 100, 1000)) {
+            channel_mgr.SetStatsWindow(static_cast<size_t>(std::max(stats_window, 0)));
+        }
+        ImGui::PopItemWidth();
+
+        ImGui::Spacing();
+        ImGui::Separator();
+        ImGui::Spacing();
+
         // 关闭按钮
         if (ImGui::Button("确定", ImVec2(120, 40))) {
             state.show_settings_dialog = false;
@@ -985,7 +1156,16 @@ int main(int, char**) {
     ImGui_ImplOpenGL3_Init(glsl_version);
 
     // 加载中文字体（完整字符集，解决乱码问题）
+#ifdef _WIN32
     io.Fonts->AddFontFromFileTTF("c:\\Windows\\Fonts\\msyh.ttc", 20.0f, NULL, io.Fonts->GetGlyphRangesChineseFull());
+#else
+    // Linux：使用Noto CJK字体（不存在时回退到ImGui默认字体）
+    const char* cjk_font = "/usr/share/fonts/opentype/noto/NotoSansCJK-Regular.ttc";
+    if (FILE* f = fopen(cjk_font, "rb")) {
+        fclose(f);
+        io.Fonts->AddFontFromFileTTF(cjk_font, 20.0f, NULL, io.Fonts->GetGlyphRangesChineseFull());
+    }
+#endif
 
     // 应用程序状态
     AppState app_state;
@@ -993,13 +1173,23 @@ int main(int, char**) {
     // 加载保存的配置
     ConfigManager::LoadConfig(app_state);
 
+    // 接收数据按序号提交到日志/文件
+    app_state.rx_log_committer.SetCommitFunction([&app_state](uint64_t, std::string& text) {
+        CommitReceivedText(&app_state, text);
+    });
+    app_state.rx_chunk_slots.SetHandler([&app_state](uint64_t seq, const unsigned char* data, size_t length,
+                                                     const RxFormat& format) {
+        app_state.rx_log_committer.Submit(seq, FormatReceivedData(data, length, format.hex, format.encoding));
+    });
+
     // 初始化线程池（如果启用了多线程）
     if (app_state.thread_config.enable_multithreading) {
         app_state.thread_pool = std::make_unique<ThreadPool>(app_state.thread_config.num_worker_threads);
+        StartIngestThread(app_state);
     }
 
     // 启动异步串口枚举（不阻塞UI）
-    app_state.port_enum_future = SerialPort_Win::EnumeratePortsAsync();
+    app_state.port_enum_future = SerialPort::EnumeratePortsAsync();
     app_state.ports_enumerating = true;
 
     // 主循环
@@ -1022,6 +1212,13 @@ int main(int, char**) {
             }
         }
 
+        // 设备拔出：接收线程已将串口标记为关闭，释放资源并回到未连接状态
+        if (app_state.is_connected && !app_state.serial_port->IsOpen()) {
+            app_state.connection_error = app_state.serial_port->GetLastError();
+            app_state.serial_port->Close();
+            app_state.is_connected = false;
+        }
+
         // 定时发送逻辑
         if (app_state.enable_auto_send && app_state.is_connected && app_state.send_buffer[0] != '\0') {
             auto now = std::chrono::steady_clock::now();
@@ -1033,14 +1230,14 @@ int main(int, char**) {
                     // HEX发送
                     std::vector<unsigned char> hexData;
                     if (DataConverter::HexStringToBytes(app_state.send_buffer, hexData)) {
-                        int sent = app_state.serial_port.Write(hexData.data(), hexData.size());
+                        int sent = app_state.serial_port->Write(hexData.data(), hexData.size());
                         if (sent > 0) {
                             app_state.bytes_sent += sent;
                         }
                     }
                 } else {
                     // ASCII发送
-                    int sent = app_state.serial_port.Write(app_state.send_buffer);
+                    int sent = app_state.serial_port->Write(app_state.send_buffer);
                     if (sent > 0) {
                         app_state.bytes_sent += sent;
                     }
@@ -1142,6 +1339,11 @@ int main(int, char**) {
     // 保存配置
     ConfigManager::SaveConfig(app_state);
 
+    // 先关闭串口（停止生产者），再停止消费线程，最后等待格式化任务完成
+    app_state.serial_port->Close();
+    app_state.ingest_thread.Stop();
+    app_state.thread_pool.reset();
+
     // 清理
     ImPlot::DestroyContext();  // 销毁ImPlot上下文
     ImGui_ImplOpenGL3_Shutdown();
@@ -0,0 +1,127 @@
+/**
+ * @file ByteScanner.h
+ * @brief 字节序列快速查找（SSE2/AVX2向量化，带标量回退）
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 用于在整块接收数据中查找帧尾/帧头等固定字节序列：
+ * - 同时比较模式的首字节和末字节，一次筛选16/32个候选位置
+ * - 候选位置再用memcmp校验中间字节
+ * - 编译目标支持AVX2时使用32字节向量（-mavx2 或 /arch:AVX2），
+ *   x86-64默认使用SSE2，其余平台使用标量循环
+ */
+
+#ifndef BYTE_SCANNER_H
+#define BYTE_SCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define BYTE_SCANNER_AVX2 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define BYTE_SCANNER_SSE2 1
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+namespace ByteScanner {
+
+/**
+ * @brief 最低位1的位置（mask非0）
+ */
+inline unsigned CountTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+/**
+ * @brief 校验候选位置的中间字节（首末字节已由向量比较确认）
+ */
+inline bool MatchMiddle(const unsigned char* candidate, const unsigned char* pattern, size_t pattern_length) {
+    return pattern_length <= 2 ||
+           std::memcmp(candidate + 1, pattern + 1, pattern_length - 2) == 0;
+}
+
+/**
+ * @brief 查找字节序列第一次出现的位置
+ * @param data 数据
+ * @param length 数据长度
+ * @param pattern 要查找的字节序列
+ * @param pattern_length 字节序列长度（>0）
+ * @return 起始位置；未找到返回length
+ */
+inline size_t Find(const unsigned char* data, size_t length,
+                   const unsigned char* pattern, size_t pattern_length) {
+    if (pattern_length == 0 || length < pattern_length) {
+        return length;
+    }
+
+    const size_t last = pattern_length - 1;
+    size_t i = 0;
+
+#if defined(BYTE_SCANNER_AVX2)
+    {
+        const __m256i first_byte = _mm256_set1_epi8(static_cast<char>(pattern[0]));
+        const __m256i last_byte = _mm256_set1_epi8(static_cast<char>(pattern[last]));
+        for (; i + last + 32 <= length; i += 32) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + last));
+            uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(a, first_byte), _mm256_cmpeq_epi8(b, last_byte))));
+            while (mask != 0) {
+                size_t pos = i + CountTrailingZeros(mask);
+                if (MatchMiddle(data + pos, pattern, pattern_length)) {
+                    return pos;
+                }
+                mask &= mask - 1;
+            }
+        }
+    }
+#endif
+
+#if defined(BYTE_SCANNER_SSE2)
+    {
+        const __m128i first_byte = _mm_set1_epi8(static_cast<char>(pattern[0]));
+        const __m128i last_byte = _mm_set1_epi8(static_cast<char>(pattern[last]));
+        for (; i + last + 16 <= length; i += 16) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + last));
+            uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(a, first_byte), _mm_cmpeq_epi8(b, last_byte))));
+            while (mask != 0) {
+                size_t pos = i + CountTrailingZeros(mask);
+                if (MatchMiddle(data + pos, pattern, pattern_length)) {
+                    return pos;
+                }
+                mask &= mask - 1;
+            }
+        }
+    }
+#endif
+
+    // 标量回退（以及向量循环剩余的尾部）
+    for (; i + last < length; i++) {
+        if (data[i] == pattern[0] && data[i + last] == pattern[last] &&
+            MatchMiddle(data + i, pattern, pattern_length)) {
+            return i;
+        }
+    }
+    return length;
+}
+
+} // namespace ByteScanner
+
+#endif // BYTE_SCANNER_H
@@ -0,0 +1,221 @@
+/**
+ * @file Checksum.h
+ * @brief 帧校验算法（和校验、异或、CRC8、CRC16、CRC32）
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 所有CRC均为查表实现，表在编译期生成：
+ * - CRC8：多项式0x07，初值0x00（CRC-8/SMBUS）
+ * - CRC16-MODBUS：反射多项式0xA001，初值0xFFFF
+ * - CRC16-CCITT：多项式0x1021，初值0xFFFF，不反射（CCITT-FALSE）
+ * - CRC32：反射多项式0xEDB88320，初值/结果异或0xFFFFFFFF（IEEE 802.3），
+ *   slice-by-8，每次处理8字节
+ */
+
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief 校验算法类型
+ */
+enum class ChecksumType {
+    NONE,           // 不校验
+    SUM8,           // 累加和（低8位）
+    XOR8,           // 异或
+    CRC8,           // CRC-8/SMBUS
+    CRC16_MODBUS,   // CRC-16/MODBUS
+    CRC16_CCITT,    // CRC-16/CCITT-FALSE
+    CRC32           // CRC-32/IEEE
+};
+
+/**
+ * @brief 获取校验值的字节数
+ */
+inline size_t GetChecksumSize(ChecksumType type) {
+    switch (type) {
+        case ChecksumType::SUM8:
+        case ChecksumType::XOR8:
+        case ChecksumType::CRC8:
+            return 1;
+        case ChecksumType::CRC16_MODBUS:
+        case ChecksumType::CRC16_CCITT:
+            return 2;
+        case ChecksumType::CRC32:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief 获取校验算法名称
+ */
+inline const char* GetChecksumTypeName(ChecksumType type) {
+    switch (type) {
+        case ChecksumType::NONE:         return "None";
+        case ChecksumType::SUM8:         return "SUM8";
+        case ChecksumType::XOR8:         return "XOR8";
+        case ChecksumType::CRC8:         return "CRC8";
+        case ChecksumType::CRC16_MODBUS: return "CRC16-MODBUS";
+        case ChecksumType::CRC16_CCITT:  return "CRC16-CCITT";
+        case ChecksumType::CRC32:        return "CRC32";
+        default: return "Unknown";
+    }
+}
+
+namespace Checksum {
+
+/**
+ * @brief 编译期生成的CRC查找表
+ */
+struct Tables {
+    uint8_t crc8[256];
+    uint16_t crc16_modbus[256];
+    uint16_t crc16_ccitt[256];
+    uint32_t crc32[8][256];     // slice-by-8
+
+    constexpr Tables() : crc8(), crc16_modbus(), crc16_ccitt(), crc32() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint8_t c8 = static_cast<uint8_t>(i);
+            for (int k = 0; k < 8; k++) {
+                c8 = static_cast<uint8_t>((c8 & 0x80) ? (c8 << 1) ^ 0x07 : (c8 << 1));
+            }
+            crc8[i] = c8;
+
+            uint16_t cm = static_cast<uint16_t>(i);
+            for (int k = 0; k < 8; k++) {
+                cm = static_cast<uint16_t>((cm & 1) ? (cm >> 1) ^ 0xA001 : (cm >> 1));
+            }
+            crc16_modbus[i] = cm;
+
+            uint16_t cc = static_cast<uint16_t>(i << 8);
+            for (int k = 0; k < 8; k++) {
+                cc = static_cast<uint16_t>((cc & 0x8000) ? (cc << 1) ^ 0x1021 : (cc << 1));
+            }
+            crc16_ccitt[i] = cc;
+
+            uint32_t c32 = i;
+            for (int k = 0; k < 8; k++) {
+                c32 = (c32 & 1) ? (c32 >> 1) ^ 0xEDB88320u : (c32 >> 1);
+            }
+            crc32[0][i] = c32;
+        }
+        for (uint32_t i = 0; i < 256; i++) {
+            for (int t = 1; t < 8; t++) {
+                crc32[t][i] = (crc32[t - 1][i] >> 8) ^ crc32[0][crc32[t - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+inline const Tables& GetTables() {
+    static constexpr Tables tables;
+    return tables;
+}
+
+inline uint8_t Sum8(const unsigned char* data, size_t length) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < length; i++) {
+        sum += data[i];
+    }
+    return static_cast<uint8_t>(sum);
+}
+
+inline uint8_t Xor8(const unsigned char* data, size_t length) {
+    uint8_t x = 0;
+    for (size_t i = 0; i < length; i++) {
+        x ^= data[i];
+    }
+    return x;
+}
+
+inline uint8_t Crc8(const unsigned char* data, size_t length) {
+    const uint8_t* table = GetTables().crc8;
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        crc = table[crc ^ data[i]];
+    }
+    return crc;
+}
+
+inline uint16_t Crc16Modbus(const unsigned char* data, size_t length) {
+    const uint16_t* table = GetTables().crc16_modbus;
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc = static_cast<uint16_t>((crc >> 8) ^ table[(crc ^ data[i]) & 0xFF]);
+    }
+    return crc;
+}
+
+inline uint16_t Crc16Ccitt(const unsigned char* data, size_t length) {
+    const uint16_t* table = GetTables().crc16_ccitt;
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc = static_cast<uint16_t>((crc << 8) ^ table[((crc >> 8) ^ data[i]) & 0xFF]);
+    }
+    return crc;
+}
+
+inline uint32_t Crc32(const unsigned char* data, size_t length) {
+    const auto& t = GetTables().crc32;
+    uint32_t crc = 0xFFFFFFFFu;
+
+    // slice-by-8：每次处理8字节（按字节组装，与主机字节序无关）
+    while (length >= 8) {
+        uint32_t lo = crc ^ (static_cast<uint32_t>(data[0]) |
+                             static_cast<uint32_t>(data[1]) << 8 |
+                             static_cast<uint32_t>(data[2]) << 16 |
+                             static_cast<uint32_t>(data[3]) << 24);
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^
+              t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+              t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+        data += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+/**
+ * @brief 计算校验值
+ * @param type 校验算法
+ * @param data 数据
+ * @param length 数据长度
+ * @return 校验值（NONE返回0）
+ */
+inline uint32_t Compute(ChecksumType type, const unsigned char* data, size_t length) {
+    switch (type) {
+        case ChecksumType::SUM8:         return Sum8(data, length);
+        case ChecksumType::XOR8:         return Xor8(data, length);
+        case ChecksumType::CRC8:         return Crc8(data, length);
+        case ChecksumType::CRC16_MODBUS: return Crc16Modbus(data, length);
+        case ChecksumType::CRC16_CCITT:  return Crc16Ccitt(data, length);
+        case ChecksumType::CRC32:        return Crc32(data, length);
+        default: return 0;
+    }
+}
+
+/**
+ * @brief 从帧中读取校验值
+ * @param data 校验字段起始
+ * @param size 校验字段字节数（1/2/4）
+ * @param big_endian 是否高字节在前
+ */
+inline uint32_t ReadValue(const unsigned char* data, size_t size, bool big_endian) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < size; i++) {
+        size_t index = big_endian ? i : size - 1 - i;
+        value = (value << 8) | data[index];
+    }
+    return value;
+}
+
+} // namespace Checksum
+
+#endif // CHECKSUM_H
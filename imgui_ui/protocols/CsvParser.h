@@ -12,15 +12,19 @@
  * 示例（9通道）：
  * 89870, -46.73, -8.88, 33.12, 35.50, 0.02, -1.46, -5.71, -41.22\r\n
  * 通道1  通道2   通道3   通道4   通道5   通道6  通道7   通道8   通道9
+ *
+ * 解析方式：
+ * - 用memchr查找换行，完整的行直接在输入缓冲区上用CsvTokenizer原地分词
+ * - 只有跨越两次调用的行才拷贝到line_buffer_
  */
 
 #ifndef CSV_PARSER_H
 #define CSV_PARSER_H
 
 #include "ProtocolParser.h"
+#include "CsvTokenizer.h"
 #include <string>
-#include <sstream>
-#include <vector>
+#include <cstring>
 
 /**
  * @brief CSV文本协议解析器
@@ -30,63 +34,65 @@ public:
     CsvParser(size_t channel_count = 9)  // 默认9通道（常见场景）
         : channel_count_(channel_count)
     {
+        line_buffer_.reserve(MAX_LINE_LENGTH);  // 预留最大行长度，追加时不再扩容
     }
 
-    ParseResult Parse(const unsigned char* buffer, size_t length) override {
-        ParseResult result;
-        result.values.reserve(channel_count_);
-
-        size_t consumed = 0;
-
-        // 逐字节处理
-        for (size_t i = 0; i < length; i++) {
-            unsigned char byte = buffer[i];
-            consumed++;
-
-            // 累积字节到行缓冲区
-            if (byte == '\n') {
-                // 检测到换行符，解析当前行
-                if (!line_buffer_.empty()) {
-                    // 移除可能的 \r（如果是 \r\n）
-                    if (line_buffer_.back() == '\r') {
-                        line_buffer_.pop_back();
-                    }
-
-                    // 解析CSV行
-                    std::vector<float> values = ParseCsvLine(line_buffer_);
-
-                    if (!values.empty()) {
-                        result.values = values;
-                        result.success = true;
-                        result.bytes_consumed = consumed;
+    BatchParseResult ParseBatch(const unsigned char* buffer, size_t length,
+                                float* out, size_t max_frames, size_t max_channels) override {
+        BatchParseResult result;
+        const char* text = reinterpret_cast<const char*>(buffer);
+        size_t i = 0;
 
-                        // 清空行缓冲区
-                        line_buffer_.clear();
-
-                        return result;
-                    }
+        // 上次调用遗留的不完整行：补齐后从行缓冲区解析
+        if (!line_buffer_.empty() || discard_line_) {
+            if (max_frames == 0) {
+                return result;
+            }
+            const char* newline = static_cast<const char*>(std::memchr(text, '\n', length));
+            if (!newline) {
+                AppendPartialLine(text, length);
+                result.bytes_consumed = length;
+                return result;
+            }
 
-                    // 解析失败，清空缓冲区继续
-                    line_buffer_.clear();
+            size_t line_end = static_cast<size_t>(newline - text);
+            AppendPartialLine(text, line_end);
+            if (!discard_line_) {
+                const char* line = line_buffer_.data();
+                if (!EmitLine(line, line + line_buffer_.size(), out, max_channels, result)) {
+                    // 通道数变化：换行符留给下次调用，已补齐的行保留在缓冲区
+                    result.bytes_consumed = line_end;
+                    return result;
                 }
-            } else {
-                // 累积字符到行缓冲区
-                line_buffer_ += static_cast<char>(byte);
+            }
+            line_buffer_.clear();
+            discard_line_ = false;
+            i = line_end + 1;
+        }
 
-                // 防止缓冲区溢出（最大4KB）
-                if (line_buffer_.size() > 4096) {
-                    line_buffer_.clear();
-                }
+        // 完整的行：在输入缓冲区上原地解析
+        while (i < length && result.frames < max_frames) {
+            const char* newline = static_cast<const char*>(std::memchr(text + i, '\n', length - i));
+            if (!newline) {
+                // 行跨越两次调用，拷贝到行缓冲区
+                AppendPartialLine(text + i, length - i);
+                i = length;
+                break;
             }
+
+            if (!EmitLine(text + i, newline, out, max_channels, result)) {
+                break;
+            }
+            i = static_cast<size_t>(newline - text) + 1;
         }
 
-        // 数据不完整，等待更多数据
-        result.bytes_consumed = consumed;
+        result.bytes_consumed = i;
         return result;
     }
 
     void Reset() override {
         line_buffer_.clear();
+        discard_line_ = false;
     }
 
     ProtocolType GetType() const override {
@@ -102,67 +108,67 @@ public:
     }
 
     void SetExpectedChannelCount(size_t count) override {
-        if (count > 0 && count <= 16) {
+        if (count > 0 && count <= MAX_FRAME_CHANNELS) {
             channel_count_ = count;
             Reset();
         }
     }
 
 private:
+    static constexpr size_t MAX_LINE_LENGTH = 4096;    // 最大行长度，超出的行被丢弃
+
     /**
-     * @brief 解析CSV行为浮点数数组
-     * @param line CSV行字符串（例如："1.23, 4.56, -7.89"）
-     * @return 浮点数数组
+     * @brief 追加不完整行到行缓冲区（超长行整行丢弃，直到下一个换行符）
      */
-    std::vector<float> ParseCsvLine(const std::string& line) {
-        std::vector<float> values;
-        std::stringstream ss(line);
-        std::string token;
-
-        // 按逗号分割
-        while (std::getline(ss, token, ',')) {
-            // 尝试转换为浮点数
-            try {
-                // 移除前后空格
-                token = Trim(token);
-
-                if (!token.empty()) {
-                    float value = std::stof(token);
-                    values.push_back(value);
-                }
-            } catch (...) {
-                // 转换失败，跳过此字段
-                continue;
-            }
+    void AppendPartialLine(const char* data, size_t length) {
+        if (discard_line_) {
+            return;
         }
-
-        return values;
+        if (line_buffer_.size() + length > MAX_LINE_LENGTH) {
+            line_buffer_.clear();
+            discard_line_ = true;
+            return;
+        }
+        line_buffer_.append(data, length);
     }
 
     /**
-     * @brief 去除字符串前后空格
-     * @param str 输入字符串
-     * @return 去除空格后的字符串
+     * @brief 解析一行并写入输出
+     * @param begin 行起始（不含换行符）
+     * @param end 行结束
+     * @return 通道数与本批次不同时返回false（该行未输出，由调用方结束本批次）
      */
-    std::string Trim(const std::string& str) {
-        size_t start = 0;
-        size_t end = str.size();
+    bool EmitLine(const char* begin, const char* end, float* out, size_t max_channels,
+                  BatchParseResult& result) {
+        // 移除可能的 \r（如果是 \r\n）
+        if (end > begin && end[-1] == '\r') {
+            end--;
+        }
+        if (begin == end) {
+            return true;
+        }
 
-        // 找到第一个非空格字符
-        while (start < end && std::isspace(static_cast<unsigned char>(str[start]))) {
-            start++;
+        size_t count = CsvTokenizer::ParseLine(begin, end, line_values_, MAX_FRAME_CHANNELS, result.error);
+        if (count == 0) {
+            return true;
         }
 
-        // 找到最后一个非空格字符
-        while (end > start && std::isspace(static_cast<unsigned char>(str[end - 1]))) {
-            end--;
+        size_t channels = (count < max_channels) ? count : max_channels;
+        if (result.frames == 0) {
+            result.channels = channels;
+        } else if (channels != result.channels) {
+            return false;
         }
 
-        return str.substr(start, end - start);
+        std::memcpy(out + result.frames * result.channels, line_values_, channels * sizeof(float));
+        result.frames++;
+        return true;
     }
 
     size_t channel_count_;      // 期望通道数
-    std::string line_buffer_;   // 行缓冲区
+    std::string line_buffer_;   // 跨越两次调用的不完整行
+    bool discard_line_ = false; // 当前行超长，丢弃到下一个换行符
+    float line_values_[MAX_FRAME_CHANNELS];  // 当前行解析结果
 };
 
 #endif // CSV_PARSER_H
@@ -0,0 +1,107 @@
+/**
+ * @file CsvTokenizer.h
+ * @brief CSV行分词器 - 在原缓冲区上单遍解析一行逗号分隔的数值
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 供CsvParser（逐行解码）和ProtocolDetector（协议识别打分）共用：
+ * - 用memchr定位逗号，字段不拷贝、不分配内存
+ * - 数值转换使用std::from_chars（无异常、不受locale影响），
+ *   标准库不支持时退回strtof
+ */
+
+#ifndef CSV_TOKENIZER_H
+#define CSV_TOKENIZER_H
+
+#include "ProtocolParser.h"
+#include <cstring>
+#include <cstdlib>
+#include <charconv>
+#include <system_error>
+
+/**
+ * @brief CSV行分词器（无状态）
+ */
+class CsvTokenizer {
+public:
+    /**
+     * @brief 单遍解析CSV行为浮点数数组
+     * @param begin 行起始（例如："1.23, 4.56, -7.89"）
+     * @param end 行结束
+     * @param values 输出数组
+     * @param max_values 最多输出的字段数（超出的字段忽略）
+     * @param error 有字段无法解析时置为INVALID_FIELD
+     * @return 解析出的字段数
+     *
+     * 与原std::stof实现保持一致：空字段跳过，字段只要以数字开头即取其数值前缀。
+     */
+    static size_t ParseLine(const char* begin, const char* end, float* values, size_t max_values,
+                            ParseError& error) {
+        size_t count = 0;
+        const char* p = begin;
+
+        while (p < end) {
+            // 字段范围
+            const char* field_end = static_cast<const char*>(std::memchr(p, ',', static_cast<size_t>(end - p)));
+            if (!field_end) {
+                field_end = end;
+            }
+
+            // 跳过前导空白和正号（from_chars不接受）
+            while (p < field_end && IsBlank(*p)) {
+                p++;
+            }
+            if (p < field_end && *p == '+') {
+                p++;
+            }
+
+            if (p < field_end && count < max_values) {
+                float value;
+                if (ParseFloat(p, field_end, value)) {
+                    values[count++] = value;
+                } else if (!OnlyBlanks(p, field_end)) {
+                    // 转换失败，跳过此字段
+                    error = ParseError::INVALID_FIELD;
+                }
+            }
+
+            p = field_end + 1;
+        }
+
+        return count;
+    }
+
+private:
+    /**
+     * @brief 转换数值前缀
+     */
+    static bool ParseFloat(const char* begin, const char* end, float& value) {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        std::from_chars_result r = std::from_chars(begin, end, value);
+        return r.ec == std::errc() && r.ptr != begin;
+#else
+        // 标准库不支持浮点from_chars时，拷贝到栈上用strtof转换
+        char temp[64];
+        size_t n = static_cast<size_t>(end - begin);
+        if (n >= sizeof(temp)) n = sizeof(temp) - 1;
+        std::memcpy(temp, begin, n);
+        temp[n] = '\0';
+        char* parse_end = nullptr;
+        value = std::strtof(temp, &parse_end);
+        return parse_end != temp;
+#endif
+    }
+
+    static bool IsBlank(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    static bool OnlyBlanks(const char* begin, const char* end) {
+        for (const char* p = begin; p < end; p++) {
+            if (!IsBlank(*p)) return false;
+        }
+        return true;
+    }
+};
+
+#endif // CSV_TOKENIZER_H
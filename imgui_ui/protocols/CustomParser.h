@@ -7,7 +7,9 @@
  * Custom协议特性：
  * - 用户可配置帧头、帧尾
  * - 用户可配置每个通道的数据类型
- * - 支持校验和验证（可选）
+ * - 支持校验和验证（可选）：SUM8/XOR8/CRC8/CRC16-MODBUS/CRC16-CCITT/CRC32，
+ *   校验字段位置和校验范围可配置，校验失败的帧计入丢帧统计
+ * - 配置变化时生成解码计划（FrameDecodePlan），每帧解码无逐字段分支
  *
  * 配置示例：
  * - 帧头：0x55 0xAA
@@ -19,9 +21,20 @@
 #define CUSTOM_PARSER_H
 
 #include "ProtocolParser.h"
+#include "FrameDecodePlan.h"
+#include "Checksum.h"
+#include <algorithm>
 #include <cstring>
 #include <vector>
 
+/**
+ * @brief 校验字段位置
+ */
+enum class ChecksumPosition {
+    BEFORE_TAIL,    // 数据之后、帧尾之前：[帧头][数据][校验][帧尾]
+    AFTER_TAIL      // 帧尾之后：[帧头][数据][帧尾][校验]
+};
+
 /**
  * @brief 自定义协议配置
  */
@@ -32,9 +45,21 @@ struct CustomProtocolConfig {
     bool use_checksum;                        // 是否使用校验和
     bool big_endian;                          // 是否大端序（默认小端）
 
+    // 校验配置（use_checksum为true时生效）
+    ChecksumType checksum_type;               // 校验算法
+    ChecksumPosition checksum_position;       // 校验字段位置
+    size_t checksum_range_start;              // 校验范围起始（相对帧头首字节的偏移）
+    size_t checksum_range_end;                // 校验范围结束（不含），0表示到校验字段之前
+    bool checksum_big_endian;                 // 校验值高字节在前（MODBUS为低字节在前）
+
     CustomProtocolConfig()
         : use_checksum(false)
         , big_endian(false)
+        , checksum_type(ChecksumType::SUM8)
+        , checksum_position(ChecksumPosition::BEFORE_TAIL)
+        , checksum_range_start(0)
+        , checksum_range_end(0)
+        , checksum_big_endian(false)
     {
         // 默认配置：类似FireWater
         frame_header = {0xAA};
@@ -45,6 +70,9 @@ struct CustomProtocolConfig {
 
 /**
  * @brief 自定义协议解析器
+ *
+ * 帧在frame_buffer_中按线路顺序组装（帧头/帧尾为常量，预先填入），
+ * 校验范围即frame_buffer_中的一段连续字节。
  */
 class CustomParser : public ProtocolParser {
 public:
@@ -54,55 +82,67 @@ public:
         : config_(config)
         , state_(State::SEARCH_HEADER)
         , header_index_(0)
-        , data_index_(0)
+        , body_index_(0)
         , tail_index_(0)
+        , checksum_index_(0)
     {
         CalculateFrameSize();
+        Reset();
     }
 
-    ParseResult Parse(const unsigned char* buffer, size_t length) override {
-        ParseResult result;
-        result.values.reserve(config_.channel_types.size());
+    BatchParseResult ParseBatch(const unsigned char* buffer, size_t length,
+                                float* out, size_t max_frames, size_t max_channels) override {
+        BatchParseResult result;
+        const size_t channel_count = config_.channel_types.size();
+        if (channel_count == 0) {
+            // 未配置通道，无法解析
+            result.error = ParseError::NO_CHANNELS;
+            return result;
+        }
+        result.channels = (channel_count < max_channels) ? channel_count : max_channels;
 
-        size_t consumed = 0;
+        const size_t header_size = config_.frame_header.size();
+        const size_t tail_size = config_.frame_tail.size();
 
-        for (size_t i = 0; i < length; i++) {
-            unsigned char byte = buffer[i];
-            consumed++;
+        size_t i = 0;
+        while (i < length && result.frames < max_frames) {
+            unsigned char byte = buffer[i++];
 
             switch (state_) {
                 case State::SEARCH_HEADER:
-                    if (config_.frame_header.empty() ||
-                        byte == config_.frame_header[header_index_]) {
+                    if (byte == config_.frame_header[header_index_]) {
                         header_index_++;
-                        if (header_index_ >= config_.frame_header.size()) {
+                        if (header_index_ >= header_size) {
                             // 帧头匹配成功
                             state_ = State::READ_DATA;
-                            data_index_ = 0;
+                            body_index_ = 0;
                             header_index_ = 0;
                         }
                     } else {
                         header_index_ = 0;
                         // 重新匹配帧头首字节
-                        if (!config_.frame_header.empty() && byte == config_.frame_header[0]) {
+                        if (byte == config_.frame_header[0]) {
                             header_index_ = 1;
                         }
                     }
                     break;
 
-                case State::READ_DATA:
-                    data_buffer_[data_index_++] = byte;
-
-                    if (data_index_ >= total_data_bytes_) {
-                        // 数据读取完成
-                        if (config_.frame_tail.empty()) {
-                            // 无帧尾，直接解析
-                            if (ParseDataBuffer(result)) {
-                                result.success = true;
-                                result.bytes_consumed = consumed;
-                                state_ = State::SEARCH_HEADER;
-                                return result;
-                            }
+                case State::READ_DATA: {
+                    unsigned char* body = &frame_buffer_[header_size];
+                    body[body_index_++] = byte;
+
+                    // 本块中剩余的帧数据（含帧尾前的校验字段）整段拷贝
+                    size_t remaining = body_bytes_ - body_index_;
+                    size_t available = length - i;
+                    size_t n = (remaining < available) ? remaining : available;
+                    std::memcpy(body + body_index_, buffer + i, n);
+                    body_index_ += n;
+                    i += n;
+
+                    if (body_index_ >= body_bytes_) {
+                        if (tail_size == 0) {
+                            // 无帧尾
+                            CompleteFrame(out, result);
                         } else {
                             // 验证帧尾
                             state_ = State::VERIFY_TAIL;
@@ -110,38 +150,54 @@ public:
                         }
                     }
                     break;
+                }
 
                 case State::VERIFY_TAIL:
                     if (byte == config_.frame_tail[tail_index_]) {
                         tail_index_++;
-                        if (tail_index_ >= config_.frame_tail.size()) {
-                            // 帧尾匹配成功，解析数据
-                            if (ParseDataBuffer(result)) {
-                                result.success = true;
-                                result.bytes_consumed = consumed;
-                                state_ = State::SEARCH_HEADER;
-                                return result;
+                        if (tail_index_ >= tail_size) {
+                            if (trailing_checksum_bytes_ > 0) {
+                                // 帧尾之后还有校验字段
+                                state_ = State::READ_CHECKSUM;
+                                checksum_index_ = 0;
+                            } else {
+                                CompleteFrame(out, result);
                             }
                         }
                     } else {
-                        // 帧尾错误
-                        result.error_message = "Frame tail mismatch";
-                        state_ = State::SEARCH_HEADER;
-                        header_index_ = 0;
+                        // 帧尾错误，丢弃本帧重新搜索帧头（当前字节可能是下一帧帧头）
+                        result.error = ParseError::TAIL_MISMATCH;
+                        RecordRejectedFrame(ParseError::TAIL_MISMATCH);
+                        RestartFrame();
+                        if (header_size == 0) {
+                            // 无帧头：当前字节是下一帧数据的首字节，交给READ_DATA重新处理
+                            i--;
+                        } else if (byte == config_.frame_header[0]) {
+                            header_index_ = 1;
+                            if (header_size == 1) {
+                                state_ = State::READ_DATA;
+                                header_index_ = 0;
+                            }
+                        }
+                    }
+                    break;
+
+                case State::READ_CHECKSUM:
+                    frame_buffer_[frame_buffer_.size() - trailing_checksum_bytes_ + checksum_index_++] = byte;
+                    if (checksum_index_ >= trailing_checksum_bytes_) {
+                        CompleteFrame(out, result);
                     }
                     break;
             }
         }
 
-        result.bytes_consumed = consumed;
+        result.bytes_consumed = i;
         return result;
     }
 
     void Reset() override {
-        state_ = State::SEARCH_HEADER;
         header_index_ = 0;
-        data_index_ = 0;
-        tail_index_ = 0;
+        RestartFrame();
     }
 
     ProtocolType GetType() const override {
@@ -175,58 +231,92 @@ public:
 private:
     enum class State {
         SEARCH_HEADER,
-        READ_DATA,
-        VERIFY_TAIL
+        READ_DATA,          // 读取数据（及帧尾前的校验字段）
+        VERIFY_TAIL,
+        READ_CHECKSUM       // 读取帧尾后的校验字段
     };
 
     /**
-     * @brief 计算数据帧大小
+     * @brief 计算数据帧大小、校验布局并生成解码计划
      */
     void CalculateFrameSize() {
-        total_data_bytes_ = 0;
-        for (const auto& type : config_.channel_types) {
-            total_data_bytes_ += GetDataTypeSize(type);
-        }
-        data_buffer_.resize(total_data_bytes_);
+        decode_plan_.Build(config_.channel_types, config_.big_endian);
+        total_data_bytes_ = decode_plan_.frame_bytes();
+
+        const size_t header_size = config_.frame_header.size();
+        const size_t tail_size = config_.frame_tail.size();
+        const bool checksum_enabled = config_.use_checksum && config_.checksum_type != ChecksumType::NONE;
+        checksum_size_ = checksum_enabled ? GetChecksumSize(config_.checksum_type) : 0;
+
+        // 无帧尾时两种位置相同，统一按帧尾前处理
+        const bool after_tail = config_.checksum_position == ChecksumPosition::AFTER_TAIL && tail_size > 0;
+        body_bytes_ = total_data_bytes_ + (after_tail ? 0 : checksum_size_);
+        trailing_checksum_bytes_ = after_tail ? checksum_size_ : 0;
+        checksum_offset_ = after_tail ? header_size + total_data_bytes_ + tail_size
+                                      : header_size + total_data_bytes_;
+
+        // 组装缓冲区：帧头和帧尾是常量，预先填入
+        frame_buffer_.assign(header_size + body_bytes_ + tail_size + trailing_checksum_bytes_, 0);
+        std::copy(config_.frame_header.begin(), config_.frame_header.end(), frame_buffer_.begin());
+        std::copy(config_.frame_tail.begin(), config_.frame_tail.end(),
+                  frame_buffer_.begin() + header_size + body_bytes_);
+
+        // 校验范围不能覆盖校验字段本身
+        checksum_range_end_ = (config_.checksum_range_end == 0 || config_.checksum_range_end > checksum_offset_)
+                                  ? checksum_offset_ : config_.checksum_range_end;
+        checksum_range_start_ = (config_.checksum_range_start < checksum_range_end_)
+                                    ? config_.checksum_range_start : 0;
     }
 
     /**
-     * @brief 解析数据缓冲区
+     * @brief 开始接收下一帧（无帧头时直接读取数据）
      */
-    bool ParseDataBuffer(ParseResult& result) {
-        size_t offset = 0;
-        for (const auto& type : config_.channel_types) {
-            size_t size = GetDataTypeSize(type);
-            if (offset + size > data_buffer_.size()) {
-                return false;
-            }
+    void RestartFrame() {
+        state_ = config_.frame_header.empty() ? State::READ_DATA : State::SEARCH_HEADER;
+        body_index_ = 0;
+        tail_index_ = 0;
+        checksum_index_ = 0;
+    }
 
-            // 处理字节序
-            unsigned char temp[8];
-            if (config_.big_endian && size > 1) {
-                // 大端转小端
-                for (size_t i = 0; i < size; i++) {
-                    temp[i] = data_buffer_[offset + size - 1 - i];
-                }
-            } else {
-                std::memcpy(temp, &data_buffer_[offset], size);
+    /**
+     * @brief 一帧接收完成：校验后解码输出
+     */
+    void CompleteFrame(float* out, BatchParseResult& result) {
+        if (checksum_size_ > 0) {
+            uint32_t expected = Checksum::Compute(config_.checksum_type,
+                                                  frame_buffer_.data() + checksum_range_start_,
+                                                  checksum_range_end_ - checksum_range_start_);
+            uint32_t received = Checksum::ReadValue(frame_buffer_.data() + checksum_offset_,
+                                                    checksum_size_, config_.checksum_big_endian);
+            if (expected != received) {
+                result.error = ParseError::CHECKSUM_MISMATCH;
+                RecordRejectedFrame(ParseError::CHECKSUM_MISMATCH);
+                RestartFrame();
+                return;
             }
-
-            float value = BytesToFloat(temp, type);
-            result.values.push_back(value);
-            offset += size;
         }
 
-        return true;
+        decode_plan_.Decode(frame_buffer_.data() + config_.frame_header.size(),
+                            out + result.frames * result.channels, result.channels);
+        result.frames++;
+        RestartFrame();
     }
 
     CustomProtocolConfig config_;
     State state_;
-    size_t header_index_;
-    size_t data_index_;
-    size_t tail_index_;
-    size_t total_data_bytes_;
-    std::vector<unsigned char> data_buffer_;
+    size_t header_index_;                   // 帧头匹配进度
+    size_t body_index_;                     // 数据区已接收字节数
+    size_t tail_index_;                     // 帧尾匹配进度
+    size_t checksum_index_;                 // 帧尾后校验字段已接收字节数
+    size_t total_data_bytes_;               // 通道数据字节数
+    size_t body_bytes_;                     // 帧头与帧尾之间的字节数（数据 + 帧尾前校验）
+    size_t checksum_size_;                  // 校验字段字节数（0表示不校验）
+    size_t trailing_checksum_bytes_;        // 帧尾后校验字段字节数
+    size_t checksum_offset_;                // 校验字段在帧中的偏移
+    size_t checksum_range_start_;           // 实际校验范围起始
+    size_t checksum_range_end_;             // 实际校验范围结束（不含）
+    std::vector<unsigned char> frame_buffer_;  // 帧组装缓冲区
+    FrameDecodePlan decode_plan_;           // 按当前配置生成的解码计划
 };
 
 #endif // CUSTOM_PARSER_H
@@ -16,13 +16,21 @@
  * - 无帧头，直接发送float数据流
  * - 帧尾0x0000807F是一个特殊的float值（NaN），用于帧同步
  * - 兼容标准VOFA+上位机软件
+ *
+ * 解析方式（按帧切片，无逐字节状态机）：
+ * - 已同步：直接检查预期位置是否为帧尾，是则整帧拷贝
+ * - 失步：用ByteScanner向量化查找下一个帧尾，帧尾前N*4字节即为一帧；
+ *   每次失步计为一个帧尾错误（TAIL_MISMATCH）
+ * - 不足一帧的尾部字节暂存到carry_，与下一块数据拼接后继续
  */
 
 #ifndef FIREWATER_PARSER_H
 #define FIREWATER_PARSER_H
 
 #include "ProtocolParser.h"
+#include "ByteScanner.h"
 #include <cstring>
+#include <vector>
 
 /**
  * @brief FireWater协议解析器
@@ -31,93 +39,83 @@ class FireWaterParser : public ProtocolParser {
 public:
     FireWaterParser(size_t channel_count = 4)
         : channel_count_(channel_count)
-        , state_(State::READ_DATA)
-        , data_index_(0)
-        , tail_index_(0)
+        , synced_(true)
+        , resync_count_(0)
     {
-        data_buffer_.resize(channel_count * 4);  // 每个通道4字节
+        AllocateBuffers();
     }
 
-    ParseResult Parse(const unsigned char* buffer, size_t length) override {
-        ParseResult result;
-        result.values.reserve(channel_count_);
+    BatchParseResult ParseBatch(const unsigned char* buffer, size_t length,
+                                float* out, size_t max_frames, size_t max_channels) override {
+        BatchParseResult result;
+        result.channels = (channel_count_ < max_channels) ? channel_count_ : max_channels;
+        if (max_frames == 0) {
+            return result;
+        }
 
-        size_t consumed = 0;
+        size_t pos = 0;
 
-        for (size_t i = 0; i < length; i++) {
-            unsigned char byte = buffer[i];
-            consumed++;
+        // 上一块遗留的字节：与本块开头拼接，查找跨越两块的帧
+        if (!carry_.empty()) {
+            pos = ParseCarry(buffer, length, out, result);
+            if (!carry_.empty()) {
+                // 本块数据不足以完成一帧，已全部暂存
+                result.bytes_consumed = length;
+                return result;
+            }
+        }
 
-            switch (state_) {
-                case State::READ_DATA:
-                    data_buffer_[data_index_++] = byte;
+        const size_t data_bytes = channel_count_ * 4;
+        const size_t frame_bytes = data_bytes + 4;
 
-                    if (data_index_ >= data_buffer_.size()) {
-                        // 数据读取完成，开始验证帧尾
-                        state_ = State::VERIFY_TAIL;
-                        tail_index_ = 0;
-                    }
+        while (result.frames < max_frames) {
+            if (synced_) {
+                if (length - pos < frame_bytes) {
                     break;
+                }
+                // 已同步：帧尾应紧跟在数据之后
+                if (std::memcmp(buffer + pos + data_bytes, FRAME_TAIL, 4) == 0) {
+                    EmitFrame(buffer + pos, out, result);
+                    pos += frame_bytes;
+                    continue;
+                }
+                LoseSync(result);
+            }
 
-                case State::VERIFY_TAIL:
-                    if (byte == FRAME_TAIL[tail_index_]) {
-                        tail_index_++;
-
-                        if (tail_index_ >= 4) {
-                            // 帧尾完全匹配，解析float数据
-                            for (size_t ch = 0; ch < channel_count_; ch++) {
-                                float value;
-                                std::memcpy(&value, &data_buffer_[ch * 4], 4);
-                                result.values.push_back(value);
-                            }
-                            result.success = true;
-                            result.bytes_consumed = consumed;
-
-                            // 准备接收下一帧
-                            state_ = State::READ_DATA;
-                            data_index_ = 0;
-                            tail_index_ = 0;
-                            return result;
-                        }
-                    } else {
-                        // 帧尾不匹配，执行数据滑动搜索
-                        // 将缓冲区数据左移1字节，尝试重新对齐
-                        for (size_t j = 0; j < data_buffer_.size() - 1; j++) {
-                            data_buffer_[j] = data_buffer_[j + 1];
-                        }
-
-                        // 如果已经读取了部分帧尾，也需要处理
-                        if (tail_index_ > 0) {
-                            // 将已读取的帧尾字节放入数据缓冲区
-                            for (size_t j = 0; j < tail_index_; j++) {
-                                if (data_buffer_.size() > 0) {
-                                    data_buffer_[data_buffer_.size() - tail_index_ + j] = FRAME_TAIL[j];
-                                }
-                            }
-                        }
-
-                        // 将当前字节放入缓冲区末尾
-                        data_buffer_[data_buffer_.size() - 1] = byte;
-
-                        // 重新尝试验证帧尾
-                        tail_index_ = 0;
-                        if (byte == FRAME_TAIL[0]) {
-                            tail_index_ = 1;
-                        }
-                    }
-                    break;
+            // 失步：向量化查找下一个帧尾（帧尾之前至少要有完整数据）
+            if (length - pos < frame_bytes) {
+                break;
+            }
+            size_t search_from = pos + data_bytes;
+            size_t tail = search_from + ByteScanner::Find(buffer + search_from, length - search_from,
+                                                          FRAME_TAIL, 4);
+            if (tail >= length) {
+                break;
             }
+            EmitFrame(buffer + tail - data_bytes, out, result);
+            pos = tail + 4;
+            synced_ = true;
         }
 
-        // 数据不完整，等待更多数据
-        result.bytes_consumed = consumed;
+        if (result.frames >= max_frames) {
+            // 输出已满，剩余字节留给下次调用
+            result.bytes_consumed = pos;
+            return result;
+        }
+
+        // 剩余字节不足以组成一帧（或未找到帧尾）：保留可能属于下一帧的最后frame_bytes-1字节
+        size_t keep = length - pos;
+        if (keep > frame_bytes - 1) {
+            keep = frame_bytes - 1;
+        }
+        carry_.assign(buffer + length - keep, buffer + length);
+        result.bytes_consumed = length;
         return result;
     }
 
     void Reset() override {
-        state_ = State::READ_DATA;
-        data_index_ = 0;
-        tail_index_ = 0;
+        carry_.clear();
+        synced_ = true;
     }
 
     ProtocolType GetType() const override {
@@ -133,27 +131,106 @@ public:
     }
 
     void SetExpectedChannelCount(size_t count) override {
-        if (count > 0 && count <= 16) {
+        if (count > 0 && count <= MAX_FRAME_CHANNELS) {
             channel_count_ = count;
-            data_buffer_.resize(channel_count_ * 4);
+            AllocateBuffers();
             Reset();
         }
     }
 
-private:
-    enum class State {
-        READ_DATA,      // 读取float数据
-        VERIFY_TAIL     // 验证4字节帧尾
-    };
+    /**
+     * @brief 失步次数（帧尾不在预期位置，需要重新查找）
+     */
+    uint64_t GetResyncCount() const {
+        return resync_count_;
+    }
 
+private:
     // 标准VOFA+ FireWater帧尾（4字节）
     static constexpr unsigned char FRAME_TAIL[4] = {0x00, 0x00, 0x80, 0x7F};
 
-    size_t channel_count_;              // 通道数量
-    State state_;                       // 当前状态
-    std::vector<unsigned char> data_buffer_;  // 数据缓冲区
-    size_t data_index_;                 // 当前数据索引
-    size_t tail_index_;                 // 帧尾验证索引（0-3）
+    /**
+     * @brief 预分配暂存缓冲区（通道数变化时调用）
+     */
+    void AllocateBuffers() {
+        const size_t frame_bytes = channel_count_ * 4 + 4;
+        carry_.clear();
+        carry_.reserve(frame_bytes);
+        joint_.reserve(frame_bytes * 2);
+    }
+
+    /**
+     * @brief 帧尾不在预期位置：进入失步状态，跳过的字节按一个帧尾错误计入丢帧统计
+     */
+    void LoseSync(BatchParseResult& result) {
+        synced_ = false;
+        resync_count_++;
+        result.error = ParseError::TAIL_MISMATCH;
+        RecordRejectedFrame(ParseError::TAIL_MISMATCH);
+    }
+
+    /**
+     * @brief 输出一帧（data指向帧数据起始）
+     */
+    void EmitFrame(const unsigned char* data, float* out, BatchParseResult& result) {
+        std::memcpy(out + result.frames * result.channels, data, result.channels * 4);
+        result.frames++;
+    }
+
+    /**
+     * @brief 处理上一块遗留字节与本块开头拼接的部分
+     * @return 本块中已处理到的位置；本块不足以完成一帧时carry_保持非空
+     *
+     * carry_中不含完整帧，且最多frame_bytes-1字节，因此任何以carry_中字节
+     * 开头的帧都会在本块前frame_bytes字节内结束，只需拼接这一小段查找。
+     */
+    size_t ParseCarry(const unsigned char* buffer, size_t length, float* out, BatchParseResult& result) {
+        const size_t data_bytes = channel_count_ * 4;
+        const size_t frame_bytes = data_bytes + 4;
+        const size_t carry_size = carry_.size();
+        const size_t take = (length < frame_bytes) ? length : frame_bytes;
+
+        joint_.assign(carry_.begin(), carry_.end());
+        joint_.insert(joint_.end(), buffer, buffer + take);
+
+        size_t tail = joint_.size();
+        if (joint_.size() >= frame_bytes) {
+            if (synced_ && std::memcmp(joint_.data() + data_bytes, FRAME_TAIL, 4) == 0) {
+                tail = data_bytes;
+            } else {
+                if (synced_) {
+                    LoseSync(result);
+                }
+                tail = data_bytes + ByteScanner::Find(joint_.data() + data_bytes, joint_.size() - data_bytes,
+                                                      FRAME_TAIL, 4);
+            }
+        }
+
+        if (tail < joint_.size()) {
+            // 找到跨越两块的帧
+            EmitFrame(joint_.data() + tail - data_bytes, out, result);
+            synced_ = true;
+            carry_.clear();
+            return tail + 4 - carry_size;
+        }
+
+        if (take == length) {
+            // 本块太短：保留拼接结果中可能属于下一帧的字节
+            size_t keep = (joint_.size() > frame_bytes - 1) ? frame_bytes - 1 : joint_.size();
+            carry_.assign(joint_.end() - keep, joint_.end());
+            return length;
+        }
+
+        // 没有跨越两块的帧，遗留字节作废，从本块开头继续查找
+        carry_.clear();
+        return 0;
+    }
+
+    size_t channel_count_;                      // 通道数量
+    bool synced_;                               // 是否已与帧边界同步
+    uint64_t resync_count_;                     // 失步次数
+    std::vector<unsigned char> carry_;          // 上一块遗留的不完整帧字节
+    std::vector<unsigned char> joint_;          // 遗留字节与本块开头的拼接缓冲区
 };
 
 #endif // FIREWATER_PARSER_H
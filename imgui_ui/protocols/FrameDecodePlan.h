@@ -0,0 +1,172 @@
+/**
+ * @file FrameDecodePlan.h
+ * @brief 帧数据解码计划 - 按帧布局预先生成的解码器
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 帧布局（各通道数据类型 + 字节序）在配置时就已确定，
+ * 因此在Build()时一次性生成解码计划，之后每帧解码不再按字段分支：
+ * - 所有通道类型相同：选用模板化的整帧内核（如全float、全int16），
+ *   循环体无分支，编译器可展开/向量化
+ * - 混合类型：预计算每个字段的偏移和转换函数指针
+ * - 大端序在模板参数中处理，编译为bswap指令，无需temp[8]中转
+ */
+
+#ifndef FRAME_DECODE_PLAN_H
+#define FRAME_DECODE_PLAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "../core/DataTypes.h"
+
+/**
+ * @brief 帧数据解码计划
+ */
+class FrameDecodePlan {
+public:
+    FrameDecodePlan() = default;
+
+    /**
+     * @brief 根据帧布局生成解码计划
+     * @param types 各通道数据类型
+     * @param big_endian 是否大端序
+     */
+    void Build(const std::vector<DataType>& types, bool big_endian) {
+        fields_.clear();
+        frame_bytes_ = 0;
+        for (DataType type : types) {
+            fields_.push_back({frame_bytes_, SelectField(type, big_endian)});
+            frame_bytes_ += GetDataTypeSize(type);
+        }
+
+        // 所有通道类型相同时使用整帧内核
+        bool uniform = !types.empty();
+        for (DataType type : types) {
+            if (type != types[0]) {
+                uniform = false;
+                break;
+            }
+        }
+        frame_kernel_ = uniform ? SelectUniform(types[0], big_endian) : &DecodeFields;
+    }
+
+    /**
+     * @brief 解码一帧
+     * @param data 帧数据（frame_bytes()字节）
+     * @param out 输出数组
+     * @param channels 输出通道数（不超过计划中的通道数）
+     */
+    void Decode(const unsigned char* data, float* out, size_t channels) const {
+        frame_kernel_(*this, data, out, channels);
+    }
+
+    /**
+     * @brief 帧数据字节数
+     */
+    size_t frame_bytes() const {
+        return frame_bytes_;
+    }
+
+    /**
+     * @brief 通道数
+     */
+    size_t channel_count() const {
+        return fields_.size();
+    }
+
+private:
+    using FieldDecoder = float (*)(const unsigned char*);
+    using FrameKernel = void (*)(const FrameDecodePlan&, const unsigned char*, float*, size_t);
+
+    struct Field {
+        size_t offset;              // 字段在帧数据中的偏移
+        FieldDecoder decode;        // 字段转换函数
+    };
+
+    /**
+     * @brief 按字节序读取一个值
+     */
+    template<typename T, bool BigEndian>
+    static T Load(const unsigned char* data) {
+        T value;
+        if (BigEndian && sizeof(T) > 1) {
+            unsigned char temp[sizeof(T)];
+            for (size_t i = 0; i < sizeof(T); i++) {
+                temp[i] = data[sizeof(T) - 1 - i];
+            }
+            std::memcpy(&value, temp, sizeof(T));
+        } else {
+            std::memcpy(&value, data, sizeof(T));
+        }
+        return value;
+    }
+
+    template<typename T, bool BigEndian>
+    static float DecodeField(const unsigned char* data) {
+        return static_cast<float>(Load<T, BigEndian>(data));
+    }
+
+    /**
+     * @brief 整帧内核：所有通道类型相同
+     */
+    template<typename T, bool BigEndian>
+    static void DecodeUniform(const FrameDecodePlan&, const unsigned char* data, float* out, size_t channels) {
+        for (size_t i = 0; i < channels; i++) {
+            out[i] = static_cast<float>(Load<T, BigEndian>(data + i * sizeof(T)));
+        }
+    }
+
+    /**
+     * @brief 通用内核：按预计算的偏移和转换函数逐字段解码
+     */
+    static void DecodeFields(const FrameDecodePlan& plan, const unsigned char* data, float* out, size_t channels) {
+        const Field* fields = plan.fields_.data();
+        for (size_t i = 0; i < channels; i++) {
+            out[i] = fields[i].decode(data + fields[i].offset);
+        }
+    }
+
+    template<bool BigEndian>
+    static FieldDecoder SelectField(DataType type) {
+        switch (type) {
+            case DataType::FLOAT:  return &DecodeField<float, BigEndian>;
+            case DataType::INT32:  return &DecodeField<int32_t, BigEndian>;
+            case DataType::UINT32: return &DecodeField<uint32_t, BigEndian>;
+            case DataType::INT16:  return &DecodeField<int16_t, BigEndian>;
+            case DataType::UINT16: return &DecodeField<uint16_t, BigEndian>;
+            case DataType::INT8:   return &DecodeField<int8_t, BigEndian>;
+            case DataType::UINT8:  return &DecodeField<uint8_t, BigEndian>;
+            default: return &DecodeField<uint8_t, BigEndian>;
+        }
+    }
+
+    static FieldDecoder SelectField(DataType type, bool big_endian) {
+        return big_endian ? SelectField<true>(type) : SelectField<false>(type);
+    }
+
+    template<bool BigEndian>
+    static FrameKernel SelectUniform(DataType type) {
+        switch (type) {
+            case DataType::FLOAT:  return &DecodeUniform<float, BigEndian>;
+            case DataType::INT32:  return &DecodeUniform<int32_t, BigEndian>;
+            case DataType::UINT32: return &DecodeUniform<uint32_t, BigEndian>;
+            case DataType::INT16:  return &DecodeUniform<int16_t, BigEndian>;
+            case DataType::UINT16: return &DecodeUniform<uint16_t, BigEndian>;
+            case DataType::INT8:   return &DecodeUniform<int8_t, BigEndian>;
+            case DataType::UINT8:  return &DecodeUniform<uint8_t, BigEndian>;
+            default: return &DecodeFields;
+        }
+    }
+
+    static FrameKernel SelectUniform(DataType type, bool big_endian) {
+        return big_endian ? SelectUniform<true>(type) : SelectUniform<false>(type);
+    }
+
+    std::vector<Field> fields_;                 // 各字段解码信息
+    size_t frame_bytes_ = 0;                    // 帧数据字节数
+    FrameKernel frame_kernel_ = &DecodeFields;  // 整帧解码内核
+};
+
+#endif // FRAME_DECODE_PLAN_H
@@ -28,50 +28,54 @@ public:
     JustFloatParser(size_t channel_count = 4)
         : channel_count_(channel_count)
         , buffer_index_(0)
+        , value_index_(0)
     {
     }
 
-    ParseResult Parse(const unsigned char* buffer, size_t length) override {
-        ParseResult result;
-        result.values.reserve(channel_count_);
+    BatchParseResult ParseBatch(const unsigned char* buffer, size_t length,
+                                float* out, size_t max_frames, size_t max_channels) override {
+        BatchParseResult result;
+        result.channels = (channel_count_ < max_channels) ? channel_count_ : max_channels;
 
-        size_t consumed = 0;
+        const size_t frame_bytes = channel_count_ * 4;
         size_t i = 0;
 
-        while (i < length) {
+        while (i < length && result.frames < max_frames) {
+            // 快速路径：位于帧边界且剩余数据包含整帧，直接拷贝到输出行
+            if (buffer_index_ == 0 && value_index_ == 0 && length - i >= frame_bytes) {
+                std::memcpy(out + result.frames * result.channels, buffer + i, result.channels * 4);
+                result.frames++;
+                i += frame_bytes;
+                continue;
+            }
+
             // 将数据拷贝到内部缓冲区
             while (buffer_index_ < 4 && i < length) {
                 temp_buffer_[buffer_index_++] = buffer[i++];
-                consumed++;
             }
 
             // 如果凑齐4个字节，解析为float
             if (buffer_index_ == 4) {
-                float value;
-                std::memcpy(&value, temp_buffer_, 4);
-                result.values.push_back(value);
+                std::memcpy(&frame_values_[value_index_++], temp_buffer_, 4);
                 buffer_index_ = 0;  // 重置缓冲区
 
-                // 如果已经读满通道数，返回结果
-                if (result.values.size() >= channel_count_) {
-                    result.success = true;
-                    result.bytes_consumed = consumed;
-                    return result;
+                // 凑齐一帧（跨越多次调用的帧在此完成）
+                if (value_index_ >= channel_count_) {
+                    std::memcpy(out + result.frames * result.channels, frame_values_,
+                                result.channels * sizeof(float));
+                    result.frames++;
+                    value_index_ = 0;
                 }
             }
         }
 
-        // 如果有部分数据，也返回（用于多通道情况）
-        if (!result.values.empty()) {
-            result.success = true;
-        }
-
-        result.bytes_consumed = consumed;
+        result.bytes_consumed = i;
         return result;
     }
 
     void Reset() override {
         buffer_index_ = 0;
+        value_index_ = 0;
     }
 
     ProtocolType GetType() const override {
@@ -87,7 +91,7 @@ public:
     }
 
     void SetExpectedChannelCount(size_t count) override {
-        if (count > 0 && count <= 16) {
+        if (count > 0 && count <= MAX_FRAME_CHANNELS) {
             channel_count_ = count;
             Reset();
         }
@@ -97,6 +101,8 @@ private:
     size_t channel_count_;                  // 通道数量
     unsigned char temp_buffer_[4];          // 临时缓冲区（4字节float）
     size_t buffer_index_;                   // 当前缓冲区索引
+    float frame_values_[MAX_FRAME_CHANNELS];  // 未完成帧的已解析通道值
+    size_t value_index_;                    // 未完成帧已解析的通道数
 };
 
 #endif // JUSTFLOAT_PARSER_H
@@ -0,0 +1,491 @@
+/**
+ * @file ProtocolDetector.h
+ * @brief 协议自动识别 - 对接收数据采样打分，推断协议类型和通道数
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 识别方法（对一段采样数据分别打分，分数0~1）：
+ * - FireWater：帧尾 0x00 0x00 0x80 0x7F 的出现间隔是否呈固定周期，
+ *   周期 = 通道数×4 + 4
+ * - JustFloat：按4种字节对齐解读为float，统计“合理值”比例；
+ *   通道数取各通道相邻采样变化最平滑的交错步长
+ * - CSV：可打印字符比例、逐行字段是否都是数值、每行字段数是否一致
+ * - Custom：用当前自定义协议配置实际解析采样，按有效帧覆盖的字节比例打分
+ *
+ * 运行方式：
+ * - 解析阶段调用Feed()，只在采集窗口打开时用try_lock拷贝数据到采样缓冲区，
+ *   拿不到锁或窗口关闭时直接返回，不会阻塞解析
+ * - 采样满后由后台线程打分并发布结果，间隔CHECK_INTERVAL后再次采样，
+ *   因此连接建立后协议变化也能被发现
+ */
+
+#ifndef PROTOCOL_DETECTOR_H
+#define PROTOCOL_DETECTOR_H
+
+#include "ByteScanner.h"
+#include "CsvTokenizer.h"
+#include "CustomParser.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 单个协议的打分
+ */
+struct ProtocolScore {
+    float score = 0.0f;         // 匹配程度（0~1）
+    size_t channels = 0;        // 推断的通道数（0表示无法推断）
+};
+
+/**
+ * @brief 一次识别的结果
+ */
+struct DetectionResult {
+    ProtocolType type = ProtocolType::FIREWATER;    // 得分最高的协议
+    size_t channels = 0;                            // 推断的通道数
+    float confidence = 0.0f;                        // 最高分
+    bool confident = false;                         // 最高分超过阈值且明显领先
+    uint64_t generation = 0;                        // 结果序号（每次识别递增）
+
+    // 各协议得分（按ProtocolType下标，RawData不参与识别）
+    ProtocolScore scores[5];
+};
+
+/**
+ * @brief 协议自动识别器
+ */
+class ProtocolDetector {
+public:
+    static constexpr size_t SAMPLE_SIZE = 4096;                 // 每次采样字节数
+    static constexpr float CONFIDENT_SCORE = 0.6f;              // 最高分阈值
+    static constexpr float CONFIDENT_MARGIN = 0.15f;            // 领先第二名的分差
+    static constexpr std::chrono::milliseconds CHECK_INTERVAL{1000};  // 两次采样的间隔
+
+    ProtocolDetector()
+        : collecting_(true)
+        , running_(true)
+    {
+        sample_.reserve(SAMPLE_SIZE);
+        analyze_buffer_.reserve(SAMPLE_SIZE);
+        thread_ = std::thread(&ProtocolDetector::Run, this);
+    }
+
+    ~ProtocolDetector() {
+        {
+            std::lock_guard<std::mutex> lock(sample_mutex_);
+            running_ = false;
+        }
+        cv_.notify_one();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    ProtocolDetector(const ProtocolDetector&) = delete;
+    ProtocolDetector& operator=(const ProtocolDetector&) = delete;
+
+    /**
+     * @brief 送入接收数据（解析阶段调用，不阻塞）
+     */
+    void Feed(const unsigned char* data, size_t length) {
+        if (!collecting_.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(sample_mutex_, std::try_to_lock);
+        if (!lock.owns_lock() || !collecting_.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        size_t n = std::min(length, SAMPLE_SIZE - sample_.size());
+        sample_.insert(sample_.end(), data, data + n);
+        if (sample_.size() >= SAMPLE_SIZE) {
+            collecting_.store(false, std::memory_order_relaxed);
+            lock.unlock();
+            cv_.notify_one();
+        }
+    }
+
+    /**
+     * @brief 丢弃已采样数据和结果，立即重新采样（如重新连接串口）
+     */
+    void Restart() {
+        {
+            std::lock_guard<std::mutex> lock(sample_mutex_);
+            sample_.clear();
+            sample_epoch_++;
+            restart_requested_ = true;
+            collecting_.store(true, std::memory_order_relaxed);
+        }
+        cv_.notify_one();
+
+        std::lock_guard<std::mutex> lock(result_mutex_);
+        result_ = DetectionResult();
+        result_.generation = ++generation_;
+        has_result_ = false;
+    }
+
+    /**
+     * @brief 设置参与识别的自定义协议配置
+     */
+    void SetCustomConfig(const CustomProtocolConfig& config) {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        custom_config_ = config;
+    }
+
+    /**
+     * @brief 获取最近一次识别结果
+     * @return 尚无结果时返回false
+     */
+    bool GetResult(DetectionResult& result) const {
+        std::lock_guard<std::mutex> lock(result_mutex_);
+        result = result_;
+        return has_result_;
+    }
+
+    /**
+     * @brief 对一段数据打分（纯函数，可在任意线程调用）
+     */
+    static DetectionResult Analyze(const unsigned char* data, size_t length,
+                                   const CustomProtocolConfig& custom_config) {
+        DetectionResult result;
+        result.scores[static_cast<int>(ProtocolType::FIREWATER)] = ScoreFireWater(data, length);
+        result.scores[static_cast<int>(ProtocolType::JUSTFLOAT)] = ScoreJustFloat(data, length);
+        result.scores[static_cast<int>(ProtocolType::CSV)] = ScoreCsv(data, length);
+        result.scores[static_cast<int>(ProtocolType::CUSTOM)] = ScoreCustom(data, length, custom_config);
+
+        // 取最高分和第二高分
+        float second = 0.0f;
+        for (int i = 0; i < 5; i++) {
+            float score = result.scores[i].score;
+            if (score > result.confidence) {
+                second = result.confidence;
+                result.confidence = score;
+                result.type = static_cast<ProtocolType>(i);
+            } else if (score > second) {
+                second = score;
+            }
+        }
+        result.channels = result.scores[static_cast<int>(result.type)].channels;
+        result.confident = result.confidence >= CONFIDENT_SCORE &&
+                           result.confidence - second >= CONFIDENT_MARGIN &&
+                           result.channels > 0;
+        return result;
+    }
+
+private:
+    static constexpr unsigned char FIREWATER_TAIL[4] = {0x00, 0x00, 0x80, 0x7F};
+    static constexpr size_t MAX_CHANNELS = ProtocolParser::MAX_FRAME_CHANNELS;
+
+    /**
+     * @brief FireWater：帧尾间隔的周期性
+     *
+     * 统计相邻帧尾的间隔，取出现最多的合法周期（通道数×4+4），
+     * 分数 = 符合该周期的间隔比例 × 这些帧覆盖的字节比例
+     */
+    static ProtocolScore ScoreFireWater(const unsigned char* data, size_t length) {
+        ProtocolScore result;
+        size_t period_counts[MAX_CHANNELS + 1] = {};
+        size_t intervals = 0;
+        size_t last = length;
+
+        size_t pos = ByteScanner::Find(data, length, FIREWATER_TAIL, 4);
+        while (pos < length) {
+            if (last < length) {
+                size_t period = pos - last;
+                intervals++;
+                if (period % 4 == 0 && period >= 8 && period <= MAX_CHANNELS * 4 + 4) {
+                    period_counts[(period - 4) / 4]++;
+                }
+            }
+            last = pos;
+            size_t next = pos + 4;
+            pos = next + ByteScanner::Find(data + next, length - next, FIREWATER_TAIL, 4);
+        }
+
+        if (intervals < 2) {
+            return result;
+        }
+
+        size_t best_channels = 1;
+        for (size_t c = 2; c <= MAX_CHANNELS; c++) {
+            if (period_counts[c] > period_counts[best_channels]) {
+                best_channels = c;
+            }
+        }
+        size_t matched = period_counts[best_channels];
+        if (matched == 0) {
+            return result;
+        }
+
+        float regularity = static_cast<float>(matched) / static_cast<float>(intervals);
+        float coverage = std::min(1.0f, static_cast<float>(matched * (best_channels * 4 + 4)) /
+                                        static_cast<float>(length));
+        result.score = regularity * coverage;
+        result.channels = best_channels;
+        return result;
+    }
+
+    /**
+     * @brief 是否为“合理”的采样值（有限、非极小非极大）
+     */
+    static bool IsPlausibleFloat(float value) {
+        if (!std::isfinite(value)) return false;
+        float magnitude = std::fabs(value);
+        return value == 0.0f || (magnitude >= 1e-6f && magnitude <= 1e7f);
+    }
+
+    /**
+     * @brief JustFloat：float合理性 + 按通道交错后的平滑度
+     *
+     * 纯float流没有帧边界，通道数只能从数据本身推断：
+     * 正确的交错步长下，同一通道相邻采样的变化最小。
+     * 多个步长同样平滑时（如步长2和4），取最小的步长。
+     */
+    static ProtocolScore ScoreJustFloat(const unsigned char* data, size_t length) {
+        ProtocolScore result;
+        if (length < 32) {
+            return result;
+        }
+
+        // 选择合理值最多的字节对齐
+        size_t best_offset = 0;
+        size_t best_plausible = 0;
+        for (size_t offset = 0; offset < 4; offset++) {
+            size_t plausible = 0;
+            for (size_t i = offset; i + 4 <= length; i += 4) {
+                float value;
+                std::memcpy(&value, data + i, 4);
+                if (IsPlausibleFloat(value)) plausible++;
+            }
+            if (plausible > best_plausible) {
+                best_plausible = plausible;
+                best_offset = offset;
+            }
+        }
+
+        size_t count = (length - best_offset) / 4;
+        float plausibility = static_cast<float>(best_plausible) / static_cast<float>(count);
+        if (plausibility < 0.5f) {
+            return result;
+        }
+
+        std::vector<float> values(count);
+        std::memcpy(values.data(), data + best_offset, count * 4);
+
+        // 各交错步长下的相对变化量（越小越平滑）
+        float roughness[MAX_CHANNELS + 1];
+        float best_roughness = 1.0f;
+        for (size_t c = 1; c <= MAX_CHANNELS; c++) {
+            double diff = 0.0;
+            double magnitude = 0.0;
+            for (size_t i = c; i < count; i++) {
+                float a = values[i];
+                float b = values[i - c];
+                if (!IsPlausibleFloat(a) || !IsPlausibleFloat(b)) continue;
+                diff += std::fabs(static_cast<double>(a) - b);
+                magnitude += std::fabs(static_cast<double>(a)) + std::fabs(static_cast<double>(b));
+            }
+            roughness[c] = magnitude > 0.0 ? static_cast<float>(diff / magnitude) : 0.0f;
+            best_roughness = std::min(best_roughness, roughness[c]);
+        }
+
+        result.channels = 1;
+        for (size_t c = 1; c <= MAX_CHANNELS; c++) {
+            if (roughness[c] <= best_roughness * 1.1f + 1e-3f) {
+                result.channels = c;
+                break;
+            }
+        }
+
+        // 纯float流中不应出现不合理值（FireWater帧尾即+inf），按四次方压低；
+        // 平滑的数据更可能是真实采样，随机二进制数据的变化量接近1
+        float p2 = plausibility * plausibility;
+        result.score = p2 * p2 * (1.0f - 0.5f * std::min(1.0f, best_roughness));
+        return result;
+    }
+
+    /**
+     * @brief CSV：可打印字符比例 × 数值行比例 × 字段数一致性
+     */
+    static ProtocolScore ScoreCsv(const unsigned char* data, size_t length) {
+        ProtocolScore result;
+        if (length == 0) {
+            return result;
+        }
+
+        size_t printable = 0;
+        for (size_t i = 0; i < length; i++) {
+            unsigned char c = data[i];
+            if ((c >= 0x20 && c < 0x7F) || c == '\n' || c == '\r' || c == '\t') printable++;
+        }
+        float printable_ratio = static_cast<float>(printable) / static_cast<float>(length);
+        if (printable_ratio < 0.9f) {
+            return result;
+        }
+
+        // 跳过首个（可能不完整的）行，只统计完整的行
+        const char* text = reinterpret_cast<const char*>(data);
+        const char* end = text + length;
+        const char* line = static_cast<const char*>(std::memchr(text, '\n', length));
+        if (!line) {
+            return result;
+        }
+        line++;
+
+        size_t lines = 0;
+        size_t numeric_lines = 0;
+        size_t field_counts[MAX_CHANNELS + 1] = {};
+        float values[MAX_CHANNELS];
+        while (line < end) {
+            const char* newline = static_cast<const char*>(
+                std::memchr(line, '\n', static_cast<size_t>(end - line)));
+            if (!newline) break;
+
+            ParseError error = ParseError::NONE;
+            size_t fields = CsvTokenizer::ParseLine(line, newline, values, MAX_CHANNELS, error);
+            if (fields > 0 || error != ParseError::NONE) {   // 空行不计
+                lines++;
+                if (fields > 0 && error == ParseError::NONE) {
+                    numeric_lines++;
+                    field_counts[fields]++;
+                }
+            }
+            line = newline + 1;
+        }
+
+        if (lines < 2 || numeric_lines == 0) {
+            return result;
+        }
+
+        size_t best_fields = 1;
+        for (size_t f = 2; f <= MAX_CHANNELS; f++) {
+            if (field_counts[f] > field_counts[best_fields]) {
+                best_fields = f;
+            }
+        }
+
+        float numeric_ratio = static_cast<float>(numeric_lines) / static_cast<float>(lines);
+        float consistency = static_cast<float>(field_counts[best_fields]) / static_cast<float>(numeric_lines);
+        result.score = printable_ratio * numeric_ratio * consistency;
+        result.channels = best_fields;
+        return result;
+    }
+
+    /**
+     * @brief Custom：用当前自定义协议配置解析采样，按有效帧覆盖的字节比例打分
+     *
+     * 帧头/帧尾/校验都由CustomParser实际验证，与正式解析口径一致
+     */
+    static ProtocolScore ScoreCustom(const unsigned char* data, size_t length,
+                                     const CustomProtocolConfig& config) {
+        ProtocolScore result;
+        if (config.frame_header.empty() || config.channel_types.empty()) {
+            return result;
+        }
+
+        CustomParser parser(config);
+        size_t frame_size = config.frame_header.size() + config.frame_tail.size() +
+                            (config.use_checksum ? GetChecksumSize(config.checksum_type) : 0);
+        for (DataType type : config.channel_types) {
+            frame_size += GetDataTypeSize(type);
+        }
+
+        std::vector<float> out(64 * MAX_CHANNELS);
+        size_t frames = 0;
+        size_t offset = 0;
+        while (offset < length) {
+            BatchParseResult batch = parser.ParseBatch(data + offset, length - offset,
+                                                       out.data(), 64, MAX_CHANNELS);
+            frames += batch.frames;
+            if (batch.bytes_consumed == 0) break;
+            offset += batch.bytes_consumed;
+        }
+
+        if (frames < 2) {
+            return result;
+        }
+        result.score = std::min(1.0f, static_cast<float>(frames * frame_size) / static_cast<float>(length));
+        result.channels = std::min(config.channel_types.size(), MAX_CHANNELS);
+        return result;
+    }
+
+    /**
+     * @brief 后台线程：等待采样满 -> 打分 -> 发布结果 -> 间隔后重新采样
+     */
+    void Run() {
+        while (true) {
+            uint64_t epoch;
+            {
+                std::unique_lock<std::mutex> lock(sample_mutex_);
+                cv_.wait(lock, [this] {
+                    return !running_ || sample_.size() >= SAMPLE_SIZE;
+                });
+                if (!running_) break;
+                analyze_buffer_.swap(sample_);
+                sample_.clear();
+                epoch = sample_epoch_;
+                restart_requested_ = false;
+            }
+
+            CustomProtocolConfig config;
+            {
+                std::lock_guard<std::mutex> lock(config_mutex_);
+                config = custom_config_;
+            }
+            DetectionResult result = Analyze(analyze_buffer_.data(), analyze_buffer_.size(), config);
+
+            // 分析期间调用过Restart()的结果属于旧数据，丢弃
+            bool stale;
+            {
+                std::lock_guard<std::mutex> lock(sample_mutex_);
+                stale = (epoch != sample_epoch_);
+            }
+            if (!stale) {
+                std::lock_guard<std::mutex> lock(result_mutex_);
+                result.generation = ++generation_;
+                result_ = result;
+                has_result_ = true;
+            }
+
+            // 间隔一段时间后重新打开采集窗口（Restart()会提前唤醒）
+            std::unique_lock<std::mutex> lock(sample_mutex_);
+            cv_.wait_for(lock, CHECK_INTERVAL, [this] {
+                return !running_ || restart_requested_;
+            });
+            if (!running_) break;
+            collecting_.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    // 采样（解析阶段写入，后台线程取走）
+    std::vector<unsigned char> sample_;
+    std::vector<unsigned char> analyze_buffer_;
+    std::atomic<bool> collecting_;              // 采集窗口是否打开
+    bool running_;                              // 后台线程是否运行（sample_mutex_保护）
+    bool restart_requested_ = false;            // 已请求重新采样（sample_mutex_保护）
+    uint64_t sample_epoch_ = 0;                 // Restart()次数（sample_mutex_保护）
+    std::mutex sample_mutex_;
+    std::condition_variable cv_;
+
+    // 自定义协议配置
+    CustomProtocolConfig custom_config_;
+    std::mutex config_mutex_;
+
+    // 识别结果
+    DetectionResult result_;
+    bool has_result_ = false;
+    uint64_t generation_ = 0;
+    mutable std::mutex result_mutex_;
+
+    std::thread thread_;
+};
+
+#endif // PROTOCOL_DETECTOR_H
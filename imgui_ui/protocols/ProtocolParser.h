@@ -5,27 +5,109 @@
  * @date 2025
  *
  * 定义协议解析器接口，所有具体协议解析器继承此基类
+ *
+ * 两种解析接口：
+ * - ParseBatch()：一次调用解码缓冲区内所有完整帧，写入调用方提供的
+ *   平铺float数组（帧 × 通道），用于高速接收路径
+ * - Parse()：只返回第一个完整帧（基于ParseBatch实现，兼容旧接口）
+ *
+ * 解析路径不做堆分配：ParseResult只是指向解析器内部存储的视图，
+ * 错误以数值错误码（ParseError）表示。
  */
 
 #ifndef PROTOCOL_PARSER_H
 #define PROTOCOL_PARSER_H
 
-#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
 #include <string>
 #include "../core/DataTypes.h"
 
+/**
+ * @brief 解析错误码
+ */
+enum class ParseError : uint8_t {
+    NONE = 0,               // 无错误
+    INCOMPLETE,             // 数据不完整，等待更多数据
+    NO_CHANNELS,            // 未配置通道
+    TAIL_MISMATCH,          // 帧尾不匹配
+    INVALID_FIELD,          // 字段无法解析（文本协议）
+    CHECKSUM_MISMATCH,      // 校验失败
+    COUNT                   // 错误码数量（非错误码）
+};
+
+/**
+ * @brief 获取解析错误码的描述
+ */
+inline const char* GetParseErrorName(ParseError error) {
+    switch (error) {
+        case ParseError::NONE:          return "OK";
+        case ParseError::INCOMPLETE:    return "Incomplete frame";
+        case ParseError::NO_CHANNELS:   return "No channel types configured";
+        case ParseError::TAIL_MISMATCH: return "Frame tail mismatch";
+        case ParseError::INVALID_FIELD: return "Invalid field";
+        case ParseError::CHECKSUM_MISMATCH: return "Checksum mismatch";
+        default: return "Unknown error";
+    }
+}
+
+/**
+ * @brief 只读float视图（不拥有数据）
+ */
+class FloatSpan {
+public:
+    FloatSpan() : data_(nullptr), size_(0) {}
+    FloatSpan(const float* data, size_t size) : data_(data), size_(size) {}
+
+    const float* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const float& operator[](size_t index) const { return data_[index]; }
+    const float* begin() const { return data_; }
+    const float* end() const { return data_ + size_; }
+
+private:
+    const float* data_;
+    size_t size_;
+};
+
 /**
  * @brief 解析结果结构
+ *
+ * values指向解析器内部存储，在下一次调用该解析器之前有效。
  */
 struct ParseResult {
     bool success;                   // 是否解析成功
-    std::vector<float> values;      // 解析出的多通道数据
+    FloatSpan values;               // 解析出的多通道数据（解析器持有）
     size_t bytes_consumed;          // 消耗的字节数
-    std::string error_message;      // 错误信息
+    ParseError error;               // 错误码
 
     ParseResult()
         : success(false)
         , bytes_consumed(0)
+        , error(ParseError::NONE)
+    {}
+};
+
+/**
+ * @brief 批量解析结果
+ *
+ * 输出数组中第f帧第c通道位于 out[f * channels + c]。
+ * 同一批次内所有帧的通道数相同；遇到通道数不同的帧（仅CSV可能出现）
+ * 或输出已满时提前结束，bytes_consumed小于输入长度，调用方应继续解析剩余字节。
+ */
+struct BatchParseResult {
+    size_t frames;                  // 解析出的完整帧数
+    size_t channels;                // 每帧通道数（输出行宽）
+    size_t bytes_consumed;          // 消耗的字节数
+    ParseError error;               // 本批次最后一次遇到的错误（丢弃的帧）
+
+    BatchParseResult()
+        : frames(0)
+        , channels(0)
+        , bytes_consumed(0)
+        , error(ParseError::NONE)
     {}
 };
 
@@ -34,15 +116,40 @@ struct ParseResult {
  */
 class ProtocolParser {
 public:
+    static constexpr size_t MAX_FRAME_CHANNELS = 256;  // 单帧最大通道数（与DataChannelManager::MAX_CHANNELS一致）
+
     virtual ~ProtocolParser() = default;
 
     /**
-     * @brief 解析数据
+     * @brief 批量解析：解码缓冲区内所有完整帧
+     * @param buffer 输入缓冲区
+     * @param length 缓冲区长度
+     * @param out 输出数组（调用方持有，至少max_frames * max_channels个float）
+     * @param max_frames 最多输出帧数
+     * @param max_channels 每帧最多输出通道数（超出的通道被截断）
+     * @return 批量解析结果
+     */
+    virtual BatchParseResult ParseBatch(const unsigned char* buffer, size_t length,
+                                        float* out, size_t max_frames, size_t max_channels) = 0;
+
+    /**
+     * @brief 解析数据（遇到第一个完整帧即返回）
      * @param buffer 输入缓冲区
      * @param length 缓冲区长度
      * @return 解析结果
      */
-    virtual ParseResult Parse(const unsigned char* buffer, size_t length) = 0;
+    virtual ParseResult Parse(const unsigned char* buffer, size_t length) {
+        ParseResult result;
+        BatchParseResult batch = ParseBatch(buffer, length, result_values_, 1, MAX_FRAME_CHANNELS);
+        if (batch.frames > 0) {
+            result.values = FloatSpan(result_values_, batch.channels);
+            result.success = true;
+        } else {
+            result.error = (batch.error != ParseError::NONE) ? batch.error : ParseError::INCOMPLETE;
+        }
+        result.bytes_consumed = batch.bytes_consumed;
+        return result;
+    }
 
     /**
      * @brief 重置解析器状态
@@ -72,6 +179,37 @@ public:
     virtual void SetExpectedChannelCount(size_t count) {
         (void)count;  // 默认实现忽略
     }
+
+    /**
+     * @brief 因指定原因被丢弃的帧数（解析线程写，任意线程读）
+     */
+    uint64_t GetRejectedFrames(ParseError reason) const {
+        return rejected_frames_[static_cast<size_t>(reason)].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 被丢弃的总帧数
+     */
+    uint64_t GetTotalRejectedFrames() const {
+        uint64_t total = 0;
+        for (const auto& count : rejected_frames_) {
+            total += count.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+protected:
+    /**
+     * @brief 记录一个被丢弃的帧
+     */
+    void RecordRejectedFrame(ParseError reason) {
+        rejected_frames_[static_cast<size_t>(reason)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    float result_values_[MAX_FRAME_CHANNELS] = {};  // Parse()结果存储
+
+private:
+    std::atomic<uint64_t> rejected_frames_[static_cast<size_t>(ParseError::COUNT)] = {};  // 按原因统计的丢帧数
 };
 
 #endif // PROTOCOL_PARSER_H
@@ -33,51 +33,45 @@ public:
         SetDefaultChannels(4);
     }
 
-    ParseResult Parse(const unsigned char* buffer, size_t length) override {
-        ParseResult result;
-        result.values.reserve(channel_types_.size());
-
-        size_t consumed = 0;
-        size_t i = 0;
+    BatchParseResult ParseBatch(const unsigned char* buffer, size_t length,
+                                float* out, size_t max_frames, size_t max_channels) override {
+        BatchParseResult result;
+        if (channel_types_.empty()) {
+            // 未配置通道类型，无法解析
+            result.error = ParseError::NO_CHANNELS;
+            return result;
+        }
 
-        while (i < length) {
-            if (channel_types_.empty()) {
-                result.error_message = "No channel types configured";
-                break;
-            }
+        const size_t channel_count = channel_types_.size();
+        result.channels = (channel_count < max_channels) ? channel_count : max_channels;
 
+        size_t i = 0;
+        while (i < length && result.frames < max_frames) {
             // 当前通道需要的字节数
             size_t bytes_needed = GetDataTypeSize(channel_types_[current_channel_]);
 
             // 将数据拷贝到临时缓冲区
             while (buffer_index_ < bytes_needed && i < length) {
                 temp_buffer_[buffer_index_++] = buffer[i++];
-                consumed++;
             }
 
             // 如果凑齐所需字节数，解析数据
             if (buffer_index_ == bytes_needed) {
-                float value = BytesToFloat(temp_buffer_, channel_types_[current_channel_]);
-                result.values.push_back(value);
+                frame_values_[current_channel_] = BytesToFloat(temp_buffer_, channel_types_[current_channel_]);
                 buffer_index_ = 0;
                 current_channel_++;
 
-                // 如果所有通道都解析完，返回结果
-                if (current_channel_ >= channel_types_.size()) {
+                // 所有通道都解析完，输出一帧
+                if (current_channel_ >= channel_count) {
+                    std::memcpy(out + result.frames * result.channels, frame_values_.data(),
+                                result.channels * sizeof(float));
+                    result.frames++;
                     current_channel_ = 0;
-                    result.success = true;
-                    result.bytes_consumed = consumed;
-                    return result;
                 }
             }
         }
 
-        // 部分数据也返回
-        if (!result.values.empty()) {
-            result.success = true;
-        }
-
-        result.bytes_consumed = consumed;
+        result.bytes_consumed = i;
         return result;
     }
 
@@ -104,6 +98,7 @@ public:
      */
     void SetChannelTypes(const std::vector<DataType>& types) {
         channel_types_ = types;
+        frame_values_.resize(channel_types_.size());
         Reset();
     }
 
@@ -120,6 +115,7 @@ public:
     void SetDefaultChannels(size_t count) {
         channel_types_.clear();
         channel_types_.resize(count, DataType::FLOAT);
+        frame_values_.resize(count);
         Reset();
     }
 
@@ -128,6 +124,7 @@ private:
     unsigned char temp_buffer_[8];          // 临时缓冲区（最大8字节）
     size_t buffer_index_;                   // 当前缓冲区索引
     size_t current_channel_;                // 当前正在解析的通道
+    std::vector<float> frame_values_;       // 未完成帧的已解析通道值
 };
 
 #endif // RAWDATA_PARSER_H
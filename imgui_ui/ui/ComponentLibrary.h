@@ -39,7 +39,8 @@ public:
             {WidgetType::DIGITAL_DISPLAY, "数字表盘", "大号数字显示当前值", "🔢"},
             {WidgetType::BAR_CHART, "柱状图", "多通道对比显示", "📊"},
             {WidgetType::GAUGE, "仪表盘", "圆形指针式显示", "⏲️"},
-            {WidgetType::DATA_TABLE, "数据表格", "历史数据表格显示", "📋"}
+            {WidgetType::DATA_TABLE, "数据表格", "历史数据表格显示", "📋"},
+            {WidgetType::SPECTRUM, "频谱图", "FFT幅度谱（加窗、Welch平均）", "〰️"}
         };
     }
 
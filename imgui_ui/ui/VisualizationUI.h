@@ -9,21 +9,32 @@
  * - 中间：大波形显示区
  * - 右侧：紧凑通道列表
  * - 底部：简化状态栏
+ *
+ * 解析输出在写入DataChannelManager之前经过可选的滤波阶段（FilterStage）：
+ * 原始通道保持不变，每个滤波器的输出作为新通道追加在原始通道之后。
  */
 
 #ifndef VISUALIZATION_UI_H
 #define VISUALIZATION_UI_H
 
 #include "../core/DataChannelManager.h"
+#include "../core/ChannelFilter.h"
 #include "../protocols/ProtocolParser.h"
 #include "../protocols/FireWaterParser.h"
 #include "../protocols/JustFloatParser.h"
 #include "../protocols/RawDataParser.h"
 #include "../protocols/CustomParser.h"
 #include "../protocols/CsvParser.h"
+#include "../protocols/ProtocolDetector.h"
+#include "../visualization/PlotSeries.h"
+#include "../visualization/SpectrumWidget.h"
 #include <imgui.h>
 #include <implot.h>
 #include <memory>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <cstdint>
 
 /**
  * @brief VOFA+风格可视化UI管理器
@@ -35,12 +46,18 @@ public:
         , auto_scale_y_(true)
     {
         protocol_parser_ = std::make_unique<FireWaterParser>();
+        channel_manager_.SetChannelCount(channel_count_);
     }
 
     /**
      * @brief 渲染VOFA+风格UI（在当前内容区域内渲染，不创建新窗口）
      */
     void Render() {
+        UpdateAutoDetection();
+
+        // 本帧所有通道读取都基于同一个快照
+        channel_manager_.AcquireSnapshot();
+
         ImVec2 content_size = ImGui::GetContentRegionAvail();
 
         // === 左侧配置面板（130px） ===
@@ -67,51 +84,159 @@ public:
         ImGui::BeginChild("##StatusBar", ImVec2(content_size.x, 30), true, ImGuiWindowFlags_NoScrollbar);
         RenderStatusBar();
         ImGui::EndChild();
+
+        // 滤波器设置窗口（独立浮动窗口）
+        if (show_filter_window_) {
+            RenderFilterWindow();
+        }
+
+        // 频谱图窗口（独立浮动窗口）
+        if (show_spectrum_window_) {
+            RenderSpectrumWindow();
+        }
     }
 
     DataChannelManager& GetChannelManager() { return channel_manager_; }
     ProtocolParser* GetProtocolParser() { return protocol_parser_.get(); }
     const ProtocolParser* GetProtocolParser() const { return protocol_parser_.get(); }
 
+    /**
+     * @brief 滤波器配置（第i个滤波器输出到通道 通道数 + i）
+     */
+    const std::vector<FilterConfig>& GetFilters() const { return filter_configs_; }
+    void SetFilters(const std::vector<FilterConfig>& filters) {
+        filter_configs_ = filters;
+        ApplyFilters();
+    }
+
+    /**
+     * @brief 滤波器设计采样率（随配置保存，0表示未设置）
+     *
+     * 截止/陷波频率只按这个值设计；测得的接收帧率仅在设置窗口中作为建议值显示。
+     */
+    double GetFilterSampleRate() const { return filter_sample_rate_; }
+    void SetFilterSampleRate(double sample_rate) {
+        filter_sample_rate_ = std::max(sample_rate, 0.0);
+        std::lock_guard<std::mutex> lock(parser_mutex_);
+        filter_stage_.SetSampleRate(filter_sample_rate_);
+    }
+
+    /**
+     * @brief 滤波开销（平均每个滤波输出样本的纳秒数，不加锁）
+     */
+    double GetFilterCostPerSample() const { return filter_stage_.GetCostPerSample(); }
+    size_t GetFilterCount() const { return filter_configs_.size(); }
+
     void SetProtocolType(ProtocolType type) {
         if (type == current_protocol_type_) return;
         current_protocol_type_ = type;
 
+        std::unique_ptr<ProtocolParser> parser;
         switch (type) {
             case ProtocolType::FIREWATER:
-                protocol_parser_ = std::make_unique<FireWaterParser>();
+                parser = std::make_unique<FireWaterParser>();
                 break;
             case ProtocolType::JUSTFLOAT:
-                protocol_parser_ = std::make_unique<JustFloatParser>();
+                parser = std::make_unique<JustFloatParser>();
                 break;
             case ProtocolType::RAWDATA:
-                protocol_parser_ = std::make_unique<RawDataParser>();
+                parser = std::make_unique<RawDataParser>();
                 break;
             case ProtocolType::CSV:
-                protocol_parser_ = std::make_unique<CsvParser>();
+                parser = std::make_unique<CsvParser>();
                 break;
             case ProtocolType::CUSTOM:
-                protocol_parser_ = std::make_unique<CustomParser>();
+                parser = std::make_unique<CustomParser>(custom_config_);
                 break;
         }
 
         // 同步通道数配置到新协议
-        if (protocol_parser_) {
-            protocol_parser_->SetExpectedChannelCount(channel_count_);
+        if (parser) {
+            parser->SetExpectedChannelCount(channel_count_);
         }
 
-        // 自动调整启用的通道数量
-        for (size_t i = 0; i < DataChannelManager::MAX_CHANNELS; i++) {
-            channel_manager_.SetChannelEnabled(i, static_cast<int>(i) < channel_count_);
+        // 在解析锁内替换，解析阶段不会看到半切换的解析器
+        {
+            std::lock_guard<std::mutex> lock(parser_mutex_);
+            protocol_parser_ = std::move(parser);
         }
+
+        // 自动调整启用的通道数量（含滤波输出通道）
+        ApplyFilters();
     }
 
-    void ProcessReceivedData(const unsigned char* data, size_t length) {
+    /**
+     * @brief 设置通道数（同步到解析器并启用相应数量的通道）
+     */
+    void SetChannelCount(int count) {
+        // 限制范围：1 ~ MAX_CHANNELS通道
+        const int max_count = static_cast<int>(DataChannelManager::MAX_CHANNELS);
+        if (count < 1) count = 1;
+        if (count > max_count) count = max_count;
+        if (count == channel_count_) return;
+        channel_count_ = count;
+
+        // 更新协议解析器的通道数
+        {
+            std::lock_guard<std::mutex> lock(parser_mutex_);
+            if (protocol_parser_) {
+                protocol_parser_->SetExpectedChannelCount(channel_count_);
+            }
+        }
+
+        // 自动启用相应数量的通道（按需创建；滤波输出通道随之移动）
+        ApplyFilters();
+    }
+
+    /**
+     * @brief 是否在连接后自动识别协议
+     */
+    bool GetAutoDetect() const { return auto_detect_; }
+    void SetAutoDetect(bool enabled) { auto_detect_ = enabled; }
+
+    /**
+     * @brief 重新开始协议识别（打开串口时调用）
+     */
+    void ResetAutoDetection() {
+        detector_.Restart();
+        auto_applied_ = false;
+        mismatch_count_ = 0;
+    }
+
+    /**
+     * @brief 处理接收数据（有序解析阶段）
+     *
+     * 解析器有内部状态机，必须由单一线程按到达顺序调用；
+     * 每次调用解码数据块中的全部完整帧，按批写入DataChannelManager。
+     * stream_offset是数据块进入流水线时分配的字节流位置，每批帧附带
+     * 其结束位置，DataChannelManager据此校验顺序（见GetFrameOrderStats）。
+     */
+    void ProcessReceivedData(const unsigned char* data, size_t length, uint64_t stream_offset) {
+        // 协议识别采样（try_lock拷贝，不阻塞解析）
+        detector_.Feed(data, length);
+
+        std::lock_guard<std::mutex> lock(parser_mutex_);
         if (!protocol_parser_) return;
 
-        ParseResult result = protocol_parser_->Parse(data, length);
-        if (result.success && !result.values.empty()) {
-            channel_manager_.PushMultiChannelData(result.values.data(), result.values.size());
+        size_t offset = 0;
+        while (offset < length) {
+            BatchParseResult batch = protocol_parser_->ParseBatch(
+                data + offset, length - offset, batch_buffer_.data(),
+                BATCH_MAX_FRAMES, DataChannelManager::MAX_CHANNELS);
+
+            uint64_t stream_position = stream_offset + offset + batch.bytes_consumed;
+            if (batch.frames > 0 && filter_stage_.GetFilterCount() > 0) {
+                // 滤波输出追加在原始通道之后
+                size_t width = filter_stage_.Apply(batch_buffer_.data(), batch.frames, batch.channels,
+                                                   filter_base_, filter_buffer_.data());
+                channel_manager_.PushFrames(filter_buffer_.data(), batch.frames, width, stream_position);
+            } else if (batch.frames > 0) {
+                channel_manager_.PushFrames(batch_buffer_.data(), batch.frames, batch.channels,
+                                            stream_position);
+            } else if (batch.bytes_consumed == 0) {
+                break;
+            }
+            offset += batch.bytes_consumed;
         }
     }
 
@@ -133,8 +258,13 @@ private:
         int current = static_cast<int>(current_protocol_type_);
         if (ImGui::Combo("##protocol", &current, protocols, IM_ARRAYSIZE(protocols))) {
             SetProtocolType(static_cast<ProtocolType>(current));
+            auto_applied_ = true;   // 手动选择优先，本次连接不再自动切换
         }
 
+        // === 协议自动识别 ===
+        ImGui::Checkbox("自动识别", &auto_detect_);
+        RenderDetectionStatus();
+
         ImGui::Spacing();
 
         // === 通道数配置 ===
@@ -143,23 +273,13 @@ private:
         ImGui::SetNextItemWidth(-FLT_MIN);
         int temp_channel_count = channel_count_;
         if (ImGui::InputInt("##channels", &temp_channel_count, 1, 1)) {
-            // 限制范围：1-16通道
-            if (temp_channel_count < 1) temp_channel_count = 1;
-            if (temp_channel_count > 16) temp_channel_count = 16;
-
-            if (temp_channel_count != channel_count_) {
-                channel_count_ = temp_channel_count;
-
-                // 更新协议解析器的通道数
-                if (protocol_parser_) {
-                    protocol_parser_->SetExpectedChannelCount(channel_count_);
-                }
+            SetChannelCount(temp_channel_count);
+            auto_applied_ = true;
+        }
 
-                // 自动启用相应数量的通道
-                for (size_t i = 0; i < DataChannelManager::MAX_CHANNELS; i++) {
-                    channel_manager_.SetChannelEnabled(i, static_cast<int>(i) < channel_count_);
-                }
-            }
+        // === 自定义协议帧校验 ===
+        if (current_protocol_type_ == ProtocolType::CUSTOM) {
+            RenderChecksumConfig();
         }
 
         ImGui::Spacing();
@@ -180,10 +300,383 @@ private:
         ImGui::SetNextItemWidth(-FLT_MIN);
         ImGui::SliderFloat("##xrange", &x_axis_range_, 1.0f, 60.0f, "%.1fs");
 
+        // === 波形降采样方式 ===
+        ImGui::AlignTextToFramePadding();
+        ImGui::Text("降采样:");
+        ImGui::SetNextItemWidth(-FLT_MIN);
+        const DownsampleMode modes[] = {DownsampleMode::STRIDE, DownsampleMode::MINMAX,
+                                        DownsampleMode::M4, DownsampleMode::LTTB};
+        if (ImGui::BeginCombo("##downsample", GetDownsampleModeName(downsample_mode_))) {
+            for (DownsampleMode mode : modes) {
+                if (ImGui::Selectable(GetDownsampleModeName(mode), mode == downsample_mode_)) {
+                    downsample_mode_ = mode;
+                }
+            }
+            ImGui::EndCombo();
+        }
+
         ImGui::Spacing();
 
         // === Y轴自动缩放 ===
         ImGui::Checkbox("Y轴自动缩放", &auto_scale_y_);
+
+        // === 通道滤波 ===
+        ImGui::Spacing();
+        ImGui::AlignTextToFramePadding();
+        ImGui::Text("滤波器:");
+        std::string filter_label = "设置 (" + std::to_string(filter_configs_.size()) + ")";
+        if (ImGui::Button(filter_label.c_str(), ImVec2(-FLT_MIN, 0))) {
+            show_filter_window_ = !show_filter_window_;
+        }
+
+        // === 频谱图 ===
+        ImGui::Spacing();
+        ImGui::AlignTextToFramePadding();
+        ImGui::Text("频谱:");
+        if (ImGui::Button(show_spectrum_window_ ? "关闭频谱图" : "打开频谱图", ImVec2(-FLT_MIN, 0))) {
+            show_spectrum_window_ = !show_spectrum_window_;
+        }
+    }
+
+    /**
+     * @brief 渲染频谱图窗口
+     *
+     * 频谱组件（及其FFT工作线程）在第一次打开时创建，之后保留设置
+     */
+    void RenderSpectrumWindow() {
+        if (!spectrum_widget_) {
+            spectrum_widget_ = std::make_unique<SpectrumWidget>("频谱图");
+        }
+
+        ImGui::SetNextWindowSize(ImVec2(640, 420), ImGuiCond_FirstUseEver);
+        if (!ImGui::Begin("频谱图", &show_spectrum_window_)) {
+            ImGui::End();
+            return;
+        }
+        if (ImGui::CollapsingHeader("频谱设置")) {
+            spectrum_widget_->RenderConfig();
+            ImGui::Separator();
+        }
+        spectrum_widget_->RenderSpectrum(channel_manager_);
+        ImGui::End();
+    }
+
+    /**
+     * @brief 渲染滤波器设置窗口
+     *
+     * 配置在UI副本上编辑，修改后调用ApplyFilters()加解析锁写入滤波阶段
+     */
+    void RenderFilterWindow() {
+        ImGui::SetNextWindowSize(ImVec2(420, 360), ImGuiCond_FirstUseEver);
+        if (!ImGui::Begin("通道滤波", &show_filter_window_)) {
+            ImGui::End();
+            return;
+        }
+
+        // 设计采样率（用户设置并随配置保存）；测得的接收帧率只作为建议值
+        float design_rate = static_cast<float>(filter_sample_rate_);
+        ImGui::SetNextItemWidth(150);
+        if (ImGui::InputFloat("设计采样率(Hz)", &design_rate, 0.0f, 0.0f, "%.1f")) {
+            SetFilterSampleRate(design_rate);
+        }
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("截止/陷波频率按此采样率设计，不随测得的接收帧率变化");
+        }
+        double measured_rate = channel_manager_.GetSnapshot().frame_rate;
+        if (measured_rate > 0.0) {
+            ImGui::Text("测得接收帧率: %.1f Hz", measured_rate);
+            ImGui::SameLine();
+            if (ImGui::SmallButton("采用测得值")) {
+                SetFilterSampleRate(measured_rate);
+            }
+        }
+        if (filter_sample_rate_ <= 0.0) {
+            ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "未设置采样率：低通/高通/陷波/FIR低通暂为直通");
+        }
+
+        if (!filter_configs_.empty()) {
+            ImGui::Text("滤波开销: %.1f ns/样本", filter_stage_.GetCostPerSample());
+        }
+        ImGui::Separator();
+
+        // 滤波器列表（第i个输出到通道 通道数 + i）
+        const FilterType types[] = {FilterType::LOWPASS, FilterType::HIGHPASS, FilterType::NOTCH,
+                                    FilterType::MOVING_AVERAGE, FilterType::FIR_LOWPASS};
+        bool changed = false;
+        int remove_index = -1;
+        for (size_t i = 0; i < filter_configs_.size(); i++) {
+            FilterConfig& config = filter_configs_[i];
+            ImGui::PushID(static_cast<int>(i));
+
+            ImGui::Text("I%zu ->", config.source_channel);
+            ImGui::SameLine();
+            ImGui::TextColored(ImVec4(0.30f, 0.70f, 1.00f, 1.0f), "I%zu", channel_count_ + i);
+            ImGui::SameLine();
+            if (ImGui::SmallButton("删除")) {
+                remove_index = static_cast<int>(i);
+            }
+
+            int source = static_cast<int>(config.source_channel);
+            ImGui::SetNextItemWidth(100);
+            if (ImGui::InputInt("输入通道", &source, 1, 1)) {
+                config.source_channel = static_cast<size_t>(std::min(std::max(source, 0), channel_count_ - 1));
+                changed = true;
+            }
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(110);
+            if (ImGui::BeginCombo("类型", GetFilterTypeName(config.type))) {
+                for (FilterType type : types) {
+                    if (ImGui::Selectable(GetFilterTypeName(type), type == config.type)) {
+                        config.type = type;
+                        changed = true;
+                    }
+                }
+                ImGui::EndCombo();
+            }
+
+            if (config.type != FilterType::MOVING_AVERAGE) {
+                float frequency = static_cast<float>(config.frequency);
+                ImGui::SetNextItemWidth(100);
+                if (ImGui::InputFloat(config.type == FilterType::NOTCH ? "中心频率(Hz)" : "截止频率(Hz)",
+                                      &frequency, 0.0f, 0.0f, "%.2f", ImGuiInputTextFlags_EnterReturnsTrue)) {
+                    config.frequency = frequency;
+                    changed = true;
+                }
+                ImGui::SameLine();
+            }
+            ImGui::SetNextItemWidth(100);
+            switch (config.type) {
+                case FilterType::LOWPASS:
+                case FilterType::HIGHPASS:
+                    if (ImGui::SliderInt("阶数", &config.order, 2, FilterConfig::MAX_ORDER)) {
+                        config.order = config.order / 2 * 2;
+                        changed = true;
+                    }
+                    break;
+                case FilterType::NOTCH: {
+                    float q = static_cast<float>(config.q);
+                    if (ImGui::InputFloat("Q值", &q, 0.0f, 0.0f, "%.1f", ImGuiInputTextFlags_EnterReturnsTrue)) {
+                        config.q = q;
+                        changed = true;
+                    }
+                    break;
+                }
+                default:
+                    if (ImGui::SliderInt("抽头数", &config.taps, 1, FilterConfig::MAX_TAPS)) {
+                        changed = true;
+                    }
+                    break;
+            }
+
+            ImGui::Separator();
+            ImGui::PopID();
+        }
+
+        if (remove_index >= 0) {
+            filter_configs_.erase(filter_configs_.begin() + remove_index);
+            changed = true;
+        }
+
+        size_t max_filters = std::min(FilterStage::MAX_FILTERS,
+                                      DataChannelManager::MAX_CHANNELS - static_cast<size_t>(channel_count_));
+        if (filter_configs_.size() < max_filters && ImGui::Button("添加滤波器")) {
+            FilterConfig config;
+            config.source_channel = filter_configs_.empty() ? 0 : filter_configs_.back().source_channel;
+            filter_configs_.push_back(config);
+            changed = true;
+        }
+
+        if (changed) {
+            ApplyFilters();
+        }
+        ImGui::End();
+    }
+
+    /**
+     * @brief 把滤波器配置写入滤波阶段，并同步通道布局（仅UI线程）
+     *
+     * 滤波输出通道为 通道数 ~ 通道数+滤波器数-1；配置改变的（或因通道数变化而移动的）
+     * 输出通道清空历史并重新命名为“输入通道名·类型”
+     */
+    void ApplyFilters() {
+        const size_t base = static_cast<size_t>(channel_count_);
+        size_t max_filters = std::min(FilterStage::MAX_FILTERS, DataChannelManager::MAX_CHANNELS - base);
+        if (filter_configs_.size() > max_filters) {
+            filter_configs_.resize(max_filters);
+        }
+        for (FilterConfig& config : filter_configs_) {
+            config.Clamp();
+        }
+
+        bool layout_changed;
+        size_t previous_base;
+        {
+            std::lock_guard<std::mutex> lock(parser_mutex_);
+            previous_base = filter_base_;
+            layout_changed = (base != filter_base_);
+            filter_base_ = base;
+            filter_stage_.SetFilters(filter_configs_);
+            filter_buffer_.resize(BATCH_MAX_FRAMES * (base + filter_configs_.size()));
+            if (layout_changed) {
+                filter_stage_.Reset();
+            }
+        }
+
+        channel_manager_.SetChannelCount(base + filter_configs_.size());
+
+        // 不再是滤波输出的旧输出通道（通道数变化或滤波器减少）：恢复默认名称并清空滤波历史
+        for (size_t channel = previous_base; channel < previous_base + applied_filters_.size(); channel++) {
+            if (channel < base || channel >= base + filter_configs_.size()) {
+                channel_manager_.ResetChannel(channel);
+            }
+        }
+
+        for (size_t i = 0; i < filter_configs_.size(); i++) {
+            const FilterConfig& config = filter_configs_[i];
+            if (!layout_changed && i < applied_filters_.size() && applied_filters_[i] == config) {
+                continue;
+            }
+            ChannelConfig channel = channel_manager_.GetChannelConfig(base + i);
+            channel.name = channel_manager_.GetChannelConfig(config.source_channel).name + "·" +
+                           GetFilterTypeName(config.type);
+            channel_manager_.SetChannelConfig(base + i, channel);
+            channel_manager_.ClearChannel(base + i);
+        }
+        applied_filters_ = filter_configs_;
+    }
+
+    /**
+     * @brief 渲染自定义协议的帧校验配置
+     *
+     * 配置在锁外编辑，修改后再加解析锁写回，避免UI渲染阻塞解析阶段
+     */
+    void RenderChecksumConfig() {
+        CustomProtocolConfig config;
+        {
+            std::lock_guard<std::mutex> lock(parser_mutex_);
+            CustomParser* custom = dynamic_cast<CustomParser*>(protocol_parser_.get());
+            if (!custom) return;
+            config = custom->GetConfig();
+        }
+
+        bool changed = false;
+        ImGui::Spacing();
+        ImGui::AlignTextToFramePadding();
+        ImGui::Text("帧校验:");
+        ImGui::SetNextItemWidth(-FLT_MIN);
+        const char* checksum_types[] = {"无", "SUM8", "XOR8", "CRC8", "CRC16-MODBUS", "CRC16-CCITT", "CRC32"};
+        int type = config.use_checksum ? static_cast<int>(config.checksum_type) : 0;
+        if (ImGui::Combo("##checksum", &type, checksum_types, IM_ARRAYSIZE(checksum_types))) {
+            config.use_checksum = (type != 0);
+            if (type != 0) {
+                config.checksum_type = static_cast<ChecksumType>(type);
+            }
+            changed = true;
+        }
+
+        if (config.use_checksum) {
+            ImGui::AlignTextToFramePadding();
+            ImGui::Text("校验位置:");
+            ImGui::SetNextItemWidth(-FLT_MIN);
+            const char* positions[] = {"帧尾之前", "帧尾之后"};
+            int position = static_cast<int>(config.checksum_position);
+            if (ImGui::Combo("##checksum_pos", &position, positions, IM_ARRAYSIZE(positions))) {
+                config.checksum_position = static_cast<ChecksumPosition>(position);
+                changed = true;
+            }
+
+            // 校验范围起始（0表示从帧头开始，帧头长度表示只校验数据）
+            ImGui::AlignTextToFramePadding();
+            ImGui::Text("校验起始字节:");
+            ImGui::SetNextItemWidth(-FLT_MIN);
+            int range_start = static_cast<int>(config.checksum_range_start);
+            if (ImGui::InputInt("##checksum_start", &range_start, 1, 1)) {
+                if (range_start < 0) range_start = 0;
+                config.checksum_range_start = static_cast<size_t>(range_start);
+                changed = true;
+            }
+
+            // 校验范围结束（不含，0表示到校验字段之前；超出校验字段时按校验字段截断）
+            ImGui::AlignTextToFramePadding();
+            ImGui::Text("校验结束字节:");
+            ImGui::SetNextItemWidth(-FLT_MIN);
+            int range_end = static_cast<int>(config.checksum_range_end);
+            if (ImGui::InputInt("##checksum_end", &range_end, 1, 1)) {
+                if (range_end < 0) range_end = 0;
+                config.checksum_range_end = static_cast<size_t>(range_end);
+                changed = true;
+            }
+            if (ImGui::IsItemHovered()) {
+                ImGui::SetTooltip("相对帧头首字节的偏移（不含该字节）\n0 = 到校验字段之前");
+            }
+
+            if (ImGui::Checkbox("校验值高字节在前", &config.checksum_big_endian)) {
+                changed = true;
+            }
+        }
+
+        if (changed) {
+            {
+                std::lock_guard<std::mutex> lock(parser_mutex_);
+                CustomParser* custom = dynamic_cast<CustomParser*>(protocol_parser_.get());
+                if (custom) {
+                    custom->SetConfig(config);
+                }
+            }
+            custom_config_ = config;
+            detector_.SetCustomConfig(config);
+        }
+    }
+
+    /**
+     * @brief 处理后台识别结果（每帧调用，仅UI线程）
+     *
+     * - 自动识别开启时，本次连接第一个可信结果直接应用
+     * - 之后连续MISMATCH_CONFIRM次识别结果与当前配置不同，提示不匹配
+     */
+    void UpdateAutoDetection() {
+        DetectionResult result;
+        if (!detector_.GetResult(result) || result.generation == handled_generation_) {
+            return;
+        }
+        handled_generation_ = result.generation;
+        if (!result.confident) {
+            return;
+        }
+
+        if (auto_detect_ && !auto_applied_) {
+            SetProtocolType(result.type);
+            SetChannelCount(static_cast<int>(result.channels));
+            auto_applied_ = true;
+        }
+
+        bool matches = result.type == current_protocol_type_ &&
+                       static_cast<int>(result.channels) == channel_count_;
+        mismatch_count_ = matches ? 0 : mismatch_count_ + 1;
+        detected_ = result;
+    }
+
+    /**
+     * @brief 显示识别结果与当前配置不匹配的提示
+     */
+    void RenderDetectionStatus() {
+        if (mismatch_count_ < MISMATCH_CONFIRM) {
+            return;
+        }
+
+        std::string name = GetProtocolName(detected_.type);
+        ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "疑似 %s", name.c_str());
+        if (ImGui::IsItemHovered()) {
+            ImGui::BeginTooltip();
+            ImGui::Text("接收数据更像 %s 协议（%zu通道），与当前配置不一致", name.c_str(), detected_.channels);
+            ImGui::Text("匹配度: %.0f%%", detected_.confidence * 100.0f);
+            ImGui::EndTooltip();
+        }
+        if (ImGui::Button("切换", ImVec2(-FLT_MIN, 0))) {
+            SetProtocolType(detected_.type);
+            SetChannelCount(static_cast<int>(detected_.channels));
+            mismatch_count_ = 0;
+        }
     }
 
     /**
@@ -193,28 +686,45 @@ private:
         ImVec2 plot_size = ImGui::GetContentRegionAvail();
 
         if (ImPlot::BeginPlot("##MainPlot", plot_size, ImPlotFlags_NoTitle)) {
+            // X轴显示最近x_axis_range_秒（数据不足时从0开始）
+            const ChannelSnapshot& snapshot = channel_manager_.GetSnapshot();
+            double latest = snapshot.timestamps.empty() ? 0.0 : snapshot.timestamps.back();
+            double x_max = std::max(latest, static_cast<double>(x_axis_range_));
             ImPlot::SetupAxes("时间 (s)", "数值", ImPlotAxisFlags_None, ImPlotAxisFlags_None);
-            ImPlot::SetupAxisLimits(ImAxis_X1, 0, x_axis_range_, ImGuiCond_Always);
+            ImPlot::SetupAxisLimits(ImAxis_X1, x_max - x_axis_range_, x_max, ImGuiCond_Always);
 
             if (auto_scale_y_) {
                 ImPlot::SetupAxisLimits(ImAxis_Y1, -5, 5, ImGuiCond_Once);
             }
 
-            // 绘制所有启用的通道
-            for (size_t i = 0; i < DataChannelManager::MAX_CHANNELS; i++) {
-                if (!channel_manager_.IsChannelEnabled(i)) continue;
-
-                ChannelConfig config = channel_manager_.GetChannelConfig(i);
-                std::vector<double> timestamps;
-                std::vector<float> y_values_float;
-                size_t point_count = channel_manager_.GetChannelData(i, timestamps, y_values_float, 2000);
-
-                if (point_count > 0) {
-                    std::vector<double> y_values(y_values_float.begin(), y_values_float.end());
+            // 请求下一次发布的波形：所有启用的通道，跟随最新的x_axis_range_秒，每个像素列一段
+            // （降采样由快照发布者完成，绘制只读快照，不加锁）
+            if (!waveform_) {
+                waveform_ = channel_manager_.AddWaveform();
+            }
+            waveform_request_.channels.clear();
+            for (size_t i = 0; i < snapshot.channels.size(); i++) {
+                if (snapshot.channels[i].config.enabled) {
+                    waveform_request_.channels.push_back(i);
+                }
+            }
+            waveform_request_.mode = downsample_mode_;
+            waveform_request_.max_buckets = static_cast<size_t>(std::max(ImPlot::GetPlotSize().x, 1.0f));
+            waveform_request_.follow = true;
+            waveform_request_.span = x_axis_range_;
+            channel_manager_.RequestWaveform(*waveform_, waveform_request_);
+
+            // 绘制本帧快照中的波形
+            for (size_t i = 0; i < snapshot.channels.size(); i++) {
+                const ChannelConfig& config = snapshot.channels[i].config;
+                if (!config.enabled) continue;
+
+                const WaveformSeries* series = snapshot.FindWaveform(waveform_->id, i);
+                if (series && !series->values.empty()) {
                     ImVec4 color(config.color[0], config.color[1], config.color[2], config.color[3]);
                     ImPlot::SetNextLineStyle(color, 2.0f); // 线条稍粗
-                    ImPlot::PlotLine(config.name.c_str(), timestamps.data(), y_values.data(),
-                                    static_cast<int>(point_count));
+                    PlotSeriesLine(config.name.c_str(), series->timestamps.data(),
+                                   series->values.data(), static_cast<int>(series->values.size()));
                 }
             }
 
@@ -240,48 +750,63 @@ private:
         ImGui::Text("数值"); ImGui::NextColumn();
         ImGui::Separator();
 
-        // 通道列表
-        for (size_t i = 0; i < DataChannelManager::MAX_CHANNELS; i++) {
-            ImGui::PushID(static_cast<int>(i));
-
-            ChannelConfig config = channel_manager_.GetChannelConfig(i);
-            ChannelStats stats = channel_manager_.GetChannelStats(i);
-
-            // 眼睛图标按钮（可见性开关）
-            bool enabled = config.enabled;
-            const char* icon = enabled ? "●" : "○";  // 实心圆=可见，空心圆=隐藏
-            ImVec4 button_color = enabled
-                ? ImVec4(0.30f, 0.70f, 1.00f, 1.00f)   // 蓝色（开启）
-                : ImVec4(0.50f, 0.50f, 0.50f, 0.50f);  // 灰色（关闭）
+        // 通道列表（只提交可见的行，通道数很多时开销与列表高度成正比）
+        const ChannelSnapshot& snapshot = channel_manager_.GetSnapshot();
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(snapshot.channels.size()));
+        while (clipper.Step()) {
+            for (size_t i = static_cast<size_t>(clipper.DisplayStart); i < static_cast<size_t>(clipper.DisplayEnd); i++) {
+                ImGui::PushID(static_cast<int>(i));
+
+                const ChannelConfig& config = snapshot.channels[i].config;
+                const ChannelStats& stats = snapshot.channels[i].stats;
+
+                // 眼睛图标按钮（可见性开关）
+                bool enabled = config.enabled;
+                const char* icon = enabled ? "●" : "○";  // 实心圆=可见，空心圆=隐藏
+                ImVec4 button_color = enabled
+                    ? ImVec4(0.30f, 0.70f, 1.00f, 1.00f)   // 蓝色（开启）
+                    : ImVec4(0.50f, 0.50f, 0.50f, 0.50f);  // 灰色（关闭）
+
+                ImGui::PushStyleColor(ImGuiCol_Button, button_color);
+                ImGui::PushStyleColor(ImGuiCol_ButtonHovered,
+                    ImVec4(button_color.x * 1.2f, button_color.y * 1.2f, button_color.z * 1.2f, 1.0f));
+                ImGui::PushStyleColor(ImGuiCol_ButtonActive,
+                    ImVec4(button_color.x * 0.8f, button_color.y * 0.8f, button_color.z * 0.8f, 1.0f));
+
+                if (ImGui::Button(icon, ImVec2(20, 20))) {
+                    channel_manager_.SetChannelEnabled(i, !enabled);
+                }
 
-            ImGui::PushStyleColor(ImGuiCol_Button, button_color);
-            ImGui::PushStyleColor(ImGuiCol_ButtonHovered,
-                ImVec4(button_color.x * 1.2f, button_color.y * 1.2f, button_color.z * 1.2f, 1.0f));
-            ImGui::PushStyleColor(ImGuiCol_ButtonActive,
-                ImVec4(button_color.x * 0.8f, button_color.y * 0.8f, button_color.z * 0.8f, 1.0f));
+                ImGui::PopStyleColor(3);
+                ImGui::NextColumn();
+
+                // 通道名（带颜色指示器）
+                ImGui::ColorButton("##colorind", ImVec4(config.color[0], config.color[1],
+                                                         config.color[2], config.color[3]),
+                                  ImGuiColorEditFlags_NoTooltip | ImGuiColorEditFlags_NoPicker,
+                                  ImVec2(10, 10));
+                ImGui::SameLine();
+                ImGui::Text("I%zu", i);
+                ImGui::NextColumn();
+
+                // 当前值（带颜色高亮）
+                ImVec4 value_color = enabled ? ImVec4(1, 1, 1, 1) : ImVec4(0.5f, 0.5f, 0.5f, 1);
+                ImGui::TextColored(value_color, "%.3f", stats.last_value);
+                // 悬停显示统计和分位数
+                if (stats.sample_count > 0 && ImGui::IsItemHovered()) {
+                    ImGui::BeginTooltip();
+                    ImGui::Text("%s  (%zu 样本)", config.name.c_str(), stats.sample_count);
+                    ImGui::Separator();
+                    ImGui::Text("Min %.3f  Max %.3f  Avg %.3f", stats.min_value, stats.max_value, stats.avg_value);
+                    ImGui::Text("P50 %.3f  P95 %.3f", stats.p50, stats.p95);
+                    ImGui::Text("P99 %.3f  P99.9 %.3f", stats.p99, stats.p999);
+                    ImGui::EndTooltip();
+                }
+                ImGui::NextColumn();
 
-            if (ImGui::Button(icon, ImVec2(20, 20))) {
-                channel_manager_.SetChannelEnabled(i, !enabled);
+                ImGui::PopID();
             }
-
-            ImGui::PopStyleColor(3);
-            ImGui::NextColumn();
-
-            // 通道名（带颜色指示器）
-            ImGui::ColorButton("##colorind", ImVec4(config.color[0], config.color[1],
-                                                     config.color[2], config.color[3]),
-                              ImGuiColorEditFlags_NoTooltip | ImGuiColorEditFlags_NoPicker,
-                              ImVec2(10, 10));
-            ImGui::SameLine();
-            ImGui::Text("I%zu", i);
-            ImGui::NextColumn();
-
-            // 当前值（带颜色高亮）
-            ImVec4 value_color = enabled ? ImVec4(1, 1, 1, 1) : ImVec4(0.5f, 0.5f, 0.5f, 1);
-            ImGui::TextColored(value_color, "%.3f", stats.last_value);
-            ImGui::NextColumn();
-
-            ImGui::PopID();
         }
 
         ImGui::Columns(1);
@@ -293,11 +818,9 @@ private:
     void RenderStatusBar() {
         // 计算总数据点数（所有启用通道）
         size_t total_points = 0;
-        for (size_t i = 0; i < DataChannelManager::MAX_CHANNELS; i++) {
-            ChannelConfig config = channel_manager_.GetChannelConfig(i);
-            if (config.enabled) {
-                ChannelStats stats = channel_manager_.GetChannelStats(i);
-                total_points += stats.sample_count;
+        for (const ChannelView& view : channel_manager_.GetSnapshot().channels) {
+            if (view.config.enabled) {
+                total_points += view.stats.sample_count;
             }
         }
 
@@ -311,10 +834,36 @@ private:
         ImGui::SameLine();
 
         // 显示当前协议
-        const char* protocol_name = GetProtocolName(current_protocol_type_).c_str();
+        std::string protocol_name = GetProtocolName(current_protocol_type_);
         ImGui::Text("协议:");
         ImGui::SameLine();
-        ImGui::TextColored(ImVec4(0.3f, 0.8f, 0.3f, 1.0f), "%s", protocol_name);
+        ImGui::TextColored(ImVec4(0.3f, 0.8f, 0.3f, 1.0f), "%s", protocol_name.c_str());
+
+        // 显示丢帧统计（帧尾错误、校验失败）
+        uint64_t tail_errors = 0;
+        uint64_t checksum_errors = 0;
+        {
+            std::lock_guard<std::mutex> lock(parser_mutex_);
+            if (protocol_parser_) {
+                tail_errors = protocol_parser_->GetRejectedFrames(ParseError::TAIL_MISMATCH);
+                checksum_errors = protocol_parser_->GetRejectedFrames(ParseError::CHECKSUM_MISMATCH);
+            }
+        }
+        if (tail_errors + checksum_errors > 0) {
+            ImGui::SameLine();
+            ImGui::Dummy(ImVec2(20, 0));
+            ImGui::SameLine();
+            ImGui::Text("丢帧:");
+            ImGui::SameLine();
+            ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.3f, 1.0f), "%llu",
+                               static_cast<unsigned long long>(tail_errors + checksum_errors));
+            if (ImGui::IsItemHovered()) {
+                ImGui::BeginTooltip();
+                ImGui::Text("帧尾错误: %llu", static_cast<unsigned long long>(tail_errors));
+                ImGui::Text("校验失败: %llu", static_cast<unsigned long long>(checksum_errors));
+                ImGui::EndTooltip();
+            }
+        }
 
         ImGui::SameLine();
         ImGui::Dummy(ImVec2(20, 0));
@@ -324,16 +873,62 @@ private:
         ImGui::Text("通道数:");
         ImGui::SameLine();
         ImGui::TextColored(ImVec4(0.8f, 0.6f, 0.3f, 1.0f), "%d", channel_count_);
+
+        ImGui::SameLine();
+        ImGui::Dummy(ImVec2(20, 0));
+        ImGui::SameLine();
+
+        // 显示历史缓冲区内存占用
+        const ChannelSnapshot& snapshot = channel_manager_.GetSnapshot();
+        ImGui::Text("内存:");
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "%.1f MB", snapshot.memory_bytes / (1024.0 * 1024.0));
+        if (ImGui::IsItemHovered()) {
+            ImGui::BeginTooltip();
+            ImGui::Text("已缓存: %zu / %zu 帧", snapshot.stored_frames, snapshot.capacity);
+            ImGui::EndTooltip();
+        }
     }
 
     DataChannelManager channel_manager_;
     std::unique_ptr<ProtocolParser> protocol_parser_;
+    std::mutex parser_mutex_;           // 解析器锁（解析阶段 vs UI切换协议）
+
+    // 批量解析输出缓冲区（帧 × 通道，构造时分配一次）
+    static constexpr size_t BATCH_MAX_FRAMES = 1024;
+    std::vector<float> batch_buffer_ = std::vector<float>(BATCH_MAX_FRAMES * DataChannelManager::MAX_CHANNELS);
+
+    // 滤波阶段（配置和Apply()都在parser_mutex_内）
+    FilterStage filter_stage_;
+    size_t filter_base_ = 4;                // 滤波输出的起始通道（= 通道数）
+    std::vector<float> filter_buffer_;      // 滤波阶段输出（帧 × (通道数 + 滤波器数)）
+    std::vector<FilterConfig> filter_configs_;  // 滤波器配置（UI副本）
+    std::vector<FilterConfig> applied_filters_; // 上次写入的配置（判断哪些输出通道需要重置）
+    double filter_sample_rate_ = 0.0;           // 滤波器设计采样率（0表示未设置）
+    bool show_filter_window_ = false;           // 显示滤波器设置窗口
+
+    // 频谱图（第一次打开时创建）
+    std::unique_ptr<SpectrumWidget> spectrum_widget_;
+    bool show_spectrum_window_ = false;         // 显示频谱图窗口
     ProtocolType current_protocol_type_;
+    CustomProtocolConfig custom_config_;    // 自定义协议配置（切换协议后保留）
+
+    // 协议自动识别（结果只在UI线程处理）
+    static constexpr int MISMATCH_CONFIRM = 2;  // 连续不匹配次数达到后提示
+    ProtocolDetector detector_;
+    DetectionResult detected_;              // 最近一次可信识别结果
+    uint64_t handled_generation_ = 0;       // 已处理的结果序号
+    bool auto_detect_ = true;               // 连接后自动识别协议
+    bool auto_applied_ = false;             // 本次连接已应用（或已手动选择）
+    int mismatch_count_ = 0;                // 连续不匹配次数
 
     bool auto_scale_y_;
     int sample_interval_ms_ = 1;
     int channel_count_ = 4;  // 默认4通道
     float x_axis_range_ = 10.0f;  // X轴显示范围（秒）
+    DownsampleMode downsample_mode_ = DownsampleMode::MINMAX;                   // 波形降采样方式
+    std::shared_ptr<WaveformState> waveform_;                                   // 主波形图的波形请求（首次绘制时登记）
+    WaveformRequest waveform_request_;                                          // 每帧提交的请求（通道列表容量复用）
 };
 
 #endif // VISUALIZATION_UI_H
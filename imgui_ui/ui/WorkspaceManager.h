@@ -20,6 +20,7 @@
 #include "../visualization/BarChartWidget.h"
 #include "../visualization/GaugeWidget.h"
 #include "../visualization/DataTableWidget.h"
+#include "../visualization/SpectrumWidget.h"
 #include <vector>
 #include <memory>
 #include <string>
@@ -61,6 +62,10 @@ public:
                 widget = std::make_unique<DataTableWidget>("Data Table " + std::to_string(next_widget_id_++));
                 break;
 
+            case WidgetType::SPECTRUM:
+                widget = std::make_unique<SpectrumWidget>("Spectrum " + std::to_string(next_widget_id_++));
+                break;
+
             default:
                 return nullptr;
         }
@@ -100,6 +105,9 @@ public:
                 }),
             widgets_.end());
 
+        // 本帧所有组件读取同一个快照
+        channel_manager.AcquireSnapshot();
+
         // 渲染所有可见组件
         for (auto& widget : widgets_) {
             if (widget->IsVisible()) {
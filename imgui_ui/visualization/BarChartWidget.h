@@ -58,26 +58,7 @@ public:
         ImGui::Separator();
         ImGui::Text("通道选择：");
 
-        // 通道选择复选框
-        for (size_t i = 0; i < DataChannelManager::MAX_CHANNELS; i++) {
-            bool selected = IsChannelSelected(i);
-            ImGui::PushID(static_cast<int>(i));
-
-            if (ImGui::Checkbox(("CH" + std::to_string(i + 1)).c_str(), &selected)) {
-                if (selected) {
-                    AddChannel(i);
-                } else {
-                    RemoveChannel(i);
-                }
-            }
-
-            ImGui::PopID();
-
-            // 每4个换行
-            if ((i + 1) % 4 != 0) {
-                ImGui::SameLine();
-            }
-        }
+        RenderChannelSelector();
     }
 
 private:
@@ -85,24 +66,28 @@ private:
      * @brief 渲染柱状图
      */
     void RenderBarChart(DataChannelManager& channel_manager) {
+        // 读取本帧快照（不加锁）
+        const ChannelSnapshot& snapshot = channel_manager.GetSnapshot();
+        available_channels_ = snapshot.channels.size();
+
         // 收集当前值
         std::vector<double> values;
         std::vector<std::string> labels;
         std::vector<ImVec4> colors;
 
         for (size_t channel_index : channels_) {
-            if (channel_index >= DataChannelManager::MAX_CHANNELS) {
+            if (channel_index >= snapshot.channels.size()) {
                 continue;
             }
 
             // 检查通道是否启用
-            if (!channel_manager.IsChannelEnabled(channel_index)) {
+            if (!snapshot.channels[channel_index].config.enabled) {
                 continue;
             }
 
             // 获取通道配置和统计
-            ChannelConfig config = channel_manager.GetChannelConfig(channel_index);
-            ChannelStats stats = channel_manager.GetChannelStats(channel_index);
+            const ChannelConfig& config = snapshot.channels[channel_index].config;
+            const ChannelStats& stats = snapshot.channels[channel_index].stats;
 
             values.push_back(stats.last_value);
             labels.push_back(config.name);
@@ -188,31 +173,6 @@ private:
         }
     }
 
-    /**
-     * @brief 判断通道是否已选择
-     */
-    bool IsChannelSelected(size_t channel_index) const {
-        return std::find(channels_.begin(), channels_.end(), channel_index) != channels_.end();
-    }
-
-    /**
-     * @brief 添加通道
-     */
-    void AddChannel(size_t channel_index) {
-        if (!IsChannelSelected(channel_index)) {
-            channels_.push_back(channel_index);
-        }
-    }
-
-    /**
-     * @brief 移除通道
-     */
-    void RemoveChannel(size_t channel_index) {
-        channels_.erase(
-            std::remove(channels_.begin(), channels_.end(), channel_index),
-            channels_.end());
-    }
-
     // 配置选项
     bool horizontal_;           // 水平方向
     bool show_values_;          // 显示数值
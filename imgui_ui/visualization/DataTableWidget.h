@@ -9,6 +9,7 @@
  * - 支持滚动查看
  * - 时间戳显示
  * - 可配置显示行数
+ * - 可选的分位数汇总（各通道P50/P95/P99/P99.9，流式估计）
  * - 支持CSV导出（预留接口）
  */
 
@@ -31,6 +32,7 @@ public:
         , show_timestamp_(true)
         , decimal_places_(3)
         , auto_scroll_(true)
+        , show_quantiles_(true)
     {
         // 默认显示前4个通道
         channels_ = {0, 1, 2, 3};
@@ -56,30 +58,12 @@ public:
         ImGui::SliderInt("小数位数", &decimal_places_, 0, 6);
         ImGui::Checkbox("显示时间戳", &show_timestamp_);
         ImGui::Checkbox("自动滚动", &auto_scroll_);
+        ImGui::Checkbox("显示分位数", &show_quantiles_);
 
         ImGui::Separator();
         ImGui::Text("通道选择：");
 
-        // 通道选择复选框
-        for (size_t i = 0; i < DataChannelManager::MAX_CHANNELS; i++) {
-            bool selected = IsChannelSelected(i);
-            ImGui::PushID(static_cast<int>(i));
-
-            if (ImGui::Checkbox(("CH" + std::to_string(i + 1)).c_str(), &selected)) {
-                if (selected) {
-                    AddChannel(i);
-                } else {
-                    RemoveChannel(i);
-                }
-            }
-
-            ImGui::PopID();
-
-            // 每4个换行
-            if ((i + 1) % 4 != 0) {
-                ImGui::SameLine();
-            }
-        }
+        RenderChannelSelector();
     }
 
 private:
@@ -87,6 +71,10 @@ private:
      * @brief 渲染数据表格
      */
     void RenderDataTable(DataChannelManager& channel_manager) {
+        // 读取本帧快照（不加锁）
+        const ChannelSnapshot& snapshot = channel_manager.GetSnapshot();
+        available_channels_ = snapshot.channels.size();
+
         // 收集所有通道的数据
         std::vector<std::vector<double>> timestamps_list;
         std::vector<std::vector<float>> values_list;
@@ -95,20 +83,23 @@ private:
         size_t min_data_points = SIZE_MAX;
 
         for (size_t channel_index : channels_) {
-            if (channel_index >= DataChannelManager::MAX_CHANNELS) {
+            if (channel_index >= snapshot.channels.size()) {
                 continue;
             }
 
-            if (!channel_manager.IsChannelEnabled(channel_index)) {
+            if (!snapshot.channels[channel_index].config.enabled) {
                 continue;
             }
 
-            ChannelConfig config = channel_manager.GetChannelConfig(channel_index);
+            // 快照只拷贝请求过的通道数值：续期最近max_rows_帧
+            channel_manager.RequestSnapshotValues(channel_index, static_cast<size_t>(max_rows_));
+
+            const ChannelConfig& config = snapshot.channels[channel_index].config;
             channel_names.push_back(config.name);
 
             std::vector<double> timestamps;
             std::vector<float> values;
-            size_t count = channel_manager.GetChannelData(
+            size_t count = snapshot.GetChannelData(
                 channel_index, timestamps, values, max_rows_);
 
             timestamps_list.push_back(timestamps);
@@ -124,6 +115,11 @@ private:
             return;
         }
 
+        // 分位数汇总（自清空以来的全部样本）
+        if (show_quantiles_) {
+            RenderQuantileSummary(snapshot);
+        }
+
         // 创建表格
         int num_columns = static_cast<int>(channel_names.size()) + (show_timestamp_ ? 1 : 0);
 
@@ -185,6 +181,48 @@ private:
         }
     }
 
+    /**
+     * @brief 渲染各通道的分位数汇总（每个选中的启用通道一行）
+     */
+    void RenderQuantileSummary(const ChannelSnapshot& snapshot) {
+        ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchSame;
+        if (ImGui::BeginTable("QuantileTable", 6, flags)) {
+            ImGui::TableSetupColumn("通道");
+            ImGui::TableSetupColumn("P50");
+            ImGui::TableSetupColumn("P95");
+            ImGui::TableSetupColumn("P99");
+            ImGui::TableSetupColumn("P99.9");
+            ImGui::TableSetupColumn("样本数");
+            ImGui::TableHeadersRow();
+
+            for (size_t channel_index : channels_) {
+                if (channel_index >= snapshot.channels.size() ||
+                    !snapshot.channels[channel_index].config.enabled) {
+                    continue;
+                }
+                const ChannelConfig& config = snapshot.channels[channel_index].config;
+                const ChannelStats& stats = snapshot.channels[channel_index].stats;
+                const float quantiles[] = {stats.p50, stats.p95, stats.p99, stats.p999};
+
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                ImGui::Text("%s", config.name.c_str());
+                for (int q = 0; q < 4; q++) {
+                    ImGui::TableSetColumnIndex(q + 1);
+                    if (stats.sample_count > 0) {
+                        ImGui::Text("%.*f", decimal_places_, quantiles[q]);
+                    } else {
+                        ImGui::TextDisabled("-");
+                    }
+                }
+                ImGui::TableSetColumnIndex(5);
+                ImGui::Text("%zu", stats.sample_count);
+            }
+            ImGui::EndTable();
+        }
+        ImGui::Spacing();
+    }
+
     /**
      * @brief 导出数据到CSV文件
      */
@@ -243,36 +281,12 @@ private:
         // TODO: 显示成功消息，可以使用ImGui::OpenPopup
     }
 
-    /**
-     * @brief 判断通道是否已选择
-     */
-    bool IsChannelSelected(size_t channel_index) const {
-        return std::find(channels_.begin(), channels_.end(), channel_index) != channels_.end();
-    }
-
-    /**
-     * @brief 添加通道
-     */
-    void AddChannel(size_t channel_index) {
-        if (!IsChannelSelected(channel_index)) {
-            channels_.push_back(channel_index);
-        }
-    }
-
-    /**
-     * @brief 移除通道
-     */
-    void RemoveChannel(size_t channel_index) {
-        channels_.erase(
-            std::remove(channels_.begin(), channels_.end(), channel_index),
-            channels_.end());
-    }
-
     // 配置选项
     int max_rows_;              // 最大显示行数
     bool show_timestamp_;       // 显示时间戳
     int decimal_places_;        // 小数位数
     bool auto_scroll_;          // 自动滚动
+    bool show_quantiles_;       // 显示分位数汇总
 };
 
 #endif // DATA_TABLE_WIDGET_H
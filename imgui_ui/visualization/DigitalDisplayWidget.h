@@ -8,7 +8,7 @@
  * - 大号字体显示当前值
  * - 支持多通道网格布局
  * - 可配置小数位数和单位
- * - 显示统计信息（最小/最大/平均）
+ * - 显示统计信息（滑动窗口内的最小/最大/平均/标准差/RMS/峰峰值，或全程统计）
  * - 自动颜色映射
  */
 
@@ -28,6 +28,7 @@ public:
         : Widget(WidgetType::DIGITAL_DISPLAY, name)
         , decimal_places_(2)
         , show_stats_(true)
+        , show_window_stats_(true)
         , grid_columns_(2)
         , font_scale_(3.0f)
     {
@@ -56,6 +57,12 @@ public:
         ImGui::SliderFloat("字体缩放", &font_scale_, 1.0f, 5.0f);
         ImGui::SliderInt("网格列数", &grid_columns_, 1, 4);
         ImGui::Checkbox("显示统计信息", &show_stats_);
+        if (show_stats_) {
+            ImGui::Checkbox("窗口统计", &show_window_stats_);
+            if (ImGui::IsItemHovered()) {
+                ImGui::SetTooltip("统计最近一段样本（窗口长度在设置中修改）；关闭后显示自清空以来的全程统计");
+            }
+        }
 
         // 单位输入
         char unit_buffer[32];
@@ -68,26 +75,7 @@ public:
         ImGui::Separator();
         ImGui::Text("通道选择：");
 
-        // 通道选择复选框
-        for (size_t i = 0; i < DataChannelManager::MAX_CHANNELS; i++) {
-            bool selected = IsChannelSelected(i);
-            ImGui::PushID(static_cast<int>(i));
-
-            if (ImGui::Checkbox(("CH" + std::to_string(i + 1)).c_str(), &selected)) {
-                if (selected) {
-                    AddChannel(i);
-                } else {
-                    RemoveChannel(i);
-                }
-            }
-
-            ImGui::PopID();
-
-            // 每4个换行
-            if ((i + 1) % 4 != 0) {
-                ImGui::SameLine();
-            }
-        }
+        RenderChannelSelector();
     }
 
 private:
@@ -95,6 +83,10 @@ private:
      * @brief 渲染数字显示
      */
     void RenderDigitalDisplay(DataChannelManager& channel_manager) {
+        // 读取本帧快照（不加锁）
+        const ChannelSnapshot& snapshot = channel_manager.GetSnapshot();
+        available_channels_ = snapshot.channels.size();
+
         // 计算网格布局
         int cols = grid_columns_;
         int rows = static_cast<int>(std::ceil(static_cast<float>(channels_.size()) / cols));
@@ -108,18 +100,18 @@ private:
         for (size_t idx = 0; idx < channels_.size(); idx++) {
             size_t channel_index = channels_[idx];
 
-            if (channel_index >= DataChannelManager::MAX_CHANNELS) {
+            if (channel_index >= snapshot.channels.size()) {
                 continue;
             }
 
             // 检查通道是否启用
-            if (!channel_manager.IsChannelEnabled(channel_index)) {
+            if (!snapshot.channels[channel_index].config.enabled) {
                 continue;
             }
 
             // 获取通道配置和统计
-            ChannelConfig config = channel_manager.GetChannelConfig(channel_index);
-            ChannelStats stats = channel_manager.GetChannelStats(channel_index);
+            const ChannelConfig& config = snapshot.channels[channel_index].config;
+            const ChannelStats& stats = snapshot.channels[channel_index].stats;
 
             // 计算网格位置
             int col = static_cast<int>(idx % cols);
@@ -166,10 +158,21 @@ private:
             // 统计信息
             if (show_stats_ && stats.sample_count > 0) {
                 ImGui::Separator();
-                ImGui::Text("Min: %.*f", decimal_places_, stats.min_value);
-                ImGui::Text("Max: %.*f", decimal_places_, stats.max_value);
-                ImGui::Text("Avg: %.*f", decimal_places_, stats.avg_value);
-                ImGui::Text("Samples: %zu", stats.sample_count);
+                if (show_window_stats_) {
+                    ImGui::Text("Min: %.*f", decimal_places_, stats.window_min);
+                    ImGui::Text("Max: %.*f", decimal_places_, stats.window_max);
+                    ImGui::Text("Avg: %.*f", decimal_places_, stats.window_mean);
+                    ImGui::Text("Std: %.*f", decimal_places_, stats.window_std);
+                    ImGui::Text("RMS: %.*f", decimal_places_, stats.window_rms);
+                    ImGui::Text("P-P: %.*f", decimal_places_, stats.PeakToPeak());
+                    ImGui::Text("Window: %zu", stats.window_count);
+                } else {
+                    ImGui::Text("Min: %.*f", decimal_places_, stats.min_value);
+                    ImGui::Text("Max: %.*f", decimal_places_, stats.max_value);
+                    ImGui::Text("Avg: %.*f", decimal_places_, stats.avg_value);
+                    ImGui::Text("Std: %.*f", decimal_places_, stats.std_dev);
+                    ImGui::Text("Samples: %zu", stats.sample_count);
+                }
             }
 
             ImGui::EndChild();
@@ -178,34 +181,10 @@ private:
         ImGui::EndChild();
     }
 
-    /**
-     * @brief 判断通道是否已选择
-     */
-    bool IsChannelSelected(size_t channel_index) const {
-        return std::find(channels_.begin(), channels_.end(), channel_index) != channels_.end();
-    }
-
-    /**
-     * @brief 添加通道
-     */
-    void AddChannel(size_t channel_index) {
-        if (!IsChannelSelected(channel_index)) {
-            channels_.push_back(channel_index);
-        }
-    }
-
-    /**
-     * @brief 移除通道
-     */
-    void RemoveChannel(size_t channel_index) {
-        channels_.erase(
-            std::remove(channels_.begin(), channels_.end(), channel_index),
-            channels_.end());
-    }
-
     // 配置选项
     int decimal_places_;        // 小数位数
     bool show_stats_;           // 显示统计信息
+    bool show_window_stats_;    // 显示窗口统计（否则显示全程统计）
     int grid_columns_;          // 网格列数
     float font_scale_;          // 字体缩放
     std::string unit_;          // 单位
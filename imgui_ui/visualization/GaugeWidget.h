@@ -10,6 +10,7 @@
  * - 可配置范围和颜色区间
  * - 刻度线和数值标签
  * - 支持多通道网格布局
+ * - 外圈标出滑动窗口内的最小~最大范围，下方显示峰峰值和RMS
  */
 
 #ifndef GAUGE_WIDGET_H
@@ -34,6 +35,7 @@ public:
         , grid_columns_(2)
         , show_value_text_(true)
         , show_ticks_(true)
+        , show_window_range_(true)
     {
         // 默认显示通道0
         channels_ = {0};
@@ -60,30 +62,12 @@ public:
         ImGui::SliderInt("网格列数", &grid_columns_, 1, 4);
         ImGui::Checkbox("显示数值", &show_value_text_);
         ImGui::Checkbox("显示刻度", &show_ticks_);
+        ImGui::Checkbox("显示窗口范围", &show_window_range_);
 
         ImGui::Separator();
         ImGui::Text("通道选择：");
 
-        // 通道选择复选框
-        for (size_t i = 0; i < DataChannelManager::MAX_CHANNELS; i++) {
-            bool selected = IsChannelSelected(i);
-            ImGui::PushID(static_cast<int>(i));
-
-            if (ImGui::Checkbox(("CH" + std::to_string(i + 1)).c_str(), &selected)) {
-                if (selected) {
-                    AddChannel(i);
-                } else {
-                    RemoveChannel(i);
-                }
-            }
-
-            ImGui::PopID();
-
-            // 每4个换行
-            if ((i + 1) % 4 != 0) {
-                ImGui::SameLine();
-            }
-        }
+        RenderChannelSelector();
     }
 
 private:
@@ -91,6 +75,10 @@ private:
      * @brief 渲染所有仪表盘
      */
     void RenderGauges(DataChannelManager& channel_manager) {
+        // 读取本帧快照（不加锁）
+        const ChannelSnapshot& snapshot = channel_manager.GetSnapshot();
+        available_channels_ = snapshot.channels.size();
+
         // 计算网格布局
         int cols = grid_columns_;
         int rows = static_cast<int>(std::ceil(static_cast<float>(channels_.size()) / cols));
@@ -104,18 +92,18 @@ private:
         for (size_t idx = 0; idx < channels_.size(); idx++) {
             size_t channel_index = channels_[idx];
 
-            if (channel_index >= DataChannelManager::MAX_CHANNELS) {
+            if (channel_index >= snapshot.channels.size()) {
                 continue;
             }
 
             // 检查通道是否启用
-            if (!channel_manager.IsChannelEnabled(channel_index)) {
+            if (!snapshot.channels[channel_index].config.enabled) {
                 continue;
             }
 
             // 获取通道配置和统计
-            ChannelConfig config = channel_manager.GetChannelConfig(channel_index);
-            ChannelStats stats = channel_manager.GetChannelStats(channel_index);
+            const ChannelConfig& config = snapshot.channels[channel_index].config;
+            const ChannelStats& stats = snapshot.channels[channel_index].stats;
 
             // 计算网格位置
             int col = static_cast<int>(idx % cols);
@@ -138,7 +126,7 @@ private:
             );
 
             // 绘制仪表盘
-            DrawGauge(config, stats.last_value);
+            DrawGauge(config, stats);
 
             ImGui::EndChild();
         }
@@ -149,7 +137,8 @@ private:
     /**
      * @brief 绘制单个仪表盘
      */
-    void DrawGauge(const ChannelConfig& config, float value) {
+    void DrawGauge(const ChannelConfig& config, const ChannelStats& stats) {
+        const float value = stats.last_value;
         ImVec2 canvas_size = ImGui::GetContentRegionAvail();
         ImVec2 canvas_pos = ImGui::GetCursorScreenPos();
 
@@ -209,6 +198,19 @@ private:
             }
         }
 
+        // 窗口内最小~最大范围（外圈细弧）
+        if (show_window_range_ && stats.window_count > 0) {
+            float low = std::max(0.0f, std::min(1.0f, (stats.window_min - min_value_) / (max_value_ - min_value_)));
+            float high = std::max(0.0f, std::min(1.0f, (stats.window_max - min_value_) / (max_value_ - min_value_)));
+            float a1 = start_angle + (end_angle - start_angle) * low;
+            float a2 = start_angle + (end_angle - start_angle) * high;
+            int range_segments = std::max(1, static_cast<int>(64 * (high - low)));
+            draw_list->PathArcTo(center, radius + 4.0f, a1, a2, range_segments);
+            ImU32 range_color = ImGui::ColorConvertFloat4ToU32(
+                ImVec4(config.color[0], config.color[1], config.color[2], 0.8f));
+            draw_list->PathStroke(range_color, 0, 3.0f);
+        }
+
         // 绘制指针
         float needle_length = radius * 0.7f;
         ImVec2 needle_end(center.x + std::cos(value_angle) * needle_length,
@@ -227,6 +229,15 @@ private:
             draw_list->AddText(text_pos, IM_COL32(255, 255, 255, 255), value_text);
         }
 
+        // 窗口峰峰值和RMS
+        if (show_window_range_ && stats.window_count > 0) {
+            char range_text[64];
+            snprintf(range_text, sizeof(range_text), "P-P %.2f  RMS %.2f", stats.PeakToPeak(), stats.window_rms);
+            ImVec2 range_size = ImGui::CalcTextSize(range_text);
+            ImVec2 range_pos(center.x - range_size.x * 0.5f, center.y + radius * 0.4f + range_size.y + 2.0f);
+            draw_list->AddText(range_pos, IM_COL32(180, 180, 180, 255), range_text);
+        }
+
         // 显示范围文本
         char min_text[32], max_text[32];
         snprintf(min_text, sizeof(min_text), "%.0f", min_value_);
@@ -244,37 +255,13 @@ private:
         draw_list->AddText(max_text_pos, IM_COL32(150, 150, 150, 255), max_text);
     }
 
-    /**
-     * @brief 判断通道是否已选择
-     */
-    bool IsChannelSelected(size_t channel_index) const {
-        return std::find(channels_.begin(), channels_.end(), channel_index) != channels_.end();
-    }
-
-    /**
-     * @brief 添加通道
-     */
-    void AddChannel(size_t channel_index) {
-        if (!IsChannelSelected(channel_index)) {
-            channels_.push_back(channel_index);
-        }
-    }
-
-    /**
-     * @brief 移除通道
-     */
-    void RemoveChannel(size_t channel_index) {
-        channels_.erase(
-            std::remove(channels_.begin(), channels_.end(), channel_index),
-            channels_.end());
-    }
-
     // 配置选项
     float min_value_;           // 最小值
     float max_value_;           // 最大值
     int grid_columns_;          // 网格列数
     bool show_value_text_;      // 显示数值
     bool show_ticks_;           // 显示刻度
+    bool show_window_range_;    // 显示窗口范围（最小~最大、峰峰值、RMS）
 };
 
 #endif // GAUGE_WIDGET_H
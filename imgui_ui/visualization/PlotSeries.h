@@ -0,0 +1,38 @@
+/**
+ * @file PlotSeries.h
+ * @brief ImPlot取点适配器 - 直接从double时间戳和float数值数组绘制折线
+ * @author AI Assistant
+ * @date 2025
+ *
+ * ImPlot::PlotLine要求X、Y为同一类型，原先每帧要把float数值再拷贝成
+ * 一个std::vector<double>。改用PlotLineG的取点回调后，ImPlot逐点读取
+ * 原数组并在回调中转换，不再分配和拷贝。
+ */
+
+#ifndef PLOT_SERIES_H
+#define PLOT_SERIES_H
+
+#include <implot.h>
+
+/**
+ * @brief 一条折线的数据（只引用，不持有）
+ */
+struct PlotSeries {
+    const double* x;    // 时间戳
+    const float* y;     // 数值
+
+    static ImPlotPoint Getter(int index, void* data) {
+        const PlotSeries* series = static_cast<const PlotSeries*>(data);
+        return ImPlotPoint(series->x[index], static_cast<double>(series->y[index]));
+    }
+};
+
+/**
+ * @brief 绘制折线（X为double、Y为float，不做类型转换拷贝）
+ */
+inline void PlotSeriesLine(const char* label, const double* x, const float* y, int count) {
+    PlotSeries series{x, y};
+    ImPlot::PlotLineG(label, &PlotSeries::Getter, &series, count);
+}
+
+#endif // PLOT_SERIES_H
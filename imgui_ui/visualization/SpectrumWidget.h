@@ -0,0 +1,271 @@
+/**
+ * @file SpectrumWidget.h
+ * @brief 频谱图组件 - 实时显示所选通道的FFT幅度谱
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 特性：
+ * - 对最近N个样本做加窗FFT（矩形/Hann/Blackman窗），Welch平均降低噪声方差
+ * - FFT在组件自己的工作线程中计算，UI线程只拷贝样本和绘制结果，不阻塞渲染
+ * - 频率轴按采样率换算（Hz）：默认使用DataChannelManager测得的接收帧率
+ *   （最近几秒每秒写入的帧数）；设备按固定频率发送时可填写固定采样率
+ *
+ * 局限：串口数据不带设备时间，测得的是上位机每秒收到的帧数。设备发送不均匀、
+ * 丢帧或刚开始接收（不足0.5秒）时与真实采样率有偏差，频率轴随之偏移。
+ * - 线性/dB幅度、线性/对数频率轴可选
+ * - 显示各通道的峰值频率、频率分辨率和计算耗时
+ */
+
+#ifndef SPECTRUM_WIDGET_H
+#define SPECTRUM_WIDGET_H
+
+#include "Widget.h"
+#include "PlotSeries.h"
+#include "../core/SpectrumAnalyzer.h"
+#include <implot.h>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+/**
+ * @brief 频谱图组件
+ */
+class SpectrumWidget : public Widget {
+public:
+    SpectrumWidget(const std::string& name = "Spectrum")
+        : Widget(WidgetType::SPECTRUM, name)
+        , fft_size_index_(3)
+        , segments_(4)
+        , window_(SpectrumWindow::HANN)
+        , remove_dc_(true)
+        , show_db_(false)
+        , log_frequency_(false)
+        , update_interval_ms_(100)
+        , fixed_sample_rate_(0.0f)
+    {
+        // 默认显示通道0
+        channels_ = {0};
+    }
+
+    void Render(DataChannelManager& channel_manager) override {
+        if (!visible_) return;
+
+        ImGui::SetNextWindowSize(GetSize(), ImGuiCond_FirstUseEver);
+        ImGui::SetNextWindowPos(GetPosition(), ImGuiCond_FirstUseEver);
+
+        if (ImGui::Begin(GetImGuiID().c_str(), &visible_)) {
+            RenderSpectrum(channel_manager);
+        }
+        ImGui::End();
+    }
+
+    void RenderConfig() override {
+        ImGui::Text("频谱图配置");
+        ImGui::Separator();
+
+        ImGui::Combo("FFT点数", &fft_size_index_, "256\0" "512\0" "1024\0" "2048\0" "4096\0" "8192\0" "16384\0");
+
+        const SpectrumWindow windows[] = {SpectrumWindow::RECTANGULAR, SpectrumWindow::HANN,
+                                          SpectrumWindow::BLACKMAN};
+        if (ImGui::BeginCombo("窗函数", GetSpectrumWindowName(window_))) {
+            for (SpectrumWindow window : windows) {
+                if (ImGui::Selectable(GetSpectrumWindowName(window), window == window_)) {
+                    window_ = window;
+                }
+            }
+            ImGui::EndCombo();
+        }
+
+        ImGui::SliderInt("平均段数", &segments_, 1, 16);
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Welch平均：相邻段重叠50%%，样本不足时自动减少段数");
+        }
+        ImGui::Checkbox("去除直流", &remove_dc_);
+        ImGui::Checkbox("幅度显示为dB", &show_db_);
+        ImGui::Checkbox("对数频率轴", &log_frequency_);
+        ImGui::SliderInt("刷新间隔(ms)", &update_interval_ms_, 0, 1000);
+        if (ImGui::InputFloat("固定采样率(Hz)", &fixed_sample_rate_, 0.0f, 0.0f, "%.1f")) {
+            fixed_sample_rate_ = std::max(fixed_sample_rate_, 0.0f);
+        }
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("0表示使用测得的接收帧率（最近几秒每秒收到的帧数）\n"
+                              "测得值反映上位机收到的帧数，设备发送不均匀或丢帧时有偏差，\n"
+                              "设备按固定频率发送时建议填写该频率");
+        }
+
+        ImGui::Separator();
+        ImGui::Text("通道选择：");
+
+        RenderChannelSelector();
+    }
+
+    /**
+     * @brief 在当前窗口内渲染频谱图（嵌入波形视图等其他界面时使用）
+     */
+    void RenderSpectrum(DataChannelManager& channel_manager) {
+        // 读取本帧快照（不加锁）
+        const ChannelSnapshot& snapshot = channel_manager.GetSnapshot();
+        available_channels_ = snapshot.channels.size();
+
+        // 快照只拷贝请求过的通道数值：为所选通道续期，下一次计算需要的长度
+        SpectrumParams wanted_params;
+        wanted_params.fft_size = GetFftSize();
+        wanted_params.segments = static_cast<size_t>(segments_);
+        for (size_t channel_index : channels_) {
+            channel_manager.RequestSnapshotValues(channel_index, wanted_params.RequiredSamples());
+        }
+
+        // 到达刷新间隔且工作线程空闲时提交新数据，随后取回已完成的结果
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_submit_ >= std::chrono::milliseconds(update_interval_ms_) &&
+            !analyzer_.IsBusy() && FillInput(snapshot)) {
+            if (analyzer_.Submit(input_)) {
+                last_submit_ = now;
+            }
+        }
+        analyzer_.TakeResult(result_);
+
+        if (result_.frequencies.size() < 2 || result_.sample_rate <= 0.0) {
+            ImGui::Text("数据不足（至少需要%zu个样本，且已测得采样率或填写了固定采样率）", GetFftSize());
+            return;
+        }
+
+        // 摘要：采样率、分辨率、各通道峰值频率、计算耗时
+        ImGui::Text("采样率: %.1f Hz (%s)  分辨率: %.3f Hz  平均段数: %zu  计算: %.2f ms",
+                    result_.sample_rate, (fixed_sample_rate_ > 0.0f) ? "固定" : "测得",
+                    result_.frequencies[1], result_.segments, result_.compute_ms);
+        for (size_t i = 0; i < result_.channels.size(); i++) {
+            if (result_.magnitudes[i].empty() || result_.channels[i] >= snapshot.channels.size()) {
+                continue;
+            }
+            ImGui::SameLine();
+            ImGui::Text("| %s 峰值: %.2f Hz", snapshot.channels[result_.channels[i]].config.name.c_str(),
+                        result_.peak_frequencies[i]);
+        }
+
+        ImPlot::PushStyleVar(ImPlotStyleVar_LineWeight, 1.5f);
+
+        if (ImPlot::BeginPlot(GetImGuiID().c_str(), ImVec2(-1, -1))) {
+            ImPlot::SetupAxis(ImAxis_X1, "Frequency (Hz)", ImPlotAxisFlags_AutoFit);
+            ImPlot::SetupAxis(ImAxis_Y1, show_db_ ? "Magnitude (dB)" : "Magnitude", ImPlotAxisFlags_AutoFit);
+            if (log_frequency_) {
+                ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Log10);
+            }
+
+            // 对数频率轴不显示直流频点
+            const size_t first_bin = log_frequency_ ? 1 : 0;
+            const size_t bins = result_.frequencies.size() - first_bin;
+            for (size_t i = 0; i < result_.channels.size(); i++) {
+                size_t channel_index = result_.channels[i];
+                const std::vector<float>& magnitude = result_.magnitudes[i];
+                if (magnitude.size() != result_.frequencies.size() ||
+                    channel_index >= snapshot.channels.size()) {
+                    continue;
+                }
+
+                const ChannelConfig& config = snapshot.channels[channel_index].config;
+                const float* values = magnitude.data() + first_bin;
+                if (show_db_) {
+                    // 20·log10(A)，下限-200 dB避免log(0)
+                    db_values_.resize(bins);
+                    for (size_t k = 0; k < bins; k++) {
+                        db_values_[k] = 20.0f * std::log10(std::max(values[k], 1e-10f));
+                    }
+                    values = db_values_.data();
+                }
+
+                ImVec4 color(config.color[0], config.color[1], config.color[2], config.color[3]);
+                ImPlot::SetNextLineStyle(color);
+                PlotSeriesLine(config.name.c_str(), result_.frequencies.data() + first_bin,
+                               values, static_cast<int>(bins));
+            }
+
+            ImPlot::EndPlot();
+        }
+
+        ImPlot::PopStyleVar();
+    }
+
+private:
+    /**
+     * @brief 当前选择的FFT点数
+     */
+    size_t GetFftSize() const {
+        return static_cast<size_t>(256) << fft_size_index_;
+    }
+
+    /**
+     * @brief 从快照填写计算输入（各通道最近的样本，复用缓冲区）
+     * @return 没有可计算的通道或采样率无法测得时返回false
+     */
+    bool FillInput(const ChannelSnapshot& snapshot) {
+        SpectrumParams& params = input_.params;
+        params.fft_size = GetFftSize();
+        params.segments = static_cast<size_t>(segments_);
+        params.window = window_;
+        params.remove_dc = remove_dc_;
+
+        // 快照只保留最近的一部分帧，段数不够时由分析器减少
+        size_t wanted = std::min(params.RequiredSamples(), snapshot.timestamps.size());
+        if (wanted < params.fft_size) return false;
+
+        input_.sample_rate = (fixed_sample_rate_ > 0.0f) ? fixed_sample_rate_ : snapshot.frame_rate;
+        if (input_.sample_rate <= 0.0) return false;
+
+        input_.channels.clear();
+        for (size_t channel_index : channels_) {
+            if (channel_index >= snapshot.channels.size() ||
+                !snapshot.channels[channel_index].config.enabled) {
+                continue;
+            }
+            const ChannelView& view = snapshot.channels[channel_index];
+            size_t count = (view.values.size() > view.first_index) ? view.values.size() - view.first_index : 0;
+            if (count < params.fft_size) {
+                continue;
+            }
+
+            size_t index = input_.channels.size();
+            input_.channels.push_back(channel_index);
+            if (input_.samples.size() <= index) {
+                input_.samples.resize(index + 1);
+            }
+
+            // 最近wanted个样本；缺失值（NaN）保持上一个有效值
+            size_t length = std::min(wanted, count);
+            const float* source = view.values.data() + view.values.size() - length;
+            std::vector<float>& samples = input_.samples[index];
+            samples.resize(length);
+            float held = 0.0f;
+            for (size_t i = 0; i < length; i++) {
+                if (std::isfinite(source[i])) {
+                    held = source[i];
+                    break;
+                }
+            }
+            for (size_t i = 0; i < length; i++) {
+                held = std::isfinite(source[i]) ? source[i] : held;
+                samples[i] = held;
+            }
+        }
+        return !input_.channels.empty();
+    }
+
+    // 配置选项
+    int fft_size_index_;            // FFT点数（256 << index）
+    int segments_;                  // Welch平均段数
+    SpectrumWindow window_;         // 窗函数
+    bool remove_dc_;                // 去除直流
+    bool show_db_;                  // 幅度显示为dB
+    bool log_frequency_;            // 对数频率轴
+    int update_interval_ms_;        // 刷新间隔（毫秒）
+    float fixed_sample_rate_;       // 固定采样率（Hz，0表示使用测得的接收帧率）
+
+    // 计算状态
+    SpectrumAnalyzer analyzer_;                                 // 后台分析器（工作线程）
+    SpectrumInput input_;                                       // 待提交的输入（与分析器交换复用）
+    SpectrumResult result_;                                     // 最近一次的结果
+    std::vector<float> db_values_;                              // dB换算缓冲区
+    std::chrono::steady_clock::time_point last_submit_;         // 上次提交时间
+};
+
+#endif // SPECTRUM_WIDGET_H
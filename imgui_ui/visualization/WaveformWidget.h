@@ -6,17 +6,22 @@
  *
  * 特性：
  * - 支持多通道叠加显示
- * - 实时滚动显示
+ * - 实时滚动显示（跟随最新数据，显示最近“历史时长”秒；关闭跟随后可自由平移缩放）
  * - 自动Y轴缩放
  * - 图例显示
  * - 支持缩放和平移
+ * - 按可见时间窗口和绘图区像素宽度降采样（等间隔/最小最大值/M4/LTTB可选），
+ *   深历史下尖峰不丢失，每帧只计算新到达的分段；降采样由快照发布者按本组件
+ *   提交的请求完成（见DataChannelManager::RequestWaveform），绘制时不加锁
  */
 
 #ifndef WAVEFORM_WIDGET_H
 #define WAVEFORM_WIDGET_H
 
 #include "Widget.h"
+#include "PlotSeries.h"
 #include <implot.h>
+#include <memory>
 #include <vector>
 
 /**
@@ -28,6 +33,7 @@ public:
         : Widget(WidgetType::WAVEFORM, name)
         , auto_fit_y_(true)
         , show_legend_(true)
+        , follow_latest_(true)
         , history_seconds_(10.0)
         , max_points_(1000)
     {
@@ -55,32 +61,28 @@ public:
         ImGui::Checkbox("自动缩放Y轴", &auto_fit_y_);
         ImGui::Checkbox("显示图例", &show_legend_);
 
+        ImGui::Checkbox("跟随最新数据", &follow_latest_);
         ImGui::SliderFloat("历史时长(秒)", &history_seconds_, 1.0f, 60.0f);
-        ImGui::SliderInt("最大点数", &max_points_, 100, 2000);
-
-        ImGui::Separator();
-        ImGui::Text("通道选择：");
-
-        // 通道选择复选框
-        for (size_t i = 0; i < DataChannelManager::MAX_CHANNELS; i++) {
-            bool selected = IsChannelSelected(i);
-            ImGui::PushID(static_cast<int>(i));
+        ImGui::SliderInt("最大分段数", &max_points_, 100, 2000);
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("实际分段数不超过绘图区像素宽度");
+        }
 
-            if (ImGui::Checkbox(("CH" + std::to_string(i + 1)).c_str(), &selected)) {
-                if (selected) {
-                    AddChannel(i);
-                } else {
-                    RemoveChannel(i);
+        const DownsampleMode modes[] = {DownsampleMode::STRIDE, DownsampleMode::MINMAX,
+                                        DownsampleMode::M4, DownsampleMode::LTTB};
+        if (ImGui::BeginCombo("降采样方式", GetDownsampleModeName(downsample_mode_))) {
+            for (DownsampleMode mode : modes) {
+                if (ImGui::Selectable(GetDownsampleModeName(mode), mode == downsample_mode_)) {
+                    downsample_mode_ = mode;
                 }
             }
+            ImGui::EndCombo();
+        }
 
-            ImGui::PopID();
+        ImGui::Separator();
+        ImGui::Text("通道选择：");
 
-            // 每4个换行
-            if ((i + 1) % 4 != 0) {
-                ImGui::SameLine();
-            }
-        }
+        RenderChannelSelector();
     }
 
 private:
@@ -88,6 +90,10 @@ private:
      * @brief 渲染波形图
      */
     void RenderWaveform(DataChannelManager& channel_manager) {
+        // 读取本帧快照（不加锁）
+        const ChannelSnapshot& snapshot = channel_manager.GetSnapshot();
+        available_channels_ = snapshot.channels.size();
+
         ImPlot::PushStyleVar(ImPlotStyleVar_LineWeight, 2.0f);
 
         // 设置图表标志
@@ -110,40 +116,55 @@ private:
             ImPlot::SetupAxis(ImAxis_X1, "Time (s)", x_flags);
             ImPlot::SetupAxis(ImAxis_Y1, "Value", y_flags);
 
+            // 跟随模式：X轴固定显示最近history_seconds_秒
+            if (follow_latest_ && !snapshot.timestamps.empty()) {
+                double latest = snapshot.timestamps.back();
+                ImPlot::SetupAxisLimits(ImAxis_X1, latest - history_seconds_, latest, ImGuiCond_Always);
+            }
+
+            // 请求下一次发布的波形：跟随时为最近history_seconds_秒，否则为当前可见窗口
+            // （按时间戳二分查找，平移缩放耗时与历史深度无关）；每个像素列最多一段
+            ImPlotRect limits = ImPlot::GetPlotLimits();
+            if (!waveform_) {
+                waveform_ = channel_manager.AddWaveform();
+            }
+            request_.channels = channels_;
+            request_.mode = downsample_mode_;
+            request_.max_buckets = std::min(static_cast<size_t>(std::max(ImPlot::GetPlotSize().x, 1.0f)),
+                                            static_cast<size_t>(max_points_));
+            request_.follow = follow_latest_;
+            request_.span = history_seconds_;
+            request_.t_begin = limits.X.Min;
+            request_.t_end = limits.X.Max;
+            channel_manager.RequestWaveform(*waveform_, request_);
+
             // 绘制每个通道
             for (size_t channel_index : channels_) {
-                if (channel_index >= DataChannelManager::MAX_CHANNELS) {
+                if (channel_index >= snapshot.channels.size()) {
                     continue;
                 }
 
                 // 检查通道是否启用
-                if (!channel_manager.IsChannelEnabled(channel_index)) {
+                if (!snapshot.channels[channel_index].config.enabled) {
                     continue;
                 }
 
                 // 获取通道配置
-                ChannelConfig config = channel_manager.GetChannelConfig(channel_index);
+                const ChannelConfig& config = snapshot.channels[channel_index].config;
 
-                // 获取数据
-                std::vector<double> timestamps;
-                std::vector<float> y_values_float;
-                size_t point_count = channel_manager.GetChannelData(
-                    channel_index, timestamps, y_values_float, max_points_);
-
-                if (point_count > 0) {
-                    // ImPlot要求X和Y类型一致，必须转换为double
-                    // 注意：这是ImPlot的限制，无法避免此转换
-                    std::vector<double> y_values(y_values_float.begin(), y_values_float.end());
+                // 快照中降采样后的数据
+                const WaveformSeries* series = snapshot.FindWaveform(waveform_->id, channel_index);
+                if (series && !series->values.empty()) {
 
                     // 设置线条颜色
                     ImVec4 color(config.color[0], config.color[1], config.color[2], config.color[3]);
                     ImPlot::SetNextLineStyle(color);
 
-                    // 绘制折线图
-                    ImPlot::PlotLine(config.name.c_str(),
-                                    timestamps.data(),
-                                    y_values.data(),
-                                    static_cast<int>(point_count));
+                    // 绘制折线图（取点回调直接读取降采样结果，不分配、不转换拷贝）
+                    PlotSeriesLine(config.name.c_str(),
+                                   series->timestamps.data(),
+                                   series->values.data(),
+                                   static_cast<int>(series->values.size()));
                 }
             }
 
@@ -153,36 +174,15 @@ private:
         ImPlot::PopStyleVar();
     }
 
-    /**
-     * @brief 判断通道是否已选择
-     */
-    bool IsChannelSelected(size_t channel_index) const {
-        return std::find(channels_.begin(), channels_.end(), channel_index) != channels_.end();
-    }
-
-    /**
-     * @brief 添加通道
-     */
-    void AddChannel(size_t channel_index) {
-        if (!IsChannelSelected(channel_index)) {
-            channels_.push_back(channel_index);
-        }
-    }
-
-    /**
-     * @brief 移除通道
-     */
-    void RemoveChannel(size_t channel_index) {
-        channels_.erase(
-            std::remove(channels_.begin(), channels_.end(), channel_index),
-            channels_.end());
-    }
-
     // 配置选项
     bool auto_fit_y_;           // 自动缩放Y轴
     bool show_legend_;          // 显示图例
+    bool follow_latest_;        // 跟随最新数据
     float history_seconds_;     // 历史时长（秒）
-    int max_points_;            // 最大显示点数
+    int max_points_;            // 最大分段数
+    DownsampleMode downsample_mode_ = DownsampleMode::MINMAX;                    // 降采样方式
+    std::shared_ptr<WaveformState> waveform_;                                   // 波形请求（首次绘制时登记，降采样缓存由发布者维护）
+    WaveformRequest request_;                                                   // 每帧提交的请求（通道列表容量复用）
 };
 
 #endif // WAVEFORM_WIDGET_H
@@ -10,6 +10,7 @@
 #ifndef WIDGET_H
 #define WIDGET_H
 
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <memory>
@@ -24,7 +25,8 @@ enum class WidgetType {
     DIGITAL_DISPLAY, // 数字表盘
     BAR_CHART,       // 柱状图
     GAUGE,           // 仪表盘
-    DATA_TABLE       // 数据表格
+    DATA_TABLE,      // 数据表格
+    SPECTRUM         // 频谱图
 };
 
 /**
@@ -37,6 +39,7 @@ inline std::string GetWidgetTypeName(WidgetType type) {
         case WidgetType::BAR_CHART:       return "Bar Chart";
         case WidgetType::GAUGE:           return "Gauge";
         case WidgetType::DATA_TABLE:      return "Data Table";
+        case WidgetType::SPECTRUM:        return "Spectrum";
         default: return "Unknown";
     }
 }
@@ -160,11 +163,80 @@ protected:
         return name_ + "##" + std::to_string(id_);
     }
 
+    /**
+     * @brief 判断通道是否已选择
+     */
+    bool IsChannelSelected(size_t channel_index) const {
+        return std::find(channels_.begin(), channels_.end(), channel_index) != channels_.end();
+    }
+
+    /**
+     * @brief 添加通道
+     */
+    void AddChannel(size_t channel_index) {
+        if (!IsChannelSelected(channel_index)) {
+            channels_.push_back(channel_index);
+        }
+    }
+
+    /**
+     * @brief 移除通道
+     */
+    void RemoveChannel(size_t channel_index) {
+        channels_.erase(
+            std::remove(channels_.begin(), channels_.end(), channel_index),
+            channels_.end());
+    }
+
+    /**
+     * @brief 渲染通道选择复选框（列出已创建的通道，每行4个）
+     *
+     * 通道很多时放在固定高度的滚动区内，只提交可见的行
+     */
+    void RenderChannelSelector() {
+        const size_t per_row = 4;
+        const int rows = static_cast<int>((available_channels_ + per_row - 1) / per_row);
+        if (rows == 0) {
+            ImGui::TextDisabled("暂无通道");
+            return;
+        }
+        const float row_height = ImGui::GetFrameHeightWithSpacing();
+        ImGui::BeginChild("##channel_selector", ImVec2(0, row_height * static_cast<float>(std::min(rows, 8))));
+
+        ImGuiListClipper clipper;
+        clipper.Begin(rows, row_height);
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                for (size_t col = 0; col < per_row; col++) {
+                    size_t i = static_cast<size_t>(row) * per_row + col;
+                    if (i >= available_channels_) break;
+
+                    bool selected = IsChannelSelected(i);
+                    ImGui::PushID(static_cast<int>(i));
+                    if (col > 0) {
+                        ImGui::SameLine();
+                    }
+                    if (ImGui::Checkbox(("CH" + std::to_string(i + 1)).c_str(), &selected)) {
+                        if (selected) {
+                            AddChannel(i);
+                        } else {
+                            RemoveChannel(i);
+                        }
+                    }
+                    ImGui::PopID();
+                }
+            }
+        }
+
+        ImGui::EndChild();
+    }
+
     WidgetType type_;                   // 组件类型
     std::string name_;                  // 组件名称
     int id_;                            // 唯一ID
     bool visible_;                      // 是否可见
     std::vector<size_t> channels_;      // 使用的通道列表
+    size_t available_channels_ = 0;     // 最近一次渲染时已创建的通道数（通道选择列表的长度）
 
     // 位置和大小
     float position_x_ = 0.0f;
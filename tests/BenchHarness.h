@@ -0,0 +1,65 @@
+/**
+ * @file BenchHarness.h
+ * @brief 最小性能基准框架 - 固定时长重复运行，输出每次操作的耗时与吞吐
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 基准只用于比较同一台机器上的相对开销（如新旧实现），不作为测试的通过条件。
+ */
+
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace bench {
+
+/**
+ * @brief 防止编译器把结果优化掉
+ */
+template<typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(_MSC_VER)
+    static volatile const void* sink;
+    sink = &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "g"(&value) : "memory");
+#endif
+}
+
+/**
+ * @brief 重复调用function直到累计至少min_seconds秒
+ * @param name 名称
+ * @param items_per_call 每次调用处理的条目数（样本、帧、字节……）
+ * @param unit 条目的单位（输出用）
+ * @param function 被测函数
+ * @return 每个条目的纳秒数
+ */
+template<typename Function>
+double Run(const char* name, double items_per_call, const char* unit, Function function,
+           double min_seconds = 0.3) {
+    function();     // 预热
+    uint64_t calls = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0.0;
+    do {
+        function();
+        calls++;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < min_seconds);
+
+    double items = items_per_call * static_cast<double>(calls);
+    double ns_per_item = elapsed * 1e9 / items;
+    std::printf("%-44s %10.2f ns/%s %10.2f M%s/s\n", name, ns_per_item, unit, items / elapsed / 1e6, unit);
+    return ns_per_item;
+}
+
+} // namespace bench
+
+#endif // BENCH_HARNESS_H
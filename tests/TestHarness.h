@@ -0,0 +1,146 @@
+/**
+ * @file TestHarness.h
+ * @brief 最小单元测试框架 - 只依赖标准库，不链接ImGui
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 用法：
+ * - TEST_CASE(Suite, Name) { ... } 定义并注册一个测试
+ * - CHECK / CHECK_EQ / CHECK_NEAR 失败时打印位置并继续，测试结束后计为失败
+ * - 可执行文件的参数为套件名前缀，只运行匹配的测试（CTest按套件分别注册）
+ */
+
+#ifndef TEST_HARNESS_H
+#define TEST_HARNESS_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace test {
+
+/**
+ * @brief 已注册的测试
+ */
+struct TestCase {
+    const char* suite;
+    const char* name;
+    void (*function)();
+};
+
+inline std::vector<TestCase>& Registry() {
+    static std::vector<TestCase> registry;
+    return registry;
+}
+
+inline size_t& CurrentFailures() {
+    static size_t failures = 0;
+    return failures;
+}
+
+struct Registrar {
+    Registrar(const char* suite, const char* name, void (*function)()) {
+        Registry().push_back({suite, name, function});
+    }
+};
+
+/**
+ * @brief 记录一次失败（每个测试最多打印20条，避免随机测试刷屏）
+ */
+inline void ReportFailure(const char* file, int line, const std::string& message) {
+    if (CurrentFailures()++ < 20) {
+        std::printf("  %s:%d: %s\n", file, line, message.c_str());
+    }
+}
+
+template<typename A, typename B>
+std::string FormatPair(const char* expression, const A& actual, const B& expected) {
+    std::ostringstream stream;
+    stream.precision(10);
+    stream << expression << " (" << actual << " vs " << expected << ")";
+    return stream.str();
+}
+
+/**
+ * @brief 浮点数比较（两者都是NaN视为相等）
+ */
+inline bool Near(double actual, double expected, double tolerance) {
+    if (std::isnan(actual) || std::isnan(expected)) return std::isnan(actual) && std::isnan(expected);
+    return std::fabs(actual - expected) <= tolerance;
+}
+
+/**
+ * @brief 固定种子的随机数发生器（失败可复现）
+ */
+inline std::mt19937_64& Random() {
+    static std::mt19937_64 engine(20250101);
+    return engine;
+}
+
+inline size_t RandomIndex(size_t bound) {
+    return static_cast<size_t>(Random()() % bound);
+}
+
+inline float RandomFloat(float low, float high) {
+    return std::uniform_real_distribution<float>(low, high)(Random());
+}
+
+/**
+ * @brief 运行名称以filter开头的测试（filter为空时全部运行）
+ * @return 失败的测试数
+ */
+inline int RunTests(const char* filter) {
+    size_t run = 0, failed = 0;
+    for (const TestCase& test : Registry()) {
+        std::string full_name = std::string(test.suite) + "." + test.name;
+        if (filter && full_name.compare(0, std::strlen(filter), filter) != 0) continue;
+        CurrentFailures() = 0;
+        test.function();
+        run++;
+        if (CurrentFailures() > 0) {
+            failed++;
+            std::printf("[FAIL] %s (%zu)\n", full_name.c_str(), CurrentFailures());
+        } else {
+            std::printf("[ OK ] %s\n", full_name.c_str());
+        }
+    }
+    std::printf("%zu tests, %zu failed\n", run, failed);
+    return (run == 0) ? 1 : static_cast<int>(failed);
+}
+
+} // namespace test
+
+#define TEST_CASE(suite, name)                                                     \
+    static void suite##_##name();                                                  \
+    static test::Registrar suite##_##name##_registrar(#suite, #name, suite##_##name); \
+    static void suite##_##name()
+
+#define CHECK(condition)                                                           \
+    do {                                                                           \
+        if (!(condition)) test::ReportFailure(__FILE__, __LINE__, #condition);     \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                 \
+    do {                                                                           \
+        auto&& check_actual_ = (actual);                                           \
+        auto&& check_expected_ = (expected);                                       \
+        if (!(check_actual_ == check_expected_))                                   \
+            test::ReportFailure(__FILE__, __LINE__,                                \
+                test::FormatPair(#actual " == " #expected, check_actual_, check_expected_)); \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                    \
+    do {                                                                           \
+        double check_actual_ = static_cast<double>(actual);                        \
+        double check_expected_ = static_cast<double>(expected);                    \
+        if (!test::Near(check_actual_, check_expected_, (tolerance)))              \
+            test::ReportFailure(__FILE__, __LINE__,                                \
+                test::FormatPair(#actual " ~ " #expected, check_actual_, check_expected_)); \
+    } while (0)
+
+#endif // TEST_HARNESS_H
@@ -0,0 +1,14 @@
+/**
+ * @file TestMain.cpp
+ * @brief 单元测试入口
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 用法：core_tests [套件名前缀]，例如 core_tests CircularBuffer
+ */
+
+#include "TestHarness.h"
+
+int main(int argc, char** argv) {
+    return test::RunTests(argc > 1 ? argv[1] : nullptr);
+}
@@ -0,0 +1,72 @@
+/**
+ * @file bench_CircularBuffer.cpp
+ * @brief CircularBuffer性能基准 - 逐个写入、批量写入、读取与二分查找
+ * @author AI Assistant
+ * @date 2025
+ */
+
+#include "BenchHarness.h"
+#include "../imgui_ui/core/CircularBuffer.h"
+
+#include <vector>
+
+int main() {
+    const size_t capacity = 1 << 20;
+    const size_t block = 1024;
+    std::vector<float> input(block * 64);
+    for (size_t i = 0; i < input.size(); i++) {
+        input[i] = static_cast<float>(i % 1000) * 0.5f;
+    }
+
+    std::printf("CircularBuffer<float>, capacity %zu\n", capacity);
+    CircularBuffer<float> buffer(capacity);
+
+    bench::Run("Push (per sample)", static_cast<double>(input.size()), "sample", [&] {
+        for (float value : input) buffer.Push(value);
+    });
+
+    for (size_t length : {size_t(16), size_t(256), block}) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "PushBatch (%zu-sample blocks)", length);
+        bench::Run(name, static_cast<double>(input.size()), "sample", [&] {
+            for (size_t i = 0; i < input.size(); i += length) buffer.PushBatch(input.data() + i, length);
+        });
+    }
+
+    bench::Run("PushFill (1024-sample runs)", static_cast<double>(input.size()), "sample", [&] {
+        for (size_t i = 0; i < input.size(); i += block) buffer.PushFill(1.0f, block);
+    });
+
+    // 读取：逐个Get、分段CopyTo、等间隔抽取
+    std::vector<float> output(capacity);
+    bench::Run("Get (sequential)", static_cast<double>(capacity), "sample", [&] {
+        float sum = 0.0f;
+        for (size_t i = 0; i < capacity; i++) sum += buffer.Get(i);
+        bench::DoNotOptimize(sum);
+    });
+    bench::Run("CopyTo (whole buffer)", static_cast<double>(capacity), "sample", [&] {
+        buffer.CopyTo(0, capacity, output.data());
+        bench::DoNotOptimize(output[0]);
+    });
+    std::vector<double> timestamps;
+    std::vector<float> values;
+    bench::Run("GetXYValues (2000 points)", 2000.0, "point", [&] {
+        buffer.GetXYValues(timestamps, values, 2000);
+        bench::DoNotOptimize(values[0]);
+    });
+
+    // 时间戳列上的二分查找（跨越环形边界）
+    CircularBuffer<double> times(capacity);
+    for (size_t i = 0; i < capacity + capacity / 3; i++) times.Push(static_cast<double>(i) * 1e-3);
+    double last = times.GetLatest();
+    size_t query = 0;
+    bench::Run("LowerBound (timestamp column)", 1024.0, "query", [&] {
+        size_t total = 0;
+        for (int i = 0; i < 1024; i++) {
+            query = query * 6364136223846793005ULL + 1442695040888963407ULL;
+            total += times.LowerBound(static_cast<double>(query >> 40) / static_cast<double>(1ULL << 24) * last);
+        }
+        bench::DoNotOptimize(total);
+    });
+    return 0;
+}
@@ -0,0 +1,444 @@
+/**
+ * @file bench_parsers.cpp
+ * @brief 协议解析性能基准 - 新解析路径与原实现（逐字节状态机等）对比
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 原实现按原样保留在legacy命名空间中，只用于对比，不参与程序构建。
+ * 输入按串口读取的块大小切分后逐块送入解析器，吞吐按输入字节计算。
+ */
+
+#include "BenchHarness.h"
+#include "../imgui_ui/protocols/FireWaterParser.h"
+#include "../imgui_ui/protocols/CsvParser.h"
+#include "../imgui_ui/protocols/FrameDecodePlan.h"
+
+#include <cctype>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace legacy {
+
+/**
+ * @brief 原FireWater解析器：逐字节状态机，帧尾不匹配时整帧缓冲区左移一字节
+ */
+class FireWaterParser {
+public:
+    struct Result {
+        bool success = false;
+        std::vector<float> values;
+        size_t bytes_consumed = 0;
+    };
+
+    explicit FireWaterParser(size_t channel_count)
+        : channel_count_(channel_count)
+        , data_buffer_(channel_count * 4)
+    {}
+
+    Result Parse(const unsigned char* buffer, size_t length) {
+        Result result;
+        result.values.reserve(channel_count_);
+        size_t consumed = 0;
+        for (size_t i = 0; i < length; i++) {
+            unsigned char byte = buffer[i];
+            consumed++;
+            if (!verifying_tail_) {
+                data_buffer_[data_index_++] = byte;
+                if (data_index_ >= data_buffer_.size()) {
+                    verifying_tail_ = true;
+                    tail_index_ = 0;
+                }
+            } else if (byte == FRAME_TAIL[tail_index_]) {
+                if (++tail_index_ >= 4) {
+                    for (size_t ch = 0; ch < channel_count_; ch++) {
+                        float value;
+                        std::memcpy(&value, &data_buffer_[ch * 4], 4);
+                        result.values.push_back(value);
+                    }
+                    result.success = true;
+                    result.bytes_consumed = consumed;
+                    verifying_tail_ = false;
+                    data_index_ = 0;
+                    tail_index_ = 0;
+                    return result;
+                }
+            } else {
+                for (size_t j = 0; j < data_buffer_.size() - 1; j++) {
+                    data_buffer_[j] = data_buffer_[j + 1];
+                }
+                for (size_t j = 0; j < tail_index_; j++) {
+                    data_buffer_[data_buffer_.size() - tail_index_ + j] = FRAME_TAIL[j];
+                }
+                data_buffer_[data_buffer_.size() - 1] = byte;
+                tail_index_ = (byte == FRAME_TAIL[0]) ? 1 : 0;
+            }
+        }
+        result.bytes_consumed = consumed;
+        return result;
+    }
+
+private:
+    static constexpr unsigned char FRAME_TAIL[4] = {0x00, 0x00, 0x80, 0x7F};
+    size_t channel_count_;
+    std::vector<unsigned char> data_buffer_;
+    bool verifying_tail_ = false;
+    size_t data_index_ = 0;
+    size_t tail_index_ = 0;
+};
+
+/**
+ * @brief 原CSV解析器：逐字节追加到std::string，stringstream/getline分割，
+ *        Trim返回新字符串，std::stof包在try/catch中
+ */
+class CsvParser {
+public:
+    struct Result {
+        bool success = false;
+        std::vector<float> values;
+        size_t bytes_consumed = 0;
+    };
+
+    explicit CsvParser(size_t channel_count)
+        : channel_count_(channel_count)
+    {}
+
+    Result Parse(const unsigned char* buffer, size_t length) {
+        Result result;
+        result.values.reserve(channel_count_);
+        size_t consumed = 0;
+        for (size_t i = 0; i < length; i++) {
+            unsigned char byte = buffer[i];
+            consumed++;
+            if (byte == '\n') {
+                if (!line_buffer_.empty()) {
+                    if (line_buffer_.back() == '\r') {
+                        line_buffer_.pop_back();
+                    }
+                    std::vector<float> values = ParseCsvLine(line_buffer_);
+                    if (!values.empty()) {
+                        result.values = values;
+                        result.success = true;
+                        result.bytes_consumed = consumed;
+                        line_buffer_.clear();
+                        return result;
+                    }
+                    line_buffer_.clear();
+                }
+            } else {
+                line_buffer_ += static_cast<char>(byte);
+                if (line_buffer_.size() > 4096) {
+                    line_buffer_.clear();
+                }
+            }
+        }
+        result.bytes_consumed = consumed;
+        return result;
+    }
+
+private:
+    std::vector<float> ParseCsvLine(const std::string& line) {
+        std::vector<float> values;
+        std::stringstream ss(line);
+        std::string token;
+        while (std::getline(ss, token, ',')) {
+            try {
+                token = Trim(token);
+                if (!token.empty()) {
+                    values.push_back(std::stof(token));
+                }
+            } catch (...) {
+                continue;
+            }
+        }
+        return values;
+    }
+
+    std::string Trim(const std::string& str) {
+        size_t start = 0;
+        size_t end = str.size();
+        while (start < end && std::isspace(static_cast<unsigned char>(str[start]))) {
+            start++;
+        }
+        while (end > start && std::isspace(static_cast<unsigned char>(str[end - 1]))) {
+            end--;
+        }
+        return str.substr(start, end - start);
+    }
+
+    size_t channel_count_;
+    std::string line_buffer_;
+};
+
+/**
+ * @brief 原自定义协议字段解码：每帧遍历通道类型，每个字段按大小端拷贝到temp[8]，
+ *        再经BytesToFloat中的switch转换
+ */
+inline void DecodeFrame(const std::vector<DataType>& types, bool big_endian,
+                        const unsigned char* data, float* out) {
+    size_t offset = 0;
+    size_t channel = 0;
+    for (const auto& type : types) {
+        size_t size = GetDataTypeSize(type);
+        unsigned char temp[8];
+        if (big_endian && size > 1) {
+            for (size_t i = 0; i < size; i++) {
+                temp[i] = data[offset + size - 1 - i];
+            }
+        } else {
+            std::memcpy(temp, data + offset, size);
+        }
+        out[channel++] = BytesToFloat(temp, type);
+        offset += size;
+    }
+}
+
+} // namespace legacy
+
+namespace {
+
+std::mt19937& Random() {
+    static std::mt19937 random(20250101u);
+    return random;
+}
+
+/**
+ * @brief 生成FireWater字节流
+ * @param corrupt_every 每隔多少帧插入一段随机字节（0表示干净数据）
+ * @param max_garbage 每段随机字节的最大长度
+ */
+std::vector<unsigned char> MakeFireWaterStream(size_t channels, size_t frames, size_t corrupt_every,
+                                               size_t max_garbage) {
+    static const unsigned char tail[4] = {0x00, 0x00, 0x80, 0x7F};
+    std::uniform_real_distribution<float> value(-100.0f, 100.0f);
+    std::vector<unsigned char> stream;
+    for (size_t f = 0; f < frames; f++) {
+        for (size_t c = 0; c < channels; c++) {
+            float v = value(Random());
+            unsigned char bytes[4];
+            std::memcpy(bytes, &v, 4);
+            stream.insert(stream.end(), bytes, bytes + 4);
+        }
+        stream.insert(stream.end(), tail, tail + 4);
+        if (corrupt_every > 0 && f % corrupt_every == corrupt_every - 1) {
+            size_t garbage = 1 + Random()() % max_garbage;
+            for (size_t i = 0; i < garbage; i++) {
+                stream.push_back(static_cast<unsigned char>(Random()()));
+            }
+        }
+    }
+    return stream;
+}
+
+/**
+ * @brief 按块送入新解析器（与VisualizationUI::ProcessReceivedData相同的循环）
+ * @return 解析出的帧数
+ */
+size_t RunBatchParser(ProtocolParser& parser, const std::vector<unsigned char>& stream, size_t chunk,
+                      std::vector<float>& out) {
+    const size_t max_frames = 1024;
+    size_t frames = 0;
+    for (size_t start = 0; start < stream.size(); start += chunk) {
+        const unsigned char* data = stream.data() + start;
+        size_t length = std::min(chunk, stream.size() - start);
+        size_t offset = 0;
+        while (offset < length) {
+            BatchParseResult batch = parser.ParseBatch(data + offset, length - offset, out.data(),
+                                                       max_frames, ProtocolParser::MAX_FRAME_CHANNELS);
+            frames += batch.frames;
+            if (batch.frames == 0 && batch.bytes_consumed == 0) break;
+            offset += batch.bytes_consumed;
+        }
+    }
+    return frames;
+}
+
+/**
+ * @brief 按块送入原解析器（原调用方式：每次Parse返回至多一帧）
+ */
+template<typename Parser>
+size_t RunLegacyParser(Parser& parser, const std::vector<unsigned char>& stream, size_t chunk) {
+    size_t frames = 0;
+    for (size_t start = 0; start < stream.size(); start += chunk) {
+        const unsigned char* data = stream.data() + start;
+        size_t length = std::min(chunk, stream.size() - start);
+        size_t offset = 0;
+        while (offset < length) {
+            auto result = parser.Parse(data + offset, length - offset);
+            if (result.success) frames++;
+            if (result.bytes_consumed == 0) break;
+            offset += result.bytes_consumed;
+        }
+    }
+    return frames;
+}
+
+void BenchFireWater() {
+    std::vector<float> out(1024 * ProtocolParser::MAX_FRAME_CHANNELS);
+
+    struct Case {
+        const char* name;
+        size_t channels;
+        size_t frames;
+        size_t corrupt_every;
+        size_t max_garbage;
+    };
+    const Case cases[] = {
+        {"clean", 8, 20000, 0, 0},
+        {"1-7 garbage bytes every 100 frames", 8, 20000, 100, 7},
+        {"1-7 garbage bytes every 5 frames", 8, 20000, 5, 7},
+        {"noise bursts up to 1 KB every 10 frames", 64, 2000, 10, 1024},
+    };
+    for (const Case& c : cases) {
+        const size_t channels = c.channels;
+        std::vector<unsigned char> stream = MakeFireWaterStream(channels, c.frames, c.corrupt_every, c.max_garbage);
+        std::printf("\nFireWater, %zu channels, %s (%zu bytes)\n", channels, c.name, stream.size());
+        for (size_t chunk : {size_t(64), size_t(4096)}) {
+            FireWaterParser parser(channels);
+            legacy::FireWaterParser old_parser(channels);
+            size_t new_frames = RunBatchParser(parser, stream, chunk, out);
+            size_t old_frames = RunLegacyParser(old_parser, stream, chunk);
+            std::printf("  %zu-byte reads: frames decoded new %zu / old %zu\n", chunk, new_frames, old_frames);
+
+            char name[96];
+            std::snprintf(name, sizeof(name), "  ParseBatch (%zu-byte reads)", chunk);
+            double fast = bench::Run(name, static_cast<double>(stream.size()), "B", [&] {
+                bench::DoNotOptimize(RunBatchParser(parser, stream, chunk, out));
+            });
+            std::snprintf(name, sizeof(name), "  legacy byte state machine (%zu-byte reads)", chunk);
+            double slow = bench::Run(name, static_cast<double>(stream.size()), "B", [&] {
+                bench::DoNotOptimize(RunLegacyParser(old_parser, stream, chunk));
+            });
+            std::printf("  speedup %.1fx\n", slow / fast);
+        }
+    }
+}
+
+/**
+ * @brief 生成CSV文本流（printf风格的数值，部分行带空格和\r\n）
+ */
+std::vector<unsigned char> MakeCsvStream(size_t channels, size_t lines) {
+    std::uniform_real_distribution<float> value(-1000.0f, 1000.0f);
+    std::string text;
+    char field[32];
+    for (size_t line = 0; line < lines; line++) {
+        bool spaced = (line % 4 == 0);
+        for (size_t c = 0; c < channels; c++) {
+            std::snprintf(field, sizeof(field), spaced ? "%s %.3f" : "%s%.3f", c == 0 ? "" : ",", value(Random()));
+            text += field;
+        }
+        text += (line % 2 == 0) ? "\r\n" : "\n";
+    }
+    return std::vector<unsigned char>(text.begin(), text.end());
+}
+
+void BenchCsv() {
+    const size_t channels = 9;
+    std::vector<float> out(1024 * ProtocolParser::MAX_FRAME_CHANNELS);
+    std::vector<unsigned char> stream = MakeCsvStream(channels, 20000);
+    std::printf("\nCSV, %zu channels (%zu bytes)\n", channels, stream.size());
+    for (size_t chunk : {size_t(64), size_t(4096)}) {
+        CsvParser parser(channels);
+        legacy::CsvParser old_parser(channels);
+        size_t new_frames = RunBatchParser(parser, stream, chunk, out);
+        size_t old_frames = RunLegacyParser(old_parser, stream, chunk);
+        std::printf("  %zu-byte reads: lines decoded new %zu / old %zu\n", chunk, new_frames, old_frames);
+
+        char name[96];
+        std::snprintf(name, sizeof(name), "  from_chars tokenizer (%zu-byte reads)", chunk);
+        double fast = bench::Run(name, static_cast<double>(stream.size()), "B", [&] {
+            bench::DoNotOptimize(RunBatchParser(parser, stream, chunk, out));
+        });
+        std::snprintf(name, sizeof(name), "  legacy stringstream/stof (%zu-byte reads)", chunk);
+        double slow = bench::Run(name, static_cast<double>(stream.size()), "B", [&] {
+            bench::DoNotOptimize(RunLegacyParser(old_parser, stream, chunk));
+        });
+        std::printf("  speedup %.1fx (%.0f ns/line new, %.0f ns/line old)\n", slow / fast,
+                    fast * stream.size() / 20000.0, slow * stream.size() / 20000.0);
+    }
+}
+
+/**
+ * @brief 生成frames帧随机字段数据（整数字段取类型范围内的值，float取有限值）
+ */
+std::vector<unsigned char> MakeFrames(const std::vector<DataType>& types, size_t frames, size_t& frame_bytes) {
+    frame_bytes = 0;
+    for (DataType type : types) frame_bytes += GetDataTypeSize(type);
+    std::vector<unsigned char> data(frame_bytes * frames);
+    std::uniform_real_distribution<float> value(-1000.0f, 1000.0f);
+    size_t offset = 0;
+    for (size_t f = 0; f < frames; f++) {
+        for (DataType type : types) {
+            size_t size = GetDataTypeSize(type);
+            if (type == DataType::FLOAT) {
+                float v = value(Random());
+                std::memcpy(&data[offset], &v, 4);
+            } else {
+                for (size_t i = 0; i < size; i++) data[offset + i] = static_cast<unsigned char>(Random()());
+            }
+            offset += size;
+        }
+    }
+    return data;
+}
+
+void BenchDecodePlan() {
+    struct Case {
+        const char* name;
+        std::vector<DataType> types;
+        bool big_endian;
+    };
+    const std::vector<Case> cases = {
+        {"8 x float, little endian", std::vector<DataType>(8, DataType::FLOAT), false},
+        {"12 x int16, big endian", std::vector<DataType>(12, DataType::INT16), true},
+        {"mixed float/int16/uint8/int32/uint16, big endian",
+         {DataType::FLOAT, DataType::INT16, DataType::UINT8, DataType::INT32, DataType::UINT16,
+          DataType::FLOAT, DataType::INT8, DataType::UINT32}, true},
+    };
+
+    const size_t frames = 4096;
+    for (const Case& c : cases) {
+        size_t frame_bytes = 0;
+        std::vector<unsigned char> data = MakeFrames(c.types, frames, frame_bytes);
+        const size_t channels = c.types.size();
+        std::vector<float> fast_out(frames * channels);
+        std::vector<float> slow_out(frames * channels);
+
+        FrameDecodePlan plan;
+        plan.Build(c.types, c.big_endian);
+        auto decode_plan = [&] {
+            for (size_t f = 0; f < frames; f++) {
+                plan.Decode(data.data() + f * frame_bytes, fast_out.data() + f * channels, channels);
+            }
+            bench::DoNotOptimize(fast_out[0]);
+        };
+        auto decode_switch = [&] {
+            for (size_t f = 0; f < frames; f++) {
+                legacy::DecodeFrame(c.types, c.big_endian, data.data() + f * frame_bytes, slow_out.data() + f * channels);
+            }
+            bench::DoNotOptimize(slow_out[0]);
+        };
+
+        // 两种解码结果必须逐位相同
+        decode_plan();
+        decode_switch();
+        bool same = std::memcmp(fast_out.data(), slow_out.data(), fast_out.size() * sizeof(float)) == 0;
+
+        std::printf("\nCustom frame decode, %s (%zu bytes/frame, results %s)\n",
+                    c.name, frame_bytes, same ? "identical" : "DIFFER");
+        double fast = bench::Run("  FrameDecodePlan", static_cast<double>(frames), "frame", decode_plan);
+        double slow = bench::Run("  legacy per-field switch", static_cast<double>(frames), "frame", decode_switch);
+        std::printf("  speedup %.1fx\n", slow / fast);
+    }
+}
+
+} // namespace
+
+int main() {
+    BenchFireWater();
+    BenchCsv();
+    BenchDecodePlan();
+    return 0;
+}
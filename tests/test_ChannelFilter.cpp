@@ -0,0 +1,156 @@
+/**
+ * @file test_ChannelFilter.cpp
+ * @brief ChannelFilter测试 - 频率响应、缺失值保持、采样率变化时保留状态、阶段按设置的采样率设计
+ * @author AI Assistant
+ * @date 2025
+ */
+
+#include "TestHarness.h"
+#include "../imgui_ui/core/ChannelFilter.h"
+
+#include <limits>
+
+namespace {
+
+const double PI = ChannelFilter::PI;
+
+/**
+ * @brief 正弦输入的稳态输出幅度（跳过前settle个样本）
+ */
+double SteadyAmplitude(ChannelFilter& filter, double frequency, double sample_rate, size_t length, size_t settle) {
+    std::vector<float> samples(length);
+    for (size_t i = 0; i < length; i++) {
+        samples[i] = static_cast<float>(std::sin(2.0 * PI * frequency * i / sample_rate));
+    }
+    filter.Process(samples.data(), samples.data(), length);
+    double peak = 0.0;
+    for (size_t i = settle; i < length; i++) {
+        peak = std::max(peak, std::fabs(static_cast<double>(samples[i])));
+    }
+    return peak;
+}
+
+/**
+ * @brief 相邻输出的最大变化量
+ */
+double MaxStep(const std::vector<float>& output, size_t begin, size_t end) {
+    double step = 0.0;
+    for (size_t i = begin + 1; i < end; i++) {
+        step = std::max(step, std::fabs(static_cast<double>(output[i]) - output[i - 1]));
+    }
+    return step;
+}
+
+} // namespace
+
+TEST_CASE(ChannelFilter, FrequencyResponse) {
+    const double fs = 1000.0;
+    FilterConfig lowpass;
+    lowpass.type = FilterType::LOWPASS;
+    lowpass.frequency = 50.0;
+    lowpass.order = 4;
+    ChannelFilter filter(lowpass);
+    filter.Design(fs);
+    CHECK_NEAR(SteadyAmplitude(filter, 2.0, fs, 20000, 5000), 1.0, 0.01);
+    filter.Reset();
+    CHECK_NEAR(SteadyAmplitude(filter, 50.0, fs, 20000, 5000), std::sqrt(0.5), 0.01);
+    filter.Reset();
+    CHECK(SteadyAmplitude(filter, 400.0, fs, 20000, 5000) < 1e-3);
+
+    FilterConfig notch;
+    notch.type = FilterType::NOTCH;
+    notch.frequency = 50.0;
+    notch.q = 5.0;
+    ChannelFilter notch_filter(notch);
+    notch_filter.Design(fs);
+    CHECK(SteadyAmplitude(notch_filter, 50.0, fs, 40000, 20000) < 1e-3);
+    notch_filter.Reset();
+    CHECK_NEAR(SteadyAmplitude(notch_filter, 5.0, fs, 40000, 20000), 1.0, 0.02);
+}
+
+TEST_CASE(ChannelFilter, MissingValuesPassThrough) {
+    FilterConfig average;
+    average.type = FilterType::MOVING_AVERAGE;
+    average.taps = 4;
+    ChannelFilter filter(average);
+    filter.Design(0.0);
+
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    float samples[] = {2.0f, nan, 2.0f, 6.0f, nan, 6.0f};
+    filter.Process(samples, samples, 6);
+    CHECK(std::isnan(samples[1]));
+    CHECK(std::isnan(samples[4]));
+    // 首个有效值预置稳态；缺失值按保持值参与平均
+    CHECK_NEAR(samples[0], 2.0, 1e-6);
+    CHECK_NEAR(samples[2], 2.0, 1e-6);
+    CHECK_NEAR(samples[3], 3.0, 1e-6);
+    CHECK_NEAR(samples[5], 5.0, 1e-6);
+}
+
+TEST_CASE(ChannelFilter, RedesignKeepsState) {
+    // 低频正弦经过有明显相位延迟的低通；采样率估计变化3%后重新设计，
+    // 输出应保持连续（不被重新预置到最后一个输入值）
+    FilterConfig config;
+    config.type = FilterType::LOWPASS;
+    config.frequency = 20.0;
+    config.order = 8;
+    ChannelFilter filter(config);
+    filter.Design(1000.0);
+
+    const size_t length = 4000, change = 2500;
+    std::vector<float> output(length);
+    for (size_t i = 0; i < length; i++) {
+        output[i] = static_cast<float>(std::sin(2.0 * PI * 3.0 * i / 1000.0));
+    }
+    filter.Process(output.data(), output.data(), change);
+    filter.Design(1030.0);
+    filter.Process(output.data() + change, output.data() + change, length - change);
+
+    double before = MaxStep(output, change - 1000, change);
+    double across = MaxStep(output, change - 1, change + 50);
+    CHECK(across < 1.5 * before);
+}
+
+TEST_CASE(ChannelFilter, StageUsesConfiguredRate) {
+    FilterConfig config;
+    config.type = FilterType::LOWPASS;
+    config.frequency = 30.0;
+    const size_t length = 2000, half = 1000;
+    std::vector<float> input(length), output(2 * length), reference(2 * length);
+    for (size_t i = 0; i < length; i++) {
+        input[i] = static_cast<float>(std::sin(2.0 * PI * 200.0 * i / 1000.0));
+    }
+
+    // 未设置采样率：低通为直通
+    FilterStage stage;
+    stage.SetFilters({config});
+    CHECK_EQ(stage.GetSampleRate(), 0.0);
+    stage.Apply(input.data(), length, 1, 1, output.data());
+    for (size_t i = 0; i < length; i++) {
+        CHECK_EQ(output[i * 2 + 1], input[i]);
+    }
+
+    // 设置后按该采样率设计：200Hz被充分衰减
+    stage.SetSampleRate(1000.0);
+    CHECK_EQ(stage.GetSampleRate(), 1000.0);
+    stage.Reset();
+    FilterStage continuous;
+    continuous.SetFilters({config});
+    continuous.SetSampleRate(1000.0);
+    stage.Apply(input.data(), half, 1, 1, output.data());
+    continuous.Apply(input.data(), half, 1, 1, reference.data());
+
+    // 相同的值不重新设计，状态保留：分两段的输出与连续处理一致
+    stage.SetSampleRate(1000.0);
+    stage.Apply(input.data() + half, length - half, 1, 1, output.data() + half * 2);
+    continuous.Apply(input.data() + half, length - half, 1, 1, reference.data() + half * 2);
+    double peak = 0.0;
+    for (size_t i = 0; i < length; i++) {
+        CHECK_EQ(output[i * 2 + 1], reference[i * 2 + 1]);
+        if (i >= half) peak = std::max(peak, std::fabs(static_cast<double>(output[i * 2 + 1])));
+    }
+    CHECK(peak < 0.05);
+
+    stage.SetSampleRate(-5.0);
+    CHECK_EQ(stage.GetSampleRate(), 0.0);
+}
@@ -0,0 +1,57 @@
+/**
+ * @file test_Checksum.cpp
+ * @brief Checksum测试 - "123456789"标准校验值、CRC32分段实现与逐位实现一致
+ * @author AI Assistant
+ * @date 2025
+ */
+
+#include "TestHarness.h"
+#include "../imgui_ui/protocols/Checksum.h"
+
+#include <vector>
+
+namespace {
+
+const unsigned char CHECK_INPUT[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+uint32_t ComputeCheck(ChecksumType type) {
+    return Checksum::Compute(type, CHECK_INPUT, sizeof(CHECK_INPUT));
+}
+
+/**
+ * @brief 逐位计算的CRC-32/IEEE（参考实现）
+ */
+uint32_t Crc32Bitwise(const unsigned char* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1u) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+} // namespace
+
+TEST_CASE(Checksum, KnownAnswers) {
+    CHECK_EQ(ComputeCheck(ChecksumType::SUM8), 0xDDu);
+    CHECK_EQ(ComputeCheck(ChecksumType::XOR8), 0x31u);
+    CHECK_EQ(ComputeCheck(ChecksumType::CRC8), 0xF4u);
+    CHECK_EQ(ComputeCheck(ChecksumType::CRC16_MODBUS), 0x4B37u);
+    CHECK_EQ(ComputeCheck(ChecksumType::CRC16_CCITT), 0x29B1u);
+    CHECK_EQ(ComputeCheck(ChecksumType::CRC32), 0xCBF43926u);
+}
+
+TEST_CASE(Checksum, Crc32MatchesBitwise) {
+    // 覆盖slice-by-8主循环、尾部字节以及非对齐起点
+    std::vector<unsigned char> data(1031);
+    for (auto& byte : data) {
+        byte = static_cast<unsigned char>(test::RandomIndex(256));
+    }
+    for (size_t offset = 0; offset < 8; offset++) {
+        for (size_t length : {size_t(0), size_t(1), size_t(7), size_t(8), size_t(9), size_t(64), size_t(1000)}) {
+            CHECK_EQ(Checksum::Crc32(data.data() + offset, length), Crc32Bitwise(data.data() + offset, length));
+        }
+    }
+}
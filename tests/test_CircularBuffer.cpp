@@ -0,0 +1,248 @@
+/**
+ * @file test_CircularBuffer.cpp
+ * @brief CircularBuffer随机差分测试 - 与std::deque参考模型逐项比较
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 随机混合Push、PushBatch、PushFill、PopFront、Clear，每次操作后比较
+ * Size/Empty/Full/GetLatest/Get/GetContinuousData/GetXYValues/CopyTo；
+ * 单调数据（时间戳列）另外比较LowerBound/UpperBound/FindRange。
+ * 容量覆盖1~256（含非2的幂的请求值），写入长度覆盖超过容量的情况。
+ */
+
+#include "TestHarness.h"
+#include "../imgui_ui/core/CircularBuffer.h"
+
+#include <algorithm>
+#include <deque>
+
+namespace {
+
+/**
+ * @brief 参考模型：容量固定、满时丢弃最旧元素的deque
+ */
+template<typename T>
+struct ReferenceBuffer {
+    size_t capacity;
+    std::deque<T> data;
+
+    void Push(const T& value) {
+        data.push_back(value);
+        if (data.size() > capacity) data.pop_front();
+    }
+    void PopFront() {
+        if (!data.empty()) data.pop_front();
+    }
+};
+
+bool SameValue(float a, float b) { return a == b; }
+bool SameValue(double a, double b) { return a == b; }
+bool SameValue(const DataPoint& a, const DataPoint& b) {
+    return a.timestamp == b.timestamp && a.value == b.value;
+}
+
+double TimestampOf(float, size_t index) { return static_cast<double>(index); }
+double TimestampOf(double, size_t index) { return static_cast<double>(index); }
+double TimestampOf(const DataPoint& point, size_t) { return point.timestamp; }
+
+float ValueOf(float value) { return value; }
+float ValueOf(double value) { return static_cast<float>(value); }
+float ValueOf(const DataPoint& point) { return point.value; }
+
+/**
+ * @brief 比较所有读取接口
+ */
+template<typename T>
+void CompareReads(const CircularBuffer<T>& buffer, const ReferenceBuffer<T>& reference) {
+    const size_t count = reference.data.size();
+    CHECK_EQ(buffer.Size(), count);
+    CHECK_EQ(buffer.Empty(), count == 0);
+    CHECK_EQ(buffer.Full(), count == buffer.GetCapacity());
+    if (count > 0) {
+        CHECK(SameValue(buffer.GetLatest(), reference.data.back()));
+    }
+    for (size_t i = 0; i < count; i++) {
+        CHECK(SameValue(buffer.Get(i), reference.data[i]));
+    }
+
+    // 全部读取与等间隔抽取
+    size_t max_points = (count > 1) ? 1 + test::RandomIndex(count) : 0;
+    for (size_t points : {size_t(0), max_points}) {
+        std::vector<T> continuous;
+        size_t n = buffer.GetContinuousData(continuous, points);
+        size_t expected_n = (points > 0 && count > points) ? points : count;
+        size_t step = (expected_n < count) ? count / expected_n : 1;
+        CHECK_EQ(n, expected_n);
+        CHECK_EQ(continuous.size(), expected_n);
+        for (size_t i = 0; i < n && i < continuous.size(); i++) {
+            CHECK(SameValue(continuous[i], reference.data[i * step]));
+        }
+
+        std::vector<double> timestamps;
+        std::vector<float> values;
+        n = buffer.GetXYValues(timestamps, values, points);
+        CHECK_EQ(n, expected_n);
+        for (size_t i = 0; i < n && i < values.size(); i++) {
+            CHECK_EQ(timestamps[i], TimestampOf(reference.data[i * step], i));
+            CHECK_EQ(values[i], ValueOf(reference.data[i * step]));
+        }
+    }
+
+    // 任意一段拷贝（可能跨越环形边界）
+    if (count > 0) {
+        size_t start = test::RandomIndex(count);
+        size_t length = test::RandomIndex(count - start + 1);
+        std::vector<T> copy(length);
+        buffer.CopyTo(start, length, copy.data());
+        for (size_t i = 0; i < length; i++) {
+            CHECK(SameValue(copy[i], reference.data[start + i]));
+        }
+    }
+}
+
+/**
+ * @brief 单调数据上的二分查找
+ */
+void CompareSearches(const CircularBuffer<double>& buffer, const ReferenceBuffer<double>& reference,
+                     double low_limit, double high_limit) {
+    const std::deque<double>& data = reference.data;
+    for (int k = 0; k < 8; k++) {
+        double value = std::floor(test::RandomFloat(static_cast<float>(low_limit) - 2.0f,
+                                                    static_cast<float>(high_limit) + 2.0f));
+        size_t lower = static_cast<size_t>(std::lower_bound(data.begin(), data.end(), value) - data.begin());
+        size_t upper = static_cast<size_t>(std::upper_bound(data.begin(), data.end(), value) - data.begin());
+        CHECK_EQ(buffer.LowerBound(value), lower);
+        CHECK_EQ(buffer.UpperBound(value), upper);
+
+        double high = value + std::floor(test::RandomFloat(0.0f, 6.0f));
+        size_t end = static_cast<size_t>(std::upper_bound(data.begin(), data.end(), high) - data.begin());
+        size_t start = 0;
+        size_t length = buffer.FindRange(value, high, start);
+        CHECK_EQ(start, lower);
+        CHECK_EQ(length, (end > lower) ? end - lower : size_t(0));
+    }
+}
+
+/**
+ * @brief 对一个缓冲区执行随机操作序列，每步比较一次
+ * @param next_value 生成下一个写入值（单调数据由调用者保证不减）
+ * @param after_step 每步之后的额外检查
+ */
+template<typename T, typename NextValue, typename AfterStep>
+void RunRandomOps(size_t requested_capacity, size_t steps, NextValue next_value, AfterStep after_step) {
+    CircularBuffer<T> buffer(requested_capacity);
+    ReferenceBuffer<T> reference{CircularBuffer<T>::RoundCapacity(requested_capacity), {}};
+    CHECK_EQ(buffer.GetCapacity(), reference.capacity);
+    CHECK(buffer.GetCapacity() >= requested_capacity);
+
+    std::vector<T> batch;
+    for (size_t step = 0; step < steps; step++) {
+        switch (test::RandomIndex(10)) {
+            case 0: case 1: case 2: {
+                T value = next_value();
+                buffer.Push(value);
+                reference.Push(value);
+                break;
+            }
+            case 3: case 4: {
+                // 长度可超过容量（只保留最后capacity个）
+                batch.resize(test::RandomIndex(reference.capacity * 2 + 2));
+                for (T& value : batch) value = next_value();
+                buffer.PushBatch(batch.data(), batch.size());
+                for (const T& value : batch) reference.Push(value);
+                break;
+            }
+            case 5: {
+                T value = next_value();
+                size_t length = test::RandomIndex(reference.capacity * 2 + 2);
+                buffer.PushFill(value, length);
+                for (size_t i = 0; i < length; i++) reference.Push(value);
+                break;
+            }
+            case 6: case 7: {
+                size_t pops = test::RandomIndex(4);
+                for (size_t i = 0; i < pops; i++) {
+                    buffer.PopFront();
+                    reference.PopFront();
+                }
+                break;
+            }
+            case 8: {
+                // 部分写入后清空：head不在0，之后未满时最旧元素也不在下标0
+                if (test::RandomIndex(4) == 0) {
+                    buffer.Clear();
+                    reference.data.clear();
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        CompareReads(buffer, reference);
+        after_step(buffer, reference);
+    }
+}
+
+size_t RandomCapacity() {
+    return 1 + test::RandomIndex(256);
+}
+
+} // namespace
+
+TEST_CASE(CircularBuffer, RoundCapacity) {
+    CHECK_EQ(CircularBuffer<float>::RoundCapacity(0), size_t(0));
+    CHECK_EQ(CircularBuffer<float>::RoundCapacity(1), size_t(1));
+    CHECK_EQ(CircularBuffer<float>::RoundCapacity(2), size_t(2));
+    CHECK_EQ(CircularBuffer<float>::RoundCapacity(3), size_t(4));
+    CHECK_EQ(CircularBuffer<float>::RoundCapacity(1000), size_t(1024));
+    CHECK_EQ(CircularBuffer<float>::RoundCapacity(1024), size_t(1024));
+}
+
+TEST_CASE(CircularBuffer, DifferentialFloat) {
+    for (int round = 0; round < 1500; round++) {
+        RunRandomOps<float>(RandomCapacity(), 40,
+            [] { return test::RandomFloat(-1000.0f, 1000.0f); },
+            [](const CircularBuffer<float>&, const ReferenceBuffer<float>&) {});
+    }
+}
+
+TEST_CASE(CircularBuffer, DifferentialDataPoint) {
+    double time = 0.0;
+    for (int round = 0; round < 500; round++) {
+        RunRandomOps<DataPoint>(RandomCapacity(), 40,
+            [&time] {
+                time += 0.001;
+                return DataPoint(time, test::RandomFloat(-1.0f, 1.0f));
+            },
+            [](const CircularBuffer<DataPoint>&, const ReferenceBuffer<DataPoint>&) {});
+    }
+}
+
+TEST_CASE(CircularBuffer, DifferentialSearch) {
+    for (int round = 0; round < 1500; round++) {
+        // 整数步长的不减序列（含重复值），与时间戳列相同的使用方式
+        double value = 0.0;
+        RunRandomOps<double>(RandomCapacity(), 40,
+            [&value] {
+                value += static_cast<double>(test::RandomIndex(3));
+                return value;
+            },
+            [&value](const CircularBuffer<double>& buffer, const ReferenceBuffer<double>& reference) {
+                CompareSearches(buffer, reference, 0.0, value);
+            });
+    }
+}
+
+TEST_CASE(CircularBuffer, SetCapacityClears) {
+    CircularBuffer<float> buffer(8);
+    for (int i = 0; i < 13; i++) buffer.Push(static_cast<float>(i));
+    buffer.SetCapacity(5);
+    CHECK_EQ(buffer.GetCapacity(), size_t(8));
+    CHECK_EQ(buffer.Size(), size_t(0));
+    buffer.SetCapacity(20);
+    CHECK_EQ(buffer.GetCapacity(), size_t(32));
+    for (int i = 0; i < 40; i++) buffer.Push(static_cast<float>(i));
+    CHECK_EQ(buffer.Size(), size_t(32));
+    CHECK_EQ(buffer.Get(0), 8.0f);
+    CHECK_EQ(buffer.GetLatest(), 39.0f);
+}
@@ -0,0 +1,100 @@
+/**
+ * @file test_CustomParser.cpp
+ * @brief CustomParser测试 - 帧尾错误后的重新同步、校验失败丢帧、分块输入
+ * @author AI Assistant
+ * @date 2025
+ */
+
+#include "TestHarness.h"
+#include "../imgui_ui/protocols/CustomParser.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief 按chunk字节分块解析整段数据，返回所有输出帧（按帧展开）
+ */
+std::vector<float> ParseAll(CustomParser& parser, const std::vector<unsigned char>& stream, size_t chunk) {
+    std::vector<float> values;
+    float out[64 * 4];
+    for (size_t pos = 0; pos < stream.size(); pos += chunk) {
+        size_t length = std::min(chunk, stream.size() - pos);
+        size_t offset = 0;
+        while (offset < length) {
+            BatchParseResult result = parser.ParseBatch(stream.data() + pos + offset, length - offset, out, 64, 4);
+            values.insert(values.end(), out, out + result.frames * result.channels);
+            offset += result.bytes_consumed;
+        }
+    }
+    return values;
+}
+
+CustomProtocolConfig Uint8Config(std::vector<unsigned char> header, std::vector<unsigned char> tail) {
+    CustomProtocolConfig config;
+    config.frame_header = std::move(header);
+    config.frame_tail = std::move(tail);
+    config.channel_types = {DataType::UINT8, DataType::UINT8};
+    return config;
+}
+
+} // namespace
+
+TEST_CASE(CustomParser, HeaderlessTailMismatchKeepsByte) {
+    // 第一帧帧尾位置收到7：丢弃本帧，7作为下一帧的首个数据字节
+    const std::vector<unsigned char> stream = {5, 6, 7, 8, 0x0A, 1, 2, 0x0A};
+    for (size_t chunk : {size_t(1), size_t(3), stream.size()}) {
+        CustomParser parser(Uint8Config({}, {0x0A}));
+        std::vector<float> values = ParseAll(parser, stream, chunk);
+        CHECK(values == (std::vector<float>{7.0f, 8.0f, 1.0f, 2.0f}));
+        CHECK_EQ(parser.GetRejectedFrames(ParseError::TAIL_MISMATCH), uint64_t(1));
+    }
+}
+
+TEST_CASE(CustomParser, TailMismatchResyncsOnHeader) {
+    // 帧尾位置收到的是下一帧的帧头
+    const std::vector<unsigned char> stream = {0xAA, 1, 2, 0xAA, 3, 4, 0x7F, 0xAA, 5, 6, 0x7F};
+    for (size_t chunk : {size_t(1), size_t(4), stream.size()}) {
+        CustomParser parser(Uint8Config({0xAA}, {0x7F}));
+        std::vector<float> values = ParseAll(parser, stream, chunk);
+        CHECK(values == (std::vector<float>{3.0f, 4.0f, 5.0f, 6.0f}));
+        CHECK_EQ(parser.GetRejectedFrames(ParseError::TAIL_MISMATCH), uint64_t(1));
+    }
+}
+
+TEST_CASE(CustomParser, ChecksumMismatchDropsFrame) {
+    CustomProtocolConfig config = Uint8Config({0x55, 0xAA}, {0x0D, 0x0A});
+    config.use_checksum = true;
+    config.checksum_type = ChecksumType::SUM8;
+    config.checksum_range_start = 2;    // 只校验数据区
+    CustomParser parser(config);
+
+    const std::vector<unsigned char> stream = {
+        0x55, 0xAA, 10, 20, 30, 0x0D, 0x0A,     // 校验正确
+        0x55, 0xAA, 11, 20, 30, 0x0D, 0x0A,     // 数据损坏
+        0x55, 0xAA, 1, 2, 3, 0x0D, 0x0A         // 校验正确
+    };
+    std::vector<float> values = ParseAll(parser, stream, stream.size());
+    CHECK(values == (std::vector<float>{10.0f, 20.0f, 1.0f, 2.0f}));
+    CHECK_EQ(parser.GetRejectedFrames(ParseError::CHECKSUM_MISMATCH), uint64_t(1));
+    CHECK_EQ(parser.GetTotalRejectedFrames(), uint64_t(1));
+}
+
+TEST_CASE(CustomParser, ChecksumRangeEnd) {
+    CustomProtocolConfig config = Uint8Config({0x55, 0xAA}, {0x0D, 0x0A});
+    config.channel_types = {DataType::UINT8, DataType::UINT8, DataType::UINT8};
+    config.use_checksum = true;
+    config.checksum_type = ChecksumType::SUM8;
+    config.checksum_range_start = 2;
+    config.checksum_range_end = 4;      // 只校验前两个数据字节
+    CustomParser parser(config);
+
+    const std::vector<unsigned char> stream = {
+        0x55, 0xAA, 10, 20, 99, 30, 0x0D, 0x0A,     // 第三个字节不在校验范围内
+        0x55, 0xAA, 11, 20, 1, 30, 0x0D, 0x0A       // 范围内数据损坏
+    };
+    std::vector<float> values = ParseAll(parser, stream, stream.size());
+    CHECK(values == (std::vector<float>{10.0f, 20.0f, 99.0f}));
+    CHECK_EQ(parser.GetRejectedFrames(ParseError::CHECKSUM_MISMATCH), uint64_t(1));
+}
@@ -0,0 +1,218 @@
+/**
+ * @file test_DataChannelManager.cpp
+ * @brief DataChannelManager测试 - 快照数值按请求拷贝、写入顺序校验、调整中的深度请求不丢失、波形随快照发布
+ * @author AI Assistant
+ * @date 2025
+ */
+
+#include "TestHarness.h"
+#include "../imgui_ui/core/DataChannelManager.h"
+
+#include <chrono>
+#include <thread>
+
+namespace {
+
+/**
+ * @brief 写入frames帧（第f帧第c通道为 基准 + f*10 + c），流位置按帧递增
+ */
+void PushRamp(DataChannelManager& manager, size_t frames, size_t channels, uint64_t& position) {
+    std::vector<float> data(frames * channels);
+    for (size_t f = 0; f < frames; f++) {
+        for (size_t c = 0; c < channels; c++) {
+            data[f * channels + c] = static_cast<float>((position + f) * 10 + c);
+        }
+    }
+    position += frames;
+    manager.PushFrames(data.data(), frames, channels, position);
+}
+
+/**
+ * @brief 有效数值个数
+ */
+size_t ValidValues(const ChannelView& view) {
+    return (view.values.size() > view.first_index) ? view.values.size() - view.first_index : 0;
+}
+
+} // namespace
+
+TEST_CASE(DataChannelManager, SnapshotCopiesOnlyRequestedValues) {
+    DataChannelManager manager;
+    manager.SetChannelCount(4);
+    uint64_t position = 0;
+    PushRamp(manager, 1500, 4, position);
+
+    // 没有请求：只有时间戳，没有数值
+    manager.AcquireSnapshot();
+    PushRamp(manager, 10, 4, position);
+    const ChannelSnapshot* snapshot = &manager.AcquireSnapshot();
+    CHECK_EQ(snapshot->timestamps.size(), size_t(1510));
+    for (const ChannelView& view : snapshot->channels) {
+        CHECK_EQ(ValidValues(view), size_t(0));
+    }
+
+    // 请求通道2的最近100帧：下一次发布的快照只包含它
+    manager.RequestSnapshotValues(2, 100);
+    PushRamp(manager, 10, 4, position);
+    snapshot = &manager.AcquireSnapshot();
+    CHECK_EQ(ValidValues(snapshot->channels[2]), size_t(100));
+    CHECK_EQ(ValidValues(snapshot->channels[0]), size_t(0));
+    CHECK_EQ(snapshot->channels[2].values.back(), static_cast<float>((position - 1) * 10 + 2));
+    CHECK_EQ(snapshot->channels[2].values.size(), snapshot->timestamps.size());
+
+    // 多个请求取最大长度（默认深度2048帧，时间戳为全部已存储的帧）
+    PushRamp(manager, 3000, 4, position);
+    manager.AcquireSnapshot();
+    manager.RequestSnapshotValues(2, 50);
+    manager.RequestSnapshotValues(2, 1200);
+    PushRamp(manager, 10, 4, position);
+    snapshot = &manager.AcquireSnapshot();
+    CHECK_EQ(ValidValues(snapshot->channels[2]), size_t(1200));
+    CHECK_EQ(snapshot->timestamps.size(), DataChannelManager::DEFAULT_CAPACITY);
+
+    // 不再续期：两次获取之后失效
+    for (int frame = 0; frame < 3; frame++) {
+        PushRamp(manager, 10, 4, position);
+        snapshot = &manager.AcquireSnapshot();
+    }
+    CHECK_EQ(ValidValues(snapshot->channels[2]), size_t(0));
+}
+
+TEST_CASE(DataChannelManager, FrameOrderViolations) {
+    DataChannelManager manager;
+    manager.SetChannelCount(2);
+    float frame[2] = {1.0f, 2.0f};
+    manager.PushFrames(frame, 1, 2, 100);
+    manager.PushFrames(frame, 1, 2, 180);
+    CHECK_EQ(manager.GetFrameOrderStats().order_violations, uint64_t(0));
+
+    // 流位置倒退或重复（数据块被重放或乱序）
+    manager.PushFrames(frame, 1, 2, 150);
+    manager.PushFrames(frame, 1, 2, 150);
+    FrameOrderStats order = manager.GetFrameOrderStats();
+    CHECK_EQ(order.order_violations, uint64_t(2));
+    CHECK_EQ(order.frames_pushed, uint64_t(4));
+}
+
+TEST_CASE(DataChannelManager, CapacityRequestsDuringResize) {
+    DataChannelManager manager;
+    manager.SetChannelCount(8);
+    uint64_t position = 0;
+    PushRamp(manager, 300000, 8, position);
+
+    // 第一次调整进行中再次请求：以最后一次请求为准
+    manager.RequestCapacity(size_t(1) << 20);
+    manager.RequestCapacity(size_t(1) << 21);
+    manager.RequestCapacity(4096);
+    CHECK_EQ(manager.GetCapacity(), size_t(4096));
+    while (manager.IsResizing()) {
+        PushRamp(manager, 100, 8, position);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    PushRamp(manager, 10000, 8, position);
+    manager.AcquireSnapshot();
+    manager.RequestSnapshotValues(3, 2000);
+    PushRamp(manager, 1, 8, position);
+    const ChannelSnapshot& snapshot = manager.AcquireSnapshot();
+    CHECK_EQ(snapshot.capacity, size_t(4096));
+    CHECK_EQ(snapshot.stored_frames, size_t(4096));
+    CHECK_EQ(manager.GetChannelSize(3), size_t(4096));
+    const ChannelView& view = snapshot.channels[3];
+    CHECK_EQ(ValidValues(view), size_t(2000));
+    for (size_t i = view.first_index; i < view.values.size(); i++) {
+        uint64_t frame = position - (view.values.size() - i);
+        CHECK_EQ(view.values[i], static_cast<float>(frame * 10 + 3));
+    }
+}
+
+TEST_CASE(DataChannelManager, WaveformPublishedWithSnapshot) {
+    DataChannelManager manager;
+    manager.SetChannelCount(2);
+    uint64_t position = 0;
+    PushRamp(manager, 1500, 2, position);
+
+    std::shared_ptr<WaveformState> waveform = manager.AddWaveform();
+    WaveformRequest request;
+    request.channels = {0, 1};
+    request.max_buckets = 100;
+    request.follow = true;
+    request.span = 1e6;
+
+    // 跟随模式：窗口终点为快照的最新时间戳
+    manager.AcquireSnapshot();
+    manager.RequestWaveform(*waveform, request);
+    PushRamp(manager, 10, 2, position);
+    const ChannelSnapshot* snapshot = &manager.AcquireSnapshot();
+    const WaveformSeries* series = snapshot->FindWaveform(waveform->id, 1);
+    CHECK(series != nullptr);
+    if (series) {
+        CHECK(!series->values.empty());
+        CHECK(series->values.size() <= 4 * request.max_buckets);
+        CHECK_EQ(series->values.size(), series->timestamps.size());
+        CHECK_EQ(series->timestamps.back(), snapshot->timestamps.back());
+        CHECK_EQ(series->values.back(), static_cast<float>((position - 1) * 10 + 1));
+        CHECK_EQ(series->values.front(), 1.0f);
+    }
+
+    // 固定窗口，点数不超过2×分段数：原始数据，两侧各多一帧
+    const std::vector<double>& times = snapshot->timestamps;
+    request.follow = false;
+    request.max_buckets = 1000;
+    request.t_begin = times[times.size() - 300];
+    request.t_end = times[times.size() - 201];
+    manager.AcquireSnapshot();
+    manager.RequestWaveform(*waveform, request);
+    PushRamp(manager, 10, 2, position);
+    snapshot = &manager.AcquireSnapshot();
+    series = snapshot->FindWaveform(waveform->id, 0);
+    CHECK(series != nullptr);
+    if (series) {
+        CHECK(series->values.size() >= 102);
+        CHECK(series->timestamps.front() < request.t_begin);
+        CHECK(series->timestamps.back() > request.t_end);
+        for (size_t i = 1; i < series->values.size(); i++) {
+            CHECK_EQ(series->values[i], series->values[i - 1] + 10.0f);
+        }
+    }
+
+    // 禁用的通道没有数据
+    manager.SetChannelEnabled(1, false);
+    manager.AcquireSnapshot();
+    manager.RequestWaveform(*waveform, request);
+    PushRamp(manager, 10, 2, position);
+    snapshot = &manager.AcquireSnapshot();
+    series = snapshot->FindWaveform(waveform->id, 1);
+    CHECK(series != nullptr && series->values.empty());
+
+    // 不再续期：两次获取之后失效
+    for (int frame = 0; frame < 3; frame++) {
+        PushRamp(manager, 10, 2, position);
+        snapshot = &manager.AcquireSnapshot();
+    }
+    CHECK(snapshot->FindWaveform(waveform->id, 0) == nullptr);
+}
+
+TEST_CASE(DataChannelManager, WaveformPublishedWithoutWrites) {
+    DataChannelManager manager;
+    manager.SetChannelCount(1);
+    uint64_t position = 0;
+    PushRamp(manager, 1000, 1, position);
+
+    // 没有写入：请求变化由空闲发布线程发布
+    std::shared_ptr<WaveformState> waveform = manager.AddWaveform();
+    WaveformRequest request;
+    request.channels = {0};
+    request.max_buckets = 200;
+    const WaveformSeries* series = nullptr;
+    for (int frame = 0; frame < 200 && !series; frame++) {
+        const ChannelSnapshot& snapshot = manager.AcquireSnapshot();
+        manager.RequestWaveform(*waveform, request);
+        series = snapshot.FindWaveform(waveform->id, 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    CHECK(series != nullptr);
+    if (series) {
+        CHECK_EQ(series->values.back(), static_cast<float>((position - 1) * 10));
+    }
+}
@@ -0,0 +1,134 @@
+/**
+ * @file test_FireWaterParser.cpp
+ * @brief FireWaterParser测试 - 随机分块下的帧切片、跨块拼接、垃圾字节后的重新同步
+ * @author AI Assistant
+ * @date 2025
+ */
+
+#include "TestHarness.h"
+#include "../imgui_ui/protocols/FireWaterParser.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const unsigned char TAIL[4] = {0x00, 0x00, 0x80, 0x7F};
+
+/**
+ * @brief 测试数据：字节流、编码的通道值（按帧展开）和插入的垃圾段数
+ */
+struct TestStream {
+    std::vector<unsigned char> bytes;
+    std::vector<float> values;
+    size_t garbage_regions = 0;
+};
+
+/**
+ * @brief 生成FireWater字节流；corrupt_every > 0时每隔约corrupt_every帧在帧间插入1~40字节垃圾
+ *
+ * 垃圾字节不含0x00，不会与数据拼出帧尾。
+ */
+TestStream MakeStream(size_t channels, size_t frames, size_t corrupt_every) {
+    TestStream stream;
+    for (size_t f = 0; f < frames; f++) {
+        if (corrupt_every > 0 && f > 0 && test::RandomIndex(corrupt_every) == 0) {
+            size_t garbage = 1 + test::RandomIndex(40);
+            for (size_t i = 0; i < garbage; i++) {
+                stream.bytes.push_back(static_cast<unsigned char>(1 + test::RandomIndex(255)));
+            }
+            stream.garbage_regions++;
+        }
+        for (size_t c = 0; c < channels; c++) {
+            float value = test::RandomFloat(-1000.0f, 1000.0f);
+            unsigned char bytes[4];
+            std::memcpy(bytes, &value, sizeof(value));
+            stream.bytes.insert(stream.bytes.end(), bytes, bytes + 4);
+            stream.values.push_back(value);
+        }
+        stream.bytes.insert(stream.bytes.end(), TAIL, TAIL + 4);
+    }
+    return stream;
+}
+
+/**
+ * @brief 按随机长度分块解析，每次调用最多输出max_frames帧
+ */
+std::vector<float> ParseChunked(FireWaterParser& parser, const std::vector<unsigned char>& bytes,
+                                size_t channels, size_t max_chunk, size_t max_frames) {
+    std::vector<float> values;
+    std::vector<float> out(max_frames * channels);
+    size_t pos = 0;
+    while (pos < bytes.size()) {
+        size_t length = std::min(1 + test::RandomIndex(max_chunk), bytes.size() - pos);
+        size_t offset = 0;
+        while (offset < length) {
+            BatchParseResult result = parser.ParseBatch(bytes.data() + pos + offset, length - offset,
+                                                        out.data(), max_frames, channels);
+            CHECK(result.frames <= max_frames);
+            values.insert(values.end(), out.begin(), out.begin() + result.frames * result.channels);
+            offset += result.bytes_consumed;
+        }
+        pos += length;
+    }
+    return values;
+}
+
+} // namespace
+
+TEST_CASE(FireWaterParser, CleanStreamRandomChunks) {
+    for (size_t channels : {size_t(1), size_t(4), size_t(13)}) {
+        const size_t frame_bytes = channels * 4 + 4;
+        TestStream stream = MakeStream(channels, 2000, 0);
+        for (size_t max_chunk : {size_t(1), frame_bytes - 1, frame_bytes * 3, size_t(4096)}) {
+            FireWaterParser parser(channels);
+            std::vector<float> values = ParseChunked(parser, stream.bytes, channels, max_chunk, 64);
+            CHECK(values == stream.values);
+            CHECK_EQ(parser.GetTotalRejectedFrames(), uint64_t(0));
+            CHECK_EQ(parser.GetResyncCount(), uint64_t(0));
+        }
+    }
+}
+
+TEST_CASE(FireWaterParser, GarbageStreamRandomChunks) {
+    for (size_t channels : {size_t(1), size_t(4), size_t(13)}) {
+        const size_t frame_bytes = channels * 4 + 4;
+        TestStream stream = MakeStream(channels, 2000, 20);
+        CHECK(stream.garbage_regions > 0);
+        for (size_t max_chunk : {size_t(1), frame_bytes - 1, frame_bytes * 3, size_t(4096)}) {
+            FireWaterParser parser(channels);
+            std::vector<float> values = ParseChunked(parser, stream.bytes, channels, max_chunk, 64);
+            // 垃圾只插在帧之间：所有帧都应解出，每段垃圾计一次帧尾错误
+            CHECK(values == stream.values);
+            CHECK_EQ(parser.GetRejectedFrames(ParseError::TAIL_MISMATCH), uint64_t(stream.garbage_regions));
+            CHECK_EQ(parser.GetResyncCount(), uint64_t(stream.garbage_regions));
+        }
+    }
+}
+
+TEST_CASE(FireWaterParser, OutputLimitLeavesBytes) {
+    const size_t channels = 4;
+    TestStream stream = MakeStream(channels, 500, 10);
+    FireWaterParser parser(channels);
+    // 每次最多输出1帧：bytes_consumed小于输入长度，剩余字节由调用方继续解析
+    std::vector<float> values = ParseChunked(parser, stream.bytes, channels, 4096, 1);
+    CHECK(values == stream.values);
+}
+
+TEST_CASE(FireWaterParser, ResetDropsCarry) {
+    const size_t channels = 2;
+    TestStream stream = MakeStream(channels, 2, 0);
+    FireWaterParser parser(channels);
+    float out[8];
+
+    // 半帧进入carry_，Reset后不应与新数据拼接
+    BatchParseResult result = parser.ParseBatch(stream.bytes.data(), 5, out, 4, channels);
+    CHECK_EQ(result.frames, size_t(0));
+    parser.Reset();
+    const size_t frame_bytes = channels * 4 + 4;
+    result = parser.ParseBatch(stream.bytes.data() + frame_bytes, frame_bytes, out, 4, channels);
+    CHECK_EQ(result.frames, size_t(1));
+    CHECK_EQ(out[0], stream.values[2]);
+    CHECK_EQ(out[1], stream.values[3]);
+}
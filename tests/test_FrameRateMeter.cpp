@@ -0,0 +1,77 @@
+/**
+ * @file test_FrameRateMeter.cpp
+ * @brief FrameRateMeter测试 - 帧率与读取分块无关、停顿后重新测量
+ * @author AI Assistant
+ * @date 2025
+ */
+
+#include "TestHarness.h"
+#include "../imgui_ui/core/FrameRateMeter.h"
+
+namespace {
+
+/**
+ * @brief 模拟以rate帧/秒发送的设备，按随机间隔（1~max_gap_ms毫秒）成批读取
+ * @return 最后一次读取的时刻
+ */
+double FeedDevice(FrameRateMeter& meter, double rate, double start, double duration, int max_gap_ms,
+                  uint64_t& frames) {
+    double time = start;
+    double emitted = static_cast<double>(frames);
+    while (time < start + duration) {
+        double gap = (1.0 + static_cast<double>(test::RandomIndex(static_cast<size_t>(max_gap_ms)))) * 1e-3;
+        time += gap;
+        emitted += rate * gap;
+        frames = static_cast<uint64_t>(emitted);
+        meter.Record(time, frames);
+    }
+    return time;
+}
+
+} // namespace
+
+TEST_CASE(FrameRateMeter, IndependentOfBatching) {
+    for (int max_gap_ms : {2, 20, 60}) {
+        for (double rate : {50.0, 1000.0, 20000.0}) {
+            FrameRateMeter meter;
+            uint64_t frames = 0;
+            FeedDevice(meter, rate, 0.0, 10.0, max_gap_ms, frames);
+            CHECK_NEAR(meter.GetRate(), rate, 0.03 * rate + 1.0);
+        }
+    }
+}
+
+TEST_CASE(FrameRateMeter, FollowsRateChange) {
+    FrameRateMeter meter;
+    uint64_t frames = 0;
+    double time = FeedDevice(meter, 1000.0, 0.0, 5.0, 30, frames);
+    CHECK_NEAR(meter.GetRate(), 1000.0, 30.0);
+    // 窗口约4秒：新频率持续一个窗口后完全取代旧值
+    FeedDevice(meter, 250.0, time, 6.0, 30, frames);
+    CHECK_NEAR(meter.GetRate(), 250.0, 10.0);
+}
+
+TEST_CASE(FrameRateMeter, NeedsMinimumSpan) {
+    FrameRateMeter meter;
+    CHECK_EQ(meter.GetRate(), 0.0);
+    uint64_t frames = 0;
+    FeedDevice(meter, 1000.0, 0.0, 0.3, 10, frames);
+    CHECK_EQ(meter.GetRate(), 0.0);
+    meter.Reset();
+    CHECK_EQ(meter.GetRate(), 0.0);
+}
+
+TEST_CASE(FrameRateMeter, RestartsAfterPauseOrClear) {
+    FrameRateMeter meter;
+    uint64_t frames = 0;
+    double time = FeedDevice(meter, 1000.0, 0.0, 3.0, 20, frames);
+
+    // 停顿超过整个窗口：停顿前的记录不参与计算（否则帧率被拉低）
+    time = FeedDevice(meter, 1000.0, time + 30.0, 2.0, 20, frames);
+    CHECK_NEAR(meter.GetRate(), 1000.0, 30.0);
+
+    // 累计帧数清零（清空数据）
+    frames = 0;
+    FeedDevice(meter, 500.0, time, 2.0, 20, frames);
+    CHECK_NEAR(meter.GetRate(), 500.0, 15.0);
+}
@@ -0,0 +1,94 @@
+/**
+ * @file test_IngestThread.cpp
+ * @brief IngestThread测试 - 字节与数据块流位置按顺序交给处理函数
+ * @author AI Assistant
+ * @date 2025
+ */
+
+#include "TestHarness.h"
+#include "../imgui_ui/core/IngestThread.h"
+
+#include <thread>
+
+namespace {
+
+/**
+ * @brief 处理函数收到的一次调用
+ */
+struct Call {
+    uint64_t stream_offset;
+    size_t length;
+};
+
+} // namespace
+
+TEST_CASE(IngestThread, StreamOffsetsFollowBytes) {
+    // 小环：生产者频繁等待消费者，数据多次跨越环末尾
+    IngestThread ingest(4096);
+    std::vector<unsigned char> received;
+    std::vector<Call> calls;
+    ingest.Start([&](const unsigned char* data, size_t length, uint64_t stream_offset) {
+        received.insert(received.end(), data, data + length);
+        calls.push_back(Call{stream_offset, length});
+    });
+
+    std::vector<size_t> lengths(20000);
+    for (size_t& length : lengths) length = 1 + test::RandomIndex(300);
+    std::thread producer([&] {
+        unsigned char chunk[300];
+        uint64_t offset = 0;
+        for (size_t length : lengths) {
+            for (size_t i = 0; i < length; i++) chunk[i] = static_cast<unsigned char>((offset + i) * 131 >> 3);
+            while (!ingest.Push(chunk, length, offset)) std::this_thread::yield();
+            offset += length;
+        }
+    });
+    producer.join();
+    ingest.Stop();
+
+    // 丢弃的数据块不计入；这里生产者重试，所有字节都应按顺序到达
+    uint64_t total = 0;
+    for (size_t length : lengths) total += length;
+    CHECK_EQ(uint64_t(received.size()), total);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < received.size(); i++) {
+        if (received[i] != static_cast<unsigned char>(uint64_t(i) * 131 >> 3)) mismatches++;
+    }
+    CHECK_EQ(mismatches, size_t(0));
+
+    // 每次调用的流位置等于之前收到的字节数
+    uint64_t expected = 0;
+    for (const Call& call : calls) {
+        CHECK_EQ(call.stream_offset, expected);
+        expected += call.length;
+    }
+    // 连续数据块被合并：调用次数远少于数据块数
+    CHECK(calls.size() < lengths.size());
+}
+
+TEST_CASE(IngestThread, GapsSplitRuns) {
+    IngestThread ingest(1 << 16);
+    std::vector<Call> calls;
+    ingest.Start([&](const unsigned char*, size_t length, uint64_t stream_offset) {
+        calls.push_back(Call{stream_offset, length});
+    });
+
+    // 流位置有空缺（如上游丢弃）时不与前一块合并，位置原样交给处理函数
+    unsigned char chunk[100] = {};
+    CHECK(ingest.Push(chunk, 100, 1000));
+    CHECK(ingest.Push(chunk, 50, 1100));
+    CHECK(ingest.Push(chunk, 10, 5000));
+    ingest.Stop();
+
+    uint64_t bytes = 0;
+    bool saw_gap = false;
+    for (const Call& call : calls) {
+        bytes += call.length;
+        if (call.stream_offset == 5000) saw_gap = true;
+        CHECK(call.stream_offset >= 1000);
+    }
+    CHECK_EQ(bytes, uint64_t(160));
+    CHECK(saw_gap);
+    CHECK_EQ(calls.front().stream_offset, uint64_t(1000));
+    CHECK_EQ(calls.back().stream_offset + calls.back().length, uint64_t(5010));
+}
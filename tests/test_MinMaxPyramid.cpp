@@ -0,0 +1,174 @@
+/**
+ * @file test_MinMaxPyramid.cpp
+ * @brief MinMaxPyramid随机差分测试 - Aggregate/Query与直接扫描原始数据比较
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 数值列与金字塔同步写入（Push/PushBatch/PushEmpty，含NaN），数值列回绕后
+ * 只查询仍在列中的帧；最小/最大值及其所在帧（相同值取最早的）、和、有效值个数
+ * 都与直接扫描的结果比较。
+ */
+
+#include "TestHarness.h"
+#include "../imgui_ui/core/MinMaxPyramid.h"
+
+#include <limits>
+
+namespace {
+
+/**
+ * @brief 直接扫描[begin, end)
+ */
+EnvelopeAggregate ScanRaw(const CircularBuffer<float>& raw, uint64_t end_frame, uint64_t begin, uint64_t end) {
+    EnvelopeAggregate result;
+    uint64_t raw_first = end_frame - raw.Size();
+    for (uint64_t frame = begin; frame < end; frame++) {
+        result.Add(raw.Get(static_cast<size_t>(frame - raw_first)), frame);
+    }
+    return result;
+}
+
+void CompareAggregate(const EnvelopeAggregate& actual, const EnvelopeAggregate& expected) {
+    CHECK_EQ(actual.count, expected.count);
+    if (expected.count == 0) return;
+    CHECK_EQ(actual.min_value, expected.min_value);
+    CHECK_EQ(actual.max_value, expected.max_value);
+    CHECK_EQ(actual.min_frame, expected.min_frame);
+    CHECK_EQ(actual.max_frame, expected.max_frame);
+    CHECK_NEAR(actual.sum, expected.sum, 1e-6 * (1.0 + std::fabs(expected.sum)) + 1e-3);
+}
+
+/**
+ * @brief 写入随机数据（小整数值，制造大量相同的最值）
+ */
+void WriteRandom(CircularBuffer<float>& raw, MinMaxPyramid& pyramid, size_t frames) {
+    std::vector<float> batch;
+    size_t written = 0;
+    while (written < frames) {
+        size_t length = std::min(frames - written, 1 + test::RandomIndex(700));
+        switch (test::RandomIndex(4)) {
+            case 0:
+                for (size_t i = 0; i < length; i++) {
+                    float value = static_cast<float>(test::RandomIndex(50)) - 25.0f;
+                    if (test::RandomIndex(20) == 0) value = std::numeric_limits<float>::quiet_NaN();
+                    raw.Push(value);
+                    pyramid.Push(value);
+                }
+                break;
+            case 1:
+                raw.PushFill(std::numeric_limits<float>::quiet_NaN(), length);
+                pyramid.PushEmpty(length);
+                break;
+            default:
+                batch.resize(length);
+                for (float& value : batch) {
+                    value = static_cast<float>(test::RandomIndex(1000)) - 500.0f;
+                    if (test::RandomIndex(50) == 0) value = std::numeric_limits<float>::quiet_NaN();
+                }
+                raw.PushBatch(batch.data(), batch.size());
+                pyramid.PushBatch(batch.data(), batch.size());
+                break;
+        }
+        written += length;
+    }
+}
+
+/**
+ * @brief 随机区间：大部分很长（走高层桶），一部分很短（只扫描原始数据）
+ */
+void RandomRange(uint64_t first, uint64_t end_frame, uint64_t& begin, uint64_t& end) {
+    uint64_t available = end_frame - first;
+    begin = first + test::RandomIndex(static_cast<size_t>(available));
+    uint64_t max_length = end_frame - begin;
+    uint64_t length = (test::RandomIndex(4) == 0) ? 1 + test::RandomIndex(static_cast<size_t>(std::min<uint64_t>(max_length, 300)))
+                                                  : 1 + test::RandomIndex(static_cast<size_t>(max_length));
+    end = begin + length;
+}
+
+} // namespace
+
+TEST_CASE(MinMaxPyramid, AggregateMatchesScan) {
+    for (size_t capacity : {size_t(1024), size_t(8192), size_t(65536)}) {
+        CircularBuffer<float> raw(capacity);
+        MinMaxPyramid pyramid;
+        pyramid.SetCapacity(capacity);
+
+        // 先写满，再持续写入使数值列回绕；每轮之后随机查询
+        for (int round = 0; round < 12; round++) {
+            WriteRandom(raw, pyramid, capacity / 3 + test::RandomIndex(capacity));
+            uint64_t end_frame = pyramid.GetEndFrame();
+            uint64_t first = end_frame - raw.Size();
+            for (int query = 0; query < 40; query++) {
+                uint64_t begin, end;
+                RandomRange(first, end_frame, begin, end);
+                CompareAggregate(pyramid.Aggregate(raw, begin, end), ScanRaw(raw, end_frame, begin, end));
+            }
+        }
+    }
+}
+
+TEST_CASE(MinMaxPyramid, QueryMatchesScan) {
+    const size_t capacity = 32768;
+    CircularBuffer<float> raw(capacity);
+    MinMaxPyramid pyramid;
+    pyramid.SetCapacity(capacity);
+
+    std::vector<EnvelopeAggregate> output;
+    for (int round = 0; round < 10; round++) {
+        WriteRandom(raw, pyramid, 5000 + test::RandomIndex(capacity));
+        uint64_t end_frame = pyramid.GetEndFrame();
+        uint64_t first = end_frame - raw.Size();
+        for (int query = 0; query < 30; query++) {
+            uint64_t begin, end;
+            RandomRange(first, end_frame, begin, end);
+            size_t max_buckets = 1 + test::RandomIndex(2000);
+            size_t buckets = pyramid.Query(raw, begin, end, max_buckets, output);
+            CHECK_EQ(buckets, output.size());
+            CHECK(buckets <= max_buckets + 2);
+
+            // 各桶合起来与整个区间一致；每个桶的最值确实在区间内、且等于该帧的原始值
+            float total_min = std::numeric_limits<float>::infinity();
+            float total_max = -std::numeric_limits<float>::infinity();
+            double total_sum = 0.0;
+            uint64_t total_count = 0;
+            uint64_t previous_frame = 0;
+            for (const EnvelopeAggregate& bucket : output) {
+                if (bucket.Empty()) continue;
+                CHECK(bucket.min_frame >= begin && bucket.min_frame < end);
+                CHECK(bucket.max_frame >= begin && bucket.max_frame < end);
+                CHECK_EQ(raw.Get(static_cast<size_t>(bucket.min_frame - first)), bucket.min_value);
+                CHECK_EQ(raw.Get(static_cast<size_t>(bucket.max_frame - first)), bucket.max_value);
+                // 桶按帧从旧到新输出
+                CHECK(std::min(bucket.min_frame, bucket.max_frame) >= previous_frame);
+                previous_frame = std::max(bucket.min_frame, bucket.max_frame);
+
+                total_min = std::min(total_min, bucket.min_value);
+                total_max = std::max(total_max, bucket.max_value);
+                total_sum += bucket.sum;
+                total_count += bucket.count;
+            }
+            EnvelopeAggregate expected = ScanRaw(raw, end_frame, begin, end);
+            CHECK_EQ(total_count, expected.count);
+            if (expected.count > 0) {
+                CHECK_EQ(total_min, expected.min_value);
+                CHECK_EQ(total_max, expected.max_value);
+                CHECK_NEAR(total_sum, expected.sum, 1e-6 * (1.0 + std::fabs(expected.sum)) + 1e-3);
+            }
+        }
+    }
+}
+
+TEST_CASE(MinMaxPyramid, ResetStartsAtFrame) {
+    CircularBuffer<float> raw(4096);
+    MinMaxPyramid pyramid;
+    pyramid.SetCapacity(4096);
+    WriteRandom(raw, pyramid, 3000);
+
+    raw.Clear();
+    pyramid.Reset(123456);
+    CHECK_EQ(pyramid.GetEndFrame(), uint64_t(123456));
+    WriteRandom(raw, pyramid, 2500);
+    uint64_t end_frame = pyramid.GetEndFrame();
+    CHECK_EQ(end_frame, uint64_t(123456 + 2500));
+    CompareAggregate(pyramid.Aggregate(raw, 123456, end_frame), ScanRaw(raw, end_frame, 123456, end_frame));
+}
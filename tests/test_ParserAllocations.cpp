@@ -0,0 +1,211 @@
+/**
+ * @file test_ParserAllocations.cpp
+ * @brief 解析器分配测试 - 预热后Parse/ParseBatch每帧零堆分配
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 本文件替换全局operator new/delete，只计数、不改变分配行为；
+ * 计数对core_tests中的所有测试生效，这里只比较解析前后的差值。
+ */
+
+#include "TestHarness.h"
+#include "../imgui_ui/protocols/CsvParser.h"
+#include "../imgui_ui/protocols/CustomParser.h"
+#include "../imgui_ui/protocols/FireWaterParser.h"
+#include "../imgui_ui/protocols/JustFloatParser.h"
+#include "../imgui_ui/protocols/RawDataParser.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+namespace {
+
+std::atomic<size_t> g_allocations{0};   // 进程内operator new调用次数
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+const size_t CHANNELS = 4;
+const size_t FRAMES = 500;
+const size_t CHUNK = 37;                // 与帧长互质，帧跨越分块边界
+
+/**
+ * @brief 测试数据：字节流及其编码的通道值（按帧展开）
+ */
+struct TestStream {
+    std::vector<unsigned char> bytes;
+    std::vector<float> values;
+};
+
+void AppendFloat(std::vector<unsigned char>& stream, float value) {
+    unsigned char bytes[4];
+    std::memcpy(bytes, &value, sizeof(value));
+    stream.insert(stream.end(), bytes, bytes + 4);
+}
+
+/**
+ * @brief 二进制帧流：[帧头][CHANNELS个float][帧尾]，每隔17帧插入3字节垃圾
+ */
+TestStream MakeBinaryStream(const std::vector<unsigned char>& header,
+                            const std::vector<unsigned char>& tail, bool garbage) {
+    TestStream stream;
+    for (size_t f = 0; f < FRAMES; f++) {
+        stream.bytes.insert(stream.bytes.end(), header.begin(), header.end());
+        for (size_t c = 0; c < CHANNELS; c++) {
+            float value = static_cast<float>(f) + 0.25f * static_cast<float>(c);
+            AppendFloat(stream.bytes, value);
+            stream.values.push_back(value);
+        }
+        stream.bytes.insert(stream.bytes.end(), tail.begin(), tail.end());
+        if (garbage && f % 17 == 16) {
+            stream.bytes.insert(stream.bytes.end(), {0x12, 0x34, 0x56});
+        }
+    }
+    return stream;
+}
+
+TestStream MakeCsvStream() {
+    TestStream stream;
+    char line[128];
+    for (size_t f = 0; f < FRAMES; f++) {
+        int n = std::snprintf(line, sizeof(line), "%zu.5, %zu.25,-%zu,+%zu\r\n", f, f, f, f);
+        stream.bytes.insert(stream.bytes.end(), line, line + n);
+        float base = static_cast<float>(f);
+        stream.values.insert(stream.values.end(), {base + 0.5f, base + 0.25f, -base, base});
+    }
+    return stream;
+}
+
+/**
+ * @brief 保存一帧解码结果（超出预分配空间的帧只计数）
+ */
+void StoreFrame(std::vector<float>& decoded, size_t frame, const float* values) {
+    if ((frame + 1) * CHANNELS <= decoded.size()) {
+        std::memcpy(decoded.data() + frame * CHANNELS, values, CHANNELS * sizeof(float));
+    }
+}
+
+/**
+ * @brief 分块批量解析整段数据，解码值写入decoded（调用方预分配）
+ */
+size_t ParseBatchPass(ProtocolParser& parser, const std::vector<unsigned char>& stream, std::vector<float>& decoded) {
+    static float out[64 * CHANNELS];
+    size_t frames = 0;
+    for (size_t pos = 0; pos < stream.size(); pos += CHUNK) {
+        size_t length = std::min(CHUNK, stream.size() - pos);
+        size_t offset = 0;
+        while (offset < length) {
+            BatchParseResult result = parser.ParseBatch(stream.data() + pos + offset, length - offset,
+                                                        out, 64, CHANNELS);
+            CHECK(result.frames == 0 || result.channels == CHANNELS);
+            for (size_t f = 0; f < result.frames; f++) {
+                StoreFrame(decoded, frames++, out + f * result.channels);
+            }
+            offset += result.bytes_consumed;
+        }
+    }
+    return frames;
+}
+
+/**
+ * @brief 分块逐帧解析整段数据（ParseResult/FloatSpan路径）
+ */
+size_t ParsePass(ProtocolParser& parser, const std::vector<unsigned char>& stream, std::vector<float>& decoded) {
+    size_t frames = 0;
+    for (size_t pos = 0; pos < stream.size(); pos += CHUNK) {
+        size_t length = std::min(CHUNK, stream.size() - pos);
+        size_t offset = 0;
+        while (offset < length) {
+            ParseResult result = parser.Parse(stream.data() + pos + offset, length - offset);
+            if (result.success) {
+                CHECK_EQ(result.values.size(), CHANNELS);
+                StoreFrame(decoded, frames++, result.values.data());
+            }
+            offset += result.bytes_consumed;
+            if (result.bytes_consumed == 0) break;
+        }
+    }
+    return frames;
+}
+
+/**
+ * @brief 预热一遍后，两种解析路径各跑一遍：帧数与解码值正确，且期间没有堆分配
+ */
+void CheckNoAllocations(ProtocolParser& parser, const TestStream& stream) {
+    std::vector<float> warmup(stream.values.size());
+    std::vector<float> batch(stream.values.size());
+    std::vector<float> single(stream.values.size());
+
+    CHECK_EQ(ParseBatchPass(parser, stream.bytes, warmup), FRAMES);
+    CHECK(warmup == stream.values);
+
+    size_t before = g_allocations.load(std::memory_order_relaxed);
+    size_t batch_frames = ParseBatchPass(parser, stream.bytes, batch);
+    size_t single_frames = ParsePass(parser, stream.bytes, single);
+    size_t allocations = g_allocations.load(std::memory_order_relaxed) - before;
+
+    CHECK_EQ(allocations, size_t(0));
+    CHECK_EQ(batch_frames, FRAMES);
+    CHECK_EQ(single_frames, FRAMES);
+    CHECK(batch == stream.values);
+    CHECK(single == stream.values);
+}
+
+} // namespace
+
+TEST_CASE(ParserAllocations, CountingAllocatorWorks) {
+    // 静态对象的容量在函数外可见，编译器不能省略这次分配
+    static std::vector<float> values;
+    values.clear();
+    values.shrink_to_fit();
+    size_t before = g_allocations.load(std::memory_order_relaxed);
+    values.reserve(16);
+    CHECK_EQ(g_allocations.load(std::memory_order_relaxed) - before, size_t(1));
+}
+
+TEST_CASE(ParserAllocations, FireWater) {
+    FireWaterParser parser(CHANNELS);
+    CheckNoAllocations(parser, MakeBinaryStream({}, {0x00, 0x00, 0x80, 0x7F}, true));
+}
+
+TEST_CASE(ParserAllocations, JustFloat) {
+    JustFloatParser parser(CHANNELS);
+    CheckNoAllocations(parser, MakeBinaryStream({}, {}, false));
+}
+
+TEST_CASE(ParserAllocations, RawData) {
+    RawDataParser parser;
+    CheckNoAllocations(parser, MakeBinaryStream({}, {}, false));
+}
+
+TEST_CASE(ParserAllocations, Csv) {
+    CsvParser parser;
+    CheckNoAllocations(parser, MakeCsvStream());
+}
+
+TEST_CASE(ParserAllocations, Custom) {
+    CustomParser parser;
+    CheckNoAllocations(parser, MakeBinaryStream({0xAA}, {0x7F}, true));
+}
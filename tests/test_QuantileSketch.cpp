@@ -0,0 +1,116 @@
+/**
+ * @file test_QuantileSketch.cpp
+ * @brief QuantileSketch精度测试 - 按秩误差检查P50/P95/P99/P99.9、状态拷贝
+ * @author AI Assistant
+ * @date 2025
+ */
+
+#include "TestHarness.h"
+#include "../imgui_ui/core/QuantileSketch.h"
+
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief 估计值在排序数据中的秩（不大于估计值的比例）
+ */
+double RankOf(const std::vector<float>& sorted, double value) {
+    return static_cast<double>(std::upper_bound(sorted.begin(), sorted.end(), static_cast<float>(value)) - sorted.begin()) /
+           static_cast<double>(sorted.size());
+}
+
+/**
+ * @brief 写入样本后检查各分位点的秩误差（尾部要求更严）
+ */
+void CheckAccuracy(std::vector<float> values) {
+    QuantileSketch sketch;
+    // 不同长度的批量写入（跨越缓冲区边界）
+    for (size_t i = 0; i < values.size();) {
+        size_t length = std::min(values.size() - i, 1 + test::RandomIndex(3000));
+        sketch.PushBatch(values.data() + i, length);
+        i += length;
+    }
+    std::sort(values.begin(), values.end());
+    CHECK_EQ(sketch.GetCount(), uint64_t(values.size()));
+    CHECK_EQ(sketch.Quantile(0.0), static_cast<double>(values.front()));
+    CHECK_EQ(sketch.Quantile(1.0), static_cast<double>(values.back()));
+
+    const double quantiles[] = {0.5, 0.95, 0.99, 0.999};
+    const double tolerances[] = {0.01, 0.005, 0.002, 0.0005};
+    for (int k = 0; k < 4; k++) {
+        double estimate = sketch.Quantile(quantiles[k]);
+        CHECK(estimate >= values.front() && estimate <= values.back());
+        CHECK_NEAR(RankOf(values, estimate), quantiles[k], tolerances[k]);
+    }
+}
+
+} // namespace
+
+TEST_CASE(QuantileSketch, Empty) {
+    QuantileSketch sketch;
+    CHECK(std::isnan(sketch.Quantile(0.5)));
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float inf = std::numeric_limits<float>::infinity();
+    float values[] = {nan, inf, -inf};
+    sketch.PushBatch(values, 3);
+    CHECK_EQ(sketch.GetCount(), uint64_t(0));
+    CHECK(std::isnan(sketch.Quantile(0.5)));
+}
+
+TEST_CASE(QuantileSketch, UniformAccuracy) {
+    std::vector<float> values(200000);
+    for (float& value : values) value = test::RandomFloat(-100.0f, 100.0f);
+    CheckAccuracy(values);
+}
+
+TEST_CASE(QuantileSketch, NormalAccuracy) {
+    std::normal_distribution<float> normal(5.0f, 2.0f);
+    std::vector<float> values(200000);
+    for (float& value : values) value = normal(test::Random());
+    CheckAccuracy(values);
+}
+
+TEST_CASE(QuantileSketch, HeavyTailAccuracy) {
+    // 延迟类信号：大部分很小，少量很大的尖峰
+    std::exponential_distribution<float> exponential(1.0f);
+    std::vector<float> values(200000);
+    for (float& value : values) {
+        value = exponential(test::Random());
+        if (test::RandomIndex(200) == 0) value *= 50.0f;
+    }
+    CheckAccuracy(values);
+}
+
+TEST_CASE(QuantileSketch, ResetClears) {
+    QuantileSketch sketch;
+    std::vector<float> values(5000, 3.0f);
+    sketch.PushBatch(values.data(), values.size());
+    CHECK_EQ(sketch.Quantile(0.5), 3.0);
+    sketch.Reset();
+    CHECK_EQ(sketch.GetCount(), uint64_t(0));
+    float value = -7.0f;
+    sketch.PushBatch(&value, 1);
+    CHECK_EQ(sketch.Quantile(0.5), -7.0);
+}
+
+TEST_CASE(QuantileSketch, CopyMatchesOriginal) {
+    // 拷贝时缓冲区中有未归并的样本：副本查询的结果与原草图相同，原草图不受影响
+    QuantileSketch sketch, copy;
+    std::vector<float> values(10500);
+    for (float& value : values) value = test::RandomFloat(-10.0f, 10.0f);
+    sketch.PushBatch(values.data(), values.size());
+    sketch.CopyTo(copy);
+    CHECK_EQ(copy.GetCount(), sketch.GetCount());
+    for (double q : {0.0, 0.5, 0.95, 0.99, 0.999, 1.0}) {
+        CHECK_EQ(copy.Quantile(q), sketch.Quantile(q));
+    }
+
+    // 副本复用：再次拷贝覆盖之前的状态
+    sketch.Reset();
+    float value = 4.0f;
+    sketch.PushBatch(&value, 1);
+    sketch.CopyTo(copy);
+    CHECK_EQ(copy.GetCount(), uint64_t(1));
+    CHECK_EQ(copy.Quantile(0.5), 4.0);
+}
@@ -0,0 +1,42 @@
+/**
+ * @file test_ReceiveGate.cpp
+ * @brief ReceiveGate测试 - 闸门关闭期间回调不执行，打开后继续
+ * @author AI Assistant
+ * @date 2025
+ */
+
+#include "TestHarness.h"
+#include "../imgui_ui/core/ReceiveGate.h"
+
+#include <chrono>
+#include <thread>
+
+TEST_CASE(ReceiveGate, CloseQuiescesCallback) {
+    ReceiveGate gate;
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> calls_seen{0};
+    uint64_t calls = 0;             // 只在闸门内修改，闸门关闭时由控制线程读取
+
+    std::thread receiver([&] {
+        while (!stop.load(std::memory_order_relaxed)) {
+            ReceiveGate::Scope scope(gate);
+            calls++;
+            calls_seen.store(calls, std::memory_order_relaxed);
+        }
+    });
+
+    for (int round = 0; round < 200; round++) {
+        gate.Close();
+        uint64_t before = calls;
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        CHECK_EQ(calls, before);
+        gate.Open();
+
+        // 打开后回调继续执行
+        while (calls_seen.load(std::memory_order_relaxed) <= before) {
+            std::this_thread::yield();
+        }
+    }
+    stop = true;
+    receiver.join();
+}
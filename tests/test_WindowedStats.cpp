@@ -0,0 +1,165 @@
+/**
+ * @file test_WindowedStats.cpp
+ * @brief WindowedStats随机差分测试 - 全程统计和滑动窗口统计与直接计算比较
+ * @author AI Assistant
+ * @date 2025
+ *
+ * 随机长度的批量写入（含NaN和单个样本的Push），中途修改窗口长度、清空；
+ * 参考值用double在保存的全部有效样本上直接计算。
+ */
+
+#include "TestHarness.h"
+#include "../imgui_ui/core/WindowedStats.h"
+
+#include <limits>
+
+namespace {
+
+/**
+ * @brief 参考模型：保存全部有效样本，窗口为修改窗口长度以来最近window个有效样本
+ */
+struct ReferenceStats {
+    std::vector<float> all;
+    std::vector<float> window_samples;      // 修改窗口长度（或清空）之后的有效样本
+    size_t window = WindowedStats::DEFAULT_WINDOW;
+
+    void Push(float value) {
+        if (std::isnan(value)) return;
+        all.push_back(value);
+        window_samples.push_back(value);
+    }
+};
+
+void Compare(const WindowedStats& stats, const ReferenceStats& reference) {
+    ChannelStats actual = stats.GetStats();
+    CHECK_EQ(actual.sample_count, reference.all.size());
+    if (reference.all.empty()) return;
+
+    double sum = 0.0, minimum = reference.all[0], maximum = reference.all[0];
+    for (float value : reference.all) {
+        sum += value;
+        minimum = std::min<double>(minimum, value);
+        maximum = std::max<double>(maximum, value);
+    }
+    double mean = sum / reference.all.size();
+    double m2 = 0.0;
+    for (float value : reference.all) m2 += (value - mean) * (value - mean);
+    double scale = std::max(std::fabs(maximum), std::fabs(minimum)) + 1.0;
+
+    CHECK_EQ(actual.min_value, static_cast<float>(minimum));
+    CHECK_EQ(actual.max_value, static_cast<float>(maximum));
+    CHECK_EQ(actual.last_value, reference.all.back());
+    CHECK_NEAR(actual.avg_value, mean, 1e-5 * scale);
+    CHECK_NEAR(actual.std_dev, std::sqrt(m2 / reference.all.size()), 1e-4 * scale);
+
+    size_t window_count = std::min(reference.window, reference.window_samples.size());
+    CHECK_EQ(actual.window_count, window_count);
+    if (window_count == 0) return;
+    double window_sum = 0.0, window_sq = 0.0;
+    double window_min = std::numeric_limits<double>::infinity();
+    double window_max = -std::numeric_limits<double>::infinity();
+    for (size_t i = reference.window_samples.size() - window_count; i < reference.window_samples.size(); i++) {
+        double value = reference.window_samples[i];
+        window_sum += value;
+        window_sq += value * value;
+        window_min = std::min(window_min, value);
+        window_max = std::max(window_max, value);
+    }
+    double window_mean = window_sum / window_count;
+    double window_m2 = 0.0;
+    for (size_t i = reference.window_samples.size() - window_count; i < reference.window_samples.size(); i++) {
+        double d = reference.window_samples[i] - window_mean;
+        window_m2 += d * d;
+    }
+    CHECK_EQ(actual.window_min, static_cast<float>(window_min));
+    CHECK_EQ(actual.window_max, static_cast<float>(window_max));
+    CHECK_NEAR(actual.window_mean, window_mean, 1e-4 * scale);
+    CHECK_NEAR(actual.window_std, std::sqrt(window_m2 / window_count), 1e-3 * scale);
+    CHECK_NEAR(actual.window_rms, std::sqrt(window_sq / window_count), 1e-3 * scale);
+    CHECK_NEAR(actual.PeakToPeak(), window_max - window_min, 1e-6 * scale);
+}
+
+} // namespace
+
+TEST_CASE(WindowedStats, ClampWindow) {
+    CHECK_EQ(WindowedStats::ClampWindow(0), WindowedStats::MIN_WINDOW);
+    CHECK_EQ(WindowedStats::ClampWindow(100), size_t(100));
+    CHECK_EQ(WindowedStats::ClampWindow(1u << 30), WindowedStats::MAX_WINDOW);
+}
+
+TEST_CASE(WindowedStats, EmptyAndAllNaN) {
+    WindowedStats stats(16);
+    CHECK_EQ(stats.GetStats().sample_count, size_t(0));
+    std::vector<float> nans(100, std::numeric_limits<float>::quiet_NaN());
+    stats.PushBatch(nans.data(), nans.size());
+    CHECK_EQ(stats.GetStats().sample_count, size_t(0));
+    CHECK_EQ(stats.GetStats().window_count, size_t(0));
+}
+
+TEST_CASE(WindowedStats, DifferentialRandom) {
+    const size_t windows[] = {2, 3, 63, 64, 65, 100, 1000, 4096};
+    for (int round = 0; round < 24; round++) {
+        ReferenceStats reference;
+        reference.window = windows[test::RandomIndex(8)];
+        WindowedStats stats(reference.window);
+
+        // 带偏置的信号（检验平移累加的数值稳定性）
+        float offset = test::RandomFloat(-1000.0f, 1000.0f);
+        std::vector<float> batch;
+        for (int step = 0; step < 150; step++) {
+            switch (test::RandomIndex(12)) {
+                case 0: {
+                    float value = offset + test::RandomFloat(-5.0f, 5.0f);
+                    stats.Push(value);
+                    reference.Push(value);
+                    break;
+                }
+                case 1: {
+                    // 修改窗口长度：窗口统计从头开始（长度不变时保持），全程统计保留
+                    size_t window = windows[test::RandomIndex(8)];
+                    stats.SetWindow(window);
+                    if (window != reference.window) {
+                        reference.window = window;
+                        reference.window_samples.clear();
+                    }
+                    break;
+                }
+                case 2: {
+                    if (test::RandomIndex(5) == 0) {
+                        stats.Reset();
+                        reference.all.clear();
+                        reference.window_samples.clear();
+                    }
+                    break;
+                }
+                default: {
+                    batch.resize(test::RandomIndex(3 * reference.window + 10));
+                    for (float& value : batch) {
+                        value = (test::RandomIndex(10) == 0) ? std::numeric_limits<float>::quiet_NaN()
+                                                             : offset + test::RandomFloat(-5.0f, 5.0f);
+                    }
+                    stats.PushBatch(batch.data(), batch.size());
+                    for (float value : batch) reference.Push(value);
+                    break;
+                }
+            }
+            Compare(stats, reference);
+        }
+    }
+}
+
+TEST_CASE(WindowedStats, MonotonicRunsAcrossChunks) {
+    // 单调上升/下降的长段：窗口最值始终在窗口两端，覆盖单调队列的极端情况
+    WindowedStats stats(200);
+    ReferenceStats reference;
+    reference.window = 200;
+    std::vector<float> batch(777);
+    for (int run = 0; run < 20; run++) {
+        for (size_t i = 0; i < batch.size(); i++) {
+            batch[i] = (run % 2 == 0) ? static_cast<float>(i) : static_cast<float>(batch.size() - i);
+        }
+        stats.PushBatch(batch.data(), batch.size());
+        for (float value : batch) reference.Push(value);
+        Compare(stats, reference);
+    }
+}